@@ -57,6 +57,7 @@ extern "C" {
 #define TSDB_PERFS_TABLE_OFFSETS     "perf_offsets"
 #define TSDB_PERFS_TABLE_TRANS       "perf_trans"
 #define TSDB_PERFS_TABLE_APPS        "perf_apps"
+#define TSDB_PERFS_TABLE_QUERY_MEMORY "perf_query_memory"
 
 typedef struct SSysDbTableSchema {
   const char*   name;
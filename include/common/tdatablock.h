@@ -235,6 +235,17 @@ size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
 int32_t blockDataSort_rv(SSDataBlock* pDataBlock, SArray* pOrderInfo, bool nullFirst);
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* pIndex);  // row i of the result is row pIndex[i]
+
+/*
+ * Normalized sort key: the order columns of one row encoded into a byte string, so that comparing two keys with
+ * memcmp gives the same result as comparing the rows column by column. Only the leading *numOfExact* order columns
+ * are decided by the key; rows with equal keys still need to be compared from the order column numOfExact on.
+ * The key length is zero when the first order column cannot be encoded.
+ */
+int32_t blockDataGetSortKeyLen(const SSDataBlock* pBlock, const SArray* pOrderInfo, int32_t* numOfExact);
+int32_t blockDataEncodeSortKeys(const SSDataBlock* pBlock, const SArray* pOrderInfo, int32_t keyLen, char* pKeys,
+                                int32_t stride);
 
 int32_t colInfoDataEnsureCapacity(SColumnInfoData* pColumn, uint32_t numOfRows, bool clearPayload);
 int32_t blockDataEnsureCapacity(SSDataBlock* pDataBlock, uint32_t numOfRows);
@@ -263,9 +274,17 @@ int32_t      blockDataAppendColInfo(SSDataBlock* pBlock, SColumnInfoData* pColIn
 SColumnInfoData  createColumnInfoData(int16_t type, int32_t bytes, int16_t colId);
 SColumnInfoData* bdGetColumnInfoData(const SSDataBlock* pBlock, int32_t index);
 
+#define BLOCK_VERSION_1          1
+#define BLOCK_VERSION_COMPRESSED 2  // each column is encoded by the codec of its type, or LZ4
+
 int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
+int32_t blockCompressEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
 
+// restore a compressed block into the version 1 layout
+int32_t blockGetDecompressSize(const char* pData);
+int32_t blockDecompress(const char* pData, char* pOut);
+
 void blockDebugShowDataBlock(SSDataBlock* pBlock, const char* flag);
 void blockDebugShowDataBlocks(const SArray* dataBlocks, const char* flag);
 // for debug
@@ -280,6 +299,12 @@ static FORCE_INLINE int32_t blockGetEncodeSize(const SSDataBlock* pBlock) {
   return blockDataGetSerialMetaSize(taosArrayGetSize(pBlock->pDataBlock)) + blockDataGetSize(pBlock);
 }
 
+// the codecs may overrun the raw size of a column by a few bytes before falling back to a plain copy
+static FORCE_INLINE int32_t blockGetCompressEncodeSize(const SSDataBlock* pBlock) {
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  return blockGetEncodeSize(pBlock) + numOfCols * (sizeof(int8_t) + sizeof(int32_t) * 2 + COMP_OVERFLOW_BYTES + 1);
+}
+
 static FORCE_INLINE int32_t blockCompressColData(SColumnInfoData* pColRes, int32_t numOfRows, char* data,
                                                  int8_t compressed) {
   int32_t colSize = colDataGetLength(pColRes, numOfRows);
@@ -51,6 +51,7 @@ extern int32_t tsTagFilterResCacheSize;
 extern int32_t tsNumOfRpcThreads;
 extern int32_t tsNumOfRpcSessions;
 extern int32_t tsNumOfCommitThreads;
+extern int32_t tsNumOfCompactThreads;
 extern int32_t tsNumOfTaskQueueThreads;
 extern int32_t tsNumOfMnodeQueryThreads;
 extern int32_t tsNumOfMnodeFetchThreads;
@@ -72,6 +73,12 @@ extern int32_t tsHeartbeatTimeout;
 
 // vnode
 extern int64_t tsVndCommitMaxIntervalMs;
+extern int32_t tsTsdbPageCacheSize;
+extern int32_t tsTsdbReadaheadBlocks;
+extern int32_t tsTsdbCompactSttTrigger;
+extern int32_t tsTsdbCompactMaxSpeed;
+extern int32_t tsTsdbCommitThreads;
+extern bool    tsTsdbBlockBloomFilter;
 
 // monitor
 extern bool     tsEnableMonitor;
@@ -94,12 +101,17 @@ extern char    *tsSvrCrashReportUri;
 // query buffer management
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in byte for each data node
+extern int32_t tsQueryMemoryLimit;      // maximum allowed usage buffer size in MB for each query task
+extern bool    tsQueryBufAsyncIo;       // flush and read ahead the spilled query buffer pages in the background
+extern bool    tsQueryBufCompress;      // compress the query buffer pages spilled to disk
 
 // query client
 extern int32_t tsQueryPolicy;
 extern int32_t tsQueryRspPolicy;
 extern int32_t tsQuerySmaOptimize;
+extern int32_t tsQueryScanParallelism;
 extern int32_t tsQueryRsmaTolerance;
+extern int32_t tsQueryHashJoinBufSize;
 extern bool    tsQueryPlannerTrace;
 extern int32_t tsQueryNodeChunkSize;
 extern bool    tsQueryUseNodeAllocator;
@@ -147,6 +159,8 @@ extern int32_t tsSmlBatchSize;
 
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
+extern int32_t tsWalGroupCommitSize;
+extern int32_t tsWalGroupCommitDelay;
 
 // internal
 extern int32_t tsTransPullupInterval;
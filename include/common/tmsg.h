@@ -130,6 +130,7 @@ typedef enum _mgmt_table {
   TSDB_MGMT_TABLE_APPS,
   TSDB_MGMT_TABLE_STREAM_TASKS,
   TSDB_MGMT_TABLE_PRIVILEGES,
+  TSDB_MGMT_TABLE_QUERY_MEMORY,
   TSDB_MGMT_TABLE_MAX,
 } EShowType;
 
@@ -1111,22 +1112,30 @@ typedef struct {
 } SQnodeLoad;
 
 typedef struct {
-  int32_t     sver;      // software version
-  int64_t     dnodeVer;  // dnode table version in sdb
-  int32_t     dnodeId;
-  int64_t     clusterId;
-  int64_t     rebootTime;
-  int64_t     updateTime;
-  float       numOfCores;
-  int32_t     numOfSupportVnodes;
-  int64_t     memTotal;
-  int64_t     memAvail;
-  char        dnodeEp[TSDB_EP_LEN];
-  SMnodeLoad  mload;
-  SQnodeLoad  qload;
-  SClusterCfg clusterCfg;
-  SArray*     pVloads;  // array of SVnodeLoad
-  int32_t     statusSeq;
+  int64_t used;          // buffer of the running query tasks, in bytes
+  int64_t peak;
+  int64_t limit;         // queryBufferSize in bytes, -1 means unlimited
+  int64_t numOfRejects;  // allocations refused by a query or node memory budget
+} SQueryMemLoad;
+
+typedef struct {
+  int32_t       sver;      // software version
+  int64_t       dnodeVer;  // dnode table version in sdb
+  int32_t       dnodeId;
+  int64_t       clusterId;
+  int64_t       rebootTime;
+  int64_t       updateTime;
+  float         numOfCores;
+  int32_t       numOfSupportVnodes;
+  int64_t       memTotal;
+  int64_t       memAvail;
+  char          dnodeEp[TSDB_EP_LEN];
+  SMnodeLoad    mload;
+  SQnodeLoad    qload;
+  SClusterCfg   clusterCfg;
+  SArray*       pVloads;  // array of SVnodeLoad
+  int32_t       statusSeq;
+  SQueryMemLoad qmemLoad;
 } SStatusReq;
 
 int32_t tSerializeSStatusReq(void* buf, int32_t bufLen, SStatusReq* pReq);
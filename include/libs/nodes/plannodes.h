@@ -103,6 +103,8 @@ typedef struct SScanLogicNode {
   bool          hasNormalCols;  // neither tag column nor primary key tag column
   bool          sortPrimaryKey;
   bool          igLastNull;
+  int32_t       sliceIdx;     // the part of the vnode's table list scanned by this subplan
+  int32_t       numOfSlices;  // number of subplans the table list of each vnode is split into
 } SScanLogicNode;
 
 typedef struct SJoinLogicNode {
@@ -360,6 +362,8 @@ typedef struct STableScanPhysiNode {
   int8_t         igExpired;
   bool           assignBlockUid;
   int8_t         igCheckUpdate;
+  int32_t        sliceIdx;
+  int32_t        numOfSlices;
 } STableScanPhysiNode;
 
 typedef STableScanPhysiNode STableSeqScanPhysiNode;
@@ -400,6 +404,15 @@ typedef struct SSortMergeJoinPhysiNode {
   EOrder     inputTsOrder;
 } SSortMergeJoinPhysiNode;
 
+typedef struct SHashJoinPhysiNode {
+  SPhysiNode node;
+  EJoinType  joinType;
+  SNodeList* pOnLeft;   // equi-join keys of the left child, the probe side
+  SNodeList* pOnRight;  // equi-join keys of the right child, the build side
+  SNode*     pOnConditions;
+  SNodeList* pTargets;
+} SHashJoinPhysiNode;
+
 typedef struct SAggPhysiNode {
   SPhysiNode node;
   SNodeList* pExprs;  // these are expression list of group_by_clause and parameter expression of aggregate function
@@ -532,6 +545,8 @@ typedef struct SDataSinkNode {
 
 typedef struct SDataDispatcherNode {
   SDataSinkNode sink;
+  bool          compress;           // the consumer accepts column compressed blocks
+  int32_t       compressThreshold;  // compress a block if any column is larger than it, 0 means always
 } SDataDispatcherNode;
 
 typedef struct SDataInserterNode {
@@ -24,6 +24,7 @@ extern "C" {
 
 typedef struct SFilterInfo SFilterInfo;
 typedef int32_t (*filer_get_col_from_id)(void *, int32_t, void **);
+typedef bool (*filter_may_contain_fn)(void *param, int16_t colId, int8_t type, const void *pVal);
 
 enum {
   FLT_OPTION_NO_REWRITE = 1,
@@ -50,6 +51,7 @@ extern int32_t filterConverNcharColumns(SFilterInfo *pFilterInfo, int32_t rows,
 extern int32_t filterFreeNcharColumns(SFilterInfo *pFilterInfo);
 extern void    filterFreeInfo(SFilterInfo *info);
 extern bool    filterRangeExecute(SFilterInfo *info, SColumnDataAgg **pColsAgg, int32_t numOfCols, int32_t numOfRows);
+extern bool    filterBloomExecute(SFilterInfo *info, filter_may_contain_fn fp, void *param);
 
 /* condition split interface */
 int32_t filterPartitionCond(SNode **pCondition, SNode **pPrimaryKeyCond, SNode **pTagIndexCond, SNode **pTagCond,
@@ -97,6 +97,20 @@ typedef struct {
 } SWalCkHead;
 #pragma pack(pop)
 
+// log entries gathered by group commit, flushed to the log and idx file in one write each
+typedef struct {
+  int64_t  firstVer;  // first buffered version, -1 if empty
+  int64_t  firstTs;   // when the first entry was buffered
+  int64_t  logOffset;
+  uint8_t *pLog;
+  int64_t  logLen;
+  int64_t  logCap;
+  uint8_t *pIdx;
+  int64_t  idxLen;
+  int64_t  idxCap;
+  int32_t  code;  // failure of a flush nobody waited for, returned by the next walFsync
+} SWalWriteBuf;
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -119,6 +133,8 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
+  // group commit
+  SWalWriteBuf writeBuf;
   // reusable write head
   SWalCkHead writeHead;
 } SWal;
@@ -174,7 +190,11 @@ int32_t walWriteWithSyncInfo(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo
 // -1 will be returned for failed writes
 int64_t walAppendLog(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body, int32_t bodyLen);
 
-void walFsync(SWal *, bool force);
+// flush the group commit batch and fsync if asked to, entries after walGetLastVer() are lost on failure
+int32_t walFsync(SWal *, bool force);
+
+// entries are buffered and flushed in batches, the caller should fsync once per batch
+bool walGroupCommitEnabled(SWal *);
 
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
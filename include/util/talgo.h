@@ -54,6 +54,28 @@ typedef int32_t (*__ext_compar_fn_t)(const void *p1, const void *p2, const void
  */
 void taosqsort(void *src, int64_t numOfElem, int64_t size, const void *param, __ext_compar_fn_t comparFn);
 
+/**
+ * pattern-defeating quick sort, falls back to heap sort on degenerated input
+ *
+ * @param src
+ * @param numOfElem
+ * @param size
+ * @param param
+ * @param comparFn
+ */
+void taosPdqSort(void *src, int64_t numOfElem, int64_t size, const void *param, __ext_compar_fn_t comparFn);
+
+/**
+ * stable LSD radix sort, elements are ordered by memcmp of their leading keyLen bytes
+ *
+ * @param src
+ * @param numOfElem
+ * @param size
+ * @param keyLen
+ * @return
+ */
+int32_t taosRadixSort(void *src, int64_t numOfElem, int64_t size, int32_t keyLen);
+
 /**
  * binary search, with range support
  *
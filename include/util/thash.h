@@ -59,6 +59,7 @@ _equal_fn_t taosGetDefaultEqualFunction(int32_t type);
 typedef enum SHashLockTypeE {
   HASH_NO_LOCK = 0,
   HASH_ENTRY_LOCK = 1,
+  HASH_STRIPED_LOCK = 2,  // split into sub tables by the high bits of the hash value, each with its own lock
 } SHashLockTypeE;
 
 typedef struct SHashNode SHashNode;
@@ -92,6 +93,20 @@ int32_t taosHashGetSize(const SHashObj *pHashObj);
  */
 int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t size);
 
+/**
+ * put a batch of elements with fixed length keys and payload into hash table. The hash table is resized at most once
+ * and the table lock is acquired once for the whole batch instead of once per element.
+ * @param pHashObj
+ * @param keys      num keys of keyLen bytes each, stored one after another
+ * @param keyLen
+ * @param data      num payloads of size bytes each, stored one after another
+ * @param size
+ * @param num
+ * @return 0 if all elements are put, HASH_KEY_ALREADY_EXISTS if some keys exist and update is not enabled, or -1
+ */
+int32_t taosHashPutBatch(SHashObj *pHashObj, const void *keys, size_t keyLen, const void *data, size_t size,
+                         int32_t num);
+
 /**
  * return the payload data with the specified key
  *
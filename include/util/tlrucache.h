@@ -37,6 +37,19 @@ typedef enum {
   TAOS_LRU_STATUS_OK_OVERWRITTEN
 } LRUStatus;
 
+typedef enum {
+  TAOS_LRU_ADMIT_ALL,      // every insert is cached, evicting cold entries if needed
+  TAOS_LRU_ADMIT_TINY_LFU  // an insert that needs an eviction is cached only if it is accessed as often as the victim
+} LRUAdmission;
+
+typedef struct {
+  int64_t hits;
+  int64_t misses;
+  int64_t inserts;
+  int64_t evictions;
+  int64_t rejections;  // inserts refused by the admission policy
+} SLRUCacheStat;
+
 SLRUCache *taosLRUCacheInit(size_t capacity, int numShardBits, double highPriPoolRatio);
 void       taosLRUCacheCleanup(SLRUCache *cache);
 
@@ -61,6 +74,9 @@ size_t taosLRUCacheGetCapacity(SLRUCache *cache);
 void taosLRUCacheSetStrictCapacity(SLRUCache *cache, bool strict);
 bool taosLRUCacheIsStrictCapacity(SLRUCache *cache);
 
+void taosLRUCacheSetAdmission(SLRUCache *cache, LRUAdmission admission);
+void taosLRUCacheGetStat(SLRUCache *cache, SLRUCacheStat *stat);
+
 #ifdef __cplusplus
 }
 #endif
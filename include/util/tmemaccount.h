@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_MEMACCOUNT_H_
+#define _TD_UTIL_MEMACCOUNT_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Memory accounts form a tree: the node account at the root, one account per query task below it and one per
+ * operator buffer below the task. A reservation is charged to the account and all of its ancestors, and fails
+ * without charging anything if it would take any of them over its limit. A negative limit means unlimited.
+ */
+typedef struct SMemAccount SMemAccount;
+
+typedef struct {
+  int64_t used;
+  int64_t peak;
+  int64_t limit;
+  int64_t numOfRejects;  // reservations refused since the account was created
+} SMemAccountStat;
+
+SMemAccount *taosMemAccountCreate(SMemAccount *pParent, const char *name, int64_t limit);
+void         taosMemAccountDestroy(SMemAccount *pAccount);
+
+// the process wide root account
+SMemAccount *taosMemAccountGetNode();
+
+int32_t taosMemAccountReserve(SMemAccount *pAccount, int64_t size);
+// charge the account and its ancestors even beyond their limits
+void    taosMemAccountCharge(SMemAccount *pAccount, int64_t size);
+void    taosMemAccountRelease(SMemAccount *pAccount, int64_t size);
+
+void    taosMemAccountSetLimit(SMemAccount *pAccount, int64_t limit);
+int64_t taosMemAccountGetUsed(SMemAccount *pAccount);
+void    taosMemAccountGetStat(SMemAccount *pAccount, SMemAccountStat *pStat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_MEMACCOUNT_H_*/
@@ -19,6 +19,7 @@
 #include "thash.h"
 #include "tlist.h"
 #include "tlockfree.h"
+#include "tmemaccount.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +40,12 @@ typedef struct SDiskbasedBufStatis {
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int64_t rawFlushBytes;   // size of the flushed pages before compression
+  int32_t pendingHits;     // pages reloaded from the background writer before reaching the disk
+  int32_t readaheadPages;  // pages read in advance by the background I/O
+  int32_t readaheadHits;   // read ahead pages that are reloaded later
+  int64_t ioWaitUs;        // time spent waiting for the spill file I/O
+  int32_t overdraftPages;  // pages allocated beyond the memory budget, since there was no page to spill
 } SDiskbasedBufStatis;
 
 /**
@@ -151,6 +158,39 @@ void setBufPageDirty(void* pPage, bool dirty);
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
 
+/**
+ * Write the evicted pages to disk in the background and read the next page ahead when reloading, it is on by
+ * default. It takes effect before the first page is flushed to disk.
+ * @param pBuf
+ * @param async
+ */
+void setBufPageAsyncIo(SDiskbasedBuf* pBuf, bool async);
+
+/**
+ * Set the defaults of the buffers created afterwards, whether to flush and read ahead the pages by the background
+ * I/O threads and whether to compress the pages flushed to disk.
+ * @param asyncIo
+ * @param comp
+ */
+void dBufSetDefaultOptions(bool asyncIo, bool comp);
+
+/**
+ * Stop the background I/O threads shared by all of the buffers, the buffers created afterwards flush pages
+ * synchronously. It is called when the process exits, after all of the buffers are destroyed.
+ */
+void dBufCleanupIoPool();
+
+/**
+ * Charge the in-memory pages of this buffer to a child account of pParent. When the budget is used up a page is
+ * spilled to disk to make room for a new one. If there is no page to spill, a buffer holding less than two pages
+ * takes the page beyond the budget, otherwise the allocation fails with TSDB_CODE_QRY_NOT_ENOUGH_BUFFER. It should
+ * be set before the first page is allocated.
+ * @param pBuf
+ * @param pParent
+ * @return
+ */
+int32_t dBufSetMemAccount(SDiskbasedBuf* pBuf, SMemAccount* pParent);
+
 /**
  * Set the pageId page buffer is not need
  * @param pBuf
@@ -33,6 +33,8 @@ Notes:
 1: taosOpenQueue/taosCloseQueue, taosOpenQset/taosCloseQset is NOT multi-thread safe
 2: after taosCloseQueue/taosCloseQset is called, read/write operation APIs are not safe.
 3: read/write operation APIs are multi-thread safe
+4: a queue is an intrusive MPSC list, writers never take a lock, readers of one queue are serialized
+5: a queue shall be added into a qset before the first write, and removed after the last one
 
 To remove the limitation and make this set of queue APIs multi-thread safe, REF(tref.c)
 shall be used to set up the protection.
@@ -73,8 +75,9 @@ typedef struct STaosQnode {
 } STaosQnode;
 
 typedef struct STaosQueue {
-  STaosQnode   *head;
-  STaosQnode   *tail;
+  STaosQnode   *head;     // read end, guarded by mutex
+  STaosQnode   *tail;     // write end, swapped atomically by writers
+  STaosQnode   *stub;     // keeps the list non-empty
   STaosQueue   *next;     // for queue set
   STaosQset    *qset;     // for queue set
   void         *ahandle;  // for queue set
@@ -93,6 +96,9 @@ typedef struct STaosQset {
   tsem_t        sem;
   int32_t       numOfQueues;
   int32_t       numOfItems;
+  int32_t       numOfWaiters;  // readers parked on sem
+  int32_t       numOfResumes;  // readers asked to exit
+  int32_t       spinLoops;     // adaptive spin before parking
 } STaosQset;
 
 typedef struct STaosQall {
@@ -178,6 +178,8 @@ typedef struct SReqResultInfo {
   bool           convertUcs4;
   int32_t        payloadLen;
   char*          convertJson;
+  char*          decompBuf;
+  int32_t        decompBufSize;
 } SReqResultInfo;
 
 typedef struct SRequestSendRecvBody {
@@ -1969,6 +1969,33 @@ void resetConnectDB(STscObj* pTscObj) {
   taosThreadMutexUnlock(&pTscObj->mutex);
 }
 
+// restore the compressed block into the version 1 layout, which the result set is parsed from
+static int32_t doDecompressResult(SReqResultInfo* pResultInfo) {
+  const char* p = pResultInfo->pData;
+  if (*(int32_t*)p != BLOCK_VERSION_COMPRESSED) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t len = blockGetDecompressSize(p);
+  if (len > pResultInfo->decompBufSize) {
+    char* tmp = taosMemoryRealloc(pResultInfo->decompBuf, len);
+    if (tmp == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pResultInfo->decompBuf = tmp;
+    pResultInfo->decompBufSize = len;
+  }
+
+  if (blockDecompress(p, pResultInfo->decompBuf) < 0) {
+    tscError("failed to decompress the result block, len:%d", len);
+    return terrno;
+  }
+
+  pResultInfo->pData = pResultInfo->decompBuf;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableRsp* pRsp, bool convertUcs4,
                               bool freeAfterUse) {
   assert(pResultInfo != NULL && pRsp != NULL);
@@ -1983,7 +2010,13 @@ int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableR
   pResultInfo->payloadLen = htonl(pRsp->compLen);
   pResultInfo->precision = pRsp->precision;
 
-  // TODO handle the compressed case
+  if (pRsp->compressed && pResultInfo->numOfRows > 0) {
+    int32_t code = doDecompressResult(pResultInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
   pResultInfo->totalRows += pResultInfo->numOfRows;
   return setResultDataPtr(pResultInfo, pResultInfo->fields, pResultInfo->numOfCols, pResultInfo->numOfRows,
                           convertUcs4);
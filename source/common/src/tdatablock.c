@@ -720,19 +720,15 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock) {
 typedef struct SSDataBlockSortHelper {
   SArray*      orderInfo;  // SArray<SBlockOrderInfo>
   SSDataBlock* pDataBlock;
+  int32_t      keyLen;      // length of the normalized sort key, the row index follows the key
+  int32_t      numOfExact;  // order columns fully decided by the normalized sort key
 } SSDataBlockSortHelper;
 
-int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
-  const SSDataBlockSortHelper* pHelper = (const SSDataBlockSortHelper*)param;
-
+static int32_t dataBlockComparFrom(const SSDataBlockSortHelper* pHelper, int32_t start, int32_t left, int32_t right) {
   SSDataBlock* pDataBlock = pHelper->pDataBlock;
+  SArray*      pInfo = pHelper->orderInfo;
 
-  int32_t left = *(int32_t*)p1;
-  int32_t right = *(int32_t*)p2;
-
-  SArray* pInfo = pHelper->orderInfo;
-
-  for (int32_t i = 0; i < pInfo->size; ++i) {
+  for (int32_t i = start; i < pInfo->size; ++i) {
     SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pInfo, i);
     SColumnInfoData* pColInfoData = pOrder->pColData;  // TARRAY_GET_ELEM(pDataBlock->pDataBlock, pOrder->colIndex);
 
@@ -773,6 +769,263 @@ int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
   return 0;
 }
 
+int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
+  return dataBlockComparFrom((const SSDataBlockSortHelper*)param, 0, *(int32_t*)p1, *(int32_t*)p2);
+}
+
+static int32_t dataBlockKeyCompar(const void* p1, const void* p2, const void* param) {
+  const SSDataBlockSortHelper* pHelper = (const SSDataBlockSortHelper*)param;
+
+  int32_t ret = memcmp(p1, p2, pHelper->keyLen);
+  if (ret != 0 || pHelper->numOfExact == taosArrayGetSize(pHelper->orderInfo)) {
+    return ret;
+  }
+
+  int32_t left = 0, right = 0;
+  memcpy(&left, (const char*)p1 + pHelper->keyLen, sizeof(int32_t));
+  memcpy(&right, (const char*)p2 + pHelper->keyLen, sizeof(int32_t));
+  return dataBlockComparFrom(pHelper, pHelper->numOfExact, left, right);
+}
+
+/*
+ * A binary value keeps its leading bytes in the sort key, followed by its length, or SORT_KEY_VAR_TRUNCATED if it does
+ * not fit. The key bytes after a truncated value are zero, so that the rows are told apart by the comparator.
+ */
+#define SORT_KEY_VAR_PREFIX_LEN 16
+#define SORT_KEY_VAR_TRUNCATED  (SORT_KEY_VAR_PREFIX_LEN + 1)
+
+// radix sort pays off only when the rows are many and the keys are short
+#define SORT_KEY_RADIX_MIN_ROWS 256
+#define SORT_KEY_RADIX_MAX_LEN  32
+
+static int32_t sortKeyColLen(int8_t type, bool* exact) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_DOUBLE:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      *exact = true;
+      return 1 + tDataTypes[type].bytes;
+    case TSDB_DATA_TYPE_VARCHAR:
+      *exact = false;
+      return 1 + SORT_KEY_VAR_PREFIX_LEN + 1;
+    default:
+      *exact = false;
+      return 0;
+  }
+}
+
+// big-endian, so that the unsigned byte order is the value order
+static FORCE_INLINE void sortKeyPutUint(char* p, uint64_t v, int32_t bytes, bool desc) {
+  if (desc) {
+    v = ~v;
+  }
+
+  for (int32_t i = bytes - 1; i >= 0; --i) {
+    p[i] = (char)(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+// return false if the value is truncated
+static bool sortKeyEncodeVal(int8_t type, const char* pVal, char* p, bool desc) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      sortKeyPutUint(p, (uint8_t)(*(int8_t*)pVal) ^ 0x80u, sizeof(int8_t), desc);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      sortKeyPutUint(p, *(uint8_t*)pVal, sizeof(uint8_t), desc);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      sortKeyPutUint(p, (uint16_t)(*(int16_t*)pVal) ^ 0x8000u, sizeof(int16_t), desc);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      sortKeyPutUint(p, *(uint16_t*)pVal, sizeof(uint16_t), desc);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      sortKeyPutUint(p, (uint32_t)(*(int32_t*)pVal) ^ 0x80000000u, sizeof(int32_t), desc);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      sortKeyPutUint(p, *(uint32_t*)pVal, sizeof(uint32_t), desc);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      sortKeyPutUint(p, (uint64_t)(*(int64_t*)pVal) ^ 0x8000000000000000ull, sizeof(int64_t), desc);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      sortKeyPutUint(p, *(uint64_t*)pVal, sizeof(uint64_t), desc);
+      break;
+    case TSDB_DATA_TYPE_FLOAT: {
+      // NaN is less than any other value, negative values have all bits flipped
+      float    v = GET_FLOAT_VAL(pVal);
+      uint32_t u = 0;
+      if (!isnan(v)) {
+        v = (v == 0) ? 0 : v;
+        memcpy(&u, &v, sizeof(u));
+        u = (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+      }
+      sortKeyPutUint(p, u, sizeof(float), desc);
+      break;
+    }
+    case TSDB_DATA_TYPE_DOUBLE: {
+      double   v = GET_DOUBLE_VAL(pVal);
+      uint64_t u = 0;
+      if (!isnan(v)) {
+        v = (v == 0) ? 0 : v;
+        memcpy(&u, &v, sizeof(u));
+        u = (u & 0x8000000000000000ull) ? ~u : (u | 0x8000000000000000ull);
+      }
+      sortKeyPutUint(p, u, sizeof(double), desc);
+      break;
+    }
+    case TSDB_DATA_TYPE_VARCHAR: {
+      // stop at the first '\0' to be consistent with strncmp, the remaining bytes are padded
+      const char* pStr = varDataVal(pVal);
+      int32_t     len = TMIN(varDataLen(pVal), SORT_KEY_VAR_PREFIX_LEN);
+      int32_t     i = 0;
+      for (; i < len && pStr[i] != 0; ++i) {
+        p[i] = desc ? ~pStr[i] : pStr[i];
+      }
+      memset(p + i, desc ? 0xFF : 0, SORT_KEY_VAR_PREFIX_LEN - i);
+
+      bool complete = (i == varDataLen(pVal));
+      sortKeyPutUint(p + SORT_KEY_VAR_PREFIX_LEN, complete ? i : SORT_KEY_VAR_TRUNCATED, 1, desc);
+      return complete;
+    }
+    default:
+      break;
+  }
+
+  return true;
+}
+
+int32_t blockDataGetSortKeyLen(const SSDataBlock* pBlock, const SArray* pOrderInfo, int32_t* numOfExact) {
+  int32_t keyLen = 0;
+  *numOfExact = 0;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+
+    bool    exact = false;
+    int32_t len = sortKeyColLen(pColInfoData->info.type, &exact);
+    if (len == 0) {
+      break;
+    }
+
+    if (exact && (*numOfExact) == i) {
+      (*numOfExact) += 1;
+    }
+
+    keyLen += len;
+  }
+
+  return keyLen;
+}
+
+int32_t blockDataEncodeSortKeys(const SSDataBlock* pBlock, const SArray* pOrderInfo, int32_t keyLen, char* pKeys,
+                                int32_t stride) {
+  int32_t  offset = 0;
+  uint8_t* pTruncated = NULL;  // rows whose key is cut off by a truncated binary value
+
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo) && offset < keyLen; ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+
+    bool    exact = false;
+    int8_t  type = pColInfoData->info.type;
+    int32_t len = sortKeyColLen(type, &exact);
+    bool    desc = (pOrder->order == TSDB_ORDER_DESC);
+    char    nullFlag = pOrder->nullFirst ? 0 : 1;
+
+    if (!exact && offset + len < keyLen && pTruncated == NULL) {
+      pTruncated = taosMemoryCalloc(pBlock->info.rows, sizeof(uint8_t));
+      if (pTruncated == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+      char* p = pKeys + (int64_t)j * stride + offset;
+      if (pTruncated != NULL && pTruncated[j]) {
+        continue;
+      }
+
+      if (pColInfoData->hasNull && colDataIsNull_s(pColInfoData, j)) {
+        p[0] = nullFlag;
+        memset(p + 1, 0, len - 1);
+      } else {
+        p[0] = nullFlag ^ 1;
+        if (!sortKeyEncodeVal(type, colDataGetData(pColInfoData, j), p + 1, desc)) {
+          memset(p + len, 0, keyLen - offset - len);
+          if (pTruncated != NULL) {
+            pTruncated[j] = 1;
+          }
+        }
+      }
+    }
+
+    offset += len;
+  }
+
+  taosMemoryFree(pTruncated);
+  return TSDB_CODE_SUCCESS;
+}
+
+// sort the normalized keys with the row index attached, and return the sorted row index
+static int32_t* blockDataSortByKey(SSDataBlock* pDataBlock, SSDataBlockSortHelper* pHelper) {
+  int32_t rows = pDataBlock->info.rows;
+  int32_t stride = pHelper->keyLen + sizeof(int32_t);
+
+  char*    pKeys = taosMemoryMalloc((int64_t)rows * stride);
+  int32_t* index = taosMemoryMalloc(rows * sizeof(int32_t));
+  if (pKeys == NULL || index == NULL) {
+    taosMemoryFree(pKeys);
+    taosMemoryFree(index);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  int32_t code = blockDataEncodeSortKeys(pDataBlock, pHelper->orderInfo, pHelper->keyLen, pKeys, stride);
+  if (code != TSDB_CODE_SUCCESS) {
+    taosMemoryFree(pKeys);
+    taosMemoryFree(index);
+    terrno = code;
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    memcpy(pKeys + (int64_t)i * stride + pHelper->keyLen, &i, sizeof(int32_t));
+  }
+
+  // integer, timestamp and floating point keys are fully ordered by the key bytes
+  code = TSDB_CODE_FAILED;
+  if (pHelper->numOfExact == taosArrayGetSize(pHelper->orderInfo) && rows >= SORT_KEY_RADIX_MIN_ROWS &&
+      pHelper->keyLen <= SORT_KEY_RADIX_MAX_LEN) {
+    code = taosRadixSort(pKeys, rows, stride, pHelper->keyLen);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    taosPdqSort(pKeys, rows, stride, pHelper, dataBlockKeyCompar);
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    memcpy(&index[i], pKeys + (int64_t)i * stride + pHelper->keyLen, sizeof(int32_t));
+  }
+
+  taosMemoryFree(pKeys);
+  return index;
+}
+
 static int32_t doAssignOneTuple(SColumnInfoData* pDstCols, int32_t numOfRows, const SSDataBlock* pSrcBlock,
                                 int32_t tupleIndex) {
   int32_t code = 0;
@@ -948,12 +1201,6 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
     }
   }
 
-  int32_t* index = createTupleIndex(rows);
-  if (index == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    return terrno;
-  }
-
   int64_t p0 = taosGetTimestampUs();
 
   SSDataBlockSortHelper helper = {.pDataBlock = pDataBlock, .orderInfo = pOrderInfo};
@@ -963,8 +1210,27 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   }
 
   terrno = 0;
-  taosqsort(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
-  if (terrno) return terrno;
+
+  int32_t* index = NULL;
+  helper.keyLen = blockDataGetSortKeyLen(pDataBlock, pOrderInfo, &helper.numOfExact);
+  if (helper.keyLen > 0) {
+    index = blockDataSortByKey(pDataBlock, &helper);
+  } else {
+    index = createTupleIndex(rows);
+    if (index != NULL) {
+      taosqsort(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
+    }
+  }
+
+  if (index == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return terrno;
+  }
+
+  if (terrno) {
+    destroyTupleIndex(index);
+    return terrno;
+  }
 
   int64_t p1 = taosGetTimestampUs();
 
@@ -992,6 +1258,22 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* pIndex) {
+  if (pDataBlock->info.rows <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColumnInfoData* pCols = createHelpColInfoData(pDataBlock);
+  if (pCols == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return terrno;
+  }
+
+  blockDataAssign(pCols, pDataBlock, pIndex);
+  copyBackToBlock(pDataBlock, pCols);
+  return TSDB_CODE_SUCCESS;
+}
+
 typedef struct SHelper {
   int32_t index;
   union {
@@ -2251,7 +2533,7 @@ int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
 
   // todo extract method
   int32_t* version = (int32_t*)data;
-  *version = 1;
+  *version = BLOCK_VERSION_1;
   data += sizeof(int32_t);
 
   int32_t* actualLen = (int32_t*)data;
@@ -2327,12 +2609,241 @@ int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
   return dataLen;
 }
 
+// per column flags of the compressed block
+#define BLOCK_CMPR_META     0x1  // offsets of the var type column are compressed by simple8b
+#define BLOCK_CMPR_DATA     0x2  // data are compressed by the codec of the column type
+#define BLOCK_CMPR_DATA_LZ4 0x4  // data are compressed by LZ4
+
+static bool blockUseTypeCodec(int8_t type) {
+  if (type <= TSDB_DATA_TYPE_NULL || type >= TSDB_DATA_TYPE_MAX || IS_VAR_DATA_TYPE(type)) {
+    return false;
+  }
+
+#ifdef TD_TSZ
+  // the result set must be transferred without any loss
+  if ((type == TSDB_DATA_TYPE_FLOAT && lossyFloat) || (type == TSDB_DATA_TYPE_DOUBLE && lossyDouble)) {
+    return false;
+  }
+#endif
+
+  return tDataTypes[type].compFunc != NULL;
+}
+
+static FORCE_INLINE int32_t blockGetColMetaSize(int8_t type, int32_t numOfRows) {
+  return IS_VAR_DATA_TYPE(type) ? numOfRows * sizeof(int32_t) : BitmapLen(numOfRows);
+}
+
+// | flag | meta length | data length | meta(offset or null bitmap) | data |
+static char* blockCompressCol(const SColumnInfoData* pColInfoData, int32_t numOfRows, char* data) {
+  int8_t   type = pColInfoData->info.type;
+  int8_t*  flag = (int8_t*)data;
+  int32_t* metaLen = (int32_t*)(data + sizeof(int8_t));
+  int32_t* dataLen = (int32_t*)(data + sizeof(int8_t) + sizeof(int32_t));
+  data += sizeof(int8_t) + sizeof(int32_t) * 2;
+
+  *flag = 0;
+  int32_t rawLen = blockGetColMetaSize(type, numOfRows);
+  if (IS_VAR_DATA_TYPE(type)) {
+    int32_t len = tsCompressInt(pColInfoData->varmeta.offset, rawLen, numOfRows, data, rawLen + COMP_OVERFLOW_BYTES,
+                                ONE_STAGE_COMP, NULL, 0);
+    if (len > 0 && len < rawLen) {
+      *flag |= BLOCK_CMPR_META;
+      *metaLen = len;
+    } else {
+      memcpy(data, pColInfoData->varmeta.offset, rawLen);
+      *metaLen = rawLen;
+    }
+  } else {
+    memcpy(data, pColInfoData->nullbitmap, rawLen);
+    *metaLen = rawLen;
+  }
+  data += *metaLen;
+
+  rawLen = colDataGetLength(pColInfoData, numOfRows);
+  *dataLen = rawLen;
+  if (rawLen > 0 && pColInfoData->pData != NULL) {
+    int32_t len = -1;
+    if (blockUseTypeCodec(type)) {
+      len = tDataTypes[type].compFunc(pColInfoData->pData, rawLen, numOfRows, data, rawLen + COMP_OVERFLOW_BYTES,
+                                      ONE_STAGE_COMP, NULL, 0);
+      if (len > 0 && len < rawLen) {
+        *flag |= BLOCK_CMPR_DATA;
+      }
+    }
+
+    // the type codec does not pay off, e.g. random float values, or there is none for the type
+    if (!(*flag & BLOCK_CMPR_DATA)) {
+      len = tsCompressString(pColInfoData->pData, rawLen, numOfRows, data, rawLen + COMP_OVERFLOW_BYTES,
+                             ONE_STAGE_COMP, NULL, 0);
+      if (len > 0 && len < rawLen) {
+        *flag |= BLOCK_CMPR_DATA_LZ4;
+      } else {
+        memcpy(data, pColInfoData->pData, rawLen);
+        len = rawLen;
+      }
+    }
+
+    *dataLen = len;
+  } else if (rawLen > 0) {
+    memset(data, 0, rawLen);
+  }
+
+  return data + *dataLen;
+}
+
+static const char* blockDecompressCol(const char* pStart, int8_t type, int32_t numOfRows, int32_t colLen, char* pMeta,
+                                      char* pData) {
+  int8_t  flag = *(int8_t*)pStart;
+  int32_t metaLen = *(int32_t*)(pStart + sizeof(int8_t));
+  int32_t dataLen = *(int32_t*)(pStart + sizeof(int8_t) + sizeof(int32_t));
+  pStart += sizeof(int8_t) + sizeof(int32_t) * 2;
+
+  int32_t rawLen = blockGetColMetaSize(type, numOfRows);
+  if (flag & BLOCK_CMPR_META) {
+    if (tsDecompressInt((void*)pStart, metaLen, numOfRows, pMeta, rawLen, ONE_STAGE_COMP, NULL, 0) != rawLen) {
+      goto _err;
+    }
+  } else {
+    if (metaLen != rawLen) {
+      goto _err;
+    }
+    memcpy(pMeta, pStart, rawLen);
+  }
+  pStart += metaLen;
+
+  if (flag & BLOCK_CMPR_DATA) {
+    if (type <= TSDB_DATA_TYPE_NULL || type >= TSDB_DATA_TYPE_MAX || tDataTypes[type].decompFunc == NULL) {
+      goto _err;
+    }
+    if (tDataTypes[type].decompFunc((void*)pStart, dataLen, numOfRows, pData, colLen, ONE_STAGE_COMP, NULL, 0) !=
+        colLen) {
+      goto _err;
+    }
+  } else if (flag & BLOCK_CMPR_DATA_LZ4) {
+    if (tsDecompressString((void*)pStart, dataLen, numOfRows, pData, colLen, ONE_STAGE_COMP, NULL, 0) != colLen) {
+      goto _err;
+    }
+  } else {
+    if (dataLen != colLen) {
+      goto _err;
+    }
+    if (colLen > 0) {
+      memcpy(pData, pStart, colLen);
+    }
+  }
+
+  return pStart + dataLen;
+
+_err:
+  uError("failed to decompress column, type:%d, rows:%d, flag:%d, meta len:%d, data len:%d", type, numOfRows, flag,
+         metaLen, dataLen);
+  terrno = TSDB_CODE_INVALID_MSG;
+  return NULL;
+}
+
+int32_t blockCompressEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
+  char*   pStart = data;
+  int32_t numOfRows = pBlock->info.rows;
+  ASSERT(numOfRows > 0);
+
+  *(int32_t*)data = BLOCK_VERSION_COMPRESSED;
+  data += sizeof(int32_t);
+
+  int32_t* actualLen = (int32_t*)data;
+  data += sizeof(int32_t);
+
+  *(int32_t*)data = numOfRows;
+  data += sizeof(int32_t);
+
+  *(int32_t*)data = numOfCols;
+  data += sizeof(int32_t);
+
+  *(int32_t*)data = (1 << 31);
+  data += sizeof(int32_t);
+
+  *(uint64_t*)data = pBlock->info.id.groupId;
+  data += sizeof(uint64_t);
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
+
+    *((int8_t*)data) = pColInfoData->info.type;
+    data += sizeof(int8_t);
+
+    *((int32_t*)data) = pColInfoData->info.bytes;
+    data += sizeof(int32_t);
+  }
+
+  // the original column lengths, so the reader is able to restore the version 1 layout
+  int32_t* colSizes = (int32_t*)data;
+  data += numOfCols * sizeof(int32_t);
+
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, col);
+    colSizes[col] = htonl(colDataGetLength(pColInfoData, numOfRows));
+    data = blockCompressCol(pColInfoData, numOfRows, data);
+  }
+
+  *actualLen = (int32_t)(data - pStart);
+
+  uDebug("build compressed data block, actualLen:%d, rows:%d, cols:%d", *actualLen, numOfRows, numOfCols);
+  return *actualLen;
+}
+
+int32_t blockGetDecompressSize(const char* pData) {
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+
+  const char* pSchema = pData + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  const char* pColLen = pSchema + numOfCols * (sizeof(int8_t) + sizeof(int32_t));
+
+  int32_t len = blockDataGetSerialMetaSize(numOfCols);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    len += blockGetColMetaSize(type, numOfRows) + htonl(((int32_t*)pColLen)[i]);
+  }
+
+  return len;
+}
+
+int32_t blockDecompress(const char* pData, char* pOut) {
+  ASSERT(*(int32_t*)pData == BLOCK_VERSION_COMPRESSED);
+
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+
+  // the header is the same as the one of version 1, except the version and the length
+  memcpy(pOut, pData, metaSize);
+  *(int32_t*)pOut = BLOCK_VERSION_1;
+
+  const char* pSchema = pData + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  const int32_t* colLen = (const int32_t*)(pSchema + numOfCols * (sizeof(int8_t) + sizeof(int32_t)));
+
+  const char* pStart = pData + metaSize;
+  char*       p = pOut + metaSize;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t len = htonl(colLen[i]);
+    int32_t rawMetaLen = blockGetColMetaSize(type, numOfRows);
+
+    pStart = blockDecompressCol(pStart, type, numOfRows, len, p, p + rawMetaLen);
+    if (pStart == NULL) {
+      return -1;
+    }
+    p += rawMetaLen + len;
+  }
+
+  *(int32_t*)(pOut + sizeof(int32_t)) = (int32_t)(p - pOut);
+  return (int32_t)(p - pOut);
+}
+
 const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   const char* pStart = pData;
 
   int32_t version = *(int32_t*)pStart;
   pStart += sizeof(int32_t);
-  ASSERT(version == 1);
+  ASSERT(version == BLOCK_VERSION_1 || version == BLOCK_VERSION_COMPRESSED);
 
   // total length sizeof(int32_t)
   int32_t dataLen = *(int32_t*)pStart;
@@ -2383,12 +2894,15 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
 
     SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
     if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
-      memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
-      pStart += sizeof(int32_t) * numOfRows;
+      if (version == BLOCK_VERSION_1) {
+        memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
+        pStart += sizeof(int32_t) * numOfRows;
+      }
 
       if (colLen[i] > 0 && pColInfoData->varmeta.allocLen < colLen[i]) {
         char* tmp = taosMemoryRealloc(pColInfoData->pData, colLen[i]);
         if (tmp == NULL) {
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
           return NULL;
         }
 
@@ -2397,20 +2911,29 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
       }
 
       pColInfoData->varmeta.length = colLen[i];
-    } else {
+    } else if (version == BLOCK_VERSION_1) {
       memcpy(pColInfoData->nullbitmap, pStart, BitmapLen(numOfRows));
       pStart += BitmapLen(numOfRows);
     }
 
-    if (colLen[i] > 0) {
-      memcpy(pColInfoData->pData, pStart, colLen[i]);
+    if (version == BLOCK_VERSION_COMPRESSED) {
+      char* pMeta = IS_VAR_DATA_TYPE(pColInfoData->info.type) ? (char*)pColInfoData->varmeta.offset
+                                                              : pColInfoData->nullbitmap;
+      pStart = blockDecompressCol(pStart, pColInfoData->info.type, numOfRows, colLen[i], pMeta, pColInfoData->pData);
+      if (pStart == NULL) {
+        return NULL;
+      }
+    } else {
+      if (colLen[i] > 0) {
+        memcpy(pColInfoData->pData, pStart, colLen[i]);
+      }
+      pStart += colLen[i];
     }
 
     // TODO
     // setting this flag to true temporarily so aggregate function on stable will
     // examine NULL value for non-primary key column
     pColInfoData->hasNull = true;
-    pStart += colLen[i];
   }
 
   pBlock->info.dataLoad = 1;
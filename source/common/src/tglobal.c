@@ -18,7 +18,9 @@
 #include "tconfig.h"
 #include "tgrant.h"
 #include "tlog.h"
+#include "tmemaccount.h"
 #include "tmisce.h"
+#include "tpagedbuf.h"
 
 GRANT_CFG_DECLARE;
 
@@ -43,6 +45,7 @@ bool    tsPrintAuth = false;
 int32_t tsNumOfRpcThreads = 1;
 int32_t tsNumOfRpcSessions = 2000;
 int32_t tsNumOfCommitThreads = 2;
+int32_t tsNumOfCompactThreads = 1;  // threads running tsdb compaction, shared by all vnodes
 int32_t tsNumOfTaskQueueThreads = 4;
 int32_t tsNumOfMnodeQueryThreads = 4;
 int32_t tsNumOfMnodeFetchThreads = 1;
@@ -62,6 +65,12 @@ int32_t tsHeartbeatTimeout = 20 * 1000;
 
 // vnode
 int64_t tsVndCommitMaxIntervalMs = 60 * 1000;
+int32_t tsTsdbPageCacheSize = 16;  // verified tsdb file pages cached per vnode (in MB), 0 to disable
+int32_t tsTsdbReadaheadBlocks = 4;  // data blocks read ahead of the current one by a query, 0 to disable
+int32_t tsTsdbCompactSttTrigger = 2;  // stt files in a file set that make it a compaction candidate, 0 to disable
+int32_t tsTsdbCompactMaxSpeed = 64;   // write rate of background compaction (in MB/s), 0 for no limit
+int32_t tsTsdbCommitThreads = 2;     // threads a single vnode commit fans its file sets out to
+bool    tsTsdbBlockBloomFilter = false;  // write bloom filters of the integer and string columns of data blocks
 
 // monitor
 bool     tsEnableMonitor = true;
@@ -95,7 +104,9 @@ int32_t tsQueryPolicy = 1;
 int32_t tsQueryRspPolicy = 0;
 bool    tsEnableQueryHb = false;
 int32_t tsQuerySmaOptimize = 0;
+int32_t tsQueryScanParallelism = 1;  // number of tasks a super table scan is split into on each vnode
 int32_t tsQueryRsmaTolerance = 1000;  // the tolerance time (ms) to judge from which level to query rsma data.
+int32_t tsQueryHashJoinBufSize = 64;  // build side kept in memory by a hash join (in MB) before it spills to disk
 bool    tsQueryPlannerTrace = false;
 int32_t tsQueryNodeChunkSize = 32 * 1024;
 bool    tsQueryUseNodeAllocator = true;
@@ -149,6 +160,15 @@ char    tsTagFilterCache = 0;
 int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
 
+// the maximum allowed query buffer size of each query task on a data node, in MB, -1 no limit (default).
+// A task over the limit spills its buffer pages to disk, and fails only when there is nothing left to spill.
+int32_t tsQueryMemoryLimit = -1;
+
+// the defaults of the paged buffers of query tasks: the pages spilled to disk are written and read ahead by the
+// background I/O threads, and compressed before written.
+bool tsQueryBufAsyncIo = true;
+bool tsQueryBufCompress = true;
+
 int32_t  tsDiskCfgNum = 0;
 SDiskCfg tsDiskCfg[TFS_MAX_DISKS] = {0};
 
@@ -178,6 +198,8 @@ bool tsStartUdfd = true;
 
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
+int32_t tsWalGroupCommitSize = 0;    // bytes of log entries gathered before one write (in KB), 0 to disable
+int32_t tsWalGroupCommitDelay = 10;  // max time a log entry waits in a group commit batch (in ms)
 
 // internal
 int32_t tsTransPullupInterval = 2;
@@ -313,6 +335,7 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryPolicy", tsQueryPolicy, 1, 4, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "enableQueryHb", tsEnableQueryHb, false) != 0) return -1;
   if (cfgAddInt32(pCfg, "querySmaOptimize", tsQuerySmaOptimize, 0, 1, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryScanParallelism", tsQueryScanParallelism, 1, 64, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "queryPlannerTrace", tsQueryPlannerTrace, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryNodeChunkSize", tsQueryNodeChunkSize, 1024, 128 * 1024, true) != 0) return -1;
   if (cfgAddBool(pCfg, "queryUseNodeAllocator", tsQueryUseNodeAllocator, true) != 0) return -1;
@@ -385,6 +408,9 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "maxNumOfDistinctRes", tsMaxNumOfDistinctResults, 10 * 10000, 10000 * 10000, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "countAlwaysReturnValue", tsCountAlwaysReturnValue, 0, 1, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryMemoryLimit", tsQueryMemoryLimit, -1, INT32_MAX, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "queryBufAsyncIo", tsQueryBufAsyncIo, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "queryBufCompress", tsQueryBufCompress, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, 0) != 0) return -1;
 
@@ -398,6 +424,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfCommitThreads = tsNumOfCores / 2;
   tsNumOfCommitThreads = TRANGE(tsNumOfCommitThreads, 2, 4);
   if (cfgAddInt32(pCfg, "numOfCommitThreads", tsNumOfCommitThreads, 1, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "numOfCompactThreads", tsNumOfCompactThreads, 1, 1024, 0) != 0) return -1;
 
   tsNumOfMnodeReadThreads = tsNumOfCores / 8;
   tsNumOfMnodeReadThreads = TRANGE(tsNumOfMnodeReadThreads, 1, 4);
@@ -443,6 +470,12 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "syncHeartbeatTimeout", tsHeartbeatTimeout, 10, 1000 * 60 * 24 * 2, 0) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "vndCommitMaxInterval", tsVndCommitMaxIntervalMs, 1000, 1000 * 60 * 60, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbPageCacheSize", tsTsdbPageCacheSize, 0, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbReadaheadBlocks", tsTsdbReadaheadBlocks, 0, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbCompactSttTrigger", tsTsdbCompactSttTrigger, 0, 16, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbCompactMaxSpeed", tsTsdbCompactMaxSpeed, 0, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbCommitThreads", tsTsdbCommitThreads, 1, 16, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "tsdbBlockBloomFilter", tsTsdbBlockBloomFilter, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "monitor", tsEnableMonitor, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "monitorInterval", tsMonitorInterval, 1, 200000, 0) != 0) return -1;
@@ -463,9 +496,12 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "ttlPushInterval", tsTtlPushInterval, 1, 100000, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "uptimeInterval", tsUptimeInterval, 1, 100000, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRsmaTolerance", tsQueryRsmaTolerance, 0, 900000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryHashJoinBufSize", tsQueryHashJoinBufSize, 1, 65536, 0) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX, 0) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitSize", tsWalGroupCommitSize, 0, 256 * 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitDelay", tsWalGroupCommitDelay, 1, 1000, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, 0) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, 0) != 0) return -1;
@@ -688,6 +724,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryPolicy = cfgGetItem(pCfg, "queryPolicy")->i32;
   tsEnableQueryHb = cfgGetItem(pCfg, "enableQueryHb")->bval;
   tsQuerySmaOptimize = cfgGetItem(pCfg, "querySmaOptimize")->i32;
+  tsQueryScanParallelism = cfgGetItem(pCfg, "queryScanParallelism")->i32;
   tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
   tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
   tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
@@ -729,11 +766,15 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMaxNumOfDistinctResults = cfgGetItem(pCfg, "maxNumOfDistinctRes")->i32;
   tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
   tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
+  tsQueryMemoryLimit = cfgGetItem(pCfg, "queryMemoryLimit")->i32;
+  tsQueryBufAsyncIo = cfgGetItem(pCfg, "queryBufAsyncIo")->bval;
+  tsQueryBufCompress = cfgGetItem(pCfg, "queryBufCompress")->bval;
   tsPrintAuth = cfgGetItem(pCfg, "printAuth")->bval;
 
   tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
   tsNumOfRpcSessions = cfgGetItem(pCfg, "numOfRpcSessions")->i32;
   tsNumOfCommitThreads = cfgGetItem(pCfg, "numOfCommitThreads")->i32;
+  tsNumOfCompactThreads = cfgGetItem(pCfg, "numOfCompactThreads")->i32;
   tsNumOfMnodeReadThreads = cfgGetItem(pCfg, "numOfMnodeReadThreads")->i32;
   tsNumOfVnodeQueryThreads = cfgGetItem(pCfg, "numOfVnodeQueryThreads")->i32;
   tsRatioOfVnodeStreamThreads = cfgGetItem(pCfg, "ratioOfVnodeStreamThreads")->fval;
@@ -768,14 +809,23 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsTtlPushInterval = cfgGetItem(pCfg, "ttlPushInterval")->i32;
   tsUptimeInterval = cfgGetItem(pCfg, "uptimeInterval")->i32;
   tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
+  tsQueryHashJoinBufSize = cfgGetItem(pCfg, "queryHashJoinBufSize")->i32;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsWalGroupCommitSize = cfgGetItem(pCfg, "walGroupCommitSize")->i32;
+  tsWalGroupCommitDelay = cfgGetItem(pCfg, "walGroupCommitDelay")->i32;
 
   tsElectInterval = cfgGetItem(pCfg, "syncElectInterval")->i32;
   tsHeartbeatInterval = cfgGetItem(pCfg, "syncHeartbeatInterval")->i32;
   tsHeartbeatTimeout = cfgGetItem(pCfg, "syncHeartbeatTimeout")->i32;
 
   tsVndCommitMaxIntervalMs = cfgGetItem(pCfg, "vndCommitMaxInterval")->i64;
+  tsTsdbPageCacheSize = cfgGetItem(pCfg, "tsdbPageCacheSize")->i32;
+  tsTsdbReadaheadBlocks = cfgGetItem(pCfg, "tsdbReadaheadBlocks")->i32;
+  tsTsdbCompactSttTrigger = cfgGetItem(pCfg, "tsdbCompactSttTrigger")->i32;
+  tsTsdbCompactMaxSpeed = cfgGetItem(pCfg, "tsdbCompactMaxSpeed")->i32;
+  tsTsdbCommitThreads = cfgGetItem(pCfg, "tsdbCommitThreads")->i32;
+  tsTsdbBlockBloomFilter = cfgGetItem(pCfg, "tsdbBlockBloomFilter")->bval;
 
   tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
   tstrncpy(tsUdfdResFuncs, cfgGetItem(pCfg, "udfdResFuncs")->str, sizeof(tsUdfdResFuncs));
@@ -783,6 +833,8 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   if (tsQueryBufferSize >= 0) {
     tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
   }
+  taosMemAccountSetLimit(taosMemAccountGetNode(), tsQueryBufferSizeBytes);
+  dBufSetDefaultOptions(tsQueryBufAsyncIo, tsQueryBufCompress);
 
   tsDisableStream = cfgGetItem(pCfg, "disableStream")->bval;
 
@@ -1032,11 +1084,20 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsQueryPolicy = cfgGetItem(pCfg, "queryPolicy")->i32;
       } else if (strcasecmp("querySmaOptimize", name) == 0) {
         tsQuerySmaOptimize = cfgGetItem(pCfg, "querySmaOptimize")->i32;
+      } else if (strcasecmp("queryScanParallelism", name) == 0) {
+        tsQueryScanParallelism = cfgGetItem(pCfg, "queryScanParallelism")->i32;
       } else if (strcasecmp("queryBufferSize", name) == 0) {
         tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
-        if (tsQueryBufferSize >= 0) {
-          tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
-        }
+        tsQueryBufferSizeBytes = (tsQueryBufferSize >= 0) ? tsQueryBufferSize * 1048576UL : -1;
+        taosMemAccountSetLimit(taosMemAccountGetNode(), tsQueryBufferSizeBytes);
+      } else if (strcasecmp("queryMemoryLimit", name) == 0) {
+        tsQueryMemoryLimit = cfgGetItem(pCfg, "queryMemoryLimit")->i32;
+      } else if (strcasecmp("queryBufAsyncIo", name) == 0) {
+        tsQueryBufAsyncIo = cfgGetItem(pCfg, "queryBufAsyncIo")->bval;
+        dBufSetDefaultOptions(tsQueryBufAsyncIo, tsQueryBufCompress);
+      } else if (strcasecmp("queryBufCompress", name) == 0) {
+        tsQueryBufCompress = cfgGetItem(pCfg, "queryBufCompress")->bval;
+        dBufSetDefaultOptions(tsQueryBufAsyncIo, tsQueryBufCompress);
       } else if (strcasecmp("qDebugFlag", name) == 0) {
         qDebugFlag = cfgGetItem(pCfg, "qDebugFlag")->i32;
       } else if (strcasecmp("queryPlannerTrace", name) == 0) {
@@ -1034,6 +1034,11 @@ int32_t tSerializeSStatusReq(void *buf, int32_t bufLen, SStatusReq *pReq) {
   if (tEncodeI64(&encoder, pReq->qload.timeInFetchQueue) < 0) return -1;
 
   if (tEncodeI32(&encoder, pReq->statusSeq) < 0) return -1;
+
+  if (tEncodeI64(&encoder, pReq->qmemLoad.used) < 0) return -1;
+  if (tEncodeI64(&encoder, pReq->qmemLoad.peak) < 0) return -1;
+  if (tEncodeI64(&encoder, pReq->qmemLoad.limit) < 0) return -1;
+  if (tEncodeI64(&encoder, pReq->qmemLoad.numOfRejects) < 0) return -1;
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -1115,6 +1120,11 @@ int32_t tDeserializeSStatusReq(void *buf, int32_t bufLen, SStatusReq *pReq) {
   if (tDecodeI64(&decoder, &pReq->qload.timeInFetchQueue) < 0) return -1;
 
   if (tDecodeI32(&decoder, &pReq->statusSeq) < 0) return -1;
+
+  if (tDecodeI64(&decoder, &pReq->qmemLoad.used) < 0) return -1;
+  if (tDecodeI64(&decoder, &pReq->qmemLoad.peak) < 0) return -1;
+  if (tDecodeI64(&decoder, &pReq->qmemLoad.limit) < 0) return -1;
+  if (tDecodeI64(&decoder, &pReq->qmemLoad.numOfRejects) < 0) return -1;
   tEndDecode(&decoder);
   tDecoderClear(&decoder);
   return 0;
@@ -260,4 +260,230 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, dataBlock_reorder_test) {
+  int32_t numOfRows = 1000;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char buf1[100] = {0};
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    colDataAppend(p0, i, (const char*)&i, i % 7 == 0);
+
+    sprintf(buf, "row:%d", i);
+    STR_TO_VARSTR(buf1, buf)
+    colDataAppend(p1, i, buf1, i % 5 == 0);
+    b->info.rows++;
+  }
+
+  // odd rows first, then even rows
+  int32_t* index = (int32_t*)taosMemoryCalloc(numOfRows, sizeof(int32_t));
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    index[i] = (i < numOfRows / 2) ? (i * 2 + 1) : ((i - numOfRows / 2) * 2);
+  }
+
+  ASSERT_EQ(blockDataReorder(b, index), 0);
+
+  p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t src = index[i];
+    ASSERT_EQ(colDataIsNull_s(p0, i), src % 7 == 0);
+    if (src % 7 != 0) {
+      ASSERT_EQ(*(int32_t*)colDataGetData(p0, i), src);
+    }
+
+    ASSERT_EQ(colDataIsNull_s(p1, i), src % 5 == 0);
+    if (src % 5 != 0) {
+      sprintf(buf, "row:%d", src);
+      char* p = colDataGetData(p1, i);
+      ASSERT_EQ(varDataLen(p), strlen(buf));
+      ASSERT_EQ(strncmp(varDataVal(p), buf, varDataLen(p)), 0);
+    }
+  }
+
+  taosMemoryFree(index);
+  blockDataDestroy(b);
+}
+
+TEST(testCase, dataBlock_compress_encode_test) {
+  int32_t numOfRows = 4096;
+  int8_t  types[] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_BOOL,
+                     TSDB_DATA_TYPE_BINARY};
+  int32_t bytes[] = {8, 4, 8, 1, 40};
+  int32_t numOfCols = sizeof(types) / sizeof(types[0]);
+
+  SSDataBlock* b = createDataBlock();
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData infoData = createColumnInfoData(types[i], bytes[i], i + 1);
+    blockDataAppendColInfo(b, &infoData);
+  }
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char buf1[100] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t ts = 1650803518000 + i * 1000;
+    int32_t v = i / 10;
+    double  d = i * 0.5;
+    int8_t  bv = i % 2;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&ts, false);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, (const char*)&v, i % 7 == 0);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&d, i % 11 == 0);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 3), i, (const char*)&bv, i % 13 == 0);
+
+    sprintf(buf, "device:%d", i % 16);
+    STR_TO_VARSTR(buf1, buf)
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 4), i, buf1, i % 5 == 0);
+    b->info.rows++;
+  }
+
+  char*   raw = (char*)taosMemoryCalloc(1, blockGetEncodeSize(b));
+  char*   cmpr = (char*)taosMemoryCalloc(1, blockGetCompressEncodeSize(b));
+  int32_t rawLen = blockEncode(b, raw, numOfCols);
+  int32_t cmprLen = blockCompressEncode(b, cmpr, numOfCols);
+  ASSERT_LT(cmprLen, rawLen);
+
+  // restore to the version 1 layout for the client
+  ASSERT_EQ(blockGetDecompressSize(cmpr), rawLen);
+  char* restored = (char*)taosMemoryCalloc(1, rawLen);
+  ASSERT_EQ(blockDecompress(cmpr, restored), rawLen);
+  ASSERT_EQ(memcmp(raw, restored, rawLen), 0);
+
+  // decode into a block for the exchange operator
+  SSDataBlock* pBlock = createOneDataBlock(b, false);
+  ASSERT_EQ(blockDecode(pBlock, cmpr), cmpr + cmprLen);
+  ASSERT_EQ(pBlock->info.rows, numOfRows);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, i);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, i);
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      ASSERT_EQ(colDataIsNull_s(p0, j), colDataIsNull_s(p1, j));
+      if (colDataIsNull_s(p0, j)) {
+        continue;
+      }
+
+      char* v0 = colDataGetData(p0, j);
+      char* v1 = colDataGetData(p1, j);
+      int32_t len = IS_VAR_DATA_TYPE(types[i]) ? varDataTLen(v0) : bytes[i];
+      ASSERT_EQ(memcmp(v0, v1, len), 0);
+    }
+  }
+
+  // a corrupted column is reported instead of decoded, the meta length of the first column is off by one
+  cmprLen = blockCompressEncode(b, cmpr, numOfCols);
+  int32_t  headLen = sizeof(int32_t) * 5 + sizeof(uint64_t) + (sizeof(int8_t) + sizeof(int32_t) * 2) * numOfCols;
+  int32_t* metaLen = (int32_t*)(cmpr + headLen + sizeof(int8_t));
+  *metaLen += 1;
+  terrno = 0;
+  ASSERT_EQ(blockDecode(pBlock, cmpr), nullptr);
+  ASSERT_EQ(terrno, TSDB_CODE_INVALID_MSG);
+
+  taosMemoryFree(raw);
+  taosMemoryFree(cmpr);
+  taosMemoryFree(restored);
+  blockDataDestroy(pBlock);
+  blockDataDestroy(b);
+}
+
+TEST(testCase, dataBlock_multi_column_sort_test) {
+  int32_t numOfRows = 5000;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  SColumnInfoData infoData2 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 3);
+  blockDataAppendColInfo(b, &infoData2);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char buf1[100] = {0};
+
+  // the device names share a prefix longer than the one kept in the sort key
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t k = (i * 7919) % numOfRows;
+    sprintf(buf, (k % 3 == 0) ? "dev:%d" : "a_long_device_name_prefix:%d", k % 17);
+    STR_TO_VARSTR(buf1, buf)
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, buf1, k % 23 == 0);
+
+    int64_t ts = 1650803518000 + (k % 101) * 1000;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, (const char*)&ts, k % 29 == 0);
+
+    double d = (k % 2 == 0) ? -k * 0.25 : k * 0.25;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&d, false);
+    b->info.rows++;
+  }
+
+  int32_t order[] = {TSDB_ORDER_ASC, TSDB_ORDER_DESC, TSDB_ORDER_ASC};
+  bool    nullFirst[] = {true, false, true};
+
+  SArray* pOrderInfo = taosArrayInit(3, sizeof(SBlockOrderInfo));
+  for (int32_t i = 0; i < 3; ++i) {
+    SBlockOrderInfo oi = {0};
+    oi.order = order[i];
+    oi.nullFirst = nullFirst[i];
+    oi.slotId = i;
+    taosArrayPush(pOrderInfo, &oi);
+  }
+
+  int32_t numOfExact = 0;
+  ASSERT_GT(blockDataGetSortKeyLen(b, pOrderInfo, &numOfExact), 0);
+  ASSERT_EQ(numOfExact, 0);
+
+  ASSERT_EQ(blockDataSort(b, pOrderInfo), 0);
+  ASSERT_EQ(b->info.rows, numOfRows);
+
+  // compare each pair of adjacent rows column by column
+  for (int32_t i = 1; i < numOfRows; ++i) {
+    int32_t ret = 0;
+    for (int32_t j = 0; j < 3 && ret == 0; ++j) {
+      SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(b->pDataBlock, j);
+      bool             prevNull = colDataIsNull_s(pCol, i - 1);
+      bool             curNull = colDataIsNull_s(pCol, i);
+      if (prevNull || curNull) {
+        ret = (prevNull == curNull) ? 0 : ((prevNull == nullFirst[j]) ? -1 : 1);
+        continue;
+      }
+
+      char* p0 = colDataGetData(pCol, i - 1);
+      char* p1 = colDataGetData(pCol, i);
+      if (j == 0) {
+        int32_t len = TMIN(varDataLen(p0), varDataLen(p1));
+        ret = strncmp(varDataVal(p0), varDataVal(p1), len);
+        if (ret == 0) {
+          ret = varDataLen(p0) - varDataLen(p1);
+        }
+      } else if (j == 1) {
+        ret = (*(int64_t*)p0 == *(int64_t*)p1) ? 0 : (*(int64_t*)p0 < *(int64_t*)p1 ? -1 : 1);
+      } else {
+        ret = (*(double*)p0 == *(double*)p1) ? 0 : (*(double*)p0 < *(double*)p1 ? -1 : 1);
+      }
+
+      ret = (order[j] == TSDB_ORDER_ASC) ? ret : -ret;
+    }
+
+    ASSERT_LE(ret, 0);
+  }
+
+  taosArrayDestroy(pOrderInfo);
+  blockDataDestroy(b);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
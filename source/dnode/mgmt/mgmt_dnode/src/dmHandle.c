@@ -17,6 +17,7 @@
 #include "dmInt.h"
 #include "systable.h"
 #include "tgrant.h"
+#include "tmemaccount.h"
 
 extern SConfig *tsCfg;
 
@@ -97,6 +98,13 @@ void dmSendStatusReq(SDnodeMgmt *pMgmt) {
 
   (*pMgmt->getQnodeLoadsFp)(&req.qload);
 
+  SMemAccountStat memStat = {0};
+  taosMemAccountGetStat(taosMemAccountGetNode(), &memStat);
+  req.qmemLoad.used = memStat.used;
+  req.qmemLoad.peak = memStat.peak;
+  req.qmemLoad.limit = memStat.limit;
+  req.qmemLoad.numOfRejects = memStat.numOfRejects;
+
   pMgmt->statusSeq++;
   req.statusSeq = pMgmt->statusSeq;
 
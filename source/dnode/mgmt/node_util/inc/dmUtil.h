@@ -26,6 +26,7 @@
 #include "tlog.h"
 #include "tmsg.h"
 #include "tmsgcb.h"
+#include "tpagedbuf.h"
 #include "tqueue.h"
 #include "trpc.h"
 #include "tthread.h"
@@ -186,23 +186,24 @@ typedef struct {
 } SClusterObj;
 
 typedef struct {
-  int32_t    id;
-  int64_t    createdTime;
-  int64_t    updateTime;
-  int64_t    rebootTime;
-  int64_t    lastAccessTime;
-  int32_t    accessTimes;
-  int32_t    numOfVnodes;
-  int32_t    numOfOtherNodes;
-  int32_t    numOfSupportVnodes;
-  float      numOfCores;
-  int64_t    memTotal;
-  int64_t    memAvail;
-  int64_t    memUsed;
-  EDndReason offlineReason;
-  uint16_t   port;
-  char       fqdn[TSDB_FQDN_LEN];
-  char       ep[TSDB_EP_LEN];
+  int32_t       id;
+  int64_t       createdTime;
+  int64_t       updateTime;
+  int64_t       rebootTime;
+  int64_t       lastAccessTime;
+  int32_t       accessTimes;
+  int32_t       numOfVnodes;
+  int32_t       numOfOtherNodes;
+  int32_t       numOfSupportVnodes;
+  float         numOfCores;
+  int64_t       memTotal;
+  int64_t       memAvail;
+  int64_t       memUsed;
+  SQueryMemLoad qmemLoad;
+  EDndReason    offlineReason;
+  uint16_t      port;
+  char          fqdn[TSDB_FQDN_LEN];
+  char          ep[TSDB_EP_LEN];
 } SDnodeObj;
 
 typedef struct {
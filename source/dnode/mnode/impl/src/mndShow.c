@@ -110,6 +110,8 @@ static int32_t convertToRetrieveType(char *name, int32_t len) {
     type = TSDB_MGMT_TABLE_STREAM_TASKS;
   } else if (strncasecmp(name, TSDB_INS_TABLE_USER_PRIVILEGES, len) == 0) {
     type = TSDB_MGMT_TABLE_PRIVILEGES;
+  } else if (strncasecmp(name, TSDB_PERFS_TABLE_QUERY_MEMORY, len) == 0) {
+    type = TSDB_MGMT_TABLE_QUERY_MEMORY;
   } else {
     mError("invalid show name:%s len:%d", name, len);
   }
@@ -47,7 +47,7 @@ typedef struct SVSnapWriter SVSnapWriter;
 
 extern const SVnodeCfg vnodeCfgDefault;
 
-int32_t vnodeInit(int32_t nthreads);
+int32_t vnodeInit(int32_t nthreads, int32_t nCompactThreads, int32_t nFSetThreads);
 void    vnodeCleanup();
 int32_t vnodeCreate(const char *path, SVnodeCfg *pCfg, STfs *pTfs);
 int32_t vnodeAlter(const char *path, SAlterVnodeReplicaReq *pReq, STfs *pTfs);
@@ -180,6 +180,9 @@ void         tsdbReaderClose(STsdbReader *pReader);
 bool         tsdbNextDataBlock(STsdbReader *pReader);
 int32_t      tsdbRetrieveDatablockSMA(STsdbReader *pReader, SSDataBlock *pDataBlock, bool *allHave);
 SSDataBlock *tsdbRetrieveDataBlock(STsdbReader *pTsdbReadHandle, SArray *pColumnIdList);
+bool         tsdbIsDataBlockPartial(STsdbReader *pReader);
+int32_t      tsdbRetrieveDataBlockRest(STsdbReader *pReader, const int8_t *pSelect);
+bool         tsdbDataBlockMayContain(STsdbReader *pReader, int16_t colId, int8_t type, const void *pVal);
 int32_t      tsdbReaderReset(STsdbReader *pReader, SQueryTableDataCond *pCond);
 int32_t      tsdbGetFileBlocksDistInfo(STsdbReader *pReader, STableBlockDistInfo *pTableBlockInfo);
 int64_t      tsdbGetNumOfRowsInMemTable(STsdbReader *pHandle);
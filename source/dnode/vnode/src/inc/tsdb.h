@@ -62,6 +62,7 @@ typedef struct SRowMerger       SRowMerger;
 typedef struct STsdbReadSnap    STsdbReadSnap;
 typedef struct SBlockInfo       SBlockInfo;
 typedef struct SSmaInfo         SSmaInfo;
+typedef struct SBlockBloomFilter SBlockBloomFilter;
 typedef struct SBlockCol        SBlockCol;
 typedef struct SVersionRange    SVersionRange;
 typedef struct SLDataIter       SLDataIter;
@@ -69,10 +70,13 @@ typedef struct SDiskCol         SDiskCol;
 typedef struct SDiskData        SDiskData;
 typedef struct SDiskDataBuilder SDiskDataBuilder;
 typedef struct SBlkInfo         SBlkInfo;
+typedef struct STsdbDataIter2   STsdbDataIter2;
+typedef struct STsdbFilterInfo  STsdbFilterInfo;
 
-#define TSDB_FILE_DLMT     ((uint32_t)0xF00AFA0F)
-#define TSDB_MAX_SUBBLOCKS 8
-#define TSDB_FHDR_SIZE     512
+#define TSDB_FILE_DLMT      ((uint32_t)0xF00AFA0F)
+#define TSDB_MAX_SUBBLOCKS  8
+#define TSDB_FHDR_SIZE      512
+#define TSDB_READ_MAX_PAGES 64
 
 #define VERSION_MIN 0
 #define VERSION_MAX INT64_MAX
@@ -273,7 +277,13 @@ int32_t tsdbReadBlockIdx(SDataFReader *pReader, SArray *aBlockIdx);
 int32_t tsdbReadDataBlk(SDataFReader *pReader, SBlockIdx *pBlockIdx, SMapData *mDataBlk);
 int32_t tsdbReadSttBlk(SDataFReader *pReader, int32_t iStt, SArray *aSttBlk);
 int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pBlock, SArray *aColumnDataAgg);
+int32_t tsdbReadBlockBloomFilter(SDataFReader *pReader, SDataBlk *pBlock, SArray *aBloomFilter);
+void    tsdbClearBlockBloomFilter(SArray *aBloomFilter);
+bool    tsdbBlockBloomFilterNoContain(const SBlockBloomFilter *pBloom, const void *pVal);
 int32_t tsdbReadDataBlock(SDataFReader *pReader, SDataBlk *pBlock, SBlockData *pBlockData);
+int32_t tsdbReadDataBlockCols(SDataFReader *pReader, SDataBlk *pBlock, SBlockData *pBlockData);
+int64_t tsdbPrefetchDataBlock(SDataFReader *pReader, SDataBlk *pBlock);
+void    tsdbPrefetchFlush(SDataFReader *pReader);
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 int32_t tsdbReadSttBlockEx(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 // SDelFWriter
@@ -290,8 +300,22 @@ int32_t tsdbReadDelIdx(SDelFReader *pReader, SArray *aDelIdx);
 // tsdbRead.c ==============================================================================================
 int32_t tsdbTakeReadSnap(STsdb *pTsdb, STsdbReadSnap **ppSnap, const char *id);
 void    tsdbUntakeReadSnap(STsdb *pTsdb, STsdbReadSnap *pSnap, const char *id);
-// tsdbMerge.c ==============================================================================================
-int32_t tsdbMerge(STsdb *pTsdb);
+// tsdbDataIter.c ==============================================================================================
+#define TSDB_MEM_TABLE_DATA_ITER 0
+#define TSDB_DATA_FILE_DATA_ITER 1
+#define TSDB_STT_FILE_DATA_ITER  2
+#define TSDB_TOMB_FILE_DATA_ITER 3
+
+#define TSDB_FILTER_FLAG_BY_VERSION 0x1
+
+#define TSDB_RBTN_TO_DATA_ITER(pNode) ((STsdbDataIter2 *)(((char *)pNode) - offsetof(STsdbDataIter2, rbtn)))
+
+int32_t tsdbOpenDataFileDataIter(SDataFReader *pReader, STsdbDataIter2 **ppIter);
+int32_t tsdbOpenSttFileDataIter(SDataFReader *pReader, int32_t iStt, STsdbDataIter2 **ppIter);
+int32_t tsdbOpenTombFileDataIter(SDelFReader *pReader, STsdbDataIter2 **ppIter);
+void    tsdbCloseDataIter2(STsdbDataIter2 *pIter);
+int32_t tsdbDataIterCmprFn(const SRBTreeNode *pNode1, const SRBTreeNode *pNode2);
+int32_t tsdbDataIterNext2(STsdbDataIter2 *pIter, STsdbFilterInfo *pFilterInfo);
 
 #define TSDB_CACHE_NO(c)       ((c).cacheLast == 0)
 #define TSDB_CACHE_LAST_ROW(c) (((c).cacheLast & 1) > 0)
@@ -322,8 +346,20 @@ struct STsdb {
   STsdbFS        fs;
   SLRUCache     *lruCache;
   TdThreadMutex  lruMutex;
+  TDB           *pCacheDb;    // last/last_row entries persisted at commit, reloaded lazily after a restart
+  TTB           *pLastDb;
+  TdThreadMutex  lastDbMutex;
+  SHashObj      *pLastDirty;  // cache keys merged from files since the last commit, guarded by lruMutex
+  int8_t         lastDbUsed;
   SLRUCache     *biCache;
   TdThreadMutex  biMutex;
+  SLRUCache     *pgCache;
+  int64_t        pgCacheHit;
+  int64_t        pgCacheMiss;
+  int8_t         compactRunning;
+  int8_t         compactForce;
+  int8_t         compactStop;
+  int32_t        compactFid;  // file set the last compaction round stopped at
 };
 
 struct TSDBKEY {
@@ -352,15 +388,34 @@ typedef struct SMemSkipList {
   SMemSkipListNode *pTail;
 } SMemSkipList;
 
+// A chunk of rows appended in key order, keys and versions are kept apart from the rows so that seeking and merging
+// do not touch the row data. The writer fills a row before publishing it by bumping nRow.
+typedef struct SMemAppendChunk SMemAppendChunk;
+struct SMemAppendChunk {
+  int32_t          capacity;
+  int32_t          nRow;
+  SMemAppendChunk *pPrev;
+  SMemAppendChunk *pNext;
+  TSKEY           *aTSKEY;
+  int64_t         *aVersion;
+  STSRow         **aTSRow;
+};
+typedef struct SMemAppendBuf {
+  int64_t          size;
+  SMemAppendChunk *pHead;
+  SMemAppendChunk *pTail;
+} SMemAppendBuf;
+
 struct STbData {
-  tb_uid_t     suid;
-  tb_uid_t     uid;
-  TSKEY        minKey;
-  TSKEY        maxKey;
-  SDelData    *pHead;
-  SDelData    *pTail;
-  SMemSkipList sl;
-  STbData     *next;
+  tb_uid_t      suid;
+  tb_uid_t      uid;
+  TSKEY         minKey;
+  TSKEY         maxKey;
+  SDelData     *pHead;
+  SDelData     *pTail;
+  SMemAppendBuf ab;  // rows in key order
+  SMemSkipList  sl;  // out-of-order rows only
+  STbData      *next;
 };
 
 struct SMemTable {
@@ -430,6 +485,17 @@ struct SSmaInfo {
   int32_t size;
 };
 
+// The bloom filters of a data block are written to the sma file right after its SColumnDataAgg list, which ends with
+// an entry of the column TSDB_BLOOM_FILTER_CID whose sum field is the encoded size of the bloom filters.
+#define TSDB_BLOOM_FILTER_CID (-1)
+#define TSDB_BLOOM_FILTER_FPP 0.01
+
+struct SBlockBloomFilter {
+  int16_t       cid;
+  int8_t        type;
+  SBloomFilter *pBF;
+};
+
 struct SBlkInfo {
   int64_t minUid;
   int64_t maxUid;
@@ -488,7 +554,10 @@ struct TABLEID {
 struct STbDataIter {
   STbData          *pTbData;
   int8_t            backward;
+  int8_t            fromAb;  // whether the current row comes from the append buffer
   SMemSkipListNode *pNode;
+  SMemAppendChunk  *pChunk;
+  int32_t           iRow;
   TSDBROW          *pRow;
   TSDBROW           row;
 };
@@ -581,13 +650,31 @@ struct SRowMerger {
 };
 
 typedef struct {
-  char     *path;
-  int32_t   szPage;
-  int32_t   flag;
-  TdFilePtr pFD;
-  int64_t   pgno;
-  uint8_t  *pBuf;
-  int64_t   szFile;
+  int32_t fid;
+  int32_t ftype;
+  int64_t commitID;
+  int64_t pgno;
+} STsdbPgKey;
+
+typedef struct {
+  char      *path;
+  int32_t    szPage;
+  int32_t    flag;
+  TdFilePtr  pFD;
+  int64_t    pgno;
+  uint8_t   *pBuf;
+  int64_t    szFile;
+  uint8_t   *pRBuf;     // buffer of coalesced page reads
+  STsdb     *pTsdb;     // not NULL if pages can be served from pTsdb->pgCache
+  STsdbPgKey pgKey;     // pgno is filled at each access
+  int64_t    pgCached;  // pages (1, pgCached] are full and immutable, thus cachable
+  // [raOffset, raEnd) is a run of adjacent blocks to read ahead, [raOffset, raIssued) is already passed to the kernel
+  int64_t    raOffset;
+  int64_t    raIssued;
+  int64_t    raEnd;
+  int64_t    nRead;       // positional reads issued
+  int64_t    nReadahead;  // positional reads inside [raOffset, raIssued)
+  int64_t    nPrefetch;   // read ahead requests passed to the kernel
 } STsdbFD;
 
 struct SDelFWriter {
@@ -705,6 +792,62 @@ struct SDiskDataBuilder {
   SBlkInfo     bi;
 };
 
+typedef struct {
+  int64_t  suid;
+  int64_t  uid;
+  SDelData delData;
+} SDelInfo;
+
+struct STsdbDataIter2 {
+  STsdbDataIter2 *next;
+  SRBTreeNode     rbtn;
+
+  int32_t  type;
+  SRowInfo rowInfo;
+  SDelInfo delInfo;
+  union {
+    // TSDB_MEM_TABLE_DATA_ITER
+    struct {
+      SMemTable *pMemTable;
+    } mIter;
+
+    // TSDB_DATA_FILE_DATA_ITER
+    struct {
+      SDataFReader *pReader;
+      SArray       *aBlockIdx;  // SArray<SBlockIdx>
+      SMapData      mDataBlk;
+      SBlockData    bData;
+      int32_t       iBlockIdx;
+      int32_t       iDataBlk;
+      int32_t       iRow;
+    } dIter;
+
+    // TSDB_STT_FILE_DATA_ITER
+    struct {
+      SDataFReader *pReader;
+      int32_t       iStt;
+      SArray       *aSttBlk;
+      SBlockData    bData;
+      int32_t       iSttBlk;
+      int32_t       iRow;
+    } sIter;
+    // TSDB_TOMB_FILE_DATA_ITER
+    struct {
+      SDelFReader *pReader;
+      SArray      *aDelIdx;
+      SArray      *aDelData;
+      int32_t      iDelIdx;
+      int32_t      iDelData;
+    } tIter;
+  };
+};
+
+struct STsdbFilterInfo {
+  int32_t flag;
+  int64_t sver;
+  int64_t ever;
+};
+
 int32_t tMergeTreeOpen(SMergeTree *pMTree, int8_t backward, SDataFReader *pFReader, uint64_t suid, uint64_t uid,
                        STimeWindow *pTimeWindow, SVersionRange *pVerRange, SSttBlockLoadInfo *pBlockLoadInfo,
                        bool destroyLoadInfo, const char *idStr);
@@ -753,9 +896,16 @@ int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h);
 int32_t tsdbCacheGetBlockIdx(SLRUCache *pCache, SDataFReader *pFileReader, LRUHandle **handle);
 int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h);
 
+bool tsdbPgCacheGet(STsdb *pTsdb, const STsdbPgKey *pKey, uint8_t *pPage, int32_t szPage);
+void tsdbPgCachePut(STsdb *pTsdb, const STsdbPgKey *pKey, const uint8_t *pPage, int32_t szPage);
+void tsdbPgCacheGetStat(STsdb *pTsdb, int64_t *nHit, int64_t *nMiss, size_t *usage);
+
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
+int32_t tsdbCacheCommit(STsdb *pTsdb, SArray *aTbDataP);
+int32_t tsdbCacheReset(STsdb *pTsdb);
+void    tsdbCacheInvalidate(STsdb *pTsdb);
 
 void   tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t tsdbCacheGetCapacity(SVnode *pVnode);
@@ -786,24 +936,6 @@ static FORCE_INLINE int32_t tsdbKeyCmprFn(const void *p1, const void *p2) {
 static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
   if (pIter == NULL) return NULL;
 
-  if (pIter->pRow) {
-    return pIter->pRow;
-  }
-
-  if (pIter->backward) {
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return NULL;
-    }
-  } else {
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return NULL;
-    }
-  }
-
-  pIter->pRow = &pIter->row;
-  pIter->pRow->version = pIter->pNode->version;
-  pIter->pRow->pTSRow = pIter->pNode->pTSRow;
-
   return pIter->pRow;
 }
 
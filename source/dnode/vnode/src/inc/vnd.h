@@ -50,6 +50,9 @@ int32_t vnodeDecodeConfig(const SJson* pJson, void* pObj);
 
 // vnodeModule.c
 int32_t vnodeScheduleTask(int32_t (*execute)(void*), void* arg);
+int32_t vnodeScheduleCompactTask(int32_t (*execute)(void*), void* arg);
+void*   vnodeCancelCompactTask(int32_t (*execute)(void*), bool (*fp)(void*, void*), void* param);
+int32_t vnodeScheduleFSetTask(int32_t (*execute)(void*), void* arg);
 
 // vnodeBufPool.c
 typedef struct SVBufPoolNode SVBufPoolNode;
@@ -21,6 +21,7 @@
 #include "qworker.h"
 #include "sync.h"
 #include "tRealloc.h"
+#include "tbloomfilter.h"
 #include "tchecksum.h"
 #include "tcoding.h"
 #include "tcompare.h"
@@ -162,12 +163,17 @@ int32_t tsdbCommit(STsdb* pTsdb, SCommitInfo* pInfo);
 int32_t tsdbFinishCommit(STsdb* pTsdb);
 int32_t tsdbRollbackCommit(STsdb* pTsdb);
 int32_t tsdbDoRetention(STsdb* pTsdb, int64_t now);
+int32_t tsdbCompact(STsdb* pTsdb, int64_t commitID);
+int32_t tsdbScheduleCompact(STsdb* pTsdb, int64_t commitID);
+void    tsdbRequestCompact(STsdb* pTsdb);
+void    tsdbStopCompact(STsdb* pTsdb);
 int     tsdbScanAndConvertSubmitMsg(STsdb* pTsdb, SSubmitReq* pMsg);
 int     tsdbInsertData(STsdb* pTsdb, int64_t version, SSubmitReq* pMsg, SSubmitRsp* pRsp);
 int32_t tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock,
                             SSubmitBlkRsp* pRsp);
 int32_t tsdbDeleteTableData(STsdb* pTsdb, int64_t version, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKEY eKey);
 int32_t tsdbSetKeepCfg(STsdb* pTsdb, STsdbCfg* pCfg);
+void    tsdbCacheDropTable(STsdb* pTsdb, SArray* aUid);
 
 // tq
 int     tqInit();
@@ -132,6 +132,7 @@ int32_t metaCacheOpen(SMeta* pMeta) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err2;
   }
+  taosLRUCacheSetAdmission(pCache->sTagFilterResCache.pUidResCache, TAOS_LRU_ADMIT_TINY_LFU);
 
   pCache->sTagFilterResCache.accTimes = 0;
   pCache->sTagFilterResCache.pTableEntry =
@@ -24,6 +24,7 @@ static int32_t tsdbOpenBICache(STsdb *pTsdb) {
   }
 
   taosLRUCacheSetStrictCapacity(pCache, false);
+  taosLRUCacheSetAdmission(pCache, TAOS_LRU_ADMIT_TINY_LFU);
 
   taosThreadMutexInit(&pTsdb->biMutex, NULL);
 
@@ -43,6 +44,134 @@ static void tsdbCloseBICache(STsdb *pTsdb) {
   }
 }
 
+static int32_t tsdbOpenPgCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = NULL;
+  size_t     cfgCapacity = (size_t)tsTsdbPageCacheSize * 1024 * 1024;
+
+  if (cfgCapacity == 0) goto _err;
+
+  pCache = taosLRUCacheInit(cfgCapacity, -1, .5);
+  if (pCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, false);
+
+_err:
+  pTsdb->pgCache = pCache;
+  pTsdb->pgCacheHit = 0;
+  pTsdb->pgCacheMiss = 0;
+  return code;
+}
+
+static void tsdbClosePgCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->pgCache;
+  if (pCache) {
+    tsdbDebug("vgId:%d, tsdb page cache closed, hit:%" PRId64 " miss:%" PRId64, TD_VID(pTsdb->pVnode),
+              pTsdb->pgCacheHit, pTsdb->pgCacheMiss);
+
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    pTsdb->pgCache = NULL;
+  }
+}
+
+static int32_t lastDbKeyCmpr(const void *pKey1, int32_t kLen1, const void *pKey2, int32_t kLen2) {
+  uint64_t key1 = *(uint64_t *)pKey1;
+  uint64_t key2 = *(uint64_t *)pKey2;
+
+  if (key1 < key2) {
+    return -1;
+  } else if (key1 > key2) {
+    return 1;
+  }
+  return 0;
+}
+
+static void tsdbLastDbPath(STsdb *pTsdb, char *path) {
+  SVnode *pVnode = pTsdb->pVnode;
+
+  if (pVnode->pTfs) {
+    snprintf(path, TSDB_FILENAME_LEN, "%s%s%s%scache", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pTsdb->path,
+             TD_DIRSEP);
+  } else {
+    snprintf(path, TSDB_FILENAME_LEN, "%s%scache", pTsdb->path, TD_DIRSEP);
+  }
+}
+
+static int32_t tsdbOpenLastDb(STsdb *pTsdb) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  SVnode *pVnode = pTsdb->pVnode;
+  TBC    *pCur = NULL;
+  char    path[TSDB_FILENAME_LEN];
+
+  tsdbLastDbPath(pTsdb, path);
+  taosMkDir(path);
+
+  if (tdbOpen(path, pVnode->config.szPage, 256, &pTsdb->pCacheDb, 0) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (tdbTbOpen("last.db", sizeof(uint64_t), -1, lastDbKeyCmpr, pTsdb->pCacheDb, &pTsdb->pLastDb, 0) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  pTsdb->pLastDirty = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT), false, HASH_NO_LOCK);
+  if (pTsdb->pLastDirty == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  taosThreadMutexInit(&pTsdb->lastDbMutex, NULL);
+
+  // an empty db lets commits skip the persisting work while caching is off
+  if (tdbTbcOpen(pTsdb->pLastDb, &pCur, NULL) == 0) {
+    void *pKey = NULL;
+    void *pVal = NULL;
+    int   kLen = 0;
+    int   vLen = 0;
+
+    tdbTbcMoveToFirst(pCur);
+    pTsdb->lastDbUsed = (tdbTbcNext(pCur, &pKey, &kLen, &pVal, &vLen) == 0);
+    tdbFree(pKey);
+    tdbFree(pVal);
+    tdbTbcClose(pCur);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pVnode), __func__, lino, tstrerror(code));
+    if (pTsdb->pLastDb) tdbTbClose(pTsdb->pLastDb);
+    if (pTsdb->pCacheDb) tdbClose(pTsdb->pCacheDb);
+    taosHashCleanup(pTsdb->pLastDirty);
+    pTsdb->pLastDb = NULL;
+    pTsdb->pCacheDb = NULL;
+    pTsdb->pLastDirty = NULL;
+  }
+  return code;
+}
+
+static void tsdbCloseLastDb(STsdb *pTsdb) {
+  // the db itself may already be dropped by tsdbCacheInvalidate
+  if (pTsdb->pLastDirty) {
+    if (pTsdb->pLastDb) tdbTbClose(pTsdb->pLastDb);
+    if (pTsdb->pCacheDb) tdbClose(pTsdb->pCacheDb);
+    taosHashCleanup(pTsdb->pLastDirty);
+    taosThreadMutexDestroy(&pTsdb->lastDbMutex);
+
+    pTsdb->pLastDb = NULL;
+    pTsdb->pCacheDb = NULL;
+    pTsdb->pLastDirty = NULL;
+  }
+}
+
 int32_t tsdbOpenCache(STsdb *pTsdb) {
   int32_t    code = 0;
   SLRUCache *pCache = NULL;
@@ -60,7 +189,18 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
     goto _err;
   }
 
+  code = tsdbOpenPgCache(pTsdb);
+  if (code != TSDB_CODE_SUCCESS) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  // without the persisted entries the cache still works, it just starts cold
+  tsdbOpenLastDb(pTsdb);
+
   taosLRUCacheSetStrictCapacity(pCache, false);
+  // a last_row scan over many cold tables must not push out the ones queried all the time
+  taosLRUCacheSetAdmission(pCache, TAOS_LRU_ADMIT_TINY_LFU);
 
   taosThreadMutexInit(&pTsdb->lruMutex, NULL);
 
@@ -80,6 +220,8 @@ void tsdbCloseCache(STsdb *pTsdb) {
   }
 
   tsdbCloseBICache(pTsdb);
+  tsdbClosePgCache(pTsdb);
+  tsdbCloseLastDb(pTsdb);
 }
 
 static void getTableCacheKey(tb_uid_t uid, int cacheType, char *key, int *len) {
@@ -1003,7 +1145,7 @@ typedef struct {
 
 static int32_t nextRowIterOpen(CacheNextRowIter *pIter, tb_uid_t uid, STsdb *pTsdb, STSchema *pTSchema, tb_uid_t suid,
                                SSttBlockLoadInfo *pLoadInfo, STsdbReadSnap *pReadSnap, SDataFReader **pDataFReader,
-                               SDataFReader **pDataFReaderLast) {
+                               SDataFReader **pDataFReaderLast, bool memOnly) {
   int code = 0;
 
   STbData *pMem = NULL;
@@ -1020,7 +1162,7 @@ static int32_t nextRowIterOpen(CacheNextRowIter *pIter, tb_uid_t uid, STsdb *pTs
 
   pIter->pSkyline = taosArrayInit(32, sizeof(TSDBKEY));
 
-  SDelFile *pDelFile = pReadSnap->fs.pDelFile;
+  SDelFile *pDelFile = memOnly ? NULL : pReadSnap->fs.pDelFile;
   if (pDelFile) {
     SDelFReader *pDelFReader;
 
@@ -1082,6 +1224,13 @@ static int32_t nextRowIterOpen(CacheNextRowIter *pIter, tb_uid_t uid, STsdb *pTs
   pIter->input[3] =
       (TsdbNextRowState){&pIter->fsRow, false, true, &pIter->fsState, getNextRowFromFS, clearNextRowFromFS};
 
+  if (memOnly) {
+    pIter->input[2].stop = true;
+    pIter->input[2].next = false;
+    pIter->input[3].stop = true;
+    pIter->input[3].next = false;
+  }
+
   if (pMem) {
     pIter->memState.pMem = pMem;
     pIter->memState.state = SMEMNEXTROW_ENTER;
@@ -1192,7 +1341,8 @@ _err:
   return code;
 }
 
-static int32_t mergeLastRow(tb_uid_t uid, STsdb *pTsdb, bool *dup, SArray **ppColArray, SCacheRowsReader *pr) {
+static int32_t mergeLastRow(tb_uid_t uid, STsdb *pTsdb, bool *dup, SArray **ppColArray, SCacheRowsReader *pr,
+                            bool memOnly) {
   int32_t code = 0;
 
   STSchema *pTSchema = pr->pSchema;  // metaGetTbTSchema(pTsdb->pVnode->pMeta, uid, -1, 1);
@@ -1207,7 +1357,7 @@ static int32_t mergeLastRow(tb_uid_t uid, STsdb *pTsdb, bool *dup, SArray **ppCo
 
   CacheNextRowIter iter = {0};
   nextRowIterOpen(&iter, uid, pTsdb, pTSchema, pr->suid, pr->pLoadInfo, pr->pReadSnap, &pr->pDataFReader,
-                  &pr->pDataFReaderLast);
+                  &pr->pDataFReaderLast, memOnly);
 
   do {
     TSDBROW *pRow = NULL;
@@ -1317,7 +1467,7 @@ _err:
   return code;
 }
 
-static int32_t mergeLast(tb_uid_t uid, STsdb *pTsdb, SArray **ppLastArray, SCacheRowsReader *pr) {
+static int32_t mergeLast(tb_uid_t uid, STsdb *pTsdb, SArray **ppLastArray, SCacheRowsReader *pr, bool memOnly) {
   int32_t code = 0;
 
   STSchema *pTSchema = pr->pSchema;  // metaGetTbTSchema(pTsdb->pVnode->pMeta, uid, -1, 1);
@@ -1332,7 +1482,7 @@ static int32_t mergeLast(tb_uid_t uid, STsdb *pTsdb, SArray **ppLastArray, SCach
 
   CacheNextRowIter iter = {0};
   nextRowIterOpen(&iter, uid, pTsdb, pTSchema, pr->suid, pr->pLoadInfo, pr->pReadSnap, &pr->pDataFReader,
-                  &pr->pDataFReaderLast);
+                  &pr->pDataFReaderLast, memOnly);
 
   do {
     TSDBROW *pRow = NULL;
@@ -1436,6 +1586,432 @@ _err:
   return code;
 }
 
+// persisted last/last_row ===================================================================================
+static int32_t tsdbCachePutLastArray(uint8_t *p, SArray *pLastArray) {
+  int32_t n = 0;
+  int16_t nCol = taosArrayGetSize(pLastArray);
+
+  n += tPutI16v(p ? p + n : p, nCol);
+  for (int16_t iCol = 0; iCol < nCol; ++iCol) {
+    SLastCol *pLastCol = (SLastCol *)taosArrayGet(pLastArray, iCol);
+    SColVal  *pColVal = &pLastCol->colVal;
+
+    n += tPutI64(p ? p + n : p, pLastCol->ts);
+    n += tPutI16v(p ? p + n : p, pColVal->cid);
+    n += tPutI8(p ? p + n : p, pColVal->type);
+    n += tPutI8(p ? p + n : p, pColVal->flag);
+    if (COL_VAL_IS_VALUE(pColVal)) {
+      if (IS_VAR_DATA_TYPE(pColVal->type)) {
+        n += tPutBinary(p ? p + n : p, pColVal->value.pData, pColVal->value.nData);
+      } else {
+        n += tPutI64(p ? p + n : p, pColVal->value.val);
+      }
+    }
+  }
+
+  return n;
+}
+
+static int32_t tsdbCacheGetLastArray(uint8_t *p, SArray **ppLastArray) {
+  int32_t code = 0;
+  int32_t n = 0;
+  int16_t nCol = 0;
+
+  n += tGetI16v(p + n, &nCol);
+  SArray *pLastArray = taosArrayInit(nCol, sizeof(SLastCol));
+  if (pLastArray == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  for (int16_t iCol = 0; iCol < nCol; ++iCol) {
+    SLastCol lastCol = {0};
+    SColVal *pColVal = &lastCol.colVal;
+
+    n += tGetI64(p + n, &lastCol.ts);
+    n += tGetI16v(p + n, &pColVal->cid);
+    n += tGetI8(p + n, &pColVal->type);
+    n += tGetI8(p + n, &pColVal->flag);
+    if (COL_VAL_IS_VALUE(pColVal)) {
+      if (IS_VAR_DATA_TYPE(pColVal->type)) {
+        uint8_t *pData = NULL;
+        n += tGetBinary(p + n, &pData, &pColVal->value.nData);
+        if (pColVal->value.nData > 0) {
+          pColVal->value.pData = taosMemoryMalloc(pColVal->value.nData);
+          if (pColVal->value.pData == NULL) {
+            code = TSDB_CODE_OUT_OF_MEMORY;
+            goto _err;
+          }
+          memcpy(pColVal->value.pData, pData, pColVal->value.nData);
+        } else {
+          pColVal->value.pData = NULL;
+        }
+      } else {
+        n += tGetI64(p + n, &pColVal->value.val);
+      }
+    }
+
+    if (taosArrayPush(pLastArray, &lastCol) == NULL) {
+      if (IS_VAR_DATA_TYPE(pColVal->type) && pColVal->value.nData > 0) taosMemoryFree(pColVal->value.pData);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+  }
+
+  *ppLastArray = pLastArray;
+  return code;
+
+_err:
+  if (pLastArray) deleteTableCacheLast(NULL, 0, pLastArray);
+  *ppLastArray = NULL;
+  return code;
+}
+
+static void tsdbCacheMoveLastCol(SLastCol *pDst, SLastCol *pSrc) {
+  if (IS_VAR_DATA_TYPE(pDst->colVal.type) && pDst->colVal.value.nData > 0) {
+    taosMemoryFree(pDst->colVal.value.pData);
+  }
+
+  *pDst = *pSrc;
+  if (IS_VAR_DATA_TYPE(pSrc->colVal.type)) {
+    pSrc->colVal.value.nData = 0;
+    pSrc->colVal.value.pData = NULL;
+  }
+}
+
+// Put the rows a table has in memory on top of its persisted entry. Same rules as mergeLastRow and mergeLast: the
+// latest row wins for last_row, the latest non-null value of each column wins for last, memory wins on equal keys.
+static SArray *tsdbCacheMergePersisted(int8_t cacheType, SArray *pLastArray, SArray *pMemArray) {
+  if (pMemArray == NULL) return pLastArray;
+
+  SLastCol *pLastTs = (SLastCol *)taosArrayGet(pLastArray, 0);
+  SLastCol *pMemTs = (SLastCol *)taosArrayGet(pMemArray, 0);
+  int16_t   nCol = taosArrayGetSize(pLastArray);
+
+  if (cacheType == 0) {
+    if (pMemTs->ts > pLastTs->ts) {
+      deleteTableCacheLast(NULL, 0, pLastArray);
+      return pMemArray;
+    } else if (pMemTs->ts == pLastTs->ts) {
+      for (int16_t iCol = 1; iCol < nCol; ++iCol) {
+        SLastCol *pMemCol = (SLastCol *)taosArrayGet(pMemArray, iCol);
+        if (!COL_VAL_IS_NONE(&pMemCol->colVal)) {
+          tsdbCacheMoveLastCol((SLastCol *)taosArrayGet(pLastArray, iCol), pMemCol);
+        }
+      }
+    }
+  } else {
+    if (pMemTs->ts > pLastTs->ts) {
+      tsdbCacheMoveLastCol(pLastTs, pMemTs);
+    }
+
+    for (int16_t iCol = 1; iCol < nCol; ++iCol) {
+      SLastCol *pLastCol = (SLastCol *)taosArrayGet(pLastArray, iCol);
+      SLastCol *pMemCol = (SLastCol *)taosArrayGet(pMemArray, iCol);
+      if (COL_VAL_IS_VALUE(&pMemCol->colVal) &&
+          (!COL_VAL_IS_VALUE(&pLastCol->colVal) || pMemCol->ts >= pLastCol->ts)) {
+        tsdbCacheMoveLastCol(pLastCol, pMemCol);
+      }
+    }
+  }
+
+  deleteTableCacheLast(NULL, 0, pMemArray);
+  return pLastArray;
+}
+
+// Load the persisted entry of a table missed in the lru cache. It is kept up to date at each commit for the tables the
+// committed memtable touched, so only rows that reached memory afterwards (replayed wal included) are merged on top of
+// it. Deletes in memory may hit the persisted rows, then the caller falls back to a full merge.
+static int32_t tsdbCacheLoadPersisted(STsdb *pTsdb, tb_uid_t uid, int8_t cacheType, SCacheRowsReader *pr,
+                                      SArray **ppLastArray) {
+  int32_t   code = 0;
+  STSchema *pTSchema = pr->pSchema;
+  SArray   *pLastArray = NULL;
+  SArray   *pMemArray = NULL;
+  void     *pVal = NULL;
+  int       vLen = 0;
+  char      key[32] = {0};
+  int       keyLen = 0;
+
+  *ppLastArray = NULL;
+  if (pTsdb->pLastDb == NULL) goto _exit;
+
+  getTableCacheKey(uid, cacheType, key, &keyLen);
+  taosThreadMutexLock(&pTsdb->lastDbMutex);
+  int32_t ret = pTsdb->pLastDb ? tdbTbGet(pTsdb->pLastDb, key, keyLen, &pVal, &vLen) : -1;
+  taosThreadMutexUnlock(&pTsdb->lastDbMutex);
+  if (ret < 0) goto _exit;
+
+  code = tsdbCacheGetLastArray(pVal, &pLastArray);
+  if (code) goto _exit;
+
+  // the schema changed since the entry was persisted, or some of its rows may have expired
+  STsdbKeepCfg *pKeepCfg = &pTsdb->keepCfg;
+  TSKEY         minKey = taosGetTimestamp(pKeepCfg->precision) - pKeepCfg->keep2 * tsTickPerMin[pKeepCfg->precision];
+  if (taosArrayGetSize(pLastArray) != pTSchema->numOfCols) goto _exit;
+  for (int16_t iCol = 0; iCol < pTSchema->numOfCols; ++iCol) {
+    SLastCol *pLastCol = (SLastCol *)taosArrayGet(pLastArray, iCol);
+    if (pLastCol->colVal.cid != pTSchema->columns[iCol].colId ||
+        pLastCol->colVal.type != pTSchema->columns[iCol].type) {
+      goto _exit;
+    }
+    if (COL_VAL_IS_VALUE(&pLastCol->colVal) && pLastCol->ts < minKey) goto _exit;
+  }
+
+  STbData *pMem = pr->pReadSnap->pMem ? tsdbGetTbDataFromMemTable(pr->pReadSnap->pMem, pr->suid, uid) : NULL;
+  STbData *pIMem = pr->pReadSnap->pIMem ? tsdbGetTbDataFromMemTable(pr->pReadSnap->pIMem, pr->suid, uid) : NULL;
+  if ((pMem && pMem->pHead) || (pIMem && pIMem->pHead)) goto _exit;
+
+  if (pMem || pIMem) {
+    if (cacheType == 0) {
+      bool dup = false;
+      code = mergeLastRow(uid, pTsdb, &dup, &pMemArray, pr, true);
+    } else {
+      code = mergeLast(uid, pTsdb, &pMemArray, pr, true);
+    }
+    if (code) goto _exit;
+  }
+
+  *ppLastArray = tsdbCacheMergePersisted(cacheType, pLastArray, pMemArray);
+  pLastArray = NULL;
+
+_exit:
+  if (pLastArray) deleteTableCacheLast(NULL, 0, pLastArray);
+  tdbFree(pVal);
+  return code;
+}
+
+static int32_t tsdbCachePersistKey(STsdb *pTsdb, TXN *pTxn, const void *key, int keyLen, uint8_t **ppBuf) {
+  int32_t    code = 0;
+  LRUHandle *h = taosLRUCacheLookup(pTsdb->lruCache, key, keyLen);
+
+  if (h) {
+    SArray *pLastArray = (SArray *)taosLRUCacheValue(pTsdb->lruCache, h);
+    int32_t n = tsdbCachePutLastArray(NULL, pLastArray);
+
+    code = tRealloc(ppBuf, n);
+    if (code == 0) {
+      tsdbCachePutLastArray(*ppBuf, pLastArray);
+    }
+    taosLRUCacheRelease(pTsdb->lruCache, h, false);
+    if (code) return code;
+
+    taosThreadMutexLock(&pTsdb->lastDbMutex);
+    if (tdbTbUpsert(pTsdb->pLastDb, key, keyLen, *ppBuf, n, pTxn) < 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+    taosThreadMutexUnlock(&pTsdb->lastDbMutex);
+    pTsdb->lastDbUsed = 1;
+  } else if (pTsdb->lastDbUsed) {
+    // evicted or invalidated after the table changed, the persisted entry is stale now
+    taosThreadMutexLock(&pTsdb->lastDbMutex);
+    tdbTbDelete(pTsdb->pLastDb, key, keyLen, pTxn);
+    taosThreadMutexUnlock(&pTsdb->lastDbMutex);
+  }
+
+  return code;
+}
+
+// Called by tsdbCommit before the file system switch, so a persisted entry never lags behind the data files: rows of
+// the committed memtable are in the entry, or the entry is gone. Rows written after the memtable switch may show up
+// in an entry too, they are in the wal and are merged again after a restart.
+int32_t tsdbCacheCommit(STsdb *pTsdb, SArray *aTbDataP) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  SHashObj *pDirty = NULL;
+  TXN      *pTxn = NULL;
+  uint8_t  *pBuf = NULL;
+  char      key[32] = {0};
+  int       keyLen = 0;
+
+  if (pTsdb->pLastDb == NULL) goto _exit;
+
+  if (TSDB_CACHE_NO(pTsdb->pVnode->config)) {
+    if (pTsdb->lastDbUsed) {
+      code = tsdbCacheReset(pTsdb);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    goto _exit;
+  }
+
+  SHashObj *pNewDirty = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT), false, HASH_NO_LOCK);
+  if (pNewDirty == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  taosThreadMutexLock(&pTsdb->lruMutex);
+  pDirty = pTsdb->pLastDirty;
+  pTsdb->pLastDirty = pNewDirty;
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+
+  if (tdbBegin(pTsdb->pCacheDb, &pTxn, tdbDefaultMalloc, tdbDefaultFree, NULL,
+               TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  int32_t nTbData = taosArrayGetSize(aTbDataP);
+  for (int32_t iTbData = 0; iTbData < nTbData; iTbData++) {
+    STbData *pTbData = (STbData *)taosArrayGetP(aTbDataP, iTbData);
+
+    for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+      getTableCacheKey(pTbData->uid, cacheType, key, &keyLen);
+      taosHashRemove(pDirty, key, keyLen);
+
+      code = tsdbCachePersistKey(pTsdb, pTxn, key, keyLen, &pBuf);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+  int32_t nDirty = taosHashGetSize(pDirty);
+  void   *pIter = taosHashIterate(pDirty, NULL);
+  while (pIter) {
+    size_t kLen = 0;
+    void  *pKey = taosHashGetKey(pIter, &kLen);
+
+    code = tsdbCachePersistKey(pTsdb, pTxn, pKey, kLen, &pBuf);
+    if (code) {
+      taosHashCancelIterate(pDirty, pIter);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    pIter = taosHashIterate(pDirty, pIter);
+  }
+
+  taosThreadMutexLock(&pTsdb->lastDbMutex);
+  if (tdbCommit(pTsdb->pCacheDb, pTxn) < 0 || tdbPostCommit(pTsdb->pCacheDb, pTxn) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosThreadMutexUnlock(&pTsdb->lastDbMutex);
+  pTxn = NULL;
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tsdbDebug("vgId:%d, last cache persisted, nTable:%d nDirty:%d", TD_VID(pTsdb->pVnode), nTbData, nDirty);
+
+_exit:
+  if (pTxn) tdbAbort(pTsdb->pCacheDb, pTxn);
+  taosHashCleanup(pDirty);
+  tFree(pBuf);
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+// Drop every persisted entry, for data replaced as a whole (a received snapshot) and for caching switched off.
+int32_t tsdbCacheReset(STsdb *pTsdb) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  SArray *aKey = NULL;
+  TBC    *pCur = NULL;
+  TXN    *pTxn = NULL;
+  void   *pKey = NULL;
+  void   *pVal = NULL;
+  int     kLen = 0;
+  int     vLen = 0;
+
+  if (pTsdb->pLastDb == NULL) goto _exit;
+
+  // entries merged from the old data must not be persisted again
+  taosThreadMutexLock(&pTsdb->lruMutex);
+  taosHashClear(pTsdb->pLastDirty);
+  taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+
+  if ((aKey = taosArrayInit(0, sizeof(uint64_t))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  taosThreadMutexLock(&pTsdb->lastDbMutex);
+  if (tdbTbcOpen(pTsdb->pLastDb, &pCur, NULL) == 0) {
+    tdbTbcMoveToFirst(pCur);
+    while (tdbTbcNext(pCur, &pKey, &kLen, &pVal, &vLen) == 0) {
+      if (taosArrayPush(aKey, pKey) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        break;
+      }
+    }
+    tdbTbcClose(pCur);
+  }
+  taosThreadMutexUnlock(&pTsdb->lastDbMutex);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (tdbBegin(pTsdb->pCacheDb, &pTxn, tdbDefaultMalloc, tdbDefaultFree, NULL,
+               TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  taosThreadMutexLock(&pTsdb->lastDbMutex);
+  for (int32_t iKey = 0; iKey < taosArrayGetSize(aKey); iKey++) {
+    tdbTbDelete(pTsdb->pLastDb, taosArrayGet(aKey, iKey), sizeof(uint64_t), pTxn);
+  }
+  if (tdbCommit(pTsdb->pCacheDb, pTxn) < 0 || tdbPostCommit(pTsdb->pCacheDb, pTxn) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosThreadMutexUnlock(&pTsdb->lastDbMutex);
+  pTxn = NULL;
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  pTsdb->lastDbUsed = 0;
+
+_exit:
+  if (pTxn) tdbAbort(pTsdb->pCacheDb, pTxn);
+  tdbFree(pKey);
+  tdbFree(pVal);
+  taosArrayDestroy(aKey);
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else {
+    tsdbInfo("vgId:%d, persisted last cache reset", TD_VID(pTsdb->pVnode));
+  }
+  return code;
+}
+
+// Persisting failed, so the persisted entries may lag behind the data files and none of them may be loaded again. The
+// lru cache is still right. Drop the entries, or if even that fails the whole db, so that a restart does not find them
+// either. Persisting stays off until the vnode is reopened.
+void tsdbCacheInvalidate(STsdb *pTsdb) {
+  char path[TSDB_FILENAME_LEN];
+
+  if (pTsdb->pLastDb == NULL) return;
+  if (tsdbCacheReset(pTsdb) == 0) return;
+
+  taosThreadMutexLock(&pTsdb->lastDbMutex);
+  tdbTbClose(pTsdb->pLastDb);
+  tdbClose(pTsdb->pCacheDb);
+  pTsdb->pLastDb = NULL;
+  pTsdb->pCacheDb = NULL;
+  taosThreadMutexUnlock(&pTsdb->lastDbMutex);
+
+  tsdbLastDbPath(pTsdb, path);
+  taosRemoveDir(path);
+  tsdbWarn("vgId:%d, persisted last cache dropped, it is not used until the vnode is reopened", TD_VID(pTsdb->pVnode));
+}
+
+// Forget the dropped tables. Their lru entries go now and their persisted entries at the next commit, which finds the
+// keys dirty with no lru entry behind them.
+void tsdbCacheDropTable(STsdb *pTsdb, SArray *aUid) {
+  char key[32] = {0};
+  int  keyLen = 0;
+
+  if (pTsdb == NULL || taosArrayGetSize(aUid) == 0) return;
+
+  taosThreadMutexLock(&pTsdb->lruMutex);
+  for (int32_t iUid = 0; iUid < taosArrayGetSize(aUid); iUid++) {
+    tb_uid_t uid = *(tb_uid_t *)taosArrayGet(aUid, iUid);
+
+    for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+      getTableCacheKey(uid, cacheType, key, &keyLen);
+      taosLRUCacheErase(pTsdb->lruCache, key, keyLen);
+      if (pTsdb->pLastDirty && pTsdb->lastDbUsed) {
+        taosHashPut(pTsdb->pLastDirty, key, keyLen, NULL, 0);
+      }
+    }
+  }
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+}
+
 int32_t tsdbCacheGetLastrowH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr, LRUHandle **handle) {
   int32_t code = 0;
   char    key[32] = {0};
@@ -1452,7 +2028,12 @@ int32_t tsdbCacheGetLastrowH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *
     if (!h) {
       SArray *pArray = NULL;
       bool    dup = false;  // which is always false for now
-      code = mergeLastRow(uid, pTsdb, &dup, &pArray, pr);
+      bool    merged = false;
+      code = tsdbCacheLoadPersisted(pTsdb, uid, 0, pr, &pArray);
+      if (code == 0 && pArray == NULL) {
+        code = mergeLastRow(uid, pTsdb, &dup, &pArray, pr, false);
+        merged = true;
+      }
       // if table's empty or error, return code of -1
       if (code < 0 || pArray == NULL) {
         if (!dup && pArray) {
@@ -1471,6 +2052,8 @@ int32_t tsdbCacheGetLastrowH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *
       LRUStatus status = taosLRUCacheInsert(pCache, key, keyLen, pArray, charge, deleter, &h, TAOS_LRU_PRIORITY_LOW);
       if (status != TAOS_LRU_STATUS_OK) {
         code = -1;
+      } else if (merged && pTsdb->pLastDirty) {
+        taosHashPut(pTsdb->pLastDirty, key, keyLen, NULL, 0);
       }
 
       // taosThreadMutexUnlock(&pTsdb->lruMutex);
@@ -1501,7 +2084,12 @@ int32_t tsdbCacheGetLastH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr,
     h = taosLRUCacheLookup(pCache, key, keyLen);
     if (!h) {
       SArray *pLastArray = NULL;
-      code = mergeLast(uid, pTsdb, &pLastArray, pr);
+      bool    merged = false;
+      code = tsdbCacheLoadPersisted(pTsdb, uid, 1, pr, &pLastArray);
+      if (code == 0 && pLastArray == NULL) {
+        code = mergeLast(uid, pTsdb, &pLastArray, pr, false);
+        merged = true;
+      }
       // if table's empty or error, return code of -1
       if (code < 0 || pLastArray == NULL) {
         taosThreadMutexUnlock(&pTsdb->lruMutex);
@@ -1516,6 +2104,8 @@ int32_t tsdbCacheGetLastH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr,
           taosLRUCacheInsert(pCache, key, keyLen, pLastArray, charge, deleter, &h, TAOS_LRU_PRIORITY_LOW);
       if (status != TAOS_LRU_STATUS_OK) {
         code = -1;
+      } else if (merged && pTsdb->pLastDirty) {
+        taosHashPut(pTsdb->pLastDirty, key, keyLen, NULL, 0);
       }
 
       // taosThreadMutexUnlock(&pTsdb->lruMutex);
@@ -1634,3 +2224,40 @@ int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h) {
 
   return code;
 }
+
+static void deletePgCache(const void *key, size_t keyLen, void *value) { taosMemoryFree(value); }
+
+bool tsdbPgCacheGet(STsdb *pTsdb, const STsdbPgKey *pKey, uint8_t *pPage, int32_t szPage) {
+  SLRUCache *pCache = pTsdb->pgCache;
+  if (pCache == NULL) return false;
+
+  LRUHandle *h = taosLRUCacheLookup(pCache, pKey, sizeof(*pKey));
+  if (h == NULL) {
+    atomic_add_fetch_64(&pTsdb->pgCacheMiss, 1);
+    return false;
+  }
+
+  memcpy(pPage, taosLRUCacheValue(pCache, h), szPage);
+  taosLRUCacheRelease(pCache, h, false);
+
+  atomic_add_fetch_64(&pTsdb->pgCacheHit, 1);
+  return true;
+}
+
+void tsdbPgCachePut(STsdb *pTsdb, const STsdbPgKey *pKey, const uint8_t *pPage, int32_t szPage) {
+  SLRUCache *pCache = pTsdb->pgCache;
+  if (pCache == NULL) return;
+
+  uint8_t *pValue = taosMemoryMalloc(szPage);
+  if (pValue == NULL) return;
+  memcpy(pValue, pPage, szPage);
+
+  // no handle is taken, the cache owns the page and frees it by deletePgCache if it is not admitted
+  taosLRUCacheInsert(pCache, pKey, sizeof(*pKey), pValue, szPage, deletePgCache, NULL, TAOS_LRU_PRIORITY_LOW);
+}
+
+void tsdbPgCacheGetStat(STsdb *pTsdb, int64_t *nHit, int64_t *nMiss, size_t *usage) {
+  *nHit = atomic_load_64(&pTsdb->pgCacheHit);
+  *nMiss = atomic_load_64(&pTsdb->pgCacheMiss);
+  *usage = pTsdb->pgCache ? taosLRUCacheGetUsage(pTsdb->pgCache) : 0;
+}
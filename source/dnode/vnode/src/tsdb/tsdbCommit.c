@@ -15,6 +15,8 @@
 
 #include "tsdb.h"
 
+extern int32_t vnodeScheduleFSetTask(int32_t (*execute)(void *), void *arg);
+
 typedef enum { MEMORY_DATA_ITER = 0, STT_DATA_ITER } EDataIterT;
 
 #define USE_STREAM_COMPRESSION 0
@@ -38,6 +40,14 @@ typedef struct {
   };
 } SDataIter;
 
+typedef struct {
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  SSttFile  aSttF[TSDB_MAX_STT_TRIGGER];
+  SDFileSet wSet;
+} SCommitFSet;
+
 typedef struct {
   STsdb *pTsdb;
   /* commit data */
@@ -52,8 +62,9 @@ typedef struct {
   STsdbFS fs;        // disk
   // --------------
   TSKEY   nextKey;  // reset by each table commit
-  int32_t commitFid;
-  int32_t expLevel;
+  int32_t      commitFid;
+  int32_t      expLevel;
+  SCommitFSet *pFSet;  // where the file set written for commitFid is kept until it is upserted
   TSKEY   minKey;
   TSKEY   maxKey;
   // commit file data
@@ -94,6 +105,15 @@ typedef struct {
   SArray      *aDelData;  // SArray<SDelData>
 } SCommitter;
 
+typedef struct {
+  SCommitter  *pCommitter;
+  SArray      *aFid;   // SArray<int32_t>, file sets touched by the memtable, in fid order
+  SCommitFSet *aFSet;  // one written file set per fid
+  int32_t      iFid;   // next fid to claim
+  int32_t      code;   // first error hit by a worker
+  tsem_t       done;   // posted by each worker queued on the vnode pool
+} SCommitJob;
+
 static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter, SCommitInfo *pInfo);
 static int32_t tsdbCommitData(SCommitter *pCommitter);
 static int32_t tsdbCommitDel(SCommitter *pCommitter);
@@ -190,6 +210,11 @@ int32_t tsdbCommit(STsdb *pTsdb, SCommitInfo *pInfo) {
   code = tsdbCommitDel(&commith);
   TSDB_CHECK_CODE(code, lino, _exit);
 
+  // the data is already written, a cache that can not be persisted is dropped instead of failing the commit
+  if (tsdbCacheCommit(pTsdb, commith.aTbDataP) != 0) {
+    tsdbCacheInvalidate(pTsdb);
+  }
+
   // end commit
   code = tsdbEndCommit(&commith, 0);
   TSDB_CHECK_CODE(code, lino, _exit);
@@ -729,6 +754,22 @@ _exit:
   return code;
 }
 
+static void tsdbCommitFSetCopy(SCommitFSet *pFSet, const SDFileSet *pSet) {
+  pFSet->fHead = *pSet->pHeadF;
+  pFSet->fData = *pSet->pDataF;
+  pFSet->fSma = *pSet->pSmaF;
+  pFSet->wSet = (SDFileSet){.diskId = pSet->diskId,
+                            .fid = pSet->fid,
+                            .pHeadF = &pFSet->fHead,
+                            .pDataF = &pFSet->fData,
+                            .pSmaF = &pFSet->fSma,
+                            .nSttF = pSet->nSttF};
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pFSet->aSttF[iStt] = *pSet->aSttF[iStt];
+    pFSet->wSet.aSttF[iStt] = &pFSet->aSttF[iStt];
+  }
+}
+
 static int32_t tsdbCommitFileDataEnd(SCommitter *pCommitter) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -745,9 +786,8 @@ static int32_t tsdbCommitFileDataEnd(SCommitter *pCommitter) {
   code = tsdbUpdateDFileSetHeader(pCommitter->dWriter.pWriter);
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  // upsert SDFileSet
-  code = tsdbFSUpsertFSet(&pCommitter->fs, &pCommitter->dWriter.pWriter->wSet);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  // keep SDFileSet, it is upserted once all file sets are written
+  tsdbCommitFSetCopy(pCommitter->pFSet, &pCommitter->dWriter.pWriter->wSet);
 
   // close and sync
   code = tsdbDataFWriterClose(&pCommitter->dWriter.pWriter, 1);
@@ -936,10 +976,105 @@ static void tsdbCommitDataEnd(SCommitter *pCommitter) {
   tDestroyTSchema(pCommitter->skmRow.pTSchema);
 }
 
-static int32_t tsdbCommitData(SCommitter *pCommitter) {
+// Collect the fids the memtable has rows in. Each step seeks every table past the current file set, so the cost is
+// O(nFid * nTable * log(nRow)) and no row is visited.
+static int32_t tsdbCommitFidList(SCommitter *pCommitter, SArray *aFid) {
   int32_t code = 0;
   int32_t lino = 0;
 
+  TSKEY nextKey = pCommitter->pTsdb->imem->minKey;
+  while (nextKey < TSKEY_MAX) {
+    int32_t fid = tsdbKeyFid(nextKey, pCommitter->minutes, pCommitter->precision);
+    TSKEY   minKey, maxKey;
+
+    if (taosArrayPush(aFid, &fid) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    tsdbFidKeyRange(fid, pCommitter->minutes, pCommitter->precision, &minKey, &maxKey);
+    nextKey = TSKEY_MAX;
+    if (maxKey == TSKEY_MAX) break;
+
+    TSDBKEY tKey = {.ts = maxKey + 1, .version = VERSION_MIN};
+    for (int32_t iTbData = 0; iTbData < taosArrayGetSize(pCommitter->aTbDataP); iTbData++) {
+      STbData    *pTbData = (STbData *)taosArrayGetP(pCommitter->aTbDataP, iTbData);
+      STbDataIter iter;
+
+      if (pTbData->maxKey <= maxKey) continue;
+
+      tsdbTbDataIterOpen(pTbData, &tKey, 0, &iter);
+      TSDBROW *pRow = tsdbTbDataIterGet(&iter);
+      if (pRow) nextKey = TMIN(nextKey, TSDBROW_TS(pRow));
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCommitter->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+// Each worker owns a private committer (reader, writer and block buffers) and claims file sets one at a time. The file
+// system copy is only read here: written file sets are upserted by tsdbCommitData after all workers are done.
+static void tsdbCommitDataWorker(SCommitJob *pJob) {
+  SCommitter *pCommitterT = pJob->pCommitter;
+  SCommitter  committer = {0};
+  int32_t     code = 0;
+  int32_t     lino = 0;
+
+  committer.pTsdb = pCommitterT->pTsdb;
+  committer.commitID = pCommitterT->commitID;
+  committer.minutes = pCommitterT->minutes;
+  committer.precision = pCommitterT->precision;
+  committer.minRow = pCommitterT->minRow;
+  committer.maxRow = pCommitterT->maxRow;
+  committer.cmprAlg = pCommitterT->cmprAlg;
+  committer.sttTrigger = pCommitterT->sttTrigger;
+  committer.aTbDataP = pCommitterT->aTbDataP;
+  committer.fs = pCommitterT->fs;
+
+  code = tsdbCommitDataStart(&committer);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  while (atomic_load_32(&pJob->code) == 0) {
+    int32_t iFid = atomic_fetch_add_32(&pJob->iFid, 1);
+    if (iFid >= taosArrayGetSize(pJob->aFid)) break;
+
+    TSKEY maxKey;
+    tsdbFidKeyRange(*(int32_t *)taosArrayGet(pJob->aFid, iFid), committer.minutes, committer.precision,
+                    &committer.nextKey, &maxKey);
+    committer.pFSet = &pJob->aFSet[iFid];
+
+    code = tsdbCommitFileData(&committer);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  tsdbCommitDataEnd(&committer);
+  if (code) {
+    atomic_val_compare_exchange_32(&pJob->code, 0, code);
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(committer.pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+}
+
+static int32_t tsdbCommitDataTask(void *arg) {
+  SCommitJob *pJob = (SCommitJob *)arg;
+
+  tsdbCommitDataWorker(pJob);
+  tsem_post(&pJob->done);
+  return 0;
+}
+
+static int32_t tsdbCommitData(SCommitter *pCommitter) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  int32_t    nTask = 0;
+  SCommitJob job = {.pCommitter = pCommitter};
+
   STsdb     *pTsdb = pCommitter->pTsdb;
   SMemTable *pMemTable = pTsdb->imem;
 
@@ -947,20 +1082,56 @@ static int32_t tsdbCommitData(SCommitter *pCommitter) {
   if (pMemTable->nRow == 0) goto _exit;
 
   // start ====================
-  code = tsdbCommitDataStart(pCommitter);
+  if ((job.aFid = taosArrayInit(0, sizeof(int32_t))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbCommitFidList(pCommitter, job.aFid);
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  // impl ====================
-  pCommitter->nextKey = pMemTable->minKey;
-  while (pCommitter->nextKey < TSKEY_MAX) {
-    code = tsdbCommitFileData(pCommitter);
+  int32_t nFid = taosArrayGetSize(job.aFid);
+  if ((job.aFSet = (SCommitFSet *)taosMemoryCalloc(nFid, sizeof(SCommitFSet))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  // impl ====================
+  // the calling thread is a worker too, the others are queued on the vnode file set pool shared by all vnodes
+  int32_t nWorker = TMIN(tsTsdbCommitThreads, nFid);
+  if (nWorker > 1) {
+    tsem_init(&job.done, 0, 0);
+    for (; nTask < nWorker - 1; nTask++) {
+      if (vnodeScheduleFSetTask(tsdbCommitDataTask, &job) < 0) {
+        tsdbWarn("vgId:%d, failed to queue commit worker since %s, continue with %d", TD_VID(pTsdb->pVnode),
+                 tstrerror(terrno), nTask + 1);
+        break;
+      }
+    }
+  }
+
+  tsdbCommitDataWorker(&job);
+  for (int32_t iTask = 0; iTask < nTask; iTask++) {
+    tsem_wait(&job.done);
+  }
+  if (nWorker > 1) {
+    tsem_destroy(&job.done);
+  }
+
+  code = job.code;
+  TSDB_CHECK_CODE(code, lino, _exit);
+
   // end ====================
-  tsdbCommitDataEnd(pCommitter);
+  for (int32_t iFid = 0; iFid < nFid; iFid++) {
+    code = tsdbFSUpsertFSet(&pCommitter->fs, &job.aFSet[iFid].wSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  tsdbDebug("vgId:%d, commit data done, nFid:%d nWorker:%d", TD_VID(pTsdb->pVnode), nFid, nTask + 1);
 
 _exit:
+  taosMemoryFree(job.aFSet);
+  taosArrayDestroy(job.aFid);
   if (code) {
     tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
   }
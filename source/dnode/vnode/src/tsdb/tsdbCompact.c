@@ -15,13 +15,1177 @@
 
 #include "tsdb.h"
 
+extern int32_t tsdbUpdateTableSchema(SMeta *pMeta, int64_t suid, int64_t uid, SSkmInfo *pSkmInfo);
+extern int32_t tsdbWriteDataBlock(SDataFWriter *pWriter, SBlockData *pBlockData, SMapData *mDataBlk, int8_t cmprAlg);
+extern int32_t tsdbWriteSttBlock(SDataFWriter *pWriter, SBlockData *pBlockData, SArray *aSttBlk, int8_t cmprAlg);
+extern int32_t vnodeScheduleCompactTask(int32_t (*execute)(void *), void *arg);
+extern void   *vnodeCancelCompactTask(int32_t (*execute)(void *), bool (*fp)(void *, void *), void *param);
+
+#define TSDB_COMPACT_PROBE_FSET     4     // file sets whose head file is read to find a candidate in one round
+#define TSDB_COMPACT_FRAG_RATIO     2     // a file set is fragmented if it has this many times the blocks a rewrite gives
+#define TSDB_COMPACT_SLEEP_SLICE_MS 100   // a throttled round checks for a stop request this often
+#define TSDB_COMPACT_STOP_WAIT_MS   5000  // a stopped round that runs longer than this is reported
+
 typedef struct {
   STsdb  *pTsdb;
-  STsdbFS fs;
+  STsdbFS fs;  // referenced snapshot of the file system
+
+  int64_t commitID;
+  int8_t  force;
+  int32_t minutes;
+  int8_t  precision;
+  int32_t minRow;
+  int32_t maxRow;
+  int8_t  cmprAlg;
+
+  SArray *aFid;        // SArray<int32_t>, file sets to compact in this round
+  SArray *aCompacted;  // SArray<int32_t>, file sets compacted and swapped in
+
+  // rate limit
+  int64_t speed;  // bytes per second, 0 for no limit
+  int64_t startTime;
+  int64_t nWritten;
+
+  // tombstone data
+  SArray *aDelInfo;  // SArray<SDelInfo>, all records of the del file in (suid, uid) order
+  int32_t iDelInfo;
+  int32_t nDelInfo;  // records of current table start at iDelInfo
+
+  /* reader */
+  SDataFReader   *pReader;
+  STsdbDataIter2 *iterList;
+  STsdbDataIter2 *pIter;
+  SRBTree         rbt;  // SRBTree<STsdbDataIter2>
+
+  /* writer */
+  SDataFWriter *pWriter;
+  TABLEID       tbid;
+  int8_t        tbDropped;
+  SSkmInfo      skmTable;
+  SArray       *aBlockIdx;  // SArray<SBlockIdx>
+  SMapData      mDataBlk;   // SMapData<SDataBlk>
+  SArray       *aSttBlk;    // SArray<SSttBlk>
+  SBlockData    bData;
+  SBlockData    sData;
+  int8_t        merging;
+  SRowMerger    merger;
 } STsdbCompactor;
 
-int32_t tsdbCompact(STsdb *pTsdb) {
+static bool tsdbCompactShouldStop(STsdbCompactor *pCompactor) {
+  return atomic_load_8(&pCompactor->pTsdb->compactStop) != 0;
+}
+
+// a file set is busy if the commit this round follows, or any later one, has written into it
+static bool tsdbCompactFileSetIsBusy(STsdbCompactor *pCompactor, SDFileSet *pSet) {
+  if (pSet->pHeadF->commitID >= pCompactor->commitID) return true;
+  if (pSet->pDataF->commitID >= pCompactor->commitID) return true;
+  if (pSet->pSmaF->commitID >= pCompactor->commitID) return true;
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    if (pSet->aSttF[iStt]->commitID >= pCompactor->commitID) return true;
+  }
+  return false;
+}
+
+static bool tsdbCompactFileSetIsSame(SDFileSet *pSet1, SDFileSet *pSet2) {
+  if (pSet1->diskId.level != pSet2->diskId.level || pSet1->diskId.id != pSet2->diskId.id) return false;
+  if (pSet1->pHeadF->commitID != pSet2->pHeadF->commitID || pSet1->pHeadF->size != pSet2->pHeadF->size) return false;
+  if (pSet1->pDataF->commitID != pSet2->pDataF->commitID || pSet1->pDataF->size != pSet2->pDataF->size) return false;
+  if (pSet1->pSmaF->commitID != pSet2->pSmaF->commitID || pSet1->pSmaF->size != pSet2->pSmaF->size) return false;
+  if (pSet1->nSttF != pSet2->nSttF) return false;
+  for (int32_t iStt = 0; iStt < pSet1->nSttF; iStt++) {
+    if (pSet1->aSttF[iStt]->commitID != pSet2->aSttF[iStt]->commitID) return false;
+    if (pSet1->aSttF[iStt]->size != pSet2->aSttF[iStt]->size) return false;
+  }
+  return true;
+}
+
+static bool tsdbCompactFileSetHasDel(STsdbCompactor *pCompactor, SDFileSet *pSet) {
+  TSKEY minKey, maxKey;
+  tsdbFidKeyRange(pSet->fid, pCompactor->minutes, pCompactor->precision, &minKey, &maxKey);
+
+  for (int32_t iDelInfo = 0; iDelInfo < taosArrayGetSize(pCompactor->aDelInfo); iDelInfo++) {
+    SDelInfo *pDelInfo = (SDelInfo *)taosArrayGet(pCompactor->aDelInfo, iDelInfo);
+    if (pDelInfo->delData.sKey <= maxKey && pDelInfo->delData.eKey >= minKey) return true;
+  }
+  return false;
+}
+
+static int32_t tsdbCompactFileSetIsFragmented(STsdbCompactor *pCompactor, SDFileSet *pSet, bool *fragmented) {
+  int32_t       code = 0;
+  int32_t       lino = 0;
+  STsdb        *pTsdb = pCompactor->pTsdb;
+  SDataFReader *pReader = NULL;
+  SArray       *aBlockIdx = NULL;
+  SMapData      mDataBlk = {0};
+  int64_t       nBlock = 0;
+  int64_t       nBlockIdeal = 0;
+
+  *fragmented = false;
+
+  if ((aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbDataFReaderOpen(&pReader, pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbReadBlockIdx(pReader, aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t iBlockIdx = 0; iBlockIdx < taosArrayGetSize(aBlockIdx); iBlockIdx++) {
+    code = tsdbReadDataBlk(pReader, (SBlockIdx *)taosArrayGet(aBlockIdx, iBlockIdx), &mDataBlk);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (mDataBlk.nItem <= 1) continue;
+
+    int64_t nRow = 0;
+    for (int32_t iDataBlk = 0; iDataBlk < mDataBlk.nItem; iDataBlk++) {
+      SDataBlk dataBlk;
+      tMapDataGetItemByIdx(&mDataBlk, iDataBlk, &dataBlk, tGetDataBlk);
+      nRow += dataBlk.nRow;
+    }
+
+    nBlock += mDataBlk.nItem;
+    nBlockIdeal += (nRow + pCompactor->maxRow - 1) / pCompactor->maxRow;
+  }
+
+  *fragmented = (nBlock > 1) && (nBlock >= nBlockIdeal * TSDB_COMPACT_FRAG_RATIO);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code),
+              pSet->fid);
+  }
+  tMapDataClear(&mDataBlk);
+  taosArrayDestroy(aBlockIdx);
+  tsdbDataFReaderClose(&pReader);
+  return code;
+}
+
+static int32_t tsdbCompactPickFileSets(STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdb  *pTsdb = pCompactor->pTsdb;
+  int32_t nSet = taosArrayGetSize(pCompactor->fs.aDFileSet);
+
+  // forced, or deletes to apply: every file set that is not busy, so the del file can be purged
+  for (int32_t iSet = 0; iSet < nSet; iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pCompactor->fs.aDFileSet, iSet);
+
+    if (tsdbCompactFileSetIsBusy(pCompactor, pSet)) continue;
+    if (!pCompactor->force && !tsdbCompactFileSetHasDel(pCompactor, pSet)) continue;
+
+    if (taosArrayPush(pCompactor->aFid, &pSet->fid) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+  if (pCompactor->force || taosArrayGetSize(pCompactor->aFid) > 0 || nSet == 0) goto _exit;
+
+  // otherwise one file set per round, round robin from where the last round stopped
+  int32_t iStart = taosArraySearchIdx(pCompactor->fs.aDFileSet, &(SDFileSet){.fid = pTsdb->compactFid},
+                                      tDFileSetCmprFn, TD_GT);
+  if (iStart < 0) iStart = 0;
+
+  int32_t nProbe = 0;
+  for (int32_t i = 0; i < nSet; i++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pCompactor->fs.aDFileSet, (iStart + i) % nSet);
+    bool       pick = false;
+
+    if (tsdbCompactFileSetIsBusy(pCompactor, pSet)) continue;
+
+    if (pSet->nSttF >= tsTsdbCompactSttTrigger) {
+      pick = true;
+    } else if (nProbe < TSDB_COMPACT_PROBE_FSET) {
+      nProbe++;
+      code = tsdbCompactFileSetIsFragmented(pCompactor, pSet, &pick);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    pTsdb->compactFid = pSet->fid;
+    if (pick) {
+      if (taosArrayPush(pCompactor->aFid, &pSet->fid) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+      break;
+    }
+
+    if (nProbe >= TSDB_COMPACT_PROBE_FSET) break;
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static void tsdbCompactThrottle(STsdbCompactor *pCompactor) {
+  if (pCompactor->speed <= 0) return;
+
+  SDataFWriter *pWriter = pCompactor->pWriter;
+  int64_t       nWritten = pCompactor->nWritten + pWriter->fData.size + pWriter->fSma.size + pWriter->fStt[0].size;
+  int64_t       elapsed = taosGetTimestampMs() - pCompactor->startTime;
+  int64_t       expected = nWritten * 1000 / pCompactor->speed;
+
+  // sleep in slices, so that a stop request is seen
+  while (expected > elapsed && !tsdbCompactShouldStop(pCompactor)) {
+    taosMsleep(TMIN(expected - elapsed, TSDB_COMPACT_SLEEP_SLICE_MS));
+    elapsed = taosGetTimestampMs() - pCompactor->startTime;
+  }
+}
+
+static int32_t tsdbCompactWriteDataBlock(STsdbCompactor *pCompactor) {
+  int32_t code =
+      tsdbWriteDataBlock(pCompactor->pWriter, &pCompactor->bData, &pCompactor->mDataBlk, pCompactor->cmprAlg);
+  if (code == 0) tsdbCompactThrottle(pCompactor);
+  return code;
+}
+
+static int32_t tsdbCompactWriteSttBlock(STsdbCompactor *pCompactor) {
+  int32_t code = tsdbWriteSttBlock(pCompactor->pWriter, &pCompactor->sData, pCompactor->aSttBlk, pCompactor->cmprAlg);
+  if (code == 0) tsdbCompactThrottle(pCompactor);
+  return code;
+}
+
+static int32_t tsdbCompactAppendRow(STsdbCompactor *pCompactor, TSDBROW *pRow) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  code = tBlockDataAppendRow(&pCompactor->bData, pRow, pCompactor->skmTable.pTSchema, pCompactor->tbid.uid);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (pCompactor->bData.nRow >= pCompactor->maxRow) {
+    code = tsdbCompactWriteDataBlock(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactFlushMerger(STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STSRow *pTSRow = NULL;
+
+  if (!pCompactor->merging) return code;
+
+  code = tRowMergerGetRow(&pCompactor->merger, &pTSRow);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  TSDBROW row = tsdbRowFromTSRow(pCompactor->merger.version, pTSRow);
+  code = tsdbCompactAppendRow(pCompactor, &row);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  taosMemoryFree(pTSRow);
+  tRowMergerClear(&pCompactor->merger);
+  pCompactor->merging = 0;
+  return code;
+}
+
+static bool tsdbCompactRowIsDeleted(STsdbCompactor *pCompactor, TSDBROW *pRow) {
+  TSDBKEY key = TSDBROW_KEY(pRow);
+
+  for (int32_t iDelInfo = pCompactor->iDelInfo; iDelInfo < pCompactor->iDelInfo + pCompactor->nDelInfo; iDelInfo++) {
+    SDelData *pDelData = &((SDelInfo *)taosArrayGet(pCompactor->aDelInfo, iDelInfo))->delData;
+    if (key.ts >= pDelData->sKey && key.ts <= pDelData->eKey && key.version <= pDelData->version) return true;
+  }
+  return false;
+}
+
+// whether the next row in key order has the same key as the current one, either in the current iterator's block
+// or at the head of the other iterators; a miss only leaves a duplicate that queries merge anyway
+static bool tsdbCompactHasDupRow(STsdbCompactor *pCompactor, SRowInfo *pRowInfo) {
+  STsdbDataIter2 *pIter = pCompactor->pIter;
+  TSKEY           ts = TSDBROW_TS(&pRowInfo->row);
+  SBlockData     *pBlockData;
+  int32_t         iRow;
+
+  if (pIter->type == TSDB_DATA_FILE_DATA_ITER) {
+    pBlockData = &pIter->dIter.bData;
+    iRow = pIter->dIter.iRow;
+  } else {
+    pBlockData = &pIter->sIter.bData;
+    iRow = pIter->sIter.iRow;
+  }
+
+  if (iRow < pBlockData->nRow && pBlockData->aTSKEY[iRow] == ts &&
+      (pBlockData->uid ? pBlockData->uid : pBlockData->aUid[iRow]) == pRowInfo->uid) {
+    return true;
+  }
+
+  SRBTreeNode *pNode = tRBTreeMin(&pCompactor->rbt);
+  if (pNode) {
+    SRowInfo *pNextInfo = &TSDB_RBTN_TO_DATA_ITER(pNode)->rowInfo;
+    if (pNextInfo->uid == pRowInfo->uid && TSDBROW_TS(&pNextInfo->row) == ts) return true;
+  }
+
+  return false;
+}
+
+static int32_t tsdbCompactTableDataStart(STsdbCompactor *pCompactor, TABLEID *pId) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  SMeta    *pMeta = pCompactor->pTsdb->pVnode->pMeta;
+  SMetaInfo info;
+
+  if (pId) {
+    pCompactor->tbid = *pId;
+  } else {
+    pCompactor->tbid = (TABLEID){INT64_MAX, INT64_MAX};
+  }
+  pCompactor->tbDropped = 0;
+
+  if (pId) {
+    // rows of dropped tables are not copied
+    if (metaGetInfo(pMeta, pId->uid, &info, NULL) != 0) {
+      pCompactor->tbDropped = 1;
+      goto _exit;
+    }
+
+    code = tsdbUpdateTableSchema(pMeta, pId->suid, pId->uid, &pCompactor->skmTable);
+    if (code == TSDB_CODE_NOT_FOUND) {
+      code = 0;
+      pCompactor->tbDropped = 1;
+      goto _exit;
+    }
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    tMapDataReset(&pCompactor->mDataBlk);
+
+    code = tBlockDataInit(&pCompactor->bData, pId, pCompactor->skmTable.pTSchema, NULL, 0);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    // tombstone data of the table
+    pCompactor->iDelInfo += pCompactor->nDelInfo;
+    pCompactor->nDelInfo = 0;
+    while (pCompactor->iDelInfo < taosArrayGetSize(pCompactor->aDelInfo)) {
+      SDelInfo *pDelInfo = (SDelInfo *)taosArrayGet(pCompactor->aDelInfo, pCompactor->iDelInfo);
+      if (tTABLEIDCmprFn(pDelInfo, pId) >= 0) break;
+      pCompactor->iDelInfo++;
+    }
+    while (pCompactor->iDelInfo + pCompactor->nDelInfo < taosArrayGetSize(pCompactor->aDelInfo)) {
+      SDelInfo *pDelInfo =
+          (SDelInfo *)taosArrayGet(pCompactor->aDelInfo, pCompactor->iDelInfo + pCompactor->nDelInfo);
+      if (tTABLEIDCmprFn(pDelInfo, pId) != 0) break;
+      pCompactor->nDelInfo++;
+    }
+  }
+
+  if (!TABLE_SAME_SCHEMA(pCompactor->tbid.suid, pCompactor->tbid.uid, pCompactor->sData.suid,
+                         pCompactor->sData.uid)) {
+    if (pCompactor->sData.nRow > 0) {
+      code = tsdbCompactWriteSttBlock(pCompactor);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    if (pId) {
+      TABLEID id = {.suid = pCompactor->tbid.suid, .uid = pCompactor->tbid.suid ? 0 : pCompactor->tbid.uid};
+      code = tBlockDataInit(&pCompactor->sData, &id, pCompactor->skmTable.pTSchema, NULL, 0);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactTableDataEnd(STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  if (pCompactor->tbDropped) goto _exit;
+
+  code = tsdbCompactFlushMerger(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (pCompactor->bData.nRow > 0) {
+    if (pCompactor->bData.nRow < pCompactor->minRow) {
+      ASSERT(TABLE_SAME_SCHEMA(pCompactor->sData.suid, pCompactor->sData.uid, pCompactor->tbid.suid,
+                               pCompactor->tbid.uid));
+      for (int32_t iRow = 0; iRow < pCompactor->bData.nRow; iRow++) {
+        code = tBlockDataAppendRow(&pCompactor->sData, &tsdbRowFromBlockData(&pCompactor->bData, iRow), NULL,
+                                   pCompactor->tbid.uid);
+        TSDB_CHECK_CODE(code, lino, _exit);
+
+        if (pCompactor->sData.nRow >= pCompactor->maxRow) {
+          code = tsdbCompactWriteSttBlock(pCompactor);
+          TSDB_CHECK_CODE(code, lino, _exit);
+        }
+      }
+
+      tBlockDataClear(&pCompactor->bData);
+    } else {
+      code = tsdbCompactWriteDataBlock(pCompactor);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+  if (pCompactor->mDataBlk.nItem) {
+    SBlockIdx *pBlockIdx = taosArrayReserve(pCompactor->aBlockIdx, 1);
+    if (pBlockIdx == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    pBlockIdx->suid = pCompactor->tbid.suid;
+    pBlockIdx->uid = pCompactor->tbid.uid;
+
+    code = tsdbWriteDataBlk(pCompactor->pWriter, &pCompactor->mDataBlk, pBlockIdx);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactTableData(STsdbCompactor *pCompactor, SRowInfo *pRowInfo) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  // switch to new table if need
+  if (pRowInfo == NULL || pRowInfo->uid != pCompactor->tbid.uid) {
+    if (pCompactor->tbid.uid) {
+      code = tsdbCompactTableDataEnd(pCompactor);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbCompactTableDataStart(pCompactor, (TABLEID *)pRowInfo);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (pRowInfo == NULL || pCompactor->tbDropped) goto _exit;
+  if (tsdbCompactRowIsDeleted(pCompactor, &pRowInfo->row)) goto _exit;
+
+  // versions of the same key come in ascending order, fold them into one row
+  if (pCompactor->merging) {
+    SColVal *pColVal = (SColVal *)taosArrayGet(pCompactor->merger.pArray, 0);
+    if (pColVal->value.val == TSDBROW_TS(&pRowInfo->row)) {
+      if (TSDBROW_VERSION(&pRowInfo->row) != pCompactor->merger.version) {
+        code = tRowMerge(&pCompactor->merger, &pRowInfo->row);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+      goto _exit;
+    }
+
+    code = tsdbCompactFlushMerger(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (tsdbCompactHasDupRow(pCompactor, pRowInfo)) {
+    code = tRowMergerInit(&pCompactor->merger, &pRowInfo->row, pCompactor->skmTable.pTSchema);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    pCompactor->merging = 1;
+  } else {
+    code = tsdbCompactAppendRow(pCompactor, &pRowInfo->row);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactNextRow(STsdbCompactor *pCompactor, SRowInfo **ppRowInfo) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  if (pCompactor->pIter) {
+    code = tsdbDataIterNext2(pCompactor->pIter, NULL);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pCompactor->pIter->rowInfo.suid == 0 && pCompactor->pIter->rowInfo.uid == 0) {
+      pCompactor->pIter = NULL;
+    } else {
+      SRBTreeNode *pNode = tRBTreeMin(&pCompactor->rbt);
+      if (pNode && tsdbDataIterCmprFn(&pCompactor->pIter->rbtn, pNode) > 0) {
+        tRBTreePut(&pCompactor->rbt, &pCompactor->pIter->rbtn);
+        pCompactor->pIter = NULL;
+      }
+    }
+  }
+
+  if (pCompactor->pIter == NULL) {
+    SRBTreeNode *pNode = tRBTreeMin(&pCompactor->rbt);
+    if (pNode) {
+      tRBTreeDrop(&pCompactor->rbt, pNode);
+      pCompactor->pIter = TSDB_RBTN_TO_DATA_ITER(pNode);
+    }
+  }
+
+  *ppRowInfo = pCompactor->pIter ? &pCompactor->pIter->rowInfo : NULL;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactAddIter(STsdbCompactor *pCompactor, STsdbDataIter2 *pIter) {
+  int32_t code = 0;
+
+  if (pIter == NULL) return code;
+
+  pIter->next = pCompactor->iterList;
+  pCompactor->iterList = pIter;
+
+  code = tsdbDataIterNext2(pIter, NULL);
+  if (code) return code;
+
+  if (pIter->rowInfo.suid || pIter->rowInfo.uid) {
+    tRBTreePut(&pCompactor->rbt, &pIter->rbtn);
+  }
+
+  return code;
+}
+
+static void tsdbCompactFileSetClear(STsdbCompactor *pCompactor) {
+  while (pCompactor->iterList) {
+    STsdbDataIter2 *pIter = pCompactor->iterList;
+    pCompactor->iterList = pIter->next;
+    tsdbCloseDataIter2(pIter);
+  }
+  pCompactor->pIter = NULL;
+  tsdbDataFReaderClose(&pCompactor->pReader);
+
+  if (pCompactor->merging) {
+    tRowMergerClear(&pCompactor->merger);
+    pCompactor->merging = 0;
+  }
+}
+
+static void tsdbCompactRemoveFileSet(STsdb *pTsdb, SDFileSet *pSet) {
+  char fname[TSDB_FILENAME_LEN];
+
+  tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[0], fname);
+  (void)taosRemoveFile(fname);
+}
+
+// swap the new file set in, or drop the file set if pNewSet is NULL, if nothing else changed the file set since the
+// snapshot was taken
+static int32_t tsdbCompactCommitFileSet(STsdbCompactor *pCompactor, SDFileSet *pSet, SDFileSet *pNewSet,
+                                        bool *committed) {
   int32_t code = 0;
-  // TODO
+  int32_t lino = 0;
+  STsdb  *pTsdb = pCompactor->pTsdb;
+  STsdbFS fs = {0};
+
+  *committed = false;
+
+  tsem_wait(&pTsdb->pVnode->canCommit);
+
+  code = tsdbFSCopy(pTsdb, &fs);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  int32_t idx = taosArraySearchIdx(fs.aDFileSet, &(SDFileSet){.fid = pSet->fid}, tDFileSetCmprFn, TD_EQ);
+  if (idx < 0 || !tsdbCompactFileSetIsSame(taosArrayGet(fs.aDFileSet, idx), pSet)) goto _exit;
+
+  if (pNewSet) {
+    code = tsdbFSUpsertFSet(&fs, pNewSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  } else {
+    SDFileSet *pCurSet = (SDFileSet *)taosArrayGet(fs.aDFileSet, idx);
+    taosMemoryFree(pCurSet->pHeadF);
+    taosMemoryFree(pCurSet->pDataF);
+    taosMemoryFree(pCurSet->pSmaF);
+    for (int32_t iStt = 0; iStt < pCurSet->nSttF; iStt++) {
+      taosMemoryFree(pCurSet->aSttF[iStt]);
+    }
+    taosArrayRemove(fs.aDFileSet, idx);
+  }
+
+  code = tsdbFSPrepareCommit(pTsdb, &fs);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosThreadRwlockWrlock(&pTsdb->rwLock);
+  code = tsdbFSCommit(pTsdb);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  *committed = true;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino,
+              tstrerror(code), pSet->fid);
+  }
+  tsdbFSDestroy(&fs);
+  tsem_post(&pTsdb->pVnode->canCommit);
   return code;
 }
+
+static int32_t tsdbCompactFileSet(STsdbCompactor *pCompactor, SDFileSet *pSet) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  STsdb    *pTsdb = pCompactor->pTsdb;
+  bool      committed = false;
+  SHeadFile fHead = {.commitID = pCompactor->commitID};
+  SDataFile fData = {.commitID = pCompactor->commitID};
+  SSmaFile  fSma = {.commitID = pCompactor->commitID};
+  SSttFile  fStt = {.commitID = pCompactor->commitID};
+  SDFileSet wSet = {.diskId = pSet->diskId,
+                    .fid = pSet->fid,
+                    .pHeadF = &fHead,
+                    .pDataF = &fData,
+                    .pSmaF = &fSma,
+                    .nSttF = 1,
+                    .aSttF = {&fStt}};
+
+  // reader
+  tRBTreeCreate(&pCompactor->rbt, tsdbDataIterCmprFn);
+  pCompactor->iterList = NULL;
+  pCompactor->pIter = NULL;
+
+  code = tsdbDataFReaderOpen(&pCompactor->pReader, pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  STsdbDataIter2 *pIter = NULL;
+  code = tsdbOpenDataFileDataIter(pCompactor->pReader, &pIter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  code = tsdbCompactAddIter(pCompactor, pIter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    code = tsdbOpenSttFileDataIter(pCompactor->pReader, iStt, &pIter);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    code = tsdbCompactAddIter(pCompactor, pIter);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // writer
+  code = tsdbDataFWriterOpen(&pCompactor->pWriter, pTsdb, &wSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  pCompactor->tbid = (TABLEID){0};
+  pCompactor->iDelInfo = 0;
+  pCompactor->nDelInfo = 0;
+  taosArrayClear(pCompactor->aBlockIdx);
+  taosArrayClear(pCompactor->aSttBlk);
+  tMapDataReset(&pCompactor->mDataBlk);
+  tBlockDataReset(&pCompactor->bData);
+  tBlockDataReset(&pCompactor->sData);
+
+  // merge all rows, ending with a NULL row
+  SRowInfo *pRowInfo = NULL;
+  code = tsdbCompactNextRow(pCompactor, &pRowInfo);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  for (;;) {
+    code = tsdbCompactTableData(pCompactor, pRowInfo);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pRowInfo == NULL) break;
+
+    if (tsdbCompactShouldStop(pCompactor)) {
+      code = TSDB_CODE_VND_STOPPED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbCompactNextRow(pCompactor, &pRowInfo);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (pCompactor->sData.nRow > 0) {
+    code = tsdbCompactWriteSttBlock(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // no row is left, the file set is dropped rather than swapped for empty files
+  if (taosArrayGetSize(pCompactor->aBlockIdx) == 0 && taosArrayGetSize(pCompactor->aSttBlk) == 0) {
+    tsdbDataFWriterClose(&pCompactor->pWriter, 0);
+    tsdbCompactRemoveFileSet(pTsdb, &wSet);
+    tsdbCompactFileSetClear(pCompactor);
+
+    code = tsdbCompactCommitFileSet(pCompactor, pSet, NULL, &committed);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (committed && taosArrayPush(pCompactor->aCompacted, &pSet->fid) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    goto _exit;
+  }
+
+  // do file-level updates
+  code = tsdbWriteSttBlk(pCompactor->pWriter, pCompactor->aSttBlk);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbWriteBlockIdx(pCompactor->pWriter, pCompactor->aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbUpdateDFileSetHeader(pCompactor->pWriter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  fHead = pCompactor->pWriter->fHead;
+  fData = pCompactor->pWriter->fData;
+  fSma = pCompactor->pWriter->fSma;
+  fStt = pCompactor->pWriter->fStt[0];
+  pCompactor->nWritten += fData.size + fSma.size + fStt.size;
+
+  code = tsdbDataFWriterClose(&pCompactor->pWriter, 1);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tsdbCompactFileSetClear(pCompactor);
+
+  // swap
+  code = tsdbCompactCommitFileSet(pCompactor, pSet, &wSet, &committed);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (committed) {
+    if (taosArrayPush(pCompactor->aCompacted, &pSet->fid) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  } else {
+    tsdbCompactRemoveFileSet(pTsdb, &wSet);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino,
+              tstrerror(code), pSet->fid);
+    if (pCompactor->pWriter) {
+      tsdbDataFWriterClose(&pCompactor->pWriter, 0);
+    }
+    tsdbCompactFileSetClear(pCompactor);
+    if (!committed) {
+      tsdbCompactRemoveFileSet(pTsdb, &wSet);
+    }
+  } else {
+    tsdbInfo("vgId:%d, %s done, fid:%d nStt:%d committed:%d", TD_VID(pTsdb->pVnode), __func__, pSet->fid,
+             pSet->nSttF, committed);
+  }
+  return code;
+}
+
+// a delete record is dropped when every file set in its range has been rewritten without the rows it deletes
+static bool tsdbCompactDelIsApplied(STsdbCompactor *pCompactor, SDelData *pDelData) {
+  int32_t sFid = tsdbKeyFid(pDelData->sKey, pCompactor->minutes, pCompactor->precision);
+  int32_t eFid = tsdbKeyFid(pDelData->eKey, pCompactor->minutes, pCompactor->precision);
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pCompactor->fs.aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pCompactor->fs.aDFileSet, iSet);
+    if (pSet->fid < sFid || pSet->fid > eFid) continue;
+
+    bool compacted = false;
+    for (int32_t i = 0; i < taosArrayGetSize(pCompactor->aCompacted); i++) {
+      if (*(int32_t *)taosArrayGet(pCompactor->aCompacted, i) == pSet->fid) {
+        compacted = true;
+        break;
+      }
+    }
+    if (!compacted) return false;
+  }
+
+  return true;
+}
+
+static int32_t tsdbCompactDelFile(STsdbCompactor *pCompactor) {
+  int32_t      code = 0;
+  int32_t      lino = 0;
+  STsdb       *pTsdb = pCompactor->pTsdb;
+  SDelFWriter *pDelFWriter = NULL;
+  SArray      *aDelIdx = NULL;
+  SArray      *aDelData = NULL;
+  STsdbFS      fs = {0};
+  bool         locked = false;
+  bool         committed = false;
+  SDelFile     fDel = {.commitID = pCompactor->commitID};
+  int32_t      nDrop = 0;
+
+  if (pCompactor->fs.pDelFile == NULL || pCompactor->fs.pDelFile->commitID >= pCompactor->commitID) goto _exit;
+  if (taosArrayGetSize(pCompactor->aCompacted) == 0) goto _exit;
+
+  for (int32_t iDelInfo = 0; iDelInfo < taosArrayGetSize(pCompactor->aDelInfo); iDelInfo++) {
+    if (tsdbCompactDelIsApplied(pCompactor, &((SDelInfo *)taosArrayGet(pCompactor->aDelInfo, iDelInfo))->delData)) {
+      nDrop++;
+    }
+  }
+  if (nDrop == 0) goto _exit;
+
+  if ((aDelIdx = taosArrayInit(0, sizeof(SDelIdx))) == NULL ||
+      (aDelData = taosArrayInit(0, sizeof(SDelData))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbDelFWriterOpen(&pDelFWriter, &fDel, pTsdb);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t iDelInfo = 0; iDelInfo < taosArrayGetSize(pCompactor->aDelInfo);) {
+    SDelInfo *pDelInfo = (SDelInfo *)taosArrayGet(pCompactor->aDelInfo, iDelInfo);
+    SDelIdx   delIdx = {.suid = pDelInfo->suid, .uid = pDelInfo->uid};
+
+    taosArrayClear(aDelData);
+    for (; iDelInfo < taosArrayGetSize(pCompactor->aDelInfo); iDelInfo++) {
+      pDelInfo = (SDelInfo *)taosArrayGet(pCompactor->aDelInfo, iDelInfo);
+      if (pDelInfo->suid != delIdx.suid || pDelInfo->uid != delIdx.uid) break;
+      if (tsdbCompactDelIsApplied(pCompactor, &pDelInfo->delData)) continue;
+
+      if (taosArrayPush(aDelData, &pDelInfo->delData) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+    }
+
+    if (taosArrayGetSize(aDelData) == 0) continue;
+
+    code = tsdbWriteDelData(pDelFWriter, aDelData, &delIdx);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (taosArrayPush(aDelIdx, &delIdx) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+  code = tsdbWriteDelIdx(pDelFWriter, aDelIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbUpdateDelFileHdr(pDelFWriter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  fDel = pDelFWriter->fDel;
+
+  code = tsdbDelFWriterClose(&pDelFWriter, 1);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // swap, if neither the del file nor the compacted file sets changed meanwhile
+  tsem_wait(&pTsdb->pVnode->canCommit);
+  locked = true;
+
+  code = tsdbFSCopy(pTsdb, &fs);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (fs.pDelFile == NULL || fs.pDelFile->commitID != pCompactor->fs.pDelFile->commitID ||
+      fs.pDelFile->size != pCompactor->fs.pDelFile->size) {
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pCompactor->aCompacted); i++) {
+    int32_t    fid = *(int32_t *)taosArrayGet(pCompactor->aCompacted, i);
+    SDFileSet *pSet = taosArraySearch(fs.aDFileSet, &(SDFileSet){.fid = fid}, tDFileSetCmprFn, TD_EQ);
+    // a file set left without rows is dropped by the round
+    if (pSet && pSet->pHeadF->commitID != pCompactor->commitID) goto _exit;
+  }
+
+  code = tsdbFSUpsertDelFile(&fs, &fDel);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbFSPrepareCommit(pTsdb, &fs);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosThreadRwlockWrlock(&pTsdb->rwLock);
+  code = tsdbFSCommit(pTsdb);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  committed = true;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else if (nDrop) {
+    tsdbInfo("vgId:%d, %s done, dropped:%d committed:%d", TD_VID(pTsdb->pVnode), __func__, nDrop, committed);
+  }
+  if (locked) {
+    tsdbFSDestroy(&fs);
+    tsem_post(&pTsdb->pVnode->canCommit);
+  }
+  if (pDelFWriter) {
+    tsdbDelFWriterClose(&pDelFWriter, 0);
+  }
+  if (nDrop && !committed) {
+    char fname[TSDB_FILENAME_LEN];
+    tsdbDelFileName(pTsdb, &fDel, fname);
+    (void)taosRemoveFile(fname);
+  }
+  taosArrayDestroy(aDelData);
+  taosArrayDestroy(aDelIdx);
+  return code;
+}
+
+static int32_t tsdbCompactLoadDelInfo(STsdbCompactor *pCompactor) {
+  int32_t         code = 0;
+  int32_t         lino = 0;
+  STsdb          *pTsdb = pCompactor->pTsdb;
+  SDelFReader    *pDelFReader = NULL;
+  STsdbDataIter2 *pIter = NULL;
+
+  if (pCompactor->fs.pDelFile == NULL) goto _exit;
+
+  code = tsdbDelFReaderOpen(&pDelFReader, pCompactor->fs.pDelFile, pTsdb);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbOpenTombFileDataIter(pDelFReader, &pIter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  while (pIter) {
+    code = tsdbDataIterNext2(pIter, NULL);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pIter->delInfo.suid == 0 && pIter->delInfo.uid == 0) break;
+
+    if (taosArrayPush(pCompactor->aDelInfo, &pIter->delInfo) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  if (pIter) tsdbCloseDataIter2(pIter);
+  tsdbDelFReaderClose(&pDelFReader);
+  return code;
+}
+
+static int32_t tsdbCompactorOpen(STsdb *pTsdb, int64_t commitID, int8_t force, STsdbCompactor **ppCompactor) {
+  int32_t         code = 0;
+  int32_t         lino = 0;
+  STsdbCompactor *pCompactor = NULL;
+  SVnode         *pVnode = pTsdb->pVnode;
+
+  pCompactor = (STsdbCompactor *)taosMemoryCalloc(1, sizeof(*pCompactor));
+  if (pCompactor == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  pCompactor->pTsdb = pTsdb;
+  pCompactor->commitID = commitID;
+  pCompactor->force = force;
+  pCompactor->minutes = pTsdb->keepCfg.days;
+  pCompactor->precision = pTsdb->keepCfg.precision;
+  pCompactor->minRow = pVnode->config.tsdbCfg.minRows;
+  pCompactor->maxRow = pVnode->config.tsdbCfg.maxRows;
+  pCompactor->cmprAlg = pVnode->config.tsdbCfg.compression;
+  pCompactor->speed = (int64_t)tsTsdbCompactMaxSpeed * 1024 * 1024;
+  pCompactor->startTime = taosGetTimestampMs();
+
+  if ((pCompactor->aFid = taosArrayInit(0, sizeof(int32_t))) == NULL ||
+      (pCompactor->aCompacted = taosArrayInit(0, sizeof(int32_t))) == NULL ||
+      (pCompactor->aDelInfo = taosArrayInit(0, sizeof(SDelInfo))) == NULL ||
+      (pCompactor->aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx))) == NULL ||
+      (pCompactor->aSttBlk = taosArrayInit(0, sizeof(SSttBlk))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tBlockDataCreate(&pCompactor->bData);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tBlockDataCreate(&pCompactor->sData);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  code = tsdbFSRef(pTsdb, &pCompactor->fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCompactLoadDelInfo(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  *ppCompactor = pCompactor;
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static void tsdbCompactorClose(STsdbCompactor *pCompactor) {
+  if (pCompactor == NULL) return;
+
+  if (pCompactor->fs.aDFileSet) {
+    tsdbFSUnref(pCompactor->pTsdb, &pCompactor->fs);
+  }
+  tDestroyTSchema(pCompactor->skmTable.pTSchema);
+  tBlockDataDestroy(&pCompactor->sData, 1);
+  tBlockDataDestroy(&pCompactor->bData, 1);
+  tMapDataClear(&pCompactor->mDataBlk);
+  taosArrayDestroy(pCompactor->aSttBlk);
+  taosArrayDestroy(pCompactor->aBlockIdx);
+  taosArrayDestroy(pCompactor->aDelInfo);
+  taosArrayDestroy(pCompactor->aCompacted);
+  taosArrayDestroy(pCompactor->aFid);
+  taosMemoryFree(pCompactor);
+}
+
+// the caller owns compactRunning
+static int32_t tsdbCompactImpl(STsdb *pTsdb, int64_t commitID) {
+  int32_t         code = 0;
+  int32_t         lino = 0;
+  STsdbCompactor *pCompactor = NULL;
+
+  if (atomic_load_8(&pTsdb->compactStop)) goto _exit;
+
+  int8_t force = atomic_val_compare_exchange_8(&pTsdb->compactForce, 1, 0);
+  if (!force && tsTsdbCompactSttTrigger == 0) goto _exit;
+
+  code = tsdbCompactorOpen(pTsdb, commitID, force, &pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCompactPickFileSets(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pCompactor->aFid); i++) {
+    int32_t    fid = *(int32_t *)taosArrayGet(pCompactor->aFid, i);
+    SDFileSet *pSet = taosArraySearch(pCompactor->fs.aDFileSet, &(SDFileSet){.fid = fid}, tDFileSetCmprFn, TD_EQ);
+
+    if (tsdbCompactShouldStop(pCompactor)) {
+      code = TSDB_CODE_VND_STOPPED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbCompactFileSet(pCompactor, pSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbCompactDelFile(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, commit id:%" PRId64, TD_VID(pTsdb->pVnode), __func__, lino,
+              tstrerror(code), commitID);
+  } else if (pCompactor && taosArrayGetSize(pCompactor->aFid) > 0) {
+    tsdbInfo("vgId:%d, %s done, commit id:%" PRId64 " nFSet:%d compacted:%d", TD_VID(pTsdb->pVnode), __func__,
+             commitID, (int32_t)taosArrayGetSize(pCompactor->aFid), (int32_t)taosArrayGetSize(pCompactor->aCompacted));
+  }
+  tsdbCompactorClose(pCompactor);
+  return code;
+}
+
+/**
+ * @brief Run one compaction round after the commit with ID commitID finished.
+ *
+ * File sets are rewritten into fully merged, right-sized blocks with deleted rows and rows of dropped tables left
+ * out, and the new files, named after commitID, are swapped in only if no commit changed the file set meanwhile.
+ * Only one round runs on a tsdb at a time, a round requested while another is queued or running is skipped.
+ */
+int32_t tsdbCompact(STsdb *pTsdb, int64_t commitID) {
+  int32_t code = 0;
+
+  if (pTsdb == NULL) return code;
+  if (atomic_val_compare_exchange_8(&pTsdb->compactRunning, 0, 1) != 0) return code;
+
+  code = tsdbCompactImpl(pTsdb, commitID);
+  atomic_store_8(&pTsdb->compactRunning, 0);
+  return code;
+}
+
+typedef struct {
+  STsdb  *pTsdb;
+  int64_t commitID;
+} STsdbCompactTask;
+
+static int32_t tsdbCompactTask(void *arg) {
+  STsdbCompactTask *pTask = (STsdbCompactTask *)arg;
+
+  int32_t code = tsdbCompactImpl(pTask->pTsdb, pTask->commitID);
+  atomic_store_8(&pTask->pTsdb->compactRunning, 0);
+  taosMemoryFree(pTask);
+  return code;
+}
+
+// queue a compaction round on the compaction pool, the round counts as running from now until it ends
+int32_t tsdbScheduleCompact(STsdb *pTsdb, int64_t commitID) {
+  int32_t code = 0;
+
+  if (pTsdb == NULL) return code;
+  if (atomic_load_8(&pTsdb->compactStop)) return code;
+  if (atomic_val_compare_exchange_8(&pTsdb->compactRunning, 0, 1) != 0) return code;
+
+  STsdbCompactTask *pTask = taosMemoryMalloc(sizeof(*pTask));
+  if (pTask == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+  pTask->pTsdb = pTsdb;
+  pTask->commitID = commitID;
+
+  if (vnodeScheduleCompactTask(tsdbCompactTask, pTask) < 0) {
+    code = terrno;
+    taosMemoryFree(pTask);
+    goto _err;
+  }
+  return code;
+
+_err:
+  atomic_store_8(&pTsdb->compactRunning, 0);
+  tsdbError("vgId:%d, %s failed since %s, commit id:%" PRId64, TD_VID(pTsdb->pVnode), __func__, tstrerror(code),
+            commitID);
+  return code;
+}
+
+// compact every file set in the round that follows the next commit
+void tsdbRequestCompact(STsdb *pTsdb) {
+  if (pTsdb == NULL) return;
+  atomic_store_8(&pTsdb->compactForce, 1);
+}
+
+static bool tsdbCompactTaskIsOf(void *arg, void *param) { return ((STsdbCompactTask *)arg)->pTsdb == param; }
+
+/**
+ * @brief Stop the queued or running round, if any, and keep later rounds from starting.
+ *
+ * A round still queued behind rounds of other vnodes is taken off the pool. A running one gives up at the next row,
+ * block write, throttle slice or file set, so the wait is bounded by the time it takes to abandon one file set. The
+ * round references the tsdb, which can not be closed under it, so the wait is reported but not cut short.
+ */
+void tsdbStopCompact(STsdb *pTsdb) {
+  if (pTsdb == NULL) return;
+  atomic_store_8(&pTsdb->compactStop, 1);
+
+  STsdbCompactTask *pTask = vnodeCancelCompactTask(tsdbCompactTask, tsdbCompactTaskIsOf, pTsdb);
+  if (pTask) {
+    taosMemoryFree(pTask);
+    atomic_store_8(&pTsdb->compactRunning, 0);
+    tsdbDebug("vgId:%d, queued compaction round is cancelled", TD_VID(pTsdb->pVnode));
+    return;
+  }
+
+  int64_t startTime = taosGetTimestampMs();
+  int64_t reportTime = startTime + TSDB_COMPACT_STOP_WAIT_MS;
+  while (atomic_load_8(&pTsdb->compactRunning)) {
+    taosMsleep(1);
+    if (taosGetTimestampMs() >= reportTime) {
+      tsdbWarn("vgId:%d, compaction round not stopped after %" PRId64 " ms", TD_VID(pTsdb->pVnode),
+               taosGetTimestampMs() - startTime);
+      reportTime += TSDB_COMPACT_STOP_WAIT_MS;
+    }
+  }
+}
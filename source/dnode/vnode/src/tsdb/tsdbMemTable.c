@@ -30,7 +30,14 @@
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
 
+#define AB_MIN_CHUNK_ROWS 8
+#define AB_MAX_CHUNK_ROWS 4096
+#define AB_CHUNK_SIZE(n)  (sizeof(SMemAppendChunk) + (n) * (sizeof(TSKEY) + sizeof(int64_t) + sizeof(STSRow *)))
+
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey, int32_t flags);
+static void    tbDataAbMoveTo(STbData *pTbData, TSDBKEY *pKey, int8_t backward, SMemAppendChunk **ppChunk,
+                              int32_t *iRow);
+static void    tbDataIterPick(STbDataIter *pIter);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
 static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                        SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock, SSubmitBlkRsp *pRsp);
@@ -238,11 +245,7 @@ void *tsdbTbDataIterDestroy(STbDataIter *pIter) {
 
 void tsdbTbDataIterOpen(STbData *pTbData, TSDBKEY *pFrom, int8_t backward, STbDataIter *pIter) {
   SMemSkipListNode *pos[SL_MAX_LEVEL];
-  SMemSkipListNode *pHead;
-  SMemSkipListNode *pTail;
 
-  pHead = pTbData->sl.pHead;
-  pTail = pTbData->sl.pTail;
   pIter->pTbData = pTbData;
   pIter->backward = backward;
   pIter->pRow = NULL;
@@ -251,8 +254,12 @@ void tsdbTbDataIterOpen(STbData *pTbData, TSDBKEY *pFrom, int8_t backward, STbDa
     // create from head or tail
     if (backward) {
       pIter->pNode = SL_GET_NODE_BACKWARD(pTbData->sl.pTail, 0);
+      pIter->pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->ab.pTail);
+      pIter->iRow = pIter->pChunk ? atomic_load_32(&pIter->pChunk->nRow) - 1 : -1;
     } else {
       pIter->pNode = SL_GET_NODE_FORWARD(pTbData->sl.pHead, 0);
+      pIter->pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->ab.pHead);
+      pIter->iRow = 0;
     }
   } else {
     // create from a key
@@ -263,36 +270,82 @@ void tsdbTbDataIterOpen(STbData *pTbData, TSDBKEY *pFrom, int8_t backward, STbDa
       tbDataMovePosTo(pTbData, pos, pFrom, 0);
       pIter->pNode = SL_GET_NODE_FORWARD(pos[0], 0);
     }
+    tbDataAbMoveTo(pTbData, pFrom, backward, &pIter->pChunk, &pIter->iRow);
   }
+
+  tbDataIterPick(pIter);
 }
 
 bool tsdbTbDataIterNext(STbDataIter *pIter) {
-  pIter->pRow = NULL;
-  if (pIter->backward) {
-    ASSERT(pIter->pNode != pIter->pTbData->sl.pTail);
-
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return false;
-    }
+  if (pIter->pRow == NULL) {
+    return false;
+  }
 
+  if (pIter->fromAb) {
+    pIter->iRow += pIter->backward ? -1 : 1;
+  } else if (pIter->backward) {
     pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return false;
-    }
   } else {
-    ASSERT(pIter->pNode != pIter->pTbData->sl.pHead);
+    pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
+  }
+
+  tbDataIterPick(pIter);
 
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
+  return pIter->pRow != NULL;
+}
+
+// merge the skip list and the append buffer, both are in key order
+static void tbDataIterPick(STbDataIter *pIter) {
+  STbData          *pTbData = pIter->pTbData;
+  SMemSkipListNode *pNode = NULL;
+  SMemAppendChunk  *pChunk = pIter->pChunk;
+  bool              hasAb = false;
+
+  pIter->pRow = NULL;
+
+  if (pIter->backward) {
+    if (pIter->pNode != pTbData->sl.pHead) pNode = pIter->pNode;
+
+    while (pChunk && pIter->iRow < 0) {
+      pChunk = pChunk->pPrev;
+      pIter->iRow = pChunk ? pChunk->nRow - 1 : -1;
     }
+    pIter->pChunk = pChunk;
+    hasAb = (pChunk != NULL);
+  } else {
+    if (pIter->pNode != pTbData->sl.pTail) pNode = pIter->pNode;
 
-    pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
+    if (pChunk && pIter->iRow >= pChunk->capacity) {
+      SMemAppendChunk *pNext = (SMemAppendChunk *)atomic_load_ptr(&pChunk->pNext);
+      if (pNext) {
+        pIter->pChunk = pChunk = pNext;
+        pIter->iRow = 0;
+      }
     }
+    hasAb = (pChunk != NULL && pIter->iRow < atomic_load_32(&pChunk->nRow));
+  }
+
+  if (pNode && hasAb) {
+    TSDBKEY nodeKey = {.version = pNode->version, .ts = pNode->pTSRow->ts};
+    TSDBKEY abKey = {.version = pChunk->aVersion[pIter->iRow], .ts = pChunk->aTSKEY[pIter->iRow]};
+    int32_t c = tsdbKeyCmprFn(&abKey, &nodeKey);
+    pIter->fromAb = pIter->backward ? (c > 0) : (c < 0);
+  } else if (hasAb) {
+    pIter->fromAb = 1;
+  } else if (pNode) {
+    pIter->fromAb = 0;
+  } else {
+    return;
   }
 
-  return true;
+  pIter->pRow = &pIter->row;
+  if (pIter->fromAb) {
+    pIter->row.version = pChunk->aVersion[pIter->iRow];
+    pIter->row.pTSRow = pChunk->aTSRow[pIter->iRow];
+  } else {
+    pIter->row.version = pNode->version;
+    pIter->row.pTSRow = pNode->pTSRow;
+  }
 }
 
 static int32_t tsdbMemTableRehash(SMemTable *pMemTable) {
@@ -350,6 +403,9 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   pTbData->maxKey = TSKEY_MIN;
   pTbData->pHead = NULL;
   pTbData->pTail = NULL;
+  pTbData->ab.size = 0;
+  pTbData->ab.pHead = NULL;
+  pTbData->ab.pTail = NULL;
   pTbData->sl.seed = taosRand();
   pTbData->sl.size = 0;
   pTbData->sl.maxLevel = maxLevel;
@@ -462,6 +518,125 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
   }
 }
 
+// index of the first row in the chunk whose key compared to pKey is not less than c
+static int32_t tbDataAbChunkBound(SMemAppendChunk *pChunk, int32_t nRow, TSDBKEY *pKey, int32_t c) {
+  int32_t lo = 0;
+  int32_t hi = nRow;
+
+  while (lo < hi) {
+    int32_t mid = (lo + hi) >> 1;
+    TSDBKEY key = {.version = pChunk->aVersion[mid], .ts = pChunk->aTSKEY[mid]};
+    if (tsdbKeyCmprFn(&key, pKey) < c) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+// position at the first row not less than pKey, or the last row not greater than it if backward
+static void tbDataAbMoveTo(STbData *pTbData, TSDBKEY *pKey, int8_t backward, SMemAppendChunk **ppChunk,
+                           int32_t *iRow) {
+  SMemAppendChunk *pChunk;
+
+  if (backward) {
+    pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->ab.pTail);
+    while (pChunk) {
+      int32_t idx = tbDataAbChunkBound(pChunk, atomic_load_32(&pChunk->nRow), pKey, 1) - 1;
+      if (idx >= 0) {
+        *ppChunk = pChunk;
+        *iRow = idx;
+        return;
+      }
+      pChunk = pChunk->pPrev;
+    }
+
+    *ppChunk = NULL;
+    *iRow = -1;
+  } else {
+    pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->ab.pHead);
+    while (pChunk) {
+      int32_t nRow = atomic_load_32(&pChunk->nRow);
+      int32_t idx = tbDataAbChunkBound(pChunk, nRow, pKey, 0);
+
+      SMemAppendChunk *pNext = (SMemAppendChunk *)atomic_load_ptr(&pChunk->pNext);
+      if (idx < nRow || pNext == NULL) {
+        *ppChunk = pChunk;
+        *iRow = idx;
+        return;
+      }
+      pChunk = pNext;
+    }
+
+    *ppChunk = NULL;
+    *iRow = 0;
+  }
+}
+
+static FORCE_INLINE bool tbDataCanAppend(STbData *pTbData, TSDBKEY *pKey) {
+  SMemAppendChunk *pChunk = pTbData->ab.pTail;
+  if (pChunk == NULL) {
+    return true;
+  }
+
+  TSDBKEY lastKey = {.version = pChunk->aVersion[pChunk->nRow - 1], .ts = pChunk->aTSKEY[pChunk->nRow - 1]};
+  return tsdbKeyCmprFn(pKey, &lastKey) >= 0;
+}
+
+static int32_t tbDataAppend(SMemTable *pMemTable, STbData *pTbData, int64_t version, STSRow *pRow) {
+  int32_t          code = 0;
+  SVBufPool       *pPool = pMemTable->pTsdb->pVnode->inUse;
+  SMemAppendChunk *pChunk = pTbData->ab.pTail;
+  STSRow          *pTSRow;
+
+  pTSRow = (STSRow *)vnodeBufPoolMallocAligned(pPool, pRow->len);
+  if (pTSRow == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  memcpy(pTSRow, pRow, pRow->len);
+
+  if (pChunk && pChunk->nRow < pChunk->capacity) {
+    int32_t iRow = pChunk->nRow;
+    pChunk->aTSKEY[iRow] = pTSRow->ts;
+    pChunk->aVersion[iRow] = version;
+    pChunk->aTSRow[iRow] = pTSRow;
+    atomic_store_32(&pChunk->nRow, iRow + 1);
+  } else {
+    // chunks grow with the table, so tables with a few rows do not waste the buffer
+    int32_t          capacity = pChunk ? TMIN(pChunk->capacity << 1, AB_MAX_CHUNK_ROWS) : AB_MIN_CHUNK_ROWS;
+    SMemAppendChunk *pNew = (SMemAppendChunk *)vnodeBufPoolMallocAligned(pPool, AB_CHUNK_SIZE(capacity));
+    if (pNew == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    pNew->capacity = capacity;
+    pNew->nRow = 1;
+    pNew->pPrev = pChunk;
+    pNew->pNext = NULL;
+    pNew->aTSKEY = (TSKEY *)&pNew[1];
+    pNew->aVersion = (int64_t *)&pNew->aTSKEY[capacity];
+    pNew->aTSRow = (STSRow **)&pNew->aVersion[capacity];
+    pNew->aTSKEY[0] = pTSRow->ts;
+    pNew->aVersion[0] = version;
+    pNew->aTSRow[0] = pTSRow;
+
+    if (pChunk) {
+      atomic_store_ptr(&pChunk->pNext, pNew);
+    } else {
+      atomic_store_ptr(&pTbData->ab.pHead, pNew);
+    }
+    atomic_store_ptr(&pTbData->ab.pTail, pNew);
+  }
+
+  pTbData->ab.size++;
+
+_exit:
+  return code;
+}
+
 static FORCE_INLINE int8_t tsdbMemSkipListRandLevel(SMemSkipList *pSl) {
   int8_t level = 1;
   int8_t tlevel = TMIN(pSl->maxLevel, pSl->level + 1);
@@ -548,43 +723,62 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
 
   tInitSubmitBlkIter(pMsgIter, pBlock, &blkIter);
 
-  // backward put first data
   row.pTSRow = tGetSubmitBlkNext(&blkIter);
   if (row.pTSRow == NULL) return code;
 
   key.ts = row.pTSRow->ts;
-  nRow++;
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  code = tbDataDoPut(pMemTable, pTbData, pos, version, row.pTSRow, 0);
-  if (code) {
-    goto _err;
-  }
-
   pTbData->minKey = TMIN(pTbData->minKey, key.ts);
 
-  pLastRow = row.pTSRow;
-
-  // forward put rest data
-  row.pTSRow = tGetSubmitBlkNext(&blkIter);
-  if (row.pTSRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+  // rows of a block come in key order, only a leading run older than the appended rows goes to the skip list
+  if (!tbDataCanAppend(pTbData, &key)) {
+    // backward put first data
+    nRow++;
+    tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
+    code = tbDataDoPut(pMemTable, pTbData, pos, version, row.pTSRow, 0);
+    if (code) {
+      goto _err;
     }
-    do {
-      key.ts = row.pTSRow->ts;
-      nRow++;
-      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
-        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
-      }
-      code = tbDataDoPut(pMemTable, pTbData, pos, version, row.pTSRow, 1);
-      if (code) {
-        goto _err;
+
+    pLastRow = row.pTSRow;
+
+    // forward put rest out-of-order data
+    row.pTSRow = tGetSubmitBlkNext(&blkIter);
+    if (row.pTSRow) {
+      for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+        pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
       }
+      do {
+        key.ts = row.pTSRow->ts;
+        if (tbDataCanAppend(pTbData, &key)) break;
+
+        nRow++;
+        if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
+          tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
+        }
+        code = tbDataDoPut(pMemTable, pTbData, pos, version, row.pTSRow, 1);
+        if (code) {
+          goto _err;
+        }
+
+        pLastRow = row.pTSRow;
+
+        row.pTSRow = tGetSubmitBlkNext(&blkIter);
+      } while (row.pTSRow);
+    }
+  }
+
+  // append the in-order rest
+  while (row.pTSRow) {
+    key.ts = row.pTSRow->ts;
+    nRow++;
+    code = tbDataAppend(pMemTable, pTbData, version, row.pTSRow);
+    if (code) {
+      goto _err;
+    }
 
-      pLastRow = row.pTSRow;
+    pLastRow = row.pTSRow;
 
-      row.pTSRow = tGetSubmitBlkNext(&blkIter);
-    } while (row.pTSRow);
+    row.pTSRow = tGetSubmitBlkNext(&blkIter);
   }
 
   if (key.ts >= pTbData->maxKey) {
@@ -615,7 +809,7 @@ _err:
   return code;
 }
 
-int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size; }
+int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size + pTbData->ab.size; }
 
 void tsdbRefMemTable(SMemTable *pMemTable) {
   int32_t nRef = atomic_fetch_add_32(&pMemTable->nRef, 1);
@@ -17,6 +17,7 @@
 #include "tsdb.h"
 
 #define ASCENDING_TRAVERSE(o) (o == TSDB_ORDER_ASC)
+#define READAHEAD_MAX_SIZE    (16 * 1024 * 1024)  // upper bound of the bytes read ahead by one query
 
 typedef enum {
   EXTERNAL_ROWS_PREV = 0x1,
@@ -74,6 +75,7 @@ typedef struct SIOCostSummary {
   double  headFileLoadTime;
   int64_t smaDataLoad;
   double  smaLoadTime;
+  int64_t bloomFilterLoad;
   int64_t lastBlockLoad;
   double  lastBlockLoadTime;
   int64_t composedBlocks;
@@ -82,6 +84,8 @@ typedef struct SIOCostSummary {
 //  double  getTbFromMemTime;
 //  double  getTbFromIMemTime;
   double  initDelSkylineIterTime;
+  int64_t pgCacheHit;   // page cache counters of the tsdb when the reader is created, shared with other readers
+  int64_t pgCacheMiss;
 } SIOCostSummary;
 
 typedef struct SBlockLoadSuppInfo {
@@ -124,6 +128,7 @@ typedef struct SDataBlockIter {
   int32_t   order;
   SDataBlk  block;  // current SDataBlk data
   SHashObj* pTableMap;
+  int32_t   readaheadIndex;  // blocks up to this index in the access order have been read ahead
 } SDataBlockIter;
 
 typedef struct SFileBlockDumpInfo {
@@ -138,6 +143,24 @@ typedef struct STableUidList {
   int32_t   currentIndex;  // index in table uid list
 } STableUidList;
 
+typedef struct SPartialLoadInfo {
+  bool       partial;    // only the filter columns of current file block have been dumped into the result block
+  int16_t*   loadCid;    // columns loaded before the filter is applied, primary timestamp column excluded
+  int32_t    numOfLoad;
+  int16_t*   restCid;    // columns loaded only when there are rows passing the filter
+  int32_t    numOfRest;
+  bool*      loaded;     // loaded or not for each column in SBlockLoadSuppInfo
+  int32_t    rowIndex;   // position in file block of the first row in the result block
+  int32_t    numOfRows;  // number of rows dumped into the result block
+  SBlockData restData;
+} SPartialLoadInfo;
+
+typedef struct SBlockBloomInfo {
+  SArray*    pBloomFilter;  // SArray<SBlockBloomFilter>, the bloom filters of a file block
+  SDFileSet* pFileSet;      // the file block they belong to
+  int64_t    smaOffset;
+} SBlockBloomInfo;
+
 typedef struct SReaderStatus {
   bool                  loadFromFile;       // check file stage
   bool                  composedDataBlock;  // the returned data block is a composed block or not
@@ -147,6 +170,8 @@ typedef struct SReaderStatus {
   SFileBlockDumpInfo    fBlockDumpInfo;
   SDFileSet*            pCurrentFileset;  // current opened file set
   SBlockData            fileBlockData;
+  SPartialLoadInfo      partialLoad;
+  SBlockBloomInfo       bloomInfo;
   SFilesetIter          fileIter;
   SDataBlockIter        blockIter;
 } SReaderStatus;
@@ -550,6 +575,7 @@ _err:
 static void resetDataBlockIterator(SDataBlockIter* pIter, int32_t order) {
   pIter->order = order;
   pIter->index = -1;
+  pIter->readaheadIndex = -1;
   pIter->numOfBlocks = 0;
   if (pIter->blockList == NULL) {
     pIter->blockList = taosArrayInit(4, sizeof(SFileDataBlockInfo));
@@ -614,6 +640,9 @@ static int32_t tsdbReaderCreate(SVnode* pVnode, SQueryTableDataCond* pCond, STsd
   pReader->window = updateQueryTimeWindow(pReader->pTsdb, &pCond->twindows);
   pReader->blockInfoBuf.numPerBucket = 1000;  // 1000 tables per bucket
 
+  size_t pgCacheUsage = 0;
+  tsdbPgCacheGetStat(pReader->pTsdb, &pReader->cost.pgCacheHit, &pReader->cost.pgCacheMiss, &pgCacheUsage);
+
   if (pReader->pResBlock == NULL) {
     pReader->freeBlock = true;
     pReader->pResBlock = createResBlock(pCond, pReader->capacity);
@@ -645,6 +674,12 @@ static int32_t tsdbReaderCreate(SVnode* pVnode, SQueryTableDataCond* pCond, STsd
     goto _end;
   }
 
+  code = tBlockDataCreate(&pReader->status.partialLoad.restData);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    goto _end;
+  }
+
   setColumnIdSlotList(pSup, pCond->colList, pCond->pSlotList, pCond->numOfCols);
 
   *ppReader = pReader;
@@ -1030,6 +1065,7 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
   SDataBlockIter*     pBlockIter = &pStatus->blockIter;
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
+  SPartialLoadInfo*   pPartial = &pStatus->partialLoad;
 
   SBlockData*         pBlockData = &pStatus->fileBlockData;
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(pBlockIter);
@@ -1042,6 +1078,8 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
   bool    asc = ASCENDING_TRAVERSE(pReader->order);
   int32_t step = asc ? 1 : -1;
 
+  pPartial->numOfRows = 0;
+
   // no data exists, return directly.
   if (pBlockData->nRow == 0 || pBlockData->aTSKEY == 0) {
     tsdbWarn("%p no need to copy since no data in blockData, table uid:%" PRIu64 " has been dropped, %s", pReader, pBlockInfo->uid,
@@ -1121,21 +1159,27 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
       colIndex += 1;
       i += 1;
     } else {  // the specified column does not exist in file block, fill with null data
-      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-      colDataAppendNNULL(pColData, 0, dumpedRows);
+      if (!pPartial->partial || pPartial->loaded[i]) {
+        pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+        colDataAppendNNULL(pColData, 0, dumpedRows);
+      }
       i += 1;
     }
   }
 
-  // fill the mis-matched columns with null value
+  // fill the mis-matched columns with null value, the columns not loaded yet are left to tsdbRetrieveDataBlockRest
   while (i < numOfOutputCols) {
-    pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-    colDataAppendNNULL(pColData, 0, dumpedRows);
+    if (!pPartial->partial || pPartial->loaded[i]) {
+      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+      colDataAppendNNULL(pColData, 0, dumpedRows);
+    }
     i += 1;
   }
 
   pResBlock->info.dataLoad = 1;
   pResBlock->info.rows = dumpedRows;
+  pPartial->rowIndex = pDumpInfo->rowIndex;
+  pPartial->numOfRows = dumpedRows;
   pDumpInfo->rowIndex += step * dumpedRows;
 
   // check if current block are all handled
@@ -1162,7 +1206,7 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
 }
 
 static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+                                   uint64_t uid, int16_t* aCid, int32_t numOfCid) {
   int32_t code = 0;
   int64_t st = taosGetTimestampUs();
 
@@ -1173,9 +1217,8 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
     return code;
   }
 
-  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
   TABLEID tid = {.suid = pReader->suid, .uid = uid};
-  code = tBlockDataInit(pBlockData, &tid, pSchema, &pSup->colId[1], pSup->numOfCols - 1);
+  code = tBlockDataInit(pBlockData, &tid, pSchema, aCid, numOfCid);
   if (code != TSDB_CODE_SUCCESS) {
     return code;
   }
@@ -1342,6 +1385,7 @@ static int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIte
               pReader, numOfBlocks, (et - st) / 1000.0, pReader->idStr);
 
     pBlockIter->index = asc ? 0 : (numOfBlocks - 1);
+    pBlockIter->readaheadIndex = pBlockIter->index;
     cleanupBlockOrderSupporter(&sup);
     doSetCurrentBlock(pBlockIter, pReader->idStr);
     return TSDB_CODE_SUCCESS;
@@ -1382,11 +1426,55 @@ static int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIte
   taosMemoryFree(pTree);
 
   pBlockIter->index = asc ? 0 : (numOfBlocks - 1);
+  pBlockIter->readaheadIndex = pBlockIter->index;
   doSetCurrentBlock(pBlockIter, pReader->idStr);
 
   return TSDB_CODE_SUCCESS;
 }
 
+// Issue background reads for the blocks following the current one in the access order, so that disk I/O overlaps
+// with the decoding of the current block. The window is bounded both in blocks and in bytes.
+static void readaheadFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter) {
+  if (tsTsdbReadaheadBlocks <= 0 || pReader->pFileReader == NULL) {
+    return;
+  }
+
+  int32_t step = ASCENDING_TRAVERSE(pBlockIter->order) ? 1 : -1;
+  int64_t size = 0;
+
+  for (int32_t i = 1; i <= tsTsdbReadaheadBlocks; ++i) {
+    int32_t index = pBlockIter->index + step * i;
+    if (index < 0 || index >= pBlockIter->numOfBlocks) {
+      break;
+    }
+
+    SFileDataBlockInfo*   pBlockInfo = taosArrayGet(pBlockIter->blockList, index);
+    STableBlockScanInfo** pScanInfo = taosHashGet(pBlockIter->pTableMap, &pBlockInfo->uid, sizeof(pBlockInfo->uid));
+    if (pScanInfo == NULL) {
+      break;
+    }
+
+    SDataBlk     block = {0};
+    SBlockIndex* pIndex = taosArrayGet((*pScanInfo)->pBlockList, pBlockInfo->tbBlockIdx);
+    tMapDataGetItemByIdx(&(*pScanInfo)->mapData, pIndex->ordinalIndex, &block, tGetDataBlk);
+
+    size += block.aSubBlock[0].szBlock;
+    if (size > READAHEAD_MAX_SIZE && i > 1) {
+      break;
+    }
+
+    // already requested by a previous call
+    if ((index - pBlockIter->readaheadIndex) * step <= 0) {
+      continue;
+    }
+
+    tsdbPrefetchDataBlock(pReader->pFileReader, &block);
+    pBlockIter->readaheadIndex = index;
+  }
+
+  tsdbPrefetchFlush(pReader->pFileReader);
+}
+
 static bool blockIteratorNext(SDataBlockIter* pBlockIter, const char* idStr) {
   bool asc = ASCENDING_TRAVERSE(pBlockIter->order);
 
@@ -2466,7 +2554,8 @@ static int32_t loadNeighborIfOverlap(SFileDataBlockInfo* pBlockInfo, STableBlock
     setFileBlockActiveInBlockIter(pBlockIter, neighborIndex, step);
 
     // 3. load the neighbor block, and set it to be the currently accessed file data block
-    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pBlockInfo->uid);
+    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pBlockInfo->uid,
+                               &pReader->suppInfo.colId[1], pReader->suppInfo.numOfCols - 1);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -2870,7 +2959,8 @@ static int32_t doBuildDataBlock(STsdbReader* pReader) {
   TSDBKEY keyInBuf = getCurrentKeyInBuf(pScanInfo, pReader);
 
   if (fileBlockShouldLoad(pReader, pBlockInfo, pBlock, pScanInfo, keyInBuf, pLastBlockReader)) {
-    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid);
+    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid,
+                               &pReader->suppInfo.colId[1], pReader->suppInfo.numOfCols - 1);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -3002,6 +3092,9 @@ static int32_t initForFirstBlockInFile(STsdbReader* pReader, SDataBlockIter* pBl
   // initialize the block iterator for a new fileset
   if (num.numOfBlocks > 0) {
     code = initBlockIterator(pReader, pBlockIter, num.numOfBlocks);
+    if (code == TSDB_CODE_SUCCESS) {
+      readaheadFileBlocks(pReader, pBlockIter);
+    }
   } else {  // no block data, only last block exists
     tBlockDataReset(&pReader->status.fileBlockData);
     resetDataBlockIterator(pBlockIter, pReader->order);
@@ -3073,6 +3166,7 @@ static int32_t buildBlockFromFiles(STsdbReader* pReader) {
         bool hasNext = blockIteratorNext(&pReader->status.blockIter, pReader->idStr);
         if (hasNext) {  // check for the next block in the block accessed order list
           initBlockDumpInfo(pReader, pBlockIter);
+          readaheadFileBlocks(pReader, pBlockIter);
         } else {
           if (pReader->status.pCurrentFileset->nSttF > 0) {
             // data blocks in current file are exhausted, let's try the next file now
@@ -3986,6 +4080,10 @@ void tsdbReaderClose(STsdbReader* pReader) {
 
   taosMemoryFree(pSupInfo->colId);
   tBlockDataDestroy(&pReader->status.fileBlockData, true);
+  tBlockDataDestroy(&pReader->status.partialLoad.restData, true);
+  taosMemoryFree(pReader->status.partialLoad.loadCid);
+  tsdbClearBlockBloomFilter(pReader->status.bloomInfo.pBloomFilter);
+  taosArrayDestroy(pReader->status.bloomInfo.pBloomFilter);
   cleanupDataBlockIterator(&pReader->status.blockIter);
 
   size_t numOfTables = taosHashGetSize(pReader->status.pTableMap);
@@ -4023,13 +4121,21 @@ void tsdbReaderClose(STsdbReader* pReader) {
     taosMemoryFree(pLReader);
   }
 
+  int64_t pgCacheHit = 0, pgCacheMiss = 0;
+  size_t  pgCacheUsage = 0;
+  tsdbPgCacheGetStat(pReader->pTsdb, &pgCacheHit, &pgCacheMiss, &pgCacheUsage);
+
+  tsdbDebug("%p page cache hit:%" PRId64 ", miss:%" PRId64 " since the reader is created, usage:%.2f Kb, %s", pReader,
+            pgCacheHit - pCost->pgCacheHit, pgCacheMiss - pCost->pgCacheMiss, pgCacheUsage / 1024.0, pReader->idStr);
+
   tsdbDebug(
       "%p :io-cost summary: head-file:%" PRIu64 ", head-file time:%.2f ms, SMA:%" PRId64
-      " SMA-time:%.2f ms, fileBlocks:%" PRId64
+      " SMA-time:%.2f ms, bloomFilters:%" PRId64 ", fileBlocks:%" PRId64
       ", fileBlocks-load-time:%.2f ms, "
       "build in-memory-block-time:%.2f ms, lastBlocks:%" PRId64 ", lastBlocks-time:%.2f ms, composed-blocks:%" PRId64
       ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,initDelSkylineIterTime:%.2f ms, %s",
-      pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime, pCost->numOfBlocks,
+      pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime, pCost->bloomFilterLoad,
+      pCost->numOfBlocks,
       pCost->blockLoadTime, pCost->buildmemBlock, pCost->lastBlockLoad, pCost->lastBlockLoadTime, pCost->composedBlocks,
       pCost->buildComposedBlockTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
       pCost->initDelSkylineIterTime, pReader->idStr);
@@ -4050,6 +4156,10 @@ static bool doTsdbNextDataBlock(STsdbReader* pReader) {
   blockDataCleanup(pBlock);
 
   SReaderStatus* pStatus = &pReader->status;
+
+  // the rest of previous block is not loaded if no rows of it pass the filter, and the block built below, which may be
+  // dumped by copyBlockDataToSDataBlock, is never partial.
+  pStatus->partialLoad.partial = false;
   if (taosHashGetSize(pStatus->pTableMap) == 0) {
     return false;
   }
@@ -4175,6 +4285,12 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SSDataBlock* pDataBlock,
                 pReader->idStr);
       return code;
     }
+
+    // only the bloom filters are written for this block
+    if (taosArrayGetSize(pSup->pColAgg) == 0) {
+      *pBlockSMA = NULL;
+      return TSDB_CODE_SUCCESS;
+    }
   } else {
     *pBlockSMA = NULL;
     return TSDB_CODE_SUCCESS;
@@ -4232,9 +4348,59 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SSDataBlock* pDataBlock,
   return code;
 }
 
-static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
-  SReaderStatus* pStatus = &pReader->status;
+// Split the output columns into the ones required by the filter and the rest. The rest columns of a file block are
+// decoded by tsdbRetrieveDataBlockRest after the filter is applied, and only when some rows pass the filter.
+static int32_t initPartialLoad(STsdbReader* pReader, SArray* pIdList) {
+  SPartialLoadInfo*   pPartial = &pReader->status.partialLoad;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+
+  pPartial->partial = false;
+  if (pIdList == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pPartial->loadCid == NULL) {
+    int32_t size = pSup->numOfCols * (sizeof(int16_t) * 2 + sizeof(bool));
+    pPartial->loadCid = taosMemoryMalloc(size);
+    if (pPartial->loadCid == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pPartial->restCid = pPartial->loadCid + pSup->numOfCols;
+    pPartial->loaded = (bool*)(pPartial->restCid + pSup->numOfCols);
+  }
+
+  pPartial->numOfLoad = 0;
+  pPartial->numOfRest = 0;
+
+  size_t numOfIds = taosArrayGetSize(pIdList);
+  for (int32_t i = 0; i < pSup->numOfCols; ++i) {
+    bool required = (pSup->colId[i] == PRIMARYKEY_TIMESTAMP_COL_ID);
+    for (int32_t j = 0; j < numOfIds && !required; ++j) {
+      required = (*(int16_t*)taosArrayGet(pIdList, j) == pSup->colId[i]);
+    }
 
+    pPartial->loaded[i] = required;
+    if (pSup->colId[i] == PRIMARYKEY_TIMESTAMP_COL_ID) {
+      continue;
+    }
+
+    if (required) {
+      pPartial->loadCid[pPartial->numOfLoad++] = pSup->colId[i];
+    } else {
+      pPartial->restCid[pPartial->numOfRest++] = pSup->colId[i];
+    }
+  }
+
+  pPartial->partial = (pPartial->numOfRest > 0);
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
+  SReaderStatus*    pStatus = &pReader->status;
+  SPartialLoadInfo* pPartial = &pStatus->partialLoad;
+
+  pPartial->partial = false;
   if (pStatus->composedDataBlock) {
     return pReader->pResBlock;
   }
@@ -4249,7 +4415,23 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
     return NULL;
   }
 
-  int32_t code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
+  // a block that is not composed is always dumped completely, so a partially loaded file block is never reused by the
+  // following merge procedure.
+  int32_t code = initPartialLoad(pReader, pIdList);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return NULL;
+  }
+
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  if (pPartial->partial) {
+    code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                               pPartial->loadCid, pPartial->numOfLoad);
+  } else {
+    code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                               &pSup->colId[1], pSup->numOfCols - 1);
+  }
+
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataDestroy(&pStatus->fileBlockData, 1);
     terrno = code;
@@ -4260,16 +4442,166 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
   return pReader->pResBlock;
 }
 
-SSDataBlock* tsdbRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
+static STsdbReader* getActiveReader(STsdbReader* pReader) {
   if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
     if (pReader->step == EXTERNAL_ROWS_PREV) {
-      return doRetrieveDataBlock(pReader->innerReader[0]);
+      return pReader->innerReader[0];
     } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
-      return doRetrieveDataBlock(pReader->innerReader[1]);
+      return pReader->innerReader[1];
+    }
+  }
+
+  return pReader;
+}
+
+// Check with the bloom filter of the column whether current file block may contain the value. It is always true if
+// the block has no bloom filter of the column, or it is not a file block returned as a whole.
+bool tsdbDataBlockMayContain(STsdbReader* pReader, int16_t colId, int8_t type, const void* pVal) {
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    return true;
+  }
+
+  SReaderStatus* pStatus = &pReader->status;
+  if (pStatus->composedDataBlock) {
+    return true;
+  }
+
+  SFileDataBlockInfo* pFBlock = getCurrentBlockInfo(&pStatus->blockIter);
+  if (pFBlock == NULL || pReader->pResBlock->info.id.uid != pFBlock->uid) {
+    return true;
+  }
+
+  SDataBlk* pBlock = getCurrentBlock(&pStatus->blockIter);
+  if (!tDataBlkHasSma(pBlock)) {
+    return true;
+  }
+
+  SBlockBloomInfo* pInfo = &pStatus->bloomInfo;
+  if (pInfo->pFileSet != pStatus->pCurrentFileset || pInfo->smaOffset != pBlock->smaInfo.offset) {
+    if (pInfo->pBloomFilter == NULL) {
+      pInfo->pBloomFilter = taosArrayInit(4, sizeof(SBlockBloomFilter));
+      if (pInfo->pBloomFilter == NULL) {
+        return true;
+      }
+    }
+
+    int64_t st = taosGetTimestampUs();
+    int32_t code = tsdbReadBlockBloomFilter(pReader->pFileReader, pBlock, pInfo->pBloomFilter);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbWarn("%p failed to load bloom filter of file block, uid:%" PRIu64 ", code:%s, %s", pReader, pFBlock->uid,
+               tstrerror(code), pReader->idStr);
+      pInfo->pFileSet = NULL;
+      return true;
+    }
+
+    pInfo->pFileSet = pStatus->pCurrentFileset;
+    pInfo->smaOffset = pBlock->smaInfo.offset;
+    pReader->cost.bloomFilterLoad += 1;
+    pReader->cost.smaLoadTime += (taosGetTimestampUs() - st) / 1000.0;
+  }
+
+  size_t num = taosArrayGetSize(pInfo->pBloomFilter);
+  for (int32_t i = 0; i < num; ++i) {
+    SBlockBloomFilter* pBloom = taosArrayGet(pInfo->pBloomFilter, i);
+    if (pBloom->cid == colId) {
+      return (pBloom->type != type) || !tsdbBlockBloomFilterNoContain(pBloom, pVal);
+    }
+  }
+
+  return true;
+}
+
+SSDataBlock* tsdbRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
+  return doRetrieveDataBlock(getActiveReader(pReader), pIdList);
+}
+
+bool tsdbIsDataBlockPartial(STsdbReader* pReader) { return getActiveReader(pReader)->status.partialLoad.partial; }
+
+// Load the columns left out by tsdbRetrieveDataBlock. Only the rows selected by pSelect are copied into the result
+// block, the others are left as null, and a NULL pSelect selects all of the rows.
+int32_t tsdbRetrieveDataBlockRest(STsdbReader* pReader, const int8_t* pSelect) {
+  pReader = getActiveReader(pReader);
+
+  SReaderStatus*      pStatus = &pReader->status;
+  SPartialLoadInfo*   pPartial = &pStatus->partialLoad;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SSDataBlock*        pResBlock = pReader->pResBlock;
+
+  if (!pPartial->partial) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pPartial->partial = false;
+  if (pPartial->numOfRows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t     st = taosGetTimestampUs();
+  bool        asc = ASCENDING_TRAVERSE(pReader->order);
+  int32_t     step = asc ? 1 : -1;
+  SBlockData* pRestData = &pPartial->restData;
+
+  tBlockDataReset(pRestData);
+
+  uint64_t  uid = pStatus->fileBlockData.uid;
+  STSchema* pSchema = getLatestTableSchema(pReader, uid);
+  if (pSchema != NULL) {
+    TABLEID tid = {.suid = pReader->suid, .uid = uid};
+    int32_t code = tBlockDataInit(pRestData, &tid, pSchema, pPartial->restCid, pPartial->numOfRest);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = tsdbReadDataBlockCols(pReader->pFileReader, getCurrentBlock(&pStatus->blockIter), pRestData);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbError("%p failed to load the rest columns of file block, uid:%" PRIu64 ", code:%s %s", pReader, uid,
+                tstrerror(code), pReader->idStr);
+      return code;
+    }
+  }
+
+  SFileBlockDumpInfo dumpInfo = {.rowIndex = pPartial->rowIndex};
+  SColVal            cv = {0};
+  int32_t            colIndex = 0;
+
+  for (int32_t i = 0; i < pSup->numOfCols; ++i) {
+    if (pPartial->loaded[i]) {
+      continue;
+    }
+
+    // both of them are in the ascending order of column id
+    SColData* pData = NULL;
+    for (; colIndex < pRestData->nColData; ++colIndex) {
+      SColData* p = tBlockDataGetColDataByIdx(pRestData, colIndex);
+      if (p->cid >= pSup->colId[i]) {
+        pData = (p->cid == pSup->colId[i]) ? p : NULL;
+        break;
+      }
+    }
+
+    SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSup->slotId[i]);
+    if (pData == NULL || pData->flag == HAS_NONE || pData->flag == HAS_NULL || pData->flag == (HAS_NULL | HAS_NONE)) {
+      colDataAppendNNULL(pColData, 0, pPartial->numOfRows);
+    } else if (IS_MATHABLE_TYPE(pColData->info.type)) {
+      copyNumericCols(pData, &dumpInfo, pColData, pPartial->numOfRows, asc);
+    } else {  // varchar/nchar type, copy the selected rows only
+      for (int32_t j = pPartial->rowIndex, rowIndex = 0; rowIndex < pPartial->numOfRows; j += step, ++rowIndex) {
+        if (pSelect != NULL && pSelect[rowIndex] == 0) {
+          colDataAppendNULL(pColData, rowIndex);
+          continue;
+        }
+
+        tColDataGetValue(pData, j, &cv);
+        doCopyColVal(pColData, rowIndex, i, &cv, pSup);
+      }
     }
   }
 
-  return doRetrieveDataBlock(pReader);
+  double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
+  pReader->cost.blockLoadTime += elapsedTime;
+
+  tsdbDebug("%p load rest %d columns of file block, uid:%" PRIu64 ", rows:%d, elapsed time:%.2f ms, %s", pReader,
+            pPartial->numOfRest, uid, pPartial->numOfRows, elapsedTime, pReader->idStr);
+  return TSDB_CODE_SUCCESS;
 }
 
 int32_t tsdbReaderReset(STsdbReader* pReader, SQueryTableDataCond* pCond) {
@@ -72,6 +72,7 @@ static void tsdbCloseFile(STsdbFD **ppFD) {
   STsdbFD *pFD = *ppFD;
   if (pFD) {
     taosMemoryFree(pFD->pBuf);
+    tFree(pFD->pRBuf);
     taosCloseFile(&pFD->pFD);
     taosMemoryFree(pFD);
     *ppFD = NULL;
@@ -106,21 +107,35 @@ _exit:
   return code;
 }
 
+static FORCE_INLINE bool tsdbFilePgCachable(STsdbFD *pFD, int64_t pgno) {
+  return pFD->pTsdb && pgno > 1 && pgno <= pFD->pgCached;
+}
+
+static FORCE_INLINE void tsdbFileReadDone(STsdbFD *pFD, int64_t offset, int64_t size) {
+  pFD->nRead++;
+  if (offset >= pFD->raOffset && offset + size <= pFD->raIssued) {
+    pFD->nReadahead++;
+  }
+}
+
 static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
   int32_t code = 0;
+  bool    cachable = tsdbFilePgCachable(pFD, pgno);
 
   // ASSERT(pgno <= pFD->szFile);
 
-  // seek
-  int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
-  int64_t n = taosLSeekFile(pFD->pFD, offset, SEEK_SET);
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _exit;
+  // cache
+  if (cachable) {
+    pFD->pgKey.pgno = pgno;
+    if (tsdbPgCacheGet(pFD->pTsdb, &pFD->pgKey, pFD->pBuf, pFD->szPage)) {
+      pFD->pgno = pgno;
+      goto _exit;
+    }
   }
 
   // read
-  n = taosReadFile(pFD->pFD, pFD->pBuf, pFD->szPage);
+  int64_t n = taosPReadFile(pFD->pFD, pFD->pBuf, pFD->szPage, PAGE_OFFSET(pgno, pFD->szPage));
+  tsdbFileReadDone(pFD, PAGE_OFFSET(pgno, pFD->szPage), pFD->szPage);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _exit;
@@ -137,10 +152,69 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
 
   pFD->pgno = pgno;
 
+  if (cachable) {
+    tsdbPgCachePut(pFD->pTsdb, &pFD->pgKey, pFD->pBuf, pFD->szPage);
+  }
+
 _exit:
   return code;
 }
 
+// Read up to nPageMax consecutive full pages starting at pgno with a single positional read and copy their contents
+// to pBuf. The run stops at the first page found in the page cache, which is left in pFD->pBuf. The number of pages
+// copied to pBuf is returned by *nPageRead.
+static int32_t tsdbReadFilePages(STsdbFD *pFD, int64_t pgno, int64_t nPageMax, uint8_t *pBuf, int64_t *nPageRead) {
+  int32_t code = 0;
+  int32_t szPgCont = PAGE_CONTENT_SIZE(pFD->szPage);
+  int64_t nPage = 0;
+
+  for (; nPage < nPageMax; nPage++) {
+    if (tsdbFilePgCachable(pFD, pgno + nPage)) {
+      pFD->pgKey.pgno = pgno + nPage;
+      if (tsdbPgCacheGet(pFD->pTsdb, &pFD->pgKey, pFD->pBuf, pFD->szPage)) {
+        pFD->pgno = pgno + nPage;
+        break;
+      }
+    }
+  }
+  if (nPage == 0) goto _exit;
+
+  // read
+  code = tRealloc(&pFD->pRBuf, pFD->szPage * nPage);
+  if (code) goto _exit;
+
+  int64_t n = taosPReadFile(pFD->pFD, pFD->pRBuf, pFD->szPage * nPage, PAGE_OFFSET(pgno, pFD->szPage));
+  tsdbFileReadDone(pFD, PAGE_OFFSET(pgno, pFD->szPage), pFD->szPage * nPage);
+  if (n < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  } else if (n < pFD->szPage * nPage) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+
+  // check and copy
+  for (int64_t iPage = 0; iPage < nPage; iPage++) {
+    uint8_t *pPage = pFD->pRBuf + pFD->szPage * iPage;
+
+    if (pgno + iPage > 1 && !taosCheckChecksumWhole(pPage, pFD->szPage)) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    memcpy(pBuf + szPgCont * iPage, pPage, szPgCont);
+
+    if (tsdbFilePgCachable(pFD, pgno + iPage)) {
+      pFD->pgKey.pgno = pgno + iPage;
+      tsdbPgCachePut(pFD->pTsdb, &pFD->pgKey, pPage, pFD->szPage);
+    }
+  }
+
+_exit:
+  *nPageRead = code ? 0 : nPage;
+  return code;
+}
+
 static int32_t tsdbWriteFile(STsdbFD *pFD, int64_t offset, const uint8_t *pBuf, int64_t size) {
   int32_t code = 0;
   int64_t fOffset = LOGIC_TO_FILE_OFFSET(offset, pFD->szPage);
@@ -186,8 +260,21 @@ static int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t
 
   while (n < size) {
     if (pFD->pgno != pgno) {
-      code = tsdbReadFilePage(pFD, pgno);
-      if (code) goto _exit;
+      // coalesce the full pages of the range into one read
+      int64_t nPage = (bOffset == 0) ? TMIN((size - n) / szPgCont, TSDB_READ_MAX_PAGES) : 0;
+      if (nPage > 1) {
+        code = tsdbReadFilePages(pFD, pgno, nPage, pBuf + n, &nPage);
+        if (code) goto _exit;
+
+        if (nPage > 0) {
+          n += szPgCont * nPage;
+          pgno += nPage;
+          continue;
+        }
+      } else {
+        code = tsdbReadFilePage(pFD, pgno);
+        if (code) goto _exit;
+      }
     }
 
     int64_t nRead = TMIN(szPgCont - bOffset, size - n);
@@ -202,6 +289,17 @@ _exit:
   return code;
 }
 
+// Let the pages of a committed file be shared through the page cache. Only full pages inside the committed size
+// are immutable: the tail page of data/sma files is rewritten by later appends and the first page holds the header.
+static void tsdbSetFilePgCache(STsdbFD *pFD, STsdb *pTsdb, int32_t fid, EDataFileT ftype, int64_t commitID,
+                               int64_t size) {
+  if (pTsdb->pgCache == NULL) return;
+
+  pFD->pTsdb = pTsdb;
+  pFD->pgKey = (STsdbPgKey){.fid = fid, .ftype = ftype, .commitID = commitID, .pgno = 0};
+  pFD->pgCached = size / PAGE_CONTENT_SIZE(pFD->szPage);
+}
+
 static int32_t tsdbFsyncFile(STsdbFD *pFD) {
   int32_t code = 0;
 
@@ -513,8 +611,59 @@ _err:
   return code;
 }
 
+static bool tsdbColDataNeedBloomFilter(SColData *pColData) {
+  if (!tsTsdbBlockBloomFilter || !pColData->smaOn || (pColData->flag & HAS_VALUE) == 0) return false;
+
+  // equal conditions on the other types are rare, or already well served by the min/max of SMA
+  return IS_INTEGER_TYPE(pColData->type) || pColData->type == TSDB_DATA_TYPE_BINARY ||
+         pColData->type == TSDB_DATA_TYPE_NCHAR;
+}
+
+// The default taosFastHash of a bloom filter only rotates on the zero bytes of small integers and of UCS4 text, which
+// gives these columns many times the configured false positive rate.
+static void tsdbBloomFilterSetHash(SBloomFilter *pBF) { pBF->hashFn1 = MurmurHash3_32; }
+
+static int32_t tsdbBuildBloomFilter(SColData *pColData, SBlockBloomFilter *pBloom) {
+  pBloom->cid = pColData->cid;
+  pBloom->type = pColData->type;
+  pBloom->pBF = tBloomFilterInit(pColData->nVal, TSDB_BLOOM_FILTER_FPP);
+  if (pBloom->pBF == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  tsdbBloomFilterSetHash(pBloom->pBF);
+
+  SColVal cv;
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    tColDataGetValue(pColData, iVal, &cv);
+    if (!COL_VAL_IS_VALUE(&cv)) continue;
+
+    if (IS_VAR_DATA_TYPE(cv.type)) {
+      tBloomFilterPut(pBloom->pBF, cv.value.pData, cv.value.nData);
+    } else {
+      tBloomFilterPut(pBloom->pBF, &cv.value.val, tDataTypes[cv.type].bytes);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tsdbEncodeBlockBloomFilter(SEncoder *pEncoder, const SArray *aBloomFilter) {
+  int32_t nBloom = taosArrayGetSize(aBloomFilter);
+
+  if (tEncodeI32v(pEncoder, nBloom) < 0) return -1;
+  for (int32_t iBloom = 0; iBloom < nBloom; iBloom++) {
+    SBlockBloomFilter *pBloom = taosArrayGet(aBloomFilter, iBloom);
+
+    if (tEncodeI16v(pEncoder, pBloom->cid) < 0) return -1;
+    if (tEncodeI8(pEncoder, pBloom->type) < 0) return -1;
+    if (tBloomFilterEncode(pBloom->pBF, pEncoder) < 0) return -1;
+  }
+
+  return 0;
+}
+
 static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData, SSmaInfo *pSmaInfo) {
   int32_t code = 0;
+  SArray *aBloomFilter = NULL;
+  int32_t szBloom = 0;
 
   pSmaInfo->offset = 0;
   pSmaInfo->size = 0;
@@ -523,6 +672,21 @@ static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData,
   for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
     SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
 
+    if (tsdbColDataNeedBloomFilter(pColData)) {
+      if (aBloomFilter == NULL && (aBloomFilter = taosArrayInit(0, sizeof(SBlockBloomFilter))) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        goto _err;
+      }
+
+      SBlockBloomFilter bloom = {0};
+      code = tsdbBuildBloomFilter(pColData, &bloom);
+      if (code || taosArrayPush(aBloomFilter, &bloom) == NULL) {
+        tBloomFilterDestroy(bloom.pBF);
+        code = code ? code : TSDB_CODE_OUT_OF_MEMORY;
+        goto _err;
+      }
+    }
+
     if ((!pColData->smaOn) || IS_VAR_DATA_TYPE(pColData->type) || ((pColData->flag & HAS_VALUE) == 0)) continue;
 
     SColumnDataAgg sma = {.colId = pColData->cid};
@@ -533,6 +697,32 @@ static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData,
     pSmaInfo->size += tPutColumnDataAgg(pWriter->aBuf[0] + pSmaInfo->size, &sma);
   }
 
+  if (aBloomFilter) {
+    int32_t ret = 0;
+    tEncodeSize(tsdbEncodeBlockBloomFilter, aBloomFilter, szBloom, ret);
+    if (ret < 0) {
+      code = TSDB_CODE_INVALID_MSG;
+      goto _err;
+    }
+
+    code = tRealloc(&pWriter->aBuf[1], szBloom);
+    if (code) goto _err;
+
+    SEncoder encoder = {0};
+    tEncoderInit(&encoder, pWriter->aBuf[1], szBloom);
+    ret = tsdbEncodeBlockBloomFilter(&encoder, aBloomFilter);
+    tEncoderClear(&encoder);
+    if (ret < 0) {
+      code = TSDB_CODE_INVALID_MSG;
+      goto _err;
+    }
+
+    SColumnDataAgg sma = {.colId = TSDB_BLOOM_FILTER_CID, .sum = szBloom};
+    code = tRealloc(&pWriter->aBuf[0], pSmaInfo->size + tPutColumnDataAgg(NULL, &sma));
+    if (code) goto _err;
+    pSmaInfo->size += tPutColumnDataAgg(pWriter->aBuf[0] + pSmaInfo->size, &sma);
+  }
+
   // write
   if (pSmaInfo->size) {
     code = tsdbWriteFile(pWriter->pSmaFD, pWriter->fSma.size, pWriter->aBuf[0], pSmaInfo->size);
@@ -542,9 +732,20 @@ static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData,
     pWriter->fSma.size += pSmaInfo->size;
   }
 
+  if (szBloom) {
+    code = tsdbWriteFile(pWriter->pSmaFD, pWriter->fSma.size, pWriter->aBuf[1], szBloom);
+    if (code) goto _err;
+
+    pWriter->fSma.size += szBloom;
+  }
+
+  tsdbClearBlockBloomFilter(aBloomFilter);
+  taosArrayDestroy(aBloomFilter);
   return code;
 
 _err:
+  tsdbClearBlockBloomFilter(aBloomFilter);
+  taosArrayDestroy(aBloomFilter);
   tsdbError("vgId:%d, tsdb write block sma failed since %s", TD_VID(pWriter->pTsdb->pVnode), tstrerror(code));
   return code;
 }
@@ -867,22 +1068,27 @@ int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pS
   tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pHeadFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFilePgCache(pReader->pHeadFD, pTsdb, pSet->fid, TSDB_HEAD_FILE, pSet->pHeadF->commitID, pSet->pHeadF->size);
 
   // data
   tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pDataFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFilePgCache(pReader->pDataFD, pTsdb, pSet->fid, TSDB_DATA_FILE, pSet->pDataF->commitID, pSet->pDataF->size);
 
   // sma
   tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pSmaFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFilePgCache(pReader->pSmaFD, pTsdb, pSet->fid, TSDB_SMA_FILE, pSet->pSmaF->commitID, pSet->pSmaF->size);
 
   // stt
   for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
     tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
     code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->aSttFD[iStt]);
     TSDB_CHECK_CODE(code, lino, _exit);
+    tsdbSetFilePgCache(pReader->aSttFD[iStt], pTsdb, pSet->fid, TSDB_LAST_FILE, pSet->aSttF[iStt]->commitID,
+                       pSet->aSttF[iStt]->size);
   }
 
 _exit:
@@ -1054,6 +1260,7 @@ int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pDataBlk, SArray *aCol
   while (n < pSmaInfo->size) {
     SColumnDataAgg sma;
     n += tGetColumnDataAgg(pReader->aBuf[0] + n, &sma);
+    if (sma.colId == TSDB_BLOOM_FILTER_CID) continue;
 
     if (taosArrayPush(aColumnDataAgg, &sma) == NULL) {
       code = TSDB_CODE_OUT_OF_MEMORY;
@@ -1068,66 +1275,101 @@ _err:
   return code;
 }
 
-static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
-                                     int32_t iStt) {
-  int32_t code = 0;
+int32_t tsdbReadBlockBloomFilter(SDataFReader *pReader, SDataBlk *pDataBlk, SArray *aBloomFilter) {
+  int32_t   code = 0;
+  SSmaInfo *pSmaInfo = &pDataBlk->smaInfo;
 
-  tBlockDataClear(pBlockData);
+  ASSERT(pSmaInfo->size > 0);
 
-  STsdbFD *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
+  tsdbClearBlockBloomFilter(aBloomFilter);
 
-  // uid + version + tskey
-  code = tRealloc(&pReader->aBuf[0], pBlkInfo->szKey);
+  // the bloom filter entry is the last one of the SColumnDataAgg list
+  code = tRealloc(&pReader->aBuf[0], pSmaInfo->size);
   if (code) goto _err;
 
-  code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
+  code = tsdbReadFile(pReader->pSmaFD, pSmaInfo->offset, pReader->aBuf[0], pSmaInfo->size);
   if (code) goto _err;
 
-  SDiskDataHdr hdr;
-  uint8_t     *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
+  SColumnDataAgg sma = {0};
+  int32_t        n = 0;
+  while (n < pSmaInfo->size) {
+    n += tGetColumnDataAgg(pReader->aBuf[0] + n, &sma);
+  }
+  ASSERT(n == pSmaInfo->size);
 
-  ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
-  ASSERT(pBlockData->suid == hdr.suid);
+  if (sma.colId != TSDB_BLOOM_FILTER_CID) return code;
 
-  pBlockData->uid = hdr.uid;
-  pBlockData->nRow = hdr.nRow;
+  // read and decode the bloom filters
+  int32_t szBloom = (int32_t)sma.sum;
+  code = tRealloc(&pReader->aBuf[1], szBloom);
+  if (code) goto _err;
 
-  // uid
-  if (hdr.uid == 0) {
-    ASSERT(hdr.szUid);
-    code = tsdbDecmprData(p, hdr.szUid, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aUid,
-                          sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
-    if (code) goto _err;
-  } else {
-    ASSERT(!hdr.szUid);
+  code = tsdbReadFile(pReader->pSmaFD, pSmaInfo->offset + pSmaInfo->size, pReader->aBuf[1], szBloom);
+  if (code) goto _err;
+
+  SDecoder decoder = {0};
+  int32_t  nBloom = 0;
+  tDecoderInit(&decoder, pReader->aBuf[1], szBloom);
+  if (tDecodeI32v(&decoder, &nBloom) < 0) {
+    code = TSDB_CODE_FILE_CORRUPTED;
   }
-  p += hdr.szUid;
 
-  // version
-  code = tsdbDecmprData(p, hdr.szVer, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aVersion,
-                        sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+  for (int32_t iBloom = 0; iBloom < nBloom && code == 0; iBloom++) {
+    SBlockBloomFilter bloom = {0};
+    if (tDecodeI16v(&decoder, &bloom.cid) < 0 || tDecodeI8(&decoder, &bloom.type) < 0 ||
+        (bloom.pBF = tBloomFilterDecode(&decoder)) == NULL) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+    } else {
+      tsdbBloomFilterSetHash(bloom.pBF);
+      if (taosArrayPush(aBloomFilter, &bloom) == NULL) {
+        tBloomFilterDestroy(bloom.pBF);
+        code = TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+  }
+  tDecoderClear(&decoder);
   if (code) goto _err;
-  p += hdr.szVer;
 
-  // TSKEY
-  code = tsdbDecmprData(p, hdr.szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr.cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
-                        sizeof(TSKEY) * hdr.nRow, &pReader->aBuf[1]);
-  if (code) goto _err;
-  p += hdr.szKey;
+  return code;
 
-  ASSERT(p - pReader->aBuf[0] == pBlkInfo->szKey);
+_err:
+  tsdbClearBlockBloomFilter(aBloomFilter);
+  tsdbError("vgId:%d, tsdb read block bloom filter failed since %s", TD_VID(pReader->pTsdb->pVnode),
+            tstrerror(code));
+  return code;
+}
+
+void tsdbClearBlockBloomFilter(SArray *aBloomFilter) {
+  for (int32_t iBloom = 0; iBloom < taosArrayGetSize(aBloomFilter); iBloom++) {
+    SBlockBloomFilter *pBloom = taosArrayGet(aBloomFilter, iBloom);
+    tBloomFilterDestroy(pBloom->pBF);
+  }
+  taosArrayClear(aBloomFilter);
+}
+
+// pVal is in the layout of the column, with the VARSTR header for binary and nchar columns
+bool tsdbBlockBloomFilterNoContain(const SBlockBloomFilter *pBloom, const void *pVal) {
+  if (IS_VAR_DATA_TYPE(pBloom->type)) {
+    return tBloomFilterNoContain(pBloom->pBF, varDataVal(pVal), varDataLen(pVal)) == TSDB_CODE_SUCCESS;
+  } else {
+    return tBloomFilterNoContain(pBloom->pBF, pVal, tDataTypes[pBloom->type].bytes) == TSDB_CODE_SUCCESS;
+  }
+}
+
+static int32_t tsdbReadBlockColsImpl(SDataFReader *pReader, STsdbFD *pFD, SBlockInfo *pBlkInfo, SDiskDataHdr *hdr,
+                                     SBlockData *pBlockData) {
+  int32_t code = 0;
 
-  // read and decode columns
   if (pBlockData->nColData == 0) goto _exit;
 
-  if (hdr.szBlkCol > 0) {
+  if (hdr->szBlkCol > 0) {
     int64_t offset = pBlkInfo->offset + pBlkInfo->szKey;
 
-    code = tRealloc(&pReader->aBuf[0], hdr.szBlkCol);
-    if (code) goto _err;
+    code = tRealloc(&pReader->aBuf[0], hdr->szBlkCol);
+    if (code) goto _exit;
 
-    code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr.szBlkCol);
-    if (code) goto _err;
+    code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr->szBlkCol);
+    if (code) goto _exit;
   }
 
   SBlockCol  blockCol = {.cid = 0};
@@ -1138,19 +1380,19 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
     SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
 
     while (pBlockCol && pBlockCol->cid < pColData->cid) {
-      if (n < hdr.szBlkCol) {
+      if (n < hdr->szBlkCol) {
         n += tGetBlockCol(pReader->aBuf[0] + n, pBlockCol);
       } else {
-        ASSERT(n == hdr.szBlkCol);
+        ASSERT(n == hdr->szBlkCol);
         pBlockCol = NULL;
       }
     }
 
     if (pBlockCol == NULL || pBlockCol->cid > pColData->cid) {
       // add a lot of NONE
-      for (int32_t iRow = 0; iRow < hdr.nRow; iRow++) {
+      for (int32_t iRow = 0; iRow < hdr->nRow; iRow++) {
         code = tColDataAppendValue(pColData, &COL_VAL_NONE(pColData->cid, pColData->type));
-        if (code) goto _err;
+        if (code) goto _exit;
       }
     } else {
       ASSERT(pBlockCol->type == pColData->type);
@@ -1158,29 +1400,85 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
 
       if (pBlockCol->flag == HAS_NULL) {
         // add a lot of NULL
-        for (int32_t iRow = 0; iRow < hdr.nRow; iRow++) {
+        for (int32_t iRow = 0; iRow < hdr->nRow; iRow++) {
           code = tColDataAppendValue(pColData, &COL_VAL_NULL(pBlockCol->cid, pBlockCol->type));
-          if (code) goto _err;
+          if (code) goto _exit;
         }
       } else {
         // decode from binary
-        int64_t offset = pBlkInfo->offset + pBlkInfo->szKey + hdr.szBlkCol + pBlockCol->offset;
+        int64_t offset = pBlkInfo->offset + pBlkInfo->szKey + hdr->szBlkCol + pBlockCol->offset;
         int32_t size = pBlockCol->szBitmap + pBlockCol->szOffset + pBlockCol->szValue;
 
         code = tRealloc(&pReader->aBuf[1], size);
-        if (code) goto _err;
+        if (code) goto _exit;
 
         code = tsdbReadFile(pFD, offset, pReader->aBuf[1], size);
-        if (code) goto _err;
+        if (code) goto _exit;
 
-        code = tsdbDecmprColData(pReader->aBuf[1], pBlockCol, hdr.cmprAlg, hdr.nRow, pColData, &pReader->aBuf[2]);
-        if (code) goto _err;
+        code = tsdbDecmprColData(pReader->aBuf[1], pBlockCol, hdr->cmprAlg, hdr->nRow, pColData, &pReader->aBuf[2]);
+        if (code) goto _exit;
       }
     }
   }
 
 _exit:
   return code;
+}
+
+static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
+                                     int32_t iStt) {
+  int32_t code = 0;
+
+  tBlockDataClear(pBlockData);
+
+  STsdbFD *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
+
+  // uid + version + tskey
+  code = tRealloc(&pReader->aBuf[0], pBlkInfo->szKey);
+  if (code) goto _err;
+
+  code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
+  if (code) goto _err;
+
+  SDiskDataHdr hdr;
+  uint8_t     *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
+
+  ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
+  ASSERT(pBlockData->suid == hdr.suid);
+
+  pBlockData->uid = hdr.uid;
+  pBlockData->nRow = hdr.nRow;
+
+  // uid
+  if (hdr.uid == 0) {
+    ASSERT(hdr.szUid);
+    code = tsdbDecmprData(p, hdr.szUid, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aUid,
+                          sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+    if (code) goto _err;
+  } else {
+    ASSERT(!hdr.szUid);
+  }
+  p += hdr.szUid;
+
+  // version
+  code = tsdbDecmprData(p, hdr.szVer, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aVersion,
+                        sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+  if (code) goto _err;
+  p += hdr.szVer;
+
+  // TSKEY
+  code = tsdbDecmprData(p, hdr.szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr.cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
+                        sizeof(TSKEY) * hdr.nRow, &pReader->aBuf[1]);
+  if (code) goto _err;
+  p += hdr.szKey;
+
+  ASSERT(p - pReader->aBuf[0] == pBlkInfo->szKey);
+
+  // read and decode columns
+  code = tsdbReadBlockColsImpl(pReader, pFD, pBlkInfo, &hdr, pBlockData);
+  if (code) goto _err;
+
+  return code;
 
 _err:
   tsdbError("vgId:%d, tsdb read block data impl failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
@@ -1225,6 +1523,76 @@ _err:
   return code;
 }
 
+// Decode the columns of pBlockData only, the keys of the block are left to tsdbReadDataBlock.
+int32_t tsdbReadDataBlockCols(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData) {
+  int32_t     code = 0;
+  SBlockInfo *pBlkInfo = &pDataBlk->aSubBlock[0];
+
+  ASSERT(pDataBlk->nSubBlock == 1);
+
+  tBlockDataClear(pBlockData);
+
+  code = tRealloc(&pReader->aBuf[0], pBlkInfo->szKey);
+  if (code) goto _err;
+
+  code = tsdbReadFile(pReader->pDataFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
+  if (code) goto _err;
+
+  SDiskDataHdr hdr;
+  tGetDiskDataHdr(pReader->aBuf[0], &hdr);
+
+  ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
+  pBlockData->uid = hdr.uid;
+  pBlockData->nRow = hdr.nRow;
+
+  code = tsdbReadBlockColsImpl(pReader, pReader->pDataFD, pBlkInfo, &hdr, pBlockData);
+  if (code) goto _err;
+
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb read data block cols failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
+// Add the pages of a data block to the run read ahead, so the I/O overlaps with the decoding of the blocks in front
+// of it. Blocks adjacent in the file extend the run and are passed to the kernel as one request by tsdbPrefetchFlush,
+// any other block flushes the run and starts a new one. Return the number of bytes added.
+int64_t tsdbPrefetchDataBlock(SDataFReader *pReader, SDataBlk *pDataBlk) {
+  STsdbFD *pFD = pReader->pDataFD;
+  int64_t  size = 0;
+
+  for (int32_t iSubBlock = 0; iSubBlock < pDataBlk->nSubBlock; iSubBlock++) {
+    SBlockInfo *pBlockInfo = &pDataBlk->aSubBlock[iSubBlock];
+
+    int64_t pgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(pBlockInfo->offset, pFD->szPage), pFD->szPage);
+    int64_t fOffset = PAGE_OFFSET(pgno, pFD->szPage);
+    int64_t fEnd = tsdbLogicToFileSize(pBlockInfo->offset + pBlockInfo->szBlock, pFD->szPage);
+
+    if (fOffset < pFD->raOffset || fOffset > pFD->raEnd) {
+      tsdbPrefetchFlush(pReader);
+      pFD->raOffset = fOffset;
+      pFD->raIssued = fOffset;
+      pFD->raEnd = fEnd;
+    } else if (fEnd > pFD->raEnd) {
+      pFD->raEnd = fEnd;
+    }
+    size += pBlockInfo->szBlock;
+  }
+
+  return size;
+}
+
+void tsdbPrefetchFlush(SDataFReader *pReader) {
+  STsdbFD *pFD = pReader->pDataFD;
+
+  if (pFD->raIssued < pFD->raEnd) {
+    taosPrefetchFile(pFD->pFD, pFD->raIssued, pFD->raEnd - pFD->raIssued);
+    pFD->raIssued = pFD->raEnd;
+    pFD->nPrefetch++;
+  }
+}
+
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -283,6 +283,9 @@ static int32_t vnodeCommitTask(void *arg) {
   // end commit
   tsem_post(&pInfo->pVnode->canCommit);
 
+  // compact on the compaction pool, swapping results in under canCommit
+  tsdbScheduleCompact(pInfo->pVnode->pTsdb, pInfo->info.state.commitID);
+
 _exit:
   taosMemoryFree(pInfo);
   return code;
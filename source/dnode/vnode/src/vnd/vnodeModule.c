@@ -23,14 +23,21 @@ struct SVnodeTask {
   void* arg;
 };
 
-struct SVnodeGlobal {
-  int8_t        init;
+typedef struct {
   int8_t        stop;
   int           nthreads;
   TdThread*     threads;
   TdThreadMutex mutex;
   TdThreadCond  hasTask;
   SVnodeTask    queue;
+  const char*   name;
+} SVnodeThreadPool;
+
+struct SVnodeGlobal {
+  int8_t           init;
+  SVnodeThreadPool commitPool;
+  SVnodeThreadPool compactPool;  // compaction rounds, kept apart so they never hold up a commit
+  SVnodeThreadPool fsetPool;     // file sets of a tsdb commit, written next to the committing thread
 };
 
 struct SVnodeGlobal vnodeGlobal;
@@ -43,36 +50,116 @@ static void vnodeInitCommit() { tsem_init(&canCommit, 0, 4); };
 void        vnode_wait_commit() { tsem_wait(&canCommit); }
 void        vnode_done_commit() { tsem_wait(&canCommit); }
 
-int vnodeInit(int nthreads) {
-  int8_t init;
-  int    ret;
+static int vnodeThreadPoolOpen(SVnodeThreadPool* pPool, const char* name, int nthreads) {
+  taosThreadMutexInit(&pPool->mutex, NULL);
+  taosThreadCondInit(&pPool->hasTask, NULL);
 
-  init = atomic_val_compare_exchange_8(&(vnodeGlobal.init), 0, 1);
-  if (init) {
-    return 0;
+  taosThreadMutexLock(&pPool->mutex);
+
+  pPool->stop = 0;
+  pPool->name = name;
+  pPool->queue.next = &pPool->queue;
+  pPool->queue.prev = &pPool->queue;
+
+  taosThreadMutexUnlock(&(pPool->mutex));
+
+  pPool->nthreads = nthreads;
+  pPool->threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
+  if (pPool->threads == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    vError("failed to init vnode %s pool since:%s", name, tstrerror(terrno));
+    return -1;
   }
 
-  taosThreadMutexInit(&vnodeGlobal.mutex, NULL);
-  taosThreadCondInit(&vnodeGlobal.hasTask, NULL);
+  for (int i = 0; i < nthreads; i++) {
+    taosThreadCreate(&(pPool->threads[i]), NULL, loop, pPool);
+  }
+
+  return 0;
+}
+
+static void vnodeThreadPoolClose(SVnodeThreadPool* pPool) {
+  // set stop
+  taosThreadMutexLock(&(pPool->mutex));
+  pPool->stop = 1;
+  taosThreadCondBroadcast(&(pPool->hasTask));
+  taosThreadMutexUnlock(&(pPool->mutex));
 
-  taosThreadMutexLock(&vnodeGlobal.mutex);
+  // wait for threads
+  for (int i = 0; i < pPool->nthreads; i++) {
+    taosThreadJoin(pPool->threads[i], NULL);
+  }
+
+  // clear source
+  taosMemoryFreeClear(pPool->threads);
+  taosThreadCondDestroy(&(pPool->hasTask));
+  taosThreadMutexDestroy(&(pPool->mutex));
+}
 
-  vnodeGlobal.stop = 0;
-  vnodeGlobal.queue.next = &vnodeGlobal.queue;
-  vnodeGlobal.queue.prev = &vnodeGlobal.queue;
+static int vnodeThreadPoolPut(SVnodeThreadPool* pPool, int (*execute)(void*), void* arg) {
+  SVnodeTask* pTask;
 
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+  ASSERT(!pPool->stop);
 
-  vnodeGlobal.nthreads = nthreads;
-  vnodeGlobal.threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
-  if (vnodeGlobal.threads == NULL) {
+  pTask = taosMemoryMalloc(sizeof(*pTask));
+  if (pTask == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
-    vError("failed to init vnode module since:%s", tstrerror(terrno));
     return -1;
   }
 
-  for (int i = 0; i < nthreads; i++) {
-    taosThreadCreate(&(vnodeGlobal.threads[i]), NULL, loop, NULL);
+  pTask->execute = execute;
+  pTask->arg = arg;
+
+  taosThreadMutexLock(&(pPool->mutex));
+  pTask->next = &pPool->queue;
+  pTask->prev = pPool->queue.prev;
+  pPool->queue.prev->next = pTask;
+  pPool->queue.prev = pTask;
+  taosThreadCondSignal(&(pPool->hasTask));
+  taosThreadMutexUnlock(&(pPool->mutex));
+
+  return 0;
+}
+
+// remove the first queued task that runs execute and whose argument fp accepts, returns its argument or NULL if no
+// such task is queued
+static void* vnodeThreadPoolCancel(SVnodeThreadPool* pPool, int (*execute)(void*), bool (*fp)(void*, void*),
+                                   void* param) {
+  SVnodeTask* pTask;
+  void*       arg = NULL;
+
+  taosThreadMutexLock(&(pPool->mutex));
+  for (pTask = pPool->queue.next; pTask != &pPool->queue; pTask = pTask->next) {
+    if (pTask->execute == execute && fp(pTask->arg, param)) {
+      pTask->prev->next = pTask->next;
+      pTask->next->prev = pTask->prev;
+      arg = pTask->arg;
+      taosMemoryFree(pTask);
+      break;
+    }
+  }
+  taosThreadMutexUnlock(&(pPool->mutex));
+
+  return arg;
+}
+
+int vnodeInit(int nthreads, int nCompactThreads, int nFSetThreads) {
+  int8_t init;
+  int    ret;
+
+  init = atomic_val_compare_exchange_8(&(vnodeGlobal.init), 0, 1);
+  if (init) {
+    return 0;
+  }
+
+  if (vnodeThreadPoolOpen(&vnodeGlobal.commitPool, "commit", nthreads) < 0) {
+    return -1;
+  }
+  if (vnodeThreadPoolOpen(&vnodeGlobal.compactPool, "compact", nCompactThreads) < 0) {
+    return -1;
+  }
+  if (vnodeThreadPoolOpen(&vnodeGlobal.fsetPool, "fset", nFSetThreads) < 0) {
+    return -1;
   }
 
   if (walInit() < 0) {
@@ -91,21 +178,10 @@ void vnodeCleanup() {
   init = atomic_val_compare_exchange_8(&(vnodeGlobal.init), 1, 0);
   if (init == 0) return;
 
-  // set stop
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
-  vnodeGlobal.stop = 1;
-  taosThreadCondBroadcast(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
-
-  // wait for threads
-  for (int i = 0; i < vnodeGlobal.nthreads; i++) {
-    taosThreadJoin(vnodeGlobal.threads[i], NULL);
-  }
-
-  // clear source
-  taosMemoryFreeClear(vnodeGlobal.threads);
-  taosThreadCondDestroy(&(vnodeGlobal.hasTask));
-  taosThreadMutexDestroy(&(vnodeGlobal.mutex));
+  // commit tasks schedule compaction, so the commit pool goes first
+  vnodeThreadPoolClose(&vnodeGlobal.commitPool);
+  vnodeThreadPoolClose(&vnodeGlobal.compactPool);
+  vnodeThreadPoolClose(&vnodeGlobal.fsetPool);
 
   walCleanUp();
   tqCleanUp();
@@ -113,48 +189,42 @@ void vnodeCleanup() {
 }
 
 int vnodeScheduleTask(int (*execute)(void*), void* arg) {
-  SVnodeTask* pTask;
-
-  ASSERT(!vnodeGlobal.stop);
-
-  pTask = taosMemoryMalloc(sizeof(*pTask));
-  if (pTask == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    return -1;
-  }
+  return vnodeThreadPoolPut(&vnodeGlobal.commitPool, execute, arg);
+}
 
-  pTask->execute = execute;
-  pTask->arg = arg;
+int vnodeScheduleCompactTask(int (*execute)(void*), void* arg) {
+  return vnodeThreadPoolPut(&vnodeGlobal.compactPool, execute, arg);
+}
 
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
-  pTask->next = &vnodeGlobal.queue;
-  pTask->prev = vnodeGlobal.queue.prev;
-  vnodeGlobal.queue.prev->next = pTask;
-  vnodeGlobal.queue.prev = pTask;
-  taosThreadCondSignal(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+void* vnodeCancelCompactTask(int (*execute)(void*), bool (*fp)(void*, void*), void* param) {
+  return vnodeThreadPoolCancel(&vnodeGlobal.compactPool, execute, fp, param);
+}
 
-  return 0;
+int vnodeScheduleFSetTask(int (*execute)(void*), void* arg) {
+  return vnodeThreadPoolPut(&vnodeGlobal.fsetPool, execute, arg);
 }
 
 /* ------------------------ STATIC METHODS ------------------------ */
 static void* loop(void* arg) {
-  SVnodeTask* pTask;
-  int         ret;
+  SVnodeThreadPool* pPool = (SVnodeThreadPool*)arg;
+  SVnodeTask*       pTask;
+  int               ret;
+  char              name[16];
 
-  setThreadName("vnode-commit");
+  snprintf(name, sizeof(name), "vnode-%s", pPool->name);
+  setThreadName(name);
 
   for (;;) {
-    taosThreadMutexLock(&(vnodeGlobal.mutex));
+    taosThreadMutexLock(&(pPool->mutex));
     for (;;) {
-      pTask = vnodeGlobal.queue.next;
-      if (pTask == &vnodeGlobal.queue) {
+      pTask = pPool->queue.next;
+      if (pTask == &pPool->queue) {
         // no task
-        if (vnodeGlobal.stop) {
-          taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+        if (pPool->stop) {
+          taosThreadMutexUnlock(&(pPool->mutex));
           return NULL;
         } else {
-          taosThreadCondWait(&(vnodeGlobal.hasTask), &(vnodeGlobal.mutex));
+          taosThreadCondWait(&(pPool->hasTask), &(pPool->mutex));
         }
       } else {
         // has task
@@ -164,7 +234,7 @@ static void* loop(void* arg) {
       }
     }
 
-    taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+    taosThreadMutexUnlock(&(pPool->mutex));
 
     pTask->execute(pTask->arg);
     taosMemoryFree(pTask);
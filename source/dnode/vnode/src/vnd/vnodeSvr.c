@@ -302,6 +302,10 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
     case TDMT_VND_COMMIT:
       needCommit = true;
       break;
+    case TDMT_VND_COMPACT:
+      tsdbRequestCompact(pVnode->pTsdb);
+      needCommit = true;
+      break;
     default:
       vError("vgId:%d, unprocessed msg, %d", TD_VID(pVnode), pMsg->msgType);
       return -1;
@@ -487,6 +491,7 @@ static int32_t vnodeProcessDropTtlTbReq(SVnode *pVnode, int64_t version, void *p
   }
   if (taosArrayGetSize(tbUids) > 0) {
     tqUpdateTbUidList(pVnode->pTq, tbUids, false);
+    tsdbCacheDropTable(pVnode->pTsdb, tbUids);
   }
 
 end:
@@ -692,6 +697,7 @@ static int32_t vnodeProcessDropStbReq(SVnode *pVnode, int64_t version, void *pRe
     rcode = terrno;
     goto _exit;
   }
+  tsdbCacheDropTable(pVnode->pTsdb, tbUidList);
 
   if (tdProcessRSmaDrop(pVnode->pSma, &req) < 0) {
     rcode = terrno;
@@ -807,6 +813,7 @@ static int32_t vnodeProcessDropTbReq(SVnode *pVnode, int64_t version, void *pReq
 
   tqUpdateTbUidList(pVnode->pTq, tbUids, false);
   tdUpdateTbUidList(pVnode->pSma, pStore, false);
+  tsdbCacheDropTable(pVnode->pTsdb, tbUids);
 
 _exit:
   taosArrayDestroy(tbUids);
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+const int64_t MS_PER_DAY = 24 * 3600 * 1000LL;
+
+}  // namespace
+
+class TsdbCacheTest : public TsdbTest {
+ protected:
+  void SetUp() override {
+    TsdbTest::SetUp();
+    uid = createTable("t1");
+    fid = fileSetOf(taosGetTimestampMs() - 15 * MS_PER_DAY);
+    sKey = fileSetStart(fid) + 1000;
+    enableCache();
+  }
+
+  // both last_row and last
+  void enableCache() { pVnode->config.cacheLast = 3; }
+
+  // the last_row (cacheType 0) or last (cacheType 1) entry of the table as a query sees it, false if it has none
+  bool getCached(int8_t cacheType, SLastCol *pTs, SLastCol *pV) {
+    STableKeyInfo     info = {.uid = (uint64_t)uid, .groupId = 0};
+    int32_t           type = CACHESCAN_RETRIEVE_TYPE_SINGLE |
+                   (cacheType == 0 ? CACHESCAN_RETRIEVE_LAST_ROW : CACHESCAN_RETRIEVE_LAST);
+    SCacheRowsReader *pr = NULL;
+    LRUHandle        *h = NULL;
+
+    EXPECT_EQ(tsdbCacherowsReaderOpen(pVnode, type, &info, 1, 2, 0, (void **)&pr, "tsdbCacheTest"), 0);
+    EXPECT_EQ(tsdbTakeReadSnap(pTsdb, &pr->pReadSnap, "tsdbCacheTest"), 0);
+    if (cacheType == 0) {
+      EXPECT_EQ(tsdbCacheGetLastrowH(pTsdb->lruCache, uid, pr, &h), 0);
+    } else {
+      EXPECT_EQ(tsdbCacheGetLastH(pTsdb->lruCache, uid, pr, &h), 0);
+    }
+    if (h) {
+      SArray *pArray = (SArray *)taosLRUCacheValue(pTsdb->lruCache, h);
+      EXPECT_EQ(taosArrayGetSize(pArray), 2);
+      *pTs = *(SLastCol *)taosArrayGet(pArray, 0);
+      *pV = *(SLastCol *)taosArrayGet(pArray, 1);
+      tsdbCacheRelease(pTsdb->lruCache, h);
+    }
+    tsdbUntakeReadSnap(pTsdb, pr->pReadSnap, "tsdbCacheTest");
+    pr->pReadSnap = NULL;
+    tsdbCacherowsReaderClose(pr);
+    return h != NULL;
+  }
+
+  bool isDirty(int8_t cacheType) {
+    uint64_t key = cacheType == 0 ? (uint64_t)uid : ((uint64_t)uid | 0x8000000000000000);
+    return taosHashGet(pTsdb->pLastDirty, &key, sizeof(key)) != NULL;
+  }
+
+  void cachePath(char *path) {
+    snprintf(path, TSDB_FILENAME_LEN, "%s%s%s%scache", tfsGetPrimaryPath(pTfs), TD_DIRSEP, pTsdb->path, TD_DIRSEP);
+  }
+
+  // a persisted entry as an earlier commit would have left it, the value does not matter here
+  void persistEntry(tb_uid_t uid) {
+    TXN    *pTxn = NULL;
+    uint8_t val[8] = {0};
+
+    ASSERT_EQ(tdbBegin(pTsdb->pCacheDb, &pTxn, tdbDefaultMalloc, tdbDefaultFree, NULL,
+                       TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED),
+              0);
+    ASSERT_EQ(tdbTbUpsert(pTsdb->pLastDb, &uid, sizeof(uid), val, sizeof(val), pTxn), 0);
+    ASSERT_EQ(tdbCommit(pTsdb->pCacheDb, pTxn), 0);
+    ASSERT_EQ(tdbPostCommit(pTsdb->pCacheDb, pTxn), 0);
+    pTsdb->lastDbUsed = 1;
+  }
+
+  int32_t countEntries() {
+    TBC    *pCur = NULL;
+    void   *pKey = NULL;
+    void   *pVal = NULL;
+    int     kLen = 0;
+    int     vLen = 0;
+    int32_t n = 0;
+
+    if (tdbTbcOpen(pTsdb->pLastDb, &pCur, NULL) != 0) return -1;
+    tdbTbcMoveToFirst(pCur);
+    while (tdbTbcNext(pCur, &pKey, &kLen, &pVal, &vLen) == 0) n++;
+    tdbFree(pKey);
+    tdbFree(pVal);
+    tdbTbcClose(pCur);
+    return n;
+  }
+
+  tb_uid_t uid = 0;
+  int32_t  fid = 0;
+  TSKEY    sKey = 0;
+};
+
+TEST_F(TsdbCacheTest, invalidateDropsEntries) {
+  ASSERT_NE(pTsdb->pLastDb, nullptr);
+  persistEntry(uid);
+  ASSERT_EQ(countEntries(), 1);
+
+  // the db still works, only the entries go
+  tsdbCacheInvalidate(pTsdb);
+  ASSERT_NE(pTsdb->pLastDb, nullptr);
+  ASSERT_EQ(countEntries(), 0);
+  ASSERT_EQ(pTsdb->lastDbUsed, 0);
+
+  insertRows(uid, sKey, 100, 1000, 1);
+  commit();
+  waitCompact();
+  ASSERT_NE(pTsdb->pLastDb, nullptr);
+}
+
+TEST_F(TsdbCacheTest, commitSurvivesCacheFailure) {
+  std::vector<STestRow> rows;
+  char                  path[TSDB_FILENAME_LEN];
+
+  persistEntry(uid);
+  insertRows(uid, sKey, 100, 1000, 1);
+
+  // no journal can be opened any more, persisting fails and so does dropping the entries
+  cachePath(path);
+  taosRemoveDir(path);
+  commit();
+  waitCompact();
+
+  // the data is committed all the same and the cache is not persisted any more
+  ASSERT_EQ(pTsdb->pLastDb, nullptr);
+  ASSERT_EQ(pTsdb->pCacheDb, nullptr);
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 100);
+
+  // later commits go on without it
+  insertRows(uid, sKey + 100 * 1000, 100, 1000, 2);
+  commit();
+  waitCompact();
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 200);
+
+  // a restart finds neither the data lost nor the stale entry
+  reopen();
+  enableCache();
+  ASSERT_NE(pTsdb->pLastDb, nullptr);
+  ASSERT_EQ(countEntries(), 0);
+  ASSERT_EQ(pTsdb->lastDbUsed, 0);
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 200);
+
+  insertRows(uid, sKey + 200 * 1000, 100, 1000, 3);
+  commit();
+  waitCompact();
+  ASSERT_NE(pTsdb->pLastDb, nullptr);
+}
+
+class TsdbPageCacheTest : public TsdbTest {
+ protected:
+  void SetUp() override {
+    pageCacheSize = tsTsdbPageCacheSize;
+    tsTsdbPageCacheSize = 1;
+    TsdbTest::SetUp();
+    uid = createTable("t1");
+    fid = fileSetOf(taosGetTimestampMs() - 15 * MS_PER_DAY);
+  }
+
+  void TearDown() override {
+    TsdbTest::TearDown();
+    tsTsdbPageCacheSize = pageCacheSize;
+  }
+
+  void getStat(int64_t *nHit, int64_t *nMiss) {
+    size_t usage = 0;
+    tsdbPgCacheGetStat(pTsdb, nHit, nMiss, &usage);
+    ASSERT_LE(usage, (size_t)tsTsdbPageCacheSize * 1024 * 1024);
+  }
+
+  tb_uid_t uid = 0;
+  int32_t  fid = 0;
+  int32_t  pageCacheSize = 0;
+};
+
+TEST_F(TsdbPageCacheTest, hitMissEvict) {
+  std::vector<STestRow> rows;
+  std::vector<STestRow> cached;
+  std::vector<int64_t>  values;
+  int64_t               nHit = 0, nMiss = 0, nHit1 = 0, nMiss1 = 0;
+
+  // values that do not compress, so the file spans many pages
+  const int32_t nRows = 8000;
+  TSKEY         sKey = fileSetStart(fid);
+  uint64_t      seed = 1;
+  for (int32_t i = 0; i < nRows; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    values.push_back((int64_t)seed);
+    insertRows(uid, sKey + i * 1000LL, 1, 1000, values.back());
+  }
+  commit();
+  waitCompact();
+
+  // the first read fills the cache
+  getStat(&nHit, &nMiss);
+  readFileSet(fid, rows);
+  getStat(&nHit1, &nMiss1);
+  ASSERT_GT(nMiss1 - nMiss, 0);
+  ASSERT_EQ(rows.size(), nRows);
+  for (int32_t i = 0; i < nRows; i++) {
+    ASSERT_EQ(rows[i].ts, sKey + i * 1000LL);
+    ASSERT_EQ(rows[i].value, values[i]);
+  }
+
+  // the second is served from it
+  readFileSet(fid, cached);
+  getStat(&nHit, &nMiss);
+  ASSERT_EQ(nMiss, nMiss1);
+  ASSERT_GT(nHit, nHit1);
+  ASSERT_EQ(cached.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_EQ(cached[i].ts, rows[i].ts);
+    ASSERT_EQ(cached[i].version, rows[i].version);
+    ASSERT_EQ(cached[i].value, rows[i].value);
+  }
+
+  // pages of another file four times the capacity push them out, least recently used first
+  int32_t              szPage = pVnode->config.tsdbPageSize;
+  int64_t              nPage = 4 * (int64_t)tsTsdbPageCacheSize * 1024 * 1024 / szPage;
+  std::vector<uint8_t> page(szPage), out(szPage);
+  STsdbPgKey           key = {.fid = fid, .ftype = TSDB_DATA_FILE, .commitID = -1, .pgno = 0};
+  for (key.pgno = 2; key.pgno < nPage + 2; key.pgno++) {
+    memcpy(page.data(), &key.pgno, sizeof(key.pgno));
+    tsdbPgCachePut(pTsdb, &key, page.data(), szPage);
+  }
+
+  getStat(&nHit1, &nMiss1);
+  key.pgno = 2;
+  ASSERT_FALSE(tsdbPgCacheGet(pTsdb, &key, out.data(), szPage));
+  key.pgno = nPage + 1;
+  ASSERT_TRUE(tsdbPgCacheGet(pTsdb, &key, out.data(), szPage));
+  ASSERT_EQ(memcmp(out.data(), &key.pgno, sizeof(key.pgno)), 0);
+  getStat(&nHit, &nMiss);
+  ASSERT_EQ(nHit, nHit1 + 1);
+  ASSERT_EQ(nMiss, nMiss1 + 1);
+
+  // and the file is read from disk again
+  readFileSet(fid, cached);
+  getStat(&nHit1, &nMiss1);
+  ASSERT_GT(nMiss1, nMiss);
+  ASSERT_EQ(cached.size(), rows.size());
+}
+
+TEST_F(TsdbCacheTest, persistedMergedWithMemory) {
+  SLastCol ts = {0}, v = {0};
+
+  // both entries are merged from memory and persisted by the commit
+  insertRows(uid, sKey, 10, 1000, 1);
+  for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+    ASSERT_TRUE(getCached(cacheType, &ts, &v));
+    ASSERT_EQ(ts.ts, sKey + 9 * 1000);
+    ASSERT_TRUE(isDirty(cacheType));
+  }
+  commit();
+  waitCompact();
+  ASSERT_EQ(countEntries(), 2);
+
+  // after a restart, rows newer than the persisted ones are put on top of them
+  reopen();
+  enableCache();
+  insertRows(uid, sKey + 100 * 1000, 5, 1000, 2);
+  for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+    ASSERT_TRUE(getCached(cacheType, &ts, &v));
+    ASSERT_EQ(ts.ts, sKey + 104 * 1000);
+    ASSERT_EQ(ts.colVal.value.val, sKey + 104 * 1000);
+    ASSERT_EQ(v.ts, sKey + 104 * 1000);
+    ASSERT_EQ(v.colVal.value.val, 2);
+    ASSERT_FALSE(isDirty(cacheType));
+  }
+
+  // and so are rows older than them, which do not win
+  reopen();
+  enableCache();
+  insertRows(uid, sKey - 100 * 1000, 5, 1000, 3);
+  for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+    ASSERT_TRUE(getCached(cacheType, &ts, &v));
+    ASSERT_EQ(ts.ts, sKey + 9 * 1000);
+    ASSERT_EQ(v.colVal.value.val, 1);
+    ASSERT_FALSE(isDirty(cacheType));
+  }
+}
+
+TEST_F(TsdbCacheTest, dropTableDropsEntries) {
+  SLastCol ts = {0}, v = {0};
+  tb_uid_t uid2 = createTable("t2");
+
+  insertRows(uid, sKey, 10, 1000, 1);
+  insertRows(uid2, sKey, 10, 1000, 1);
+  for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+    ASSERT_TRUE(getCached(cacheType, &ts, &v));
+  }
+  std::swap(uid, uid2);
+  for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+    ASSERT_TRUE(getCached(cacheType, &ts, &v));
+  }
+  std::swap(uid, uid2);
+  commit();
+  waitCompact();
+  ASSERT_EQ(countEntries(), 4);
+
+  // the lru entries of the dropped table go at once, the persisted ones with the next commit
+  SArray *aUid = taosArrayInit(1, sizeof(tb_uid_t));
+  taosArrayPush(aUid, &uid);
+  tsdbCacheDropTable(pTsdb, aUid);
+  taosArrayDestroy(aUid);
+  for (int8_t cacheType = 0; cacheType < 2; cacheType++) {
+    uint64_t key = cacheType == 0 ? (uint64_t)uid : ((uint64_t)uid | 0x8000000000000000);
+    ASSERT_EQ(taosLRUCacheLookup(pTsdb->lruCache, &key, sizeof(key)), nullptr);
+    ASSERT_TRUE(isDirty(cacheType));
+  }
+
+  insertRows(uid2, sKey + 10 * 1000, 10, 1000, 2);
+  commit();
+  waitCompact();
+  ASSERT_EQ(countEntries(), 2);
+}
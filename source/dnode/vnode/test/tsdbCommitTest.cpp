@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+const int64_t MS_PER_DAY = 24 * 3600 * 1000LL;
+const int32_t NUM_OF_TABLES = 5;
+const int32_t NUM_OF_FSETS = 7;
+const int32_t NUM_OF_ROWS = 200;
+
+bool rowLess(const STestRow &r1, const STestRow &r2) {
+  if (r1.uid != r2.uid) return r1.uid < r2.uid;
+  if (r1.ts != r2.ts) return r1.ts < r2.ts;
+  return r1.version < r2.version;
+}
+
+}  // namespace
+
+class TsdbCommitTest : public TsdbTest {
+ protected:
+  void SetUp() override {
+    TsdbTest::SetUp();
+    commitThreads = tsTsdbCommitThreads;
+
+    char name[TSDB_TABLE_NAME_LEN];
+    for (int32_t i = 0; i < NUM_OF_TABLES; i++) {
+      snprintf(name, sizeof(name), "t%d", i);
+      uids.push_back(createTable(name));
+    }
+    std::sort(uids.begin(), uids.end());
+
+    int32_t fid = fileSetOf(taosGetTimestampMs() - 60 * MS_PER_DAY);
+    for (int32_t i = 0; i < NUM_OF_FSETS; i++) {
+      fids.push_back(fid + i);
+    }
+  }
+
+  void TearDown() override {
+    tsTsdbCommitThreads = commitThreads;
+    TsdbTest::TearDown();
+  }
+
+  // every table gets NUM_OF_ROWS rows in every file set, the value tells the table, file set and round apart
+  void insertAll(int64_t round) {
+    for (int32_t iTb = 0; iTb < NUM_OF_TABLES; iTb++) {
+      for (int32_t iFid = 0; iFid < NUM_OF_FSETS; iFid++) {
+        insertRows(uids[iTb], fileSetStart(fids[iFid]) + 1000, NUM_OF_ROWS, 1000, valueOf(iTb, iFid, round));
+      }
+    }
+  }
+
+  void checkAll(int64_t round) {
+    std::vector<STestRow> rows;
+
+    for (int32_t iFid = 0; iFid < NUM_OF_FSETS; iFid++) {
+      readFileSet(fids[iFid], rows);
+      std::sort(rows.begin(), rows.end(), rowLess);
+
+      // the latest round of each key, older versions may be kept in other files
+      std::vector<STestRow> latest;
+      for (size_t i = 0; i < rows.size(); i++) {
+        if (!latest.empty() && latest.back().uid == rows[i].uid && latest.back().ts == rows[i].ts) {
+          latest.back() = rows[i];
+        } else {
+          latest.push_back(rows[i]);
+        }
+      }
+
+      ASSERT_EQ(latest.size(), NUM_OF_TABLES * NUM_OF_ROWS);
+      for (int32_t iTb = 0; iTb < NUM_OF_TABLES; iTb++) {
+        for (int32_t iRow = 0; iRow < NUM_OF_ROWS; iRow++) {
+          STestRow &row = latest[iTb * NUM_OF_ROWS + iRow];
+          ASSERT_EQ(row.uid, uids[iTb]);
+          ASSERT_EQ(row.ts, fileSetStart(fids[iFid]) + 1000 + iRow * 1000);
+          ASSERT_EQ(row.value, valueOf(iTb, iFid, round));
+        }
+      }
+    }
+  }
+
+  static int64_t valueOf(int32_t iTb, int32_t iFid, int64_t round) { return round * 10000 + iTb * 100 + iFid; }
+
+  int32_t               commitThreads = 0;
+  std::vector<tb_uid_t> uids;
+  std::vector<int32_t>  fids;
+};
+
+TEST_F(TsdbCommitTest, parallelFileSets) {
+  int32_t nSttF = 0;
+  bool    hasData = false;
+
+  // more file sets than workers, the workers claim them one at a time
+  tsTsdbCommitThreads = 4;
+  insertAll(1);
+  commit();
+  waitCompact();
+
+  for (int32_t iFid = 0; iFid < NUM_OF_FSETS; iFid++) {
+    ASSERT_TRUE(getFileSet(fids[iFid], &nSttF, &hasData));
+    ASSERT_EQ(nSttF, 1);
+  }
+  checkAll(1);
+
+  // the second commit reads back what the first one wrote on other threads
+  insertAll(2);
+  commit();
+  waitCompact();
+  checkAll(2);
+
+  // and the result survives a restart
+  reopen();
+  checkAll(2);
+}
+
+TEST_F(TsdbCommitTest, sameAsSingleWorker) {
+  std::vector<STestRow> rows;
+
+  tsTsdbCommitThreads = 1;
+  insertAll(1);
+  commit();
+  waitCompact();
+  checkAll(1);
+
+  std::vector<std::vector<STestRow>> single(NUM_OF_FSETS);
+  for (int32_t iFid = 0; iFid < NUM_OF_FSETS; iFid++) {
+    readFileSet(fids[iFid], single[iFid]);
+    std::sort(single[iFid].begin(), single[iFid].end(), rowLess);
+  }
+
+  // the same commit spread over more workers than file sets writes the same rows
+  tsTsdbCommitThreads = NUM_OF_FSETS + 2;
+  insertAll(2);
+  commit();
+  waitCompact();
+  checkAll(2);
+
+  for (int32_t iFid = 0; iFid < NUM_OF_FSETS; iFid++) {
+    readFileSet(fids[iFid], rows);
+    ASSERT_EQ(rows.size(), 2 * single[iFid].size());
+  }
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+const int64_t MS_PER_DAY = 24 * 3600 * 1000LL;
+
+bool rowLess(const STestRow &r1, const STestRow &r2) {
+  if (r1.uid != r2.uid) return r1.uid < r2.uid;
+  if (r1.ts != r2.ts) return r1.ts < r2.ts;
+  return r1.version < r2.version;
+}
+
+// a task of another vnode that holds the compaction thread until it is released
+int32_t tsdbTestHoldPool(void *arg) {
+  int8_t *pHold = (int8_t *)arg;
+  atomic_store_8(&pHold[1], 1);
+  while (atomic_load_8(&pHold[0])) taosMsleep(1);
+  atomic_store_8(&pHold[1], 0);
+  return 0;
+}
+
+}  // namespace
+
+class TsdbCompactTest : public TsdbTest {
+ protected:
+  void SetUp() override {
+    TsdbTest::SetUp();
+    uid = createTable("t1");
+    fid = fileSetOf(taosGetTimestampMs() - 15 * MS_PER_DAY);
+    sKey = fileSetStart(fid) + 1000;
+  }
+
+  // wait until the file set is down to at most one stt file
+  bool waitSttMerged(int32_t fid) {
+    for (int32_t i = 0; i < 500; i++) {
+      int32_t nSttF = 0;
+      if (getFileSet(fid, &nSttF, NULL) && nSttF <= 1 && !atomic_load_8(&pTsdb->compactRunning)) return true;
+      taosMsleep(10);
+    }
+    return false;
+  }
+
+  tb_uid_t uid = 0;
+  int32_t  fid = 0;
+  TSKEY    sKey = 0;
+};
+
+TEST_F(TsdbCompactTest, mergeSttFiles) {
+  std::vector<STestRow> rows;
+  int32_t               nSttF = 0;
+
+  insertRows(uid, sKey, 100, 1000, 1);
+  commit();
+  insertRows(uid, sKey + 50 * 1000, 100, 1000, 2);
+  commit();
+  insertRows(uid, sKey, 10, 1000, 3);
+  int64_t lastVer = version;
+  commit();
+  waitCompact();
+
+  // not forced and the trigger is off, every commit left its own stt file
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  ASSERT_EQ(nSttF, 3);
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 210);
+
+  compact();
+
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  ASSERT_LE(nSttF, 1);
+
+  // one row per key, the one of the latest version
+  readFileSet(fid, rows);
+  std::sort(rows.begin(), rows.end(), rowLess);
+  ASSERT_EQ(rows.size(), 150);
+  for (int32_t i = 0; i < (int32_t)rows.size(); i++) {
+    ASSERT_EQ(rows[i].uid, uid);
+    ASSERT_EQ(rows[i].ts, sKey + i * 1000);
+    if (i < 10) {
+      ASSERT_EQ(rows[i].value, 3);
+      ASSERT_EQ(rows[i].version, lastVer);
+    } else if (i < 50) {
+      ASSERT_EQ(rows[i].value, 1);
+    } else {
+      ASSERT_EQ(rows[i].value, 2);
+    }
+  }
+}
+
+TEST_F(TsdbCompactTest, purgeDeletedRows) {
+  std::vector<STestRow> rows;
+  std::vector<SDelInfo> delInfos;
+
+  insertRows(uid, sKey, 100, 1000, 1);
+  commit();
+  deleteRows(uid, sKey + 10 * 1000, sKey + 19 * 1000);
+  commit();
+  waitCompact();
+
+  readDelFile(delInfos);
+  ASSERT_EQ(delInfos.size(), 1);
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 100);
+
+  compact();
+
+  // the deleted rows are gone from the files and the applied delete from the del file
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 90);
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_TRUE(rows[i].ts < sKey + 10 * 1000 || rows[i].ts > sKey + 19 * 1000);
+  }
+  readDelFile(delInfos);
+  ASSERT_EQ(delInfos.size(), 0);
+}
+
+TEST_F(TsdbCompactTest, scheduleOnCompactPool) {
+  int32_t nSttF = 0;
+
+  for (int32_t i = 0; i < 3; i++) {
+    insertRows(uid, sKey, 100, 1000, i);
+    commit();
+  }
+  waitCompact();
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  ASSERT_EQ(nSttF, 3);
+
+  // the round after a commit is queued by the commit task and runs on the compaction pool
+  tsdbRequestCompact(pTsdb);
+  insertRows(uid, sKey - 30 * MS_PER_DAY, 10, 1000, 0);
+  commit();
+  ASSERT_TRUE(waitSttMerged(fid));
+
+  // or queued directly
+  for (int32_t i = 0; i < 2; i++) {
+    insertRows(uid, sKey, 100, 1000, i);
+    commit();
+  }
+  waitCompact();
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  ASSERT_GE(nSttF, 2);
+
+  commit();
+  waitCompact();
+  tsdbRequestCompact(pTsdb);
+  ASSERT_EQ(tsdbScheduleCompact(pTsdb, pVnode->state.commitID - 1), 0);
+  ASSERT_TRUE(waitSttMerged(fid));
+
+  // nothing is queued once compaction is stopped
+  insertRows(uid, sKey, 100, 1000, 5);
+  commit();
+  waitCompact();
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  int32_t nSttFBefore = nSttF;
+
+  tsdbStopCompact(pTsdb);
+  tsdbRequestCompact(pTsdb);
+  ASSERT_EQ(tsdbScheduleCompact(pTsdb, pVnode->state.commitID - 1), 0);
+  ASSERT_EQ(atomic_load_8(&pTsdb->compactRunning), 0);
+  waitCompact();
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  ASSERT_EQ(nSttF, nSttFBefore);
+}
+
+TEST_F(TsdbCompactTest, dropEmptyFileSet) {
+  std::vector<STestRow> rows;
+  std::vector<SDelInfo> delInfos;
+
+  insertRows(uid, sKey, 100, 1000, 1);
+  commit();
+  deleteRows(uid, sKey, sKey + 99 * 1000);
+  commit();
+  waitCompact();
+  ASSERT_TRUE(getFileSet(fid, NULL, NULL));
+
+  // no row is left, so the file set goes instead of being rewritten as empty files
+  compact();
+  ASSERT_FALSE(getFileSet(fid, NULL, NULL));
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 0);
+  readDelFile(delInfos);
+  ASSERT_EQ(delInfos.size(), 0);
+
+  // and comes back with the next rows
+  insertRows(uid, sKey, 10, 1000, 2);
+  commit();
+  waitCompact();
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 10);
+
+  reopen();
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 10);
+}
+
+TEST_F(TsdbCompactTest, stopCancelsQueuedRound) {
+  int32_t nSttF = 0;
+  int8_t  hold[2] = {1, 0};
+
+  for (int32_t i = 0; i < 2; i++) {
+    insertRows(uid, sKey, 100, 1000, i);
+    commit();
+  }
+  waitCompact();
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  ASSERT_EQ(nSttF, 2);
+
+  // the round is queued behind one that holds the only compaction thread
+  ASSERT_EQ(vnodeScheduleCompactTask(tsdbTestHoldPool, hold), 0);
+  tsdbRequestCompact(pTsdb);
+  ASSERT_EQ(tsdbScheduleCompact(pTsdb, pVnode->state.commitID - 1), 0);
+  ASSERT_EQ(atomic_load_8(&pTsdb->compactRunning), 1);
+
+  // stopping takes it off the pool rather than waiting for its turn
+  int64_t startTime = taosGetTimestampMs();
+  tsdbStopCompact(pTsdb);
+  ASSERT_LT(taosGetTimestampMs() - startTime, 1000);
+  ASSERT_EQ(atomic_load_8(&pTsdb->compactRunning), 0);
+
+  atomic_store_8(&hold[0], 0);
+  while (atomic_load_8(&hold[1])) taosMsleep(1);
+  ASSERT_TRUE(getFileSet(fid, &nSttF, NULL));
+  ASSERT_EQ(nSttF, 2);
+}
+
+TEST_F(TsdbCompactTest, dataIter) {
+  std::vector<STestRow> rows;
+  bool                  hasData = false;
+  int32_t               nSttF = 0;
+
+  insertRows(uid, sKey, 100, 1000, 1);
+  int64_t ver1 = version;
+  commit();
+  insertRows(uid, sKey + 100 * 1000, 100, 1000, 2);
+  int64_t ver2 = version;
+  commit();
+  waitCompact();
+
+  // compaction writes everything to the data file and leaves an empty stt file, the next commit adds another
+  compact();
+  // rows behind the last data block are not merged into the data file
+  insertRows(uid, sKey + 300 * 1000, 10, 1000, 3);
+  int64_t ver3 = version;
+  commit();
+  waitCompact();
+
+  ASSERT_TRUE(getFileSet(fid, &nSttF, &hasData));
+  ASSERT_TRUE(hasData);
+  ASSERT_EQ(nSttF, 2);
+
+  // data file rows in key order, then stt file rows
+  readFileSet(fid, rows);
+  ASSERT_EQ(rows.size(), 210);
+  for (int32_t i = 0; i < 200; i++) {
+    ASSERT_EQ(rows[i].ts, sKey + i * 1000);
+    ASSERT_EQ(rows[i].version, i < 100 ? ver1 : ver2);
+    ASSERT_EQ(rows[i].value, i < 100 ? 1 : 2);
+  }
+  for (int32_t i = 200; i < 210; i++) {
+    ASSERT_EQ(rows[i].ts, sKey + (i + 100) * 1000);
+    ASSERT_EQ(rows[i].version, ver3);
+  }
+
+  // filter by version, whole blocks out of the range are skipped
+  STsdbFilterInfo filter = {.flag = TSDB_FILTER_FLAG_BY_VERSION, .sver = ver1, .ever = ver1};
+  readFileSet(fid, rows, &filter);
+  ASSERT_EQ(rows.size(), 100);
+  for (size_t i = 0; i < rows.size(); i++) ASSERT_EQ(rows[i].version, ver1);
+
+  filter.sver = ver2;
+  filter.ever = ver3;
+  readFileSet(fid, rows, &filter);
+  ASSERT_EQ(rows.size(), 110);
+
+  filter.sver = ver3 + 1;
+  filter.ever = VERSION_MAX;
+  readFileSet(fid, rows, &filter);
+  ASSERT_EQ(rows.size(), 0);
+
+  // tomb file
+  std::vector<SDelInfo> delInfos;
+  deleteRows(uid, sKey, sKey + 1000);
+  int64_t delVer1 = version;
+  deleteRows(uid, sKey + 50 * 1000, sKey + 60 * 1000);
+  int64_t delVer2 = version;
+  commit();
+  waitCompact();
+
+  readDelFile(delInfos);
+  ASSERT_EQ(delInfos.size(), 2);
+  ASSERT_EQ(delInfos[0].uid, uid);
+  ASSERT_EQ(delInfos[0].delData.version, delVer1);
+  ASSERT_EQ(delInfos[0].delData.sKey, sKey);
+  ASSERT_EQ(delInfos[1].uid, uid);
+  ASSERT_EQ(delInfos[1].delData.version, delVer2);
+  ASSERT_EQ(delInfos[1].delData.eKey, sKey + 60 * 1000);
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+const int32_t MIN_CHUNK_ROWS = 8;
+const int32_t MAX_CHUNK_ROWS = 4096;
+
+bool keyLess(const TSDBKEY &k1, const TSDBKEY &k2) { return tsdbKeyCmprFn(&k1, &k2) < 0; }
+
+}  // namespace
+
+class TsdbMemTableTest : public TsdbTest {
+ protected:
+  void SetUp() override {
+    TsdbTest::SetUp();
+    uid = createTable("t1");
+    sKey = taosGetTimestampMs() - 3600 * 1000LL;
+  }
+
+  STbData *tbData() {
+    if (pTsdb->mem == NULL) return NULL;
+    return tsdbGetTbDataFromMemTable(pTsdb->mem, 0, uid);
+  }
+
+  // rows of the table in the order of the iterator, from pFrom if not NULL
+  void scan(TSDBKEY *pFrom, int8_t backward, std::vector<TSDBKEY> &keys) {
+    STbDataIter iter = {0};
+
+    keys.clear();
+    tsdbTbDataIterOpen(tbData(), pFrom, backward, &iter);
+    for (TSDBROW *pRow; (pRow = tsdbTbDataIterGet(&iter)) != NULL; tsdbTbDataIterNext(&iter)) {
+      ASSERT_EQ(pRow->type, 0);
+      keys.push_back(TSDBROW_KEY(pRow));
+    }
+  }
+
+  tb_uid_t uid = 0;
+  TSKEY    sKey = 0;
+};
+
+TEST_F(TsdbMemTableTest, appendInOrder) {
+  std::vector<TSDBKEY> keys;
+  int32_t              nRows = 0;
+
+  // one block after another, each continuing the keys of the last
+  for (int32_t i = 0; i < 20; i++) {
+    insertRows(uid, sKey + nRows * 1000LL, 500, 1000, i);
+    nRows += 500;
+  }
+
+  STbData *pTbData = tbData();
+  ASSERT_NE(pTbData, nullptr);
+  ASSERT_EQ(pTbData->ab.size, nRows);
+  ASSERT_EQ(pTbData->sl.size, 0);
+  ASSERT_EQ(tsdbGetNRowsInTbData(pTbData), nRows);
+
+  // chunks double up to the maximum, all but the last one are full
+  int32_t capacity = MIN_CHUNK_ROWS;
+  int32_t nChunkRows = 0;
+  for (SMemAppendChunk *pChunk = pTbData->ab.pHead; pChunk; pChunk = pChunk->pNext) {
+    ASSERT_EQ(pChunk->capacity, capacity);
+    if (pChunk->pNext) {
+      ASSERT_EQ(pChunk->nRow, pChunk->capacity);
+      ASSERT_EQ(pChunk->pNext->pPrev, pChunk);
+    } else {
+      ASSERT_EQ(pChunk, pTbData->ab.pTail);
+    }
+    nChunkRows += pChunk->nRow;
+    capacity = std::min(capacity * 2, MAX_CHUNK_ROWS);
+  }
+  ASSERT_EQ(nChunkRows, nRows);
+
+  // forward and backward across all the chunks
+  scan(NULL, 0, keys);
+  ASSERT_EQ(keys.size(), nRows);
+  for (int32_t i = 0; i < nRows; i++) {
+    ASSERT_EQ(keys[i].ts, sKey + i * 1000LL);
+    ASSERT_EQ(keys[i].version, version - 19 + i / 500);
+  }
+
+  std::vector<TSDBKEY> backward;
+  scan(NULL, 1, backward);
+  std::reverse(backward.begin(), backward.end());
+  ASSERT_EQ(backward.size(), keys.size());
+  for (int32_t i = 0; i < nRows; i++) {
+    ASSERT_EQ(tsdbKeyCmprFn(&backward[i], &keys[i]), 0);
+  }
+}
+
+TEST_F(TsdbMemTableTest, outOfOrderToSkipList) {
+  std::vector<TSDBKEY> keys;
+
+  insertRows(uid, sKey + 500, 100, 1000, 1);
+  STbData *pTbData = tbData();
+  ASSERT_EQ(pTbData->ab.size, 100);
+  ASSERT_EQ(pTbData->sl.size, 0);
+
+  // the leading run older than the last appended row goes to the skip list, the rest is appended
+  insertRows(uid, sKey, 150, 1000, 2);
+  ASSERT_EQ(pTbData->sl.size, 100);
+  ASSERT_EQ(pTbData->ab.size, 150);
+
+  // a block entirely older
+  insertRows(uid, sKey - 100 * 1000, 50, 1000, 3);
+  ASSERT_EQ(pTbData->sl.size, 150);
+  ASSERT_EQ(pTbData->ab.size, 150);
+
+  // the same key at a newer version is appended
+  TSKEY lastKey = sKey + 149 * 1000;
+  insertRows(uid, lastKey, 1, 1000, 4);
+  ASSERT_EQ(pTbData->sl.size, 150);
+  ASSERT_EQ(pTbData->ab.size, 151);
+  ASSERT_EQ(tsdbGetNRowsInTbData(pTbData), 301);
+
+  // the iterator merges both in key order, versions break ties
+  scan(NULL, 0, keys);
+  ASSERT_EQ(keys.size(), 301);
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end(), keyLess));
+  ASSERT_EQ(keys.front().ts, sKey - 100 * 1000);
+  ASSERT_EQ(keys.back().ts, lastKey);
+  ASSERT_EQ(keys.back().version, version);
+  ASSERT_EQ(keys[keys.size() - 2].ts, lastKey);
+  ASSERT_EQ(keys[keys.size() - 2].version, version - 2);
+
+  std::vector<TSDBKEY> backward;
+  scan(NULL, 1, backward);
+  std::reverse(backward.begin(), backward.end());
+  ASSERT_EQ(backward.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(tsdbKeyCmprFn(&backward[i], &keys[i]), 0);
+  }
+
+  // seeks into the merged rows
+  TSDBKEY from = {.version = VERSION_MIN, .ts = sKey + 500};
+  scan(&from, 0, keys);
+  ASSERT_EQ(keys.size(), 301 - 50 - 1);
+  ASSERT_EQ(keys.front().ts, sKey + 500);
+
+  from = {.version = VERSION_MAX, .ts = sKey};
+  scan(&from, 1, keys);
+  ASSERT_EQ(keys.size(), 51);
+  ASSERT_EQ(keys.front().ts, sKey);
+}
+
+TEST_F(TsdbMemTableTest, moveToBounds) {
+  std::vector<TSDBKEY> keys;
+
+  // 8 + 16 + 32 + 64 rows fill the first four chunks exactly, the fifth holds the last 80
+  const int32_t nRows = 200;
+  insertRows(uid, sKey, nRows, 1000, 1);
+  ASSERT_EQ(tbData()->sl.size, 0);
+
+  // before the first row
+  TSDBKEY from = {.version = VERSION_MIN, .ts = sKey - 1};
+  scan(&from, 0, keys);
+  ASSERT_EQ(keys.size(), nRows);
+  from.version = VERSION_MAX;
+  scan(&from, 1, keys);
+  ASSERT_EQ(keys.size(), 0);
+
+  // after the last row
+  from = {.version = VERSION_MIN, .ts = sKey + nRows * 1000};
+  scan(&from, 0, keys);
+  ASSERT_EQ(keys.size(), 0);
+  from.version = VERSION_MAX;
+  scan(&from, 1, keys);
+  ASSERT_EQ(keys.size(), nRows);
+  ASSERT_EQ(keys.front().ts, sKey + (nRows - 1) * 1000);
+
+  // exactly on the first and last rows of each chunk, and between two rows
+  int32_t bounds[] = {0, 7, 8, 23, 24, 55, 56, 119, 120, nRows - 1};
+  for (size_t i = 0; i < sizeof(bounds) / sizeof(bounds[0]); i++) {
+    int32_t iRow = bounds[i];
+
+    from = {.version = VERSION_MIN, .ts = sKey + iRow * 1000};
+    scan(&from, 0, keys);
+    ASSERT_EQ(keys.size(), nRows - iRow);
+    ASSERT_EQ(keys.front().ts, from.ts);
+
+    from.version = VERSION_MAX;
+    scan(&from, 1, keys);
+    ASSERT_EQ(keys.size(), iRow + 1);
+    ASSERT_EQ(keys.front().ts, from.ts);
+
+    from = {.version = VERSION_MIN, .ts = sKey + iRow * 1000 + 500};
+    scan(&from, 0, keys);
+    ASSERT_EQ(keys.size(), nRows - iRow - 1);
+
+    from.version = VERSION_MAX;
+    scan(&from, 1, keys);
+    ASSERT_EQ(keys.size(), iRow + 1);
+    ASSERT_EQ(keys.front().ts, sKey + iRow * 1000);
+  }
+
+  // the version is part of the key
+  from = {.version = version + 1, .ts = sKey + 8 * 1000};
+  scan(&from, 0, keys);
+  ASSERT_EQ(keys.front().ts, sKey + 9 * 1000);
+  from = {.version = version - 1, .ts = sKey + 8 * 1000};
+  scan(&from, 1, keys);
+  ASSERT_EQ(keys.front().ts, sKey + 7 * 1000);
+}
+
+TEST_F(TsdbMemTableTest, readWhileAppending) {
+  const int32_t nBlocks = 200;
+  const int32_t nRowsPerBlock = 50;
+
+  insertRows(uid, sKey, 1, 1000, 0);
+  STbData *pTbData = tbData();
+  ASSERT_NE(pTbData, nullptr);
+
+  // the reader sees a prefix of the rows in key order, never a row that is not written yet
+  volatile bool done = false;
+  int32_t       nScan = 0;
+  bool          ok = true;
+  std::thread   reader([&]() {
+    size_t lastSize = 0;
+    while (ok && !done) {
+      STbDataIter iter = {0};
+      size_t      n = 0;
+      TSKEY       lastTs = TSKEY_MIN;
+
+      tsdbTbDataIterOpen(pTbData, NULL, 0, &iter);
+      for (TSDBROW *pRow; (pRow = tsdbTbDataIterGet(&iter)) != NULL; tsdbTbDataIterNext(&iter)) {
+        TSKEY ts = TSDBROW_TS(pRow);
+        if (ts != sKey + (TSKEY)n * 1000 || ts <= lastTs || pRow->pTSRow->ts != ts) {
+          ok = false;
+          break;
+        }
+        lastTs = ts;
+        n++;
+      }
+      if (n < lastSize) ok = false;
+      lastSize = n;
+      nScan++;
+    }
+  });
+
+  for (int32_t i = 0; i < nBlocks; i++) {
+    insertRows(uid, sKey + (1 + i * nRowsPerBlock) * 1000LL, nRowsPerBlock, 1000, i + 1);
+  }
+  done = true;
+  reader.join();
+
+  ASSERT_TRUE(ok);
+  ASSERT_GT(nScan, 0);
+  ASSERT_EQ(pTbData->sl.size, 0);
+  ASSERT_EQ(pTbData->ab.size, 1 + nBlocks * nRowsPerBlock);
+}
@@ -0,0 +1,544 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+const int64_t MS_PER_DAY = 24 * 3600 * 1000LL;
+const int32_t ROWS_PER_FSET = 500;
+
+}  // namespace
+
+class TsdbReadTest : public TsdbTest {
+ protected:
+  void SetUp() override {
+    TsdbTest::SetUp();
+    uid = createTable("t1");
+    fid = fileSetOf(taosGetTimestampMs() - 35 * MS_PER_DAY);
+  }
+
+  void TearDown() override {
+    tsdbReaderClose(pReader);
+    taosArrayDestroy(pIdList);
+    TsdbTest::TearDown();
+  }
+
+  // one data file block in each of the file sets fid, fid + 1, ...
+  void writeBlocks(int32_t nFSet) {
+    for (int32_t i = 0; i < nFSet; i++) {
+      insertRows(uid, fileSetStart(fid + i), ROWS_PER_FSET, 1000, i);
+    }
+    commit();
+    waitCompact();
+    compact();
+
+    for (int32_t i = 0; i < nFSet; i++) {
+      bool hasData = false;
+      ASSERT_TRUE(getFileSet(fid + i, NULL, &hasData));
+      ASSERT_TRUE(hasData);
+    }
+  }
+
+  // read ts, the bigint column and column 3, which no file block has
+  void openReader(TSKEY skey, TSKEY ekey) {
+    SColumnInfo aCol[3] = {0};
+    aCol[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    aCol[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    aCol[0].bytes = TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP];
+    aCol[1].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    aCol[1].type = TSDB_DATA_TYPE_BIGINT;
+    aCol[1].bytes = TYPE_BYTES[TSDB_DATA_TYPE_BIGINT];
+    aCol[2].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 2;
+    aCol[2].type = TSDB_DATA_TYPE_INT;
+    aCol[2].bytes = TYPE_BYTES[TSDB_DATA_TYPE_INT];
+
+    int32_t aSlot[3] = {0, 1, 2};
+
+    SQueryTableDataCond cond = {0};
+    cond.order = TSDB_ORDER_ASC;
+    cond.numOfCols = 3;
+    cond.colList = aCol;
+    cond.pSlotList = aSlot;
+    cond.type = TIMEWINDOW_RANGE_CONTAINED;
+    cond.twindows = {.skey = skey, .ekey = ekey};
+    cond.startVersion = -1;
+    cond.endVersion = -1;
+
+    STableKeyInfo info = {.uid = (uint64_t)uid, .groupId = 0};
+    ASSERT_EQ(tsdbReaderOpen(pVnode, &cond, &info, 1, NULL, &pReader, "tsdbReadTest"), 0);
+
+    // the filter of the scan refers to the bigint column only
+    int16_t cid = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    pIdList = taosArrayInit(1, sizeof(int16_t));
+    taosArrayPush(pIdList, &cid);
+  }
+
+  // rows of the block are sKey, sKey + 1000, ... with the given value, and column 3 is null
+  void checkBlock(SSDataBlock *pBlock, TSKEY sKey, int32_t nRows, int64_t value) {
+    ASSERT_EQ(pBlock->info.rows, nRows);
+    SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData *pV = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+    SColumnInfoData *pNull = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2);
+    for (int32_t i = 0; i < nRows; i++) {
+      ASSERT_EQ(*(TSKEY *)colDataGetData(pTs, i), sKey + i * 1000);
+      ASSERT_EQ(*(int64_t *)colDataGetData(pV, i), value);
+      ASSERT_TRUE(colDataIsNull_s(pNull, i));
+    }
+  }
+
+  tb_uid_t     uid = 0;
+  int32_t      fid = 0;
+  STsdbReader *pReader = NULL;
+  SArray      *pIdList = NULL;
+};
+
+// A partially loaded block whose rows are all rejected by the filter is never completed by
+// tsdbRetrieveDataBlockRest, which must not leave the next block treated as partial.
+TEST_F(TsdbReadTest, partialLoadAllRejected) {
+  writeBlocks(3);
+
+  // the window ends in the middle of the last block, which is dumped by the composed path
+  TSKEY lastStart = fileSetStart(fid + 2);
+  openReader(fileSetStart(fid), lastStart + (ROWS_PER_FSET / 2 - 1) * 1000);
+
+  // only the filter column is loaded, the rest is loaded for the qualified rows
+  ASSERT_TRUE(tsdbNextDataBlock(pReader));
+  SSDataBlock *pBlock = tsdbRetrieveDataBlock(pReader, pIdList);
+  ASSERT_NE(pBlock, nullptr);
+  ASSERT_TRUE(tsdbIsDataBlockPartial(pReader));
+  ASSERT_EQ(tsdbRetrieveDataBlockRest(pReader, NULL), 0);
+  ASSERT_FALSE(tsdbIsDataBlockPartial(pReader));
+  checkBlock(pBlock, fileSetStart(fid), ROWS_PER_FSET, 0);
+
+  // no row qualifies, the rest is never loaded
+  ASSERT_TRUE(tsdbNextDataBlock(pReader));
+  pBlock = tsdbRetrieveDataBlock(pReader, pIdList);
+  ASSERT_NE(pBlock, nullptr);
+  ASSERT_TRUE(tsdbIsDataBlockPartial(pReader));
+
+  ASSERT_TRUE(tsdbNextDataBlock(pReader));
+  ASSERT_FALSE(tsdbIsDataBlockPartial(pReader));
+  pBlock = tsdbRetrieveDataBlock(pReader, pIdList);
+  ASSERT_NE(pBlock, nullptr);
+  ASSERT_FALSE(tsdbIsDataBlockPartial(pReader));
+  checkBlock(pBlock, lastStart, ROWS_PER_FSET / 2, 2);
+
+  ASSERT_FALSE(tsdbNextDataBlock(pReader));
+}
+
+namespace {
+
+const int32_t BLOOM_ROWS = 200;
+const int32_t BLOOM_BINARY_LEN = 16;
+const int32_t BLOOM_NCHAR_LEN = 8;
+
+// the value of row i of each column is built from 2 * i, so odd numbers build values no row has
+void bloomBinaryVal(int32_t n, char *buf) {
+  int32_t len = snprintf(varDataVal(buf), BLOOM_BINARY_LEN + 1, "bin%d", n);
+  varDataSetLen(buf, len);
+}
+
+void bloomNcharVal(int32_t n, char *buf) {
+  char    str[BLOOM_NCHAR_LEN + 1] = {0};
+  int32_t len = snprintf(str, sizeof(str), "n%d", n);
+  for (int32_t i = 0; i < len; i++) {
+    uint32_t c = (uint8_t)str[i];
+    memcpy(varDataVal(buf) + i * TSDB_NCHAR_SIZE, &c, TSDB_NCHAR_SIZE);
+  }
+  varDataSetLen(buf, len * TSDB_NCHAR_SIZE);
+}
+
+}  // namespace
+
+class TsdbBloomFilterTest : public TsdbTest {
+ protected:
+  void SetUp() override {
+    bloomFilter = tsTsdbBlockBloomFilter;
+    tsTsdbBlockBloomFilter = true;
+    TsdbTest::SetUp();
+
+    const int8_t  aType[4] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BINARY,
+                              TSDB_DATA_TYPE_NCHAR};
+    const int32_t aBytes[4] = {TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP], TYPE_BYTES[TSDB_DATA_TYPE_INT],
+                               BLOOM_BINARY_LEN + VARSTR_HEADER_SIZE,
+                               BLOOM_NCHAR_LEN * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE};
+    for (int32_t i = 0; i < 4; i++) {
+      aSchema[i].type = aType[i];
+      aSchema[i].flags = COL_SMA_ON;
+      aSchema[i].colId = PRIMARYKEY_TIMESTAMP_COL_ID + i;
+      aSchema[i].bytes = aBytes[i];
+      snprintf(aSchema[i].name, sizeof(aSchema[i].name), "c%d", i);
+    }
+    uid = createTable("t1", aSchema, 4);
+    fid = fileSetOf(taosGetTimestampMs() - 35 * MS_PER_DAY);
+  }
+
+  void TearDown() override {
+    tsdbReaderClose(pReader);
+    TsdbTest::TearDown();
+    tsTsdbBlockBloomFilter = bloomFilter;
+  }
+
+  // one data file block of BLOOM_ROWS rows
+  void writeBlock() {
+    STSchema *pTSchema = metaGetTbTSchema(pVnode->pMeta, uid, 1, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    SArray              *aColVal = taosArrayInit(4, sizeof(SColVal));
+    std::vector<STSRow *> aRow;
+    char                  binary[VARSTR_HEADER_SIZE + BLOOM_BINARY_LEN + 1];
+    char                  nchar[VARSTR_HEADER_SIZE + BLOOM_NCHAR_LEN * TSDB_NCHAR_SIZE];
+    for (int32_t i = 0; i < BLOOM_ROWS; i++) {
+      bloomBinaryVal(2 * i, binary);
+      bloomNcharVal(2 * i, nchar);
+
+      SColVal aCv[4] = {
+          COL_VAL_VALUE(aSchema[0].colId, aSchema[0].type, (SValue){.val = fileSetStart(fid) + i * 1000}),
+          COL_VAL_VALUE(aSchema[1].colId, aSchema[1].type, (SValue){.val = 2 * i}),
+          COL_VAL_VALUE(aSchema[2].colId, aSchema[2].type, (SValue){}),
+          COL_VAL_VALUE(aSchema[3].colId, aSchema[3].type, (SValue){}),
+      };
+      aCv[2].value.nData = varDataLen(binary);
+      aCv[2].value.pData = (uint8_t *)varDataVal(binary);
+      aCv[3].value.nData = varDataLen(nchar);
+      aCv[3].value.pData = (uint8_t *)varDataVal(nchar);
+
+      taosArrayClear(aColVal);
+      for (int32_t iCol = 0; iCol < 4; iCol++) {
+        taosArrayPush(aColVal, &aCv[iCol]);
+      }
+
+      STSRow *pRow = NULL;
+      ASSERT_EQ(tdSTSRowNew(aColVal, pTSchema, &pRow), 0);
+      aRow.push_back(pRow);
+    }
+    taosArrayDestroy(aColVal);
+    taosMemoryFree(pTSchema);
+
+    submitRows(uid, aRow);
+    commit();
+    waitCompact();
+    compact();
+
+    bool hasData = false;
+    ASSERT_TRUE(getFileSet(fid, NULL, &hasData));
+    ASSERT_TRUE(hasData);
+  }
+
+  void openReader() {
+    SColumnInfo aCol[4] = {0};
+    int32_t     aSlot[4] = {0};
+    for (int32_t i = 0; i < 4; i++) {
+      aCol[i].colId = aSchema[i].colId;
+      aCol[i].type = aSchema[i].type;
+      aCol[i].bytes = aSchema[i].bytes;
+      aSlot[i] = i;
+    }
+
+    SQueryTableDataCond cond = {0};
+    cond.order = TSDB_ORDER_ASC;
+    cond.numOfCols = 4;
+    cond.colList = aCol;
+    cond.pSlotList = aSlot;
+    cond.type = TIMEWINDOW_RANGE_CONTAINED;
+    cond.twindows = {.skey = fileSetStart(fid), .ekey = fileSetStart(fid + 1) - 1};
+    cond.startVersion = -1;
+    cond.endVersion = -1;
+
+    STableKeyInfo info = {.uid = (uint64_t)uid, .groupId = 0};
+    ASSERT_EQ(tsdbReaderOpen(pVnode, &cond, &info, 1, NULL, &pReader, "tsdbBloomFilterTest"), 0);
+  }
+
+  // whether the current block may contain the values built from n, one for each of the three columns
+  void mayContain(int32_t n, bool aMay[3]) {
+    int32_t iv = n;
+    char    binary[VARSTR_HEADER_SIZE + BLOOM_BINARY_LEN + 1];
+    char    nchar[VARSTR_HEADER_SIZE + BLOOM_NCHAR_LEN * TSDB_NCHAR_SIZE];
+    bloomBinaryVal(n, binary);
+    bloomNcharVal(n, nchar);
+
+    aMay[0] = tsdbDataBlockMayContain(pReader, aSchema[1].colId, aSchema[1].type, &iv);
+    aMay[1] = tsdbDataBlockMayContain(pReader, aSchema[2].colId, aSchema[2].type, binary);
+    aMay[2] = tsdbDataBlockMayContain(pReader, aSchema[3].colId, aSchema[3].type, nchar);
+  }
+
+  bool         bloomFilter = false;
+  SSchema      aSchema[4] = {0};
+  tb_uid_t     uid = 0;
+  int32_t      fid = 0;
+  STsdbReader *pReader = NULL;
+};
+
+// The bloom filters of a committed block never reject a value the block has, reject most of the values it does not
+// have, and are not taken for the SMA of a column.
+TEST_F(TsdbBloomFilterTest, mayContain) {
+  writeBlock();
+  openReader();
+
+  ASSERT_TRUE(tsdbNextDataBlock(pReader));
+
+  bool    aMay[3] = {0};
+  int32_t aFalsePositive[3] = {0};
+  for (int32_t i = 0; i < BLOOM_ROWS; i++) {
+    mayContain(2 * i, aMay);
+    for (int32_t iCol = 0; iCol < 3; iCol++) {
+      ASSERT_TRUE(aMay[iCol]) << "column " << iCol + 1 << " rejects present value " << 2 * i;
+    }
+
+    mayContain(2 * i + 1, aMay);
+    for (int32_t iCol = 0; iCol < 3; iCol++) {
+      aFalsePositive[iCol] += aMay[iCol];
+    }
+  }
+
+  // the filters are built at TSDB_BLOOM_FILTER_FPP, far below one in ten
+  for (int32_t iCol = 0; iCol < 3; iCol++) {
+    EXPECT_LT(aFalsePositive[iCol], BLOOM_ROWS / 10) << "column " << iCol + 1;
+  }
+
+  // the marker entry of the bloom filters is not an SMA of any column
+  bool allHave = false;
+  SSDataBlock block = {0};
+  ASSERT_EQ(tsdbRetrieveDatablockSMA(pReader, &block, &allHave), 0);
+  ASSERT_TRUE(allHave);
+  ASSERT_NE(block.pBlockAgg, nullptr);
+  for (int32_t i = 0; i < 4; i++) {
+    if (block.pBlockAgg[i]) {
+      EXPECT_NE(block.pBlockAgg[i]->colId, TSDB_BLOOM_FILTER_CID);
+    }
+  }
+
+  SSDataBlock *pBlock = tsdbRetrieveDataBlock(pReader, NULL);
+  ASSERT_NE(pBlock, nullptr);
+  ASSERT_EQ(pBlock->info.rows, BLOOM_ROWS);
+  ASSERT_FALSE(tsdbNextDataBlock(pReader));
+}
+
+// tsdbReadBlockSma leaves out the marker entry the bloom filters are located by, which tsdbReadBlockBloomFilter reads
+TEST_F(TsdbBloomFilterTest, readBlockSma) {
+  writeBlock();
+
+  STsdbFS fs = {0};
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  ASSERT_EQ(tsdbFSRef(pTsdb, &fs), 0);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+
+  SDFileSet     fSet = {.fid = fid};
+  SDFileSet    *pSet = (SDFileSet *)taosArraySearch(fs.aDFileSet, &fSet, tDFileSetCmprFn, TD_EQ);
+  SDataFReader *pFReader = NULL;
+  SArray       *aBlockIdx = taosArrayInit(1, sizeof(SBlockIdx));
+  SArray       *aSma = taosArrayInit(4, sizeof(SColumnDataAgg));
+  SArray       *aBloom = taosArrayInit(4, sizeof(SBlockBloomFilter));
+  SMapData      mDataBlk = {0};
+  ASSERT_NE(pSet, nullptr);
+  ASSERT_EQ(tsdbDataFReaderOpen(&pFReader, pTsdb, pSet), 0);
+  ASSERT_EQ(tsdbReadBlockIdx(pFReader, aBlockIdx), 0);
+  ASSERT_EQ(taosArrayGetSize(aBlockIdx), 1);
+  ASSERT_EQ(tsdbReadDataBlk(pFReader, (SBlockIdx *)taosArrayGet(aBlockIdx, 0), &mDataBlk), 0);
+  ASSERT_EQ(mDataBlk.nItem, 1);
+
+  SDataBlk dataBlk;
+  tMapDataGetItemByIdx(&mDataBlk, 0, &dataBlk, tGetDataBlk);
+  ASSERT_TRUE(tDataBlkHasSma(&dataBlk));
+
+  ASSERT_EQ(tsdbReadBlockSma(pFReader, &dataBlk, aSma), 0);
+  ASSERT_GT(taosArrayGetSize(aSma), 0);
+  for (int32_t i = 0; i < taosArrayGetSize(aSma); i++) {
+    EXPECT_NE(((SColumnDataAgg *)taosArrayGet(aSma, i))->colId, TSDB_BLOOM_FILTER_CID);
+  }
+
+  ASSERT_EQ(tsdbReadBlockBloomFilter(pFReader, &dataBlk, aBloom), 0);
+  ASSERT_EQ(taosArrayGetSize(aBloom), 3);
+  for (int32_t i = 0; i < 3; i++) {
+    SBlockBloomFilter *pBloom = (SBlockBloomFilter *)taosArrayGet(aBloom, i);
+    EXPECT_EQ(pBloom->cid, aSchema[i + 1].colId);
+    EXPECT_EQ(pBloom->type, aSchema[i + 1].type);
+  }
+
+  tsdbClearBlockBloomFilter(aBloom);
+  taosArrayDestroy(aBloom);
+  taosArrayDestroy(aSma);
+  taosArrayDestroy(aBlockIdx);
+  tMapDataClear(&mDataBlk);
+  tsdbDataFReaderClose(&pFReader);
+  tsdbFSUnref(pTsdb, &fs);
+}
+
+extern "C" int32_t tsdbReadDataBlockEx(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData);
+
+namespace {
+
+const int32_t FILE_BLOCKS = 3;
+const int32_t FILE_BLOCK_ROWS = 4096;  // maxRows of the vnode
+
+}  // namespace
+
+/*
+ * Reads of the data file without the page cache, which would serve the pages read by the compaction instead, so that
+ * the positional reads counted by the STsdbFD are the ones of the test.
+ */
+class TsdbReadFileTest : public TsdbReadTest {
+ protected:
+  void SetUp() override {
+    pageCacheSize = tsTsdbPageCacheSize;
+    tsTsdbPageCacheSize = 0;
+    TsdbReadTest::SetUp();
+  }
+
+  void TearDown() override {
+    tBlockDataDestroy(&bData, 1);
+    taosArrayDestroy(aBlockIdx);
+    tMapDataClear(&mDataBlk);
+    tsdbDataFReaderClose(&pFReader);
+    if (fs.aDFileSet) tsdbFSUnref(pTsdb, &fs);
+    TsdbReadTest::TearDown();
+    tsTsdbPageCacheSize = pageCacheSize;
+  }
+
+  // FILE_BLOCKS full data file blocks of incompressible values in the file set fid, opened to aDataBlk
+  void writeFileBlocks() {
+    uint64_t seed = 7;
+    for (int32_t i = 0; i < FILE_BLOCKS * FILE_BLOCK_ROWS; i++) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      values.push_back((int64_t)seed);
+    }
+
+    insertRows(uid, fileSetStart(fid), 1000, values);
+    commit();
+    waitCompact();
+    compact();
+  }
+
+  void openFileReader() {
+    taosThreadRwlockRdlock(&pTsdb->rwLock);
+    int32_t code = tsdbFSRef(pTsdb, &fs);
+    taosThreadRwlockUnlock(&pTsdb->rwLock);
+    ASSERT_EQ(code, 0);
+
+    SDFileSet  fSet = {.fid = fid};
+    SDFileSet *pSet = (SDFileSet *)taosArraySearch(fs.aDFileSet, &fSet, tDFileSetCmprFn, TD_EQ);
+    ASSERT_NE(pSet, nullptr);
+    ASSERT_EQ(tsdbDataFReaderOpen(&pFReader, pTsdb, pSet), 0);
+
+    aBlockIdx = taosArrayInit(1, sizeof(SBlockIdx));
+    ASSERT_EQ(tsdbReadBlockIdx(pFReader, aBlockIdx), 0);
+    ASSERT_EQ(taosArrayGetSize(aBlockIdx), 1);
+    ASSERT_EQ(tsdbReadDataBlk(pFReader, (SBlockIdx *)taosArrayGet(aBlockIdx, 0), &mDataBlk), 0);
+    ASSERT_EQ(mDataBlk.nItem, FILE_BLOCKS);
+    for (int32_t i = 0; i < FILE_BLOCKS; i++) {
+      tMapDataGetItemByIdx(&mDataBlk, i, &aDataBlk[i], tGetDataBlk);
+      ASSERT_EQ(aDataBlk[i].nSubBlock, 1);
+    }
+    ASSERT_EQ(tBlockDataCreate(&bData), 0);
+  }
+
+  // block iBlock is read back to bData with the rows written
+  void checkDataBlock(int32_t iBlock) {
+    SColData *pColData = NULL;
+    int32_t   iRow = iBlock * FILE_BLOCK_ROWS;
+    tBlockDataGetColData(&bData, PRIMARYKEY_TIMESTAMP_COL_ID + 1, &pColData);
+    ASSERT_NE(pColData, nullptr);
+    ASSERT_EQ(bData.nRow, FILE_BLOCK_ROWS);
+    for (int32_t i = 0; i < bData.nRow; i++) {
+      SColVal cv;
+      tColDataGetValue(pColData, i, &cv);
+      ASSERT_EQ(bData.aTSKEY[i], fileSetStart(fid) + (iRow + i) * 1000);
+      ASSERT_EQ(cv.value.val, values[iRow + i]);
+    }
+  }
+
+  std::vector<int64_t> values;
+  int32_t              pageCacheSize = 0;
+  STsdbFS              fs = {0};
+  SDataFReader        *pFReader = NULL;
+  SArray              *aBlockIdx = NULL;
+  SMapData             mDataBlk = {0};
+  SDataBlk             aDataBlk[FILE_BLOCKS];
+  SBlockData           bData = {0};
+};
+
+// The full pages of a data block are read with one positional read, between the partial head and tail pages.
+TEST_F(TsdbReadFileTest, coalescedRead) {
+  writeFileBlocks();
+  openFileReader();
+
+  STsdbFD *pFD = pFReader->pDataFD;
+  int32_t  szPgCont = PAGE_CONTENT_SIZE(pFD->szPage);
+  for (int32_t i = 0; i < FILE_BLOCKS; i++) {
+    ASSERT_GT(aDataBlk[i].aSubBlock[0].szBlock, szPgCont * 4);
+
+    int64_t nRead = pFD->nRead;
+    ASSERT_EQ(tsdbReadDataBlockEx(pFReader, &aDataBlk[i], &bData), 0);
+    EXPECT_GT(pFD->nRead - nRead, 0);
+    EXPECT_LE(pFD->nRead - nRead, 3);
+    checkDataBlock(i);
+  }
+}
+
+// The blocks following the one read, adjacent in the file, are read ahead with one request that serves each of
+// their reads.
+TEST_F(TsdbReadFileTest, readaheadAdjacentBlocks) {
+  writeFileBlocks();
+  openFileReader();
+
+  STsdbFD *pFD = pFReader->pDataFD;
+  ASSERT_EQ(tsdbReadDataBlockEx(pFReader, &aDataBlk[0], &bData), 0);
+  EXPECT_EQ(pFD->nReadahead, 0);
+  checkDataBlock(0);
+
+  for (int32_t i = 1; i < FILE_BLOCKS; i++) {
+    SBlockInfo *pPrev = &aDataBlk[i - 1].aSubBlock[0];
+    EXPECT_EQ(aDataBlk[i].aSubBlock[0].offset, pPrev->offset + pPrev->szBlock);
+    EXPECT_EQ(tsdbPrefetchDataBlock(pFReader, &aDataBlk[i]), aDataBlk[i].aSubBlock[0].szBlock);
+  }
+  EXPECT_EQ(pFD->nPrefetch, 0);
+  tsdbPrefetchFlush(pFReader);
+  EXPECT_EQ(pFD->nPrefetch, 1);
+  tsdbPrefetchFlush(pFReader);
+  EXPECT_EQ(pFD->nPrefetch, 1);
+
+  for (int32_t i = 1; i < FILE_BLOCKS; i++) {
+    int64_t nRead = pFD->nRead;
+    int64_t nReadahead = pFD->nReadahead;
+    ASSERT_EQ(tsdbReadDataBlockEx(pFReader, &aDataBlk[i], &bData), 0);
+    EXPECT_GT(pFD->nRead - nRead, 0);
+    EXPECT_EQ(pFD->nReadahead - nReadahead, pFD->nRead - nRead);
+    checkDataBlock(i);
+  }
+}
+
+// A scan that reads the blocks ahead returns every row of the file set
+TEST_F(TsdbReadFileTest, scanWithReadahead) {
+  int32_t readaheadBlocks = tsTsdbReadaheadBlocks;
+  tsTsdbReadaheadBlocks = 1;
+  writeFileBlocks();
+  openReader(fileSetStart(fid), fileSetStart(fid + 1) - 1);
+
+  int32_t iRow = 0;
+  while (tsdbNextDataBlock(pReader)) {
+    SSDataBlock *pBlock = tsdbRetrieveDataBlock(pReader, NULL);
+    if (pBlock == NULL) break;
+
+    SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData *pV = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+    for (int32_t i = 0; i < pBlock->info.rows && iRow < (int32_t)values.size(); i++, iRow++) {
+      EXPECT_EQ(*(TSKEY *)colDataGetData(pTs, i), fileSetStart(fid) + iRow * 1000);
+      EXPECT_EQ(*(int64_t *)colDataGetData(pV, i), values[iRow]);
+    }
+  }
+  tsTsdbReadaheadBlocks = readaheadBlocks;
+  EXPECT_EQ(iRow, (int32_t)values.size());
+}
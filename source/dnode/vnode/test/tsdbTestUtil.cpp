@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbTestUtil.h"
+
+#define TSDB_TEST_DIR   TD_TMP_DIR_PATH "tsdbTest"
+#define TSDB_TEST_VNODE "vnode2"
+#define TSDB_TEST_VGID  2
+
+STfs *TsdbTest::pTfs = NULL;
+
+static void tsdbTestUpdateDnodeInfo(void *pData, int32_t *dnodeId, int64_t *clusterId, char *fqdn, uint16_t *port) {}
+
+static SMsgCb tsdbTestMsgCb() {
+  SMsgCb msgCb = {0};
+  msgCb.mgmt = &msgCb;  // the query worker only checks it is set
+  msgCb.updateDnodeInfoFp = tsdbTestUpdateDnodeInfo;
+  return msgCb;
+}
+
+void TsdbTest::SetUpTestCase() {
+  taosRemoveDir(TSDB_TEST_DIR);
+  ASSERT_EQ(taosMulMkDir(TSDB_TEST_DIR), 0);
+
+  SDiskCfg diskCfg = {0};
+  diskCfg.level = 0;
+  diskCfg.primary = 1;
+  tstrncpy(diskCfg.dir, TSDB_TEST_DIR, sizeof(diskCfg.dir));
+  pTfs = tfsOpen(&diskCfg, 1);
+  ASSERT_NE(pTfs, nullptr);
+
+  SMsgCb msgCb = tsdbTestMsgCb();
+  tmsgSetDefault(&msgCb);
+
+  ASSERT_EQ(syncInit(), 0);
+  ASSERT_EQ(vnodeInit(2, 1, 4), 0);
+
+  tsTsdbCompactSttTrigger = 0;
+  tsTsdbCompactMaxSpeed = 0;
+}
+
+void TsdbTest::TearDownTestCase() {
+  vnodeCleanup();
+  syncCleanUp();
+  tfsClose(pTfs);
+  pTfs = NULL;
+  taosRemoveDir(TSDB_TEST_DIR);
+}
+
+void TsdbTest::SetUp() {
+  SVnodeCfg cfg = vnodeCfgDefault;
+  cfg.vgId = TSDB_TEST_VGID;
+  tstrncpy(cfg.dbname, "1.db", sizeof(cfg.dbname));
+  cfg.sttTrigger = sttTrigger;
+  cfg.walCfg.vgId = TSDB_TEST_VGID;
+  cfg.syncCfg.replicaNum = 1;
+  cfg.syncCfg.myIndex = 0;
+  cfg.syncCfg.nodeInfo[0].nodeId = 1;
+  cfg.syncCfg.nodeInfo[0].nodePort = 6030;
+  tstrncpy(cfg.syncCfg.nodeInfo[0].nodeFqdn, "localhost", sizeof(cfg.syncCfg.nodeInfo[0].nodeFqdn));
+
+  tfsRmdir(pTfs, TSDB_TEST_VNODE);
+  ASSERT_EQ(vnodeCreate(TSDB_TEST_VNODE, &cfg, pTfs), 0);
+
+  version = 0;
+  reopen();
+}
+
+void TsdbTest::TearDown() {
+  vnodeClose(pVnode);
+  pVnode = NULL;
+  pTsdb = NULL;
+  tfsRmdir(pTfs, TSDB_TEST_VNODE);
+}
+
+void TsdbTest::reopen() {
+  if (pVnode) {
+    vnodeClose(pVnode);
+  }
+
+  pVnode = vnodeOpen(TSDB_TEST_VNODE, pTfs, tsdbTestMsgCb());
+  ASSERT_NE(pVnode, nullptr);
+  pTsdb = pVnode->pTsdb;
+  if (version < pVnode->state.applied) version = pVnode->state.applied;
+}
+
+// a normal table of the given columns, ts and the bigint column v by default
+tb_uid_t TsdbTest::createTable(const char *name, SSchema *aSchema, int32_t nCols) {
+  SSchema aDefault[2] = {0};
+  if (aSchema == NULL) {
+    aDefault[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    aDefault[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    aDefault[0].bytes = TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP];
+    tstrncpy(aDefault[0].name, "ts", sizeof(aDefault[0].name));
+    aDefault[1].type = TSDB_DATA_TYPE_BIGINT;
+    aDefault[1].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    aDefault[1].bytes = TYPE_BYTES[TSDB_DATA_TYPE_BIGINT];
+    tstrncpy(aDefault[1].name, "v", sizeof(aDefault[1].name));
+    aSchema = aDefault;
+    nCols = 2;
+  }
+
+  SVCreateTbReq req = {0};
+  req.name = (char *)name;
+  req.uid = tGenIdPI64();
+  req.ctime = taosGetTimestampMs();
+  req.type = TSDB_NORMAL_TABLE;
+  req.ntb.schemaRow.nCols = nCols;
+  req.ntb.schemaRow.version = 1;
+  req.ntb.schemaRow.pSchema = aSchema;
+
+  EXPECT_EQ(metaCreateTable(pVnode->pMeta, ++version, &req, NULL), 0);
+  pVnode->state.applied = version;
+  return req.uid;
+}
+
+// rows sKey, sKey + step, ..., all with the given value, written in one submit at the next version
+void TsdbTest::insertRows(tb_uid_t uid, TSKEY sKey, int32_t nRows, int64_t step, int64_t value) {
+  insertRows(uid, sKey, step, std::vector<int64_t>(nRows, value));
+}
+
+// rows sKey, sKey + step, ... with one value each, written in one submit at the next version
+void TsdbTest::insertRows(tb_uid_t uid, TSKEY sKey, int64_t step, const std::vector<int64_t> &values) {
+  STSchema *pTSchema = metaGetTbTSchema(pVnode->pMeta, uid, 1, 1);
+  ASSERT_NE(pTSchema, nullptr);
+
+  SArray              *aColVal = taosArrayInit(2, sizeof(SColVal));
+  std::vector<STSRow *> aRow;
+  for (size_t i = 0; i < values.size(); i++) {
+    SColVal cvTs = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, (SValue){.val = sKey + step * i});
+    SColVal cvV = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_BIGINT, (SValue){.val = values[i]});
+    taosArrayClear(aColVal);
+    taosArrayPush(aColVal, &cvTs);
+    taosArrayPush(aColVal, &cvV);
+
+    STSRow *pRow = NULL;
+    ASSERT_EQ(tdSTSRowNew(aColVal, pTSchema, &pRow), 0);
+    aRow.push_back(pRow);
+  }
+  taosArrayDestroy(aColVal);
+  taosMemoryFree(pTSchema);
+
+  submitRows(uid, aRow);
+}
+
+// write the rows in one submit at the next version, the rows are freed
+void TsdbTest::submitRows(tb_uid_t uid, std::vector<STSRow *> &aRow) {
+  int32_t dataLen = 0;
+  for (size_t i = 0; i < aRow.size(); i++) {
+    dataLen += TD_ROW_LEN(aRow[i]);
+  }
+
+  // the submit message is in network byte order
+  int32_t     msgLen = sizeof(SSubmitReq) + sizeof(SSubmitBlk) + dataLen;
+  SSubmitReq *pMsg = (SSubmitReq *)taosMemoryCalloc(1, msgLen);
+  pMsg->length = htonl(msgLen);
+  pMsg->numOfBlocks = htonl(1);
+
+  SSubmitBlk *pBlock = (SSubmitBlk *)pMsg->blocks;
+  pBlock->uid = htobe64(uid);
+  pBlock->suid = htobe64(0);
+  pBlock->sversion = htonl(1);
+  pBlock->dataLen = htonl(dataLen);
+  pBlock->schemaLen = htonl(0);
+  pBlock->numOfRows = htonl((int32_t)aRow.size());
+
+  char *p = pBlock->data;
+  for (size_t i = 0; i < aRow.size(); i++) {
+    memcpy(p, aRow[i], TD_ROW_LEN(aRow[i]));
+    p += TD_ROW_LEN(aRow[i]);
+    taosMemoryFree(aRow[i]);
+  }
+  aRow.clear();
+
+  EXPECT_EQ(tsdbInsertData(pTsdb, ++version, pMsg, NULL), 0);
+  pVnode->state.applied = version;
+  taosMemoryFree(pMsg);
+}
+
+void TsdbTest::deleteRows(tb_uid_t uid, TSKEY sKey, TSKEY eKey) {
+  EXPECT_EQ(tsdbDeleteTableData(pTsdb, ++version, 0, uid, sKey, eKey), 0);
+  pVnode->state.applied = version;
+}
+
+void TsdbTest::commit() {
+  ASSERT_EQ(vnodeSyncCommit(pVnode), 0);
+  ASSERT_EQ(vnodeBegin(pVnode), 0);
+}
+
+// a forced round that covers every file set, run as if it followed one more commit
+void TsdbTest::compact() {
+  commit();
+  waitCompact();
+  tsdbRequestCompact(pTsdb);
+  ASSERT_EQ(tsdbCompact(pTsdb, pVnode->state.commitID - 1), 0);
+}
+
+// wait for the round scheduled by the last commit, if any, to end
+void TsdbTest::waitCompact() {
+  for (int32_t nIdle = 0; nIdle < 3;) {
+    taosMsleep(10);
+    nIdle = atomic_load_8(&pTsdb->compactRunning) ? 0 : nIdle + 1;
+  }
+}
+
+int32_t TsdbTest::fileSetOf(TSKEY key) {
+  return tsdbKeyFid(key, pTsdb->keepCfg.days, pTsdb->keepCfg.precision);
+}
+
+TSKEY TsdbTest::fileSetStart(int32_t fid) {
+  TSKEY minKey, maxKey;
+  tsdbFidKeyRange(fid, pTsdb->keepCfg.days, pTsdb->keepCfg.precision, &minKey, &maxKey);
+  return minKey;
+}
+
+bool TsdbTest::getFileSet(int32_t fid, int32_t *nSttF, bool *hasData) {
+  bool found = false;
+
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  SDFileSet  fSet = {.fid = fid};
+  SDFileSet *pSet = (SDFileSet *)taosArraySearch(pTsdb->fs.aDFileSet, &fSet, tDFileSetCmprFn, TD_EQ);
+  if (pSet) {
+    found = true;
+    if (nSttF) *nSttF = pSet->nSttF;
+    if (hasData) *hasData = pSet->pDataF->size > TSDB_FHDR_SIZE;
+  }
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+
+  return found;
+}
+
+static void tsdbTestCollectRows(STsdbDataIter2 *pIter, STsdbFilterInfo *pFilter, std::vector<STestRow> &rows) {
+  if (pIter == NULL) return;
+
+  for (;;) {
+    ASSERT_EQ(tsdbDataIterNext2(pIter, pFilter), 0);
+    if (pIter->rowInfo.uid == 0) break;
+
+    TSDBROW  *pRow = &pIter->rowInfo.row;
+    SColData *pColData = NULL;
+    SColVal   cv = {0};
+    tBlockDataGetColData(pRow->pBlockData, PRIMARYKEY_TIMESTAMP_COL_ID + 1, &pColData);
+    ASSERT_NE(pColData, nullptr);
+    tColDataGetValue(pColData, pRow->iRow, &cv);
+
+    rows.push_back({pIter->rowInfo.uid, TSDBROW_TS(pRow), TSDBROW_VERSION(pRow), cv.value.val});
+  }
+
+  tsdbCloseDataIter2(pIter);
+}
+
+// rows of the data file followed by the rows of each stt file, in file order
+void TsdbTest::readFileSet(int32_t fid, std::vector<STestRow> &rows, STsdbFilterInfo *pFilter) {
+  STsdbFS fs = {0};
+
+  rows.clear();
+
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  int32_t code = tsdbFSRef(pTsdb, &fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  ASSERT_EQ(code, 0);
+
+  SDFileSet  fSet = {.fid = fid};
+  SDFileSet *pSet = (SDFileSet *)taosArraySearch(fs.aDFileSet, &fSet, tDFileSetCmprFn, TD_EQ);
+  if (pSet) {
+    SDataFReader   *pReader = NULL;
+    STsdbDataIter2 *pIter = NULL;
+
+    ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, pSet), 0);
+
+    ASSERT_EQ(tsdbOpenDataFileDataIter(pReader, &pIter), 0);
+    tsdbTestCollectRows(pIter, pFilter, rows);
+
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      ASSERT_EQ(tsdbOpenSttFileDataIter(pReader, iStt, &pIter), 0);
+      tsdbTestCollectRows(pIter, pFilter, rows);
+    }
+
+    tsdbDataFReaderClose(&pReader);
+  }
+
+  tsdbFSUnref(pTsdb, &fs);
+}
+
+void TsdbTest::readDelFile(std::vector<SDelInfo> &delInfos) {
+  STsdbFS fs = {0};
+
+  delInfos.clear();
+
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  int32_t code = tsdbFSRef(pTsdb, &fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  ASSERT_EQ(code, 0);
+
+  if (fs.pDelFile) {
+    SDelFReader    *pReader = NULL;
+    STsdbDataIter2 *pIter = NULL;
+
+    ASSERT_EQ(tsdbDelFReaderOpen(&pReader, fs.pDelFile, pTsdb), 0);
+    ASSERT_EQ(tsdbOpenTombFileDataIter(pReader, &pIter), 0);
+    if (pIter) {
+      for (;;) {
+        ASSERT_EQ(tsdbDataIterNext2(pIter, NULL), 0);
+        if (pIter->delInfo.uid == 0) break;
+        delInfos.push_back(pIter->delInfo);
+      }
+      tsdbCloseDataIter2(pIter);
+    }
+    tsdbDelFReaderClose(&pReader);
+  }
+
+  tsdbFSUnref(pTsdb, &fs);
+}
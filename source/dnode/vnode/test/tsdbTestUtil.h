@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_VNODE_TSDB_TEST_UTIL_H_
+#define _TD_VNODE_TSDB_TEST_UTIL_H_
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "tglobal.h"
+#include "tsdb.h"
+#include "vnd.h"
+
+// a row as it is read back from the files
+typedef struct {
+  tb_uid_t uid;
+  TSKEY    ts;
+  int64_t  version;
+  int64_t  value;
+} STestRow;
+
+/*
+ * A single replica vnode on a scratch directory. Background compaction rounds only run when forced, so tests see
+ * exactly the files their commits and compactions produce.
+ */
+class TsdbTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase();
+  static void TearDownTestCase();
+
+  void SetUp() override;
+  void TearDown() override;
+
+  // vnode
+  void    reopen();
+  tb_uid_t createTable(const char *name, SSchema *aSchema = NULL, int32_t nCols = 0);
+  void    insertRows(tb_uid_t uid, TSKEY sKey, int32_t nRows, int64_t step, int64_t value);
+  void    insertRows(tb_uid_t uid, TSKEY sKey, int64_t step, const std::vector<int64_t> &values);
+  void    submitRows(tb_uid_t uid, std::vector<STSRow *> &aRow);
+  void    deleteRows(tb_uid_t uid, TSKEY sKey, TSKEY eKey);
+  void    commit();
+
+  // tsdb
+  void    compact();
+  void    waitCompact();
+  int32_t fileSetOf(TSKEY key);
+  TSKEY   fileSetStart(int32_t fid);
+  bool    getFileSet(int32_t fid, int32_t *nSttF, bool *hasData);
+  void    readFileSet(int32_t fid, std::vector<STestRow> &rows, STsdbFilterInfo *pFilter = NULL);
+  void    readDelFile(std::vector<SDelInfo> &delInfos);
+
+  static STfs *pTfs;
+
+  SVnode *pVnode = NULL;
+  STsdb  *pTsdb = NULL;
+  int64_t version = 0;
+  int32_t sttTrigger = 8;
+};
+
+#endif /*_TD_VNODE_TSDB_TEST_UTIL_H_*/
@@ -22,6 +22,7 @@ extern "C" {
 
 #include "os.h"
 #include "tcommon.h"
+#include "tmemaccount.h"
 
 enum {
   SORT_MULTISOURCE_MERGE = 0x1,
@@ -44,7 +45,11 @@ typedef struct SSortSource {
     void* param;
     bool  onlyRef;
   };
-
+  struct {
+    char*   pKeys;  // normalized sort keys of the rows in src.pBlock
+    int32_t keyCapacity;
+    bool    keyValid;
+  };
 } SSortSource;
 
 typedef struct SMsortComparParam {
@@ -52,6 +57,8 @@ typedef struct SMsortComparParam {
   int32_t numOfSources;
   SArray* orderInfo;  // SArray<SBlockOrderInfo>
   bool    cmpGroupId;
+  int32_t keyLen;      // length of the normalized sort key, -1 if not decided yet
+  int32_t numOfExact;  // order columns fully decided by the normalized sort key
 } SMsortComparParam;
 
 typedef struct SSortHandle  SSortHandle;
@@ -108,6 +115,21 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp);
  */
 int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId);
 
+/**
+ * Only the first maxRows rows are required, a bounded heap is used instead of the external sort if they fit in the
+ * sort buffer.
+ * @param pHandle
+ * @param maxRows
+ */
+void tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows);
+
+/**
+ * The pages of the external sort buffer are charged to the given memory account.
+ * @param pHandle
+ * @param pAccount
+ */
+void tsortSetMemAccount(SSortHandle* pHandle, SMemAccount* pAccount);
+
 /**
  *
  * @param pHandle
@@ -48,6 +48,8 @@ typedef struct SDataDispatchHandle {
   bool                queryEnd;
   uint64_t            useconds;
   uint64_t            cachedSize;
+  bool                compress;
+  int32_t             compressThreshold;
   TdThreadMutex       mutex;
 } SDataDispatchHandle;
 
@@ -58,7 +60,9 @@ typedef struct SDataDispatchHandle {
 // |                |  sizeof(int32_t) |sizeof(int32) | sizeof(int32)| sizeof(uint64_t) | (sizeof(int8_t)+sizeof(int32_t))*numOfCols | sizeof(int32_t) * numOfCols        | actual size |           |
 // +----------------+------------------+--------------+--------------+------------------+--------------------------------------------+------------------------------------+-------------+-----------+-------------+-----------+
 // The length of bitmap is decided by number of rows of this data block, and the length of each column data is
-// recorded in the first segment, next to the struct header
+// recorded in the first segment, next to the struct header.
+// A compressed block (version 2) has the same header, and each column is | flag | meta length | data length | meta |
+// data |, see blockCompressEncode.
 // clang-format on
 static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
   int32_t numOfCols = 0;
@@ -70,13 +74,16 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
     }
   }
   SDataCacheEntry* pEntry = (SDataCacheEntry*)pBuf->pData;
-  pEntry->compressed = 0;
   pEntry->numOfRows = pInput->pData->info.rows;
   pEntry->numOfCols = numOfCols;
   pEntry->dataLen = 0;
 
   pBuf->useSize = sizeof(SDataCacheEntry);
-  pEntry->dataLen = blockEncode(pInput->pData, pEntry->data, numOfCols);
+  if (pEntry->compressed) {
+    pEntry->dataLen = blockCompressEncode(pInput->pData, pEntry->data, numOfCols);
+  } else {
+    pEntry->dataLen = blockEncode(pInput->pData, pEntry->data, numOfCols);
+  }
 //  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
 //  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
 
@@ -86,6 +93,27 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
   atomic_add_fetch_64(&gDataSinkStat.cachedSize, pEntry->dataLen);
 }
 
+// the same rule as the compressColData option: compress the block if any column is larger than the threshold
+static bool needCompress(SDataDispatchHandle* pDispatcher, const SSDataBlock* pBlock) {
+  if (!pDispatcher->compress) {
+    return false;
+  }
+
+  if (pDispatcher->compressThreshold == 0) {
+    return true;
+  }
+
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
+    if (colDataGetLength(pColInfoData, pBlock->info.rows) > pDispatcher->compressThreshold) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput, SDataDispatchBuf* pBuf) {
   /*
     uint32_t capacity = pDispatcher->pManager->cfg.maxDataBlockNumPerQuery;
@@ -96,14 +124,21 @@ static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput,
     }
   */
 
-  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
+  bool compressed = needCompress(pDispatcher, pInput->pData);
+  if (compressed) {
+    pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetCompressEncodeSize(pInput->pData);
+  } else {
+    pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
+  }
 
   pBuf->pData = taosMemoryMalloc(pBuf->allocSize);
   if (pBuf->pData == NULL) {
     qError("SinkNode failed to malloc memory, size:%d, code:%d", pBuf->allocSize, TAOS_SYSTEM_ERROR(errno));
+    return false;
   }
 
-  return NULL != pBuf->pData;
+  ((SDataCacheEntry*)pBuf->pData)->compressed = compressed;
+  return true;
 }
 
 static int32_t updateStatus(SDataDispatchHandle* pDispatcher) {
@@ -247,6 +282,8 @@ int32_t createDataDispatcher(SDataSinkManager* pManager, const SDataSinkNode* pD
   dispatcher->sink.fGetCacheSize = getCacheSize;
   dispatcher->pManager = pManager;
   dispatcher->pSchema = pDataSink->pInputDataBlockDesc;
+  dispatcher->compress = ((const SDataDispatcherNode*)pDataSink)->compress;
+  dispatcher->compressThreshold = ((const SDataDispatcherNode*)pDataSink)->compressThreshold;
   dispatcher->status = DS_BUF_EMPTY;
   dispatcher->queryEnd = false;
   dispatcher->pDataBlocks = taosOpenQueue();
@@ -1997,6 +1997,23 @@ int32_t buildGroupIdMapForAllTables(STableListInfo* pTableListInfo, SReadHandle*
   return code;
 }
 
+// keep the tables of the given slice only, the other slices of the same vnode are scanned by sibling tasks
+static void keepTablesInSlice(STableListInfo* pTableListInfo, int32_t sliceIdx, int32_t numOfSlices) {
+  int32_t numOfTables = taosArrayGetSize(pTableListInfo->pTableList);
+  int32_t numOfKept = 0;
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    STableKeyInfo* pInfo = taosArrayGet(pTableListInfo->pTableList, i);
+    if (MurmurHash3_32((const char*)&pInfo->uid, sizeof(pInfo->uid)) % numOfSlices != sliceIdx) {
+      continue;
+    }
+    if (numOfKept != i) {
+      taosArraySet(pTableListInfo->pTableList, numOfKept, pInfo);
+    }
+    ++numOfKept;
+  }
+  taosArrayPopTailBatch(pTableListInfo->pTableList, numOfTables - numOfKept);
+}
+
 int32_t createScanTableListInfo(SScanPhysiNode* pScanNode, SNodeList* pGroupTags, bool groupSort, SReadHandle* pHandle,
                                 STableListInfo* pTableListInfo, SNode* pTagCond, SNode* pTagIndexCond,
                                 SExecTaskInfo* pTaskInfo) {
@@ -2014,6 +2031,14 @@ int32_t createScanTableListInfo(SScanPhysiNode* pScanNode, SNodeList* pGroupTags
     return code;
   }
 
+  if (QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN == nodeType(pScanNode) ||
+      QUERY_NODE_PHYSICAL_PLAN_TABLE_MERGE_SCAN == nodeType(pScanNode)) {
+    STableScanPhysiNode* pTableScanNode = (STableScanPhysiNode*)pScanNode;
+    if (pTableScanNode->numOfSlices > 1) {
+      keepTablesInSlice(pTableListInfo, pTableScanNode->sliceIdx, pTableScanNode->numOfSlices);
+    }
+  }
+
   int32_t numOfTables = taosArrayGetSize(pTableListInfo->pTableList);
   ASSERT(pTableListInfo->numOfOuputGroups == 1);
 
@@ -27,16 +27,49 @@
 #include "thash.h"
 #include "ttypes.h"
 
+typedef struct SGroupEntry {
+  uint64_t           hash;
+  uint64_t           groupId;  // block group id, part of the result row key as well
+  const char*        pKey;     // the group key held by the key of the result row in SAggSupporter.pResultRowHashTable
+  int32_t            keyLen;
+  int32_t            mark;     // the last block this group showed up in
+  int32_t            localId;  // dense id of this group within that block
+  SResultRowPosition pos;
+} SGroupEntry;
+
+typedef struct SGroupSlot {
+  uint32_t tag;    // high bits of the hash, to skip most mismatched entries without touching them
+  int32_t  entry;  // entry index + 1, 0 for an empty slot
+} SGroupSlot;
+
+// Open addressing table that maps a group key to its result row, keys are resolved a block at a time.
+typedef struct SGroupHashTable {
+  SGroupSlot*  pSlots;
+  uint32_t     capacity;  // power of 2
+  SGroupEntry* pEntries;
+  int32_t      numOfEntries;
+  int32_t      entryCapacity;
+  int32_t      mark;
+  int32_t      rowCapacity;  // buffers below are allocated for this many rows
+  char*        pRowKeys;     // group key of each row, groupKeyLen bytes apart
+  int32_t*     pRowKeyLen;
+  uint64_t*    pRowHash;
+  int32_t*     pRowGroup;   // entry index of each row
+  int32_t*     pRowLocal;   // local group id of each row
+  int32_t*     pLocalGroup;  // local group id -> entry index
+  int32_t*     pLocalStart;
+  int32_t*     pLocalCount;
+  int32_t*     pIndex;  // row permutation that makes every group contiguous
+} SGroupHashTable;
+
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  SAggSupporter  aggSup;
-  SArray*        pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  bool           isInit;         // denote if current val is initialized or not
-  char*          keyBuf;         // group by keys for hash
-  int32_t        groupKeyLen;    // total group by column width
-  SGroupResInfo  groupResInfo;
-  SExprSupp      scalarSup;
+  SOptrBasicInfo  binfo;
+  SAggSupporter   aggSup;
+  SArray*         pGroupCols;   // group by columns, SArray<SColumn>
+  int32_t         groupKeyLen;  // total group by column width
+  SGroupHashTable groupTable;
+  SGroupResInfo   groupResInfo;
+  SExprSupp       scalarSup;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -62,11 +95,7 @@ static int32_t* setupColumnOffset(const SSDataBlock* pBlock, int32_t rowCapacity
 static int32_t  setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo* binfo, int32_t numOfCols, char* pData,
                                         int16_t bytes, uint64_t groupId, SDiskbasedBuf* pBuf, SAggSupporter* pAggSup);
 static SArray*  extractColumnInfo(SNodeList* pNodeList);
-
-static void freeGroupKey(void* param) {
-  SGroupKeys* pKey = (SGroupKeys*)param;
-  taosMemoryFree(pKey->pData);
-}
+static void     cleanupGroupHashTable(SGroupHashTable* pTable);
 
 static void destroyGroupOperatorInfo(void* param) {
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*)param;
@@ -75,9 +104,8 @@ static void destroyGroupOperatorInfo(void* param) {
   }
 
   cleanupBasicInfo(&pInfo->binfo);
-  taosMemoryFreeClear(pInfo->keyBuf);
   taosArrayDestroy(pInfo->pGroupCols);
-  taosArrayDestroyEx(pInfo->pGroupColVals, freeGroupKey);
+  cleanupGroupHashTable(&pInfo->groupTable);
   cleanupExprSupp(&pInfo->scalarSup);
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
@@ -85,6 +113,18 @@ static void destroyGroupOperatorInfo(void* param) {
   taosMemoryFreeClear(param);
 }
 
+// the width of the group by columns plus a null flag for each of them
+static int32_t getGroupKeyLen(const SArray* pGroupColList) {
+  int32_t keyLen = 0;
+  int32_t numOfGroupCols = taosArrayGetSize(pGroupColList);
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn* pCol = (SColumn*)taosArrayGet(pGroupColList, i);
+    keyLen += pCol->bytes;
+  }
+
+  return keyLen + sizeof(int8_t) * numOfGroupCols;
+}
+
 static int32_t initGroupOptrInfo(SArray** pGroupColVals, int32_t* keyLen, char** keyBuf, const SArray* pGroupColList) {
   *pGroupColVals = taosArrayInit(4, sizeof(SGroupKeys));
   if ((*pGroupColVals) == NULL) {
@@ -94,7 +134,6 @@ static int32_t initGroupOptrInfo(SArray** pGroupColVals, int32_t* keyLen, char**
   int32_t numOfGroupCols = taosArrayGetSize(pGroupColList);
   for (int32_t i = 0; i < numOfGroupCols; ++i) {
     SColumn* pCol = (SColumn*)taosArrayGet(pGroupColList, i);
-    (*keyLen) += pCol->bytes;  // actual data + null_flag
 
     SGroupKeys key = {0};
     key.bytes = pCol->bytes;
@@ -108,9 +147,7 @@ static int32_t initGroupOptrInfo(SArray** pGroupColVals, int32_t* keyLen, char**
     taosArrayPush((*pGroupColVals), &key);
   }
 
-  int32_t nullFlagSize = sizeof(int8_t) * numOfGroupCols;
-  (*keyLen) += nullFlagSize;
-
+  (*keyLen) = getGroupKeyLen(pGroupColList);
   (*keyBuf) = taosMemoryCalloc(1, (*keyLen));
   if ((*keyBuf) == NULL) {
     return TSDB_CODE_OUT_OF_MEMORY;
@@ -119,54 +156,6 @@ static int32_t initGroupOptrInfo(SArray** pGroupColVals, int32_t* keyLen, char**
   return TSDB_CODE_SUCCESS;
 }
 
-static bool groupKeyCompare(SArray* pGroupCols, SArray* pGroupColVals, SSDataBlock* pBlock, int32_t rowIndex,
-                            int32_t numOfGroupCols) {
-  SColumnDataAgg* pColAgg = NULL;
-  for (int32_t i = 0; i < numOfGroupCols; ++i) {
-    SColumn*         pCol = taosArrayGet(pGroupCols, i);
-    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
-    if (pBlock->pBlockAgg != NULL) {
-      pColAgg = pBlock->pBlockAgg[pCol->slotId];  // TODO is agg data matched?
-    }
-
-    bool isNull = colDataIsNull(pColInfoData, pBlock->info.rows, rowIndex, pColAgg);
-
-    SGroupKeys* pkey = taosArrayGet(pGroupColVals, i);
-    if (pkey->isNull && isNull) {
-      continue;
-    }
-
-    if (isNull || pkey->isNull) {
-      return false;
-    }
-
-    char* val = colDataGetData(pColInfoData, rowIndex);
-
-    if (pkey->type == TSDB_DATA_TYPE_JSON) {
-      int32_t dataLen = getJsonValueLen(val);
-
-      if (memcmp(pkey->pData, val, dataLen) == 0) {
-        continue;
-      } else {
-        return false;
-      }
-    } else if (IS_VAR_DATA_TYPE(pkey->type)) {
-      int32_t len = varDataLen(val);
-      if (len == varDataLen(pkey->pData) && memcmp(varDataVal(pkey->pData), varDataVal(val), len) == 0) {
-        continue;
-      } else {
-        return false;
-      }
-    } else {
-      if (memcmp(pkey->pData, val, pkey->bytes) != 0) {
-        return false;
-      }
-    }
-  }
-
-  return true;
-}
-
 static void recordNewGroupKeys(SArray* pGroupCols, SArray* pGroupColVals, SSDataBlock* pBlock, int32_t rowIndex) {
   SColumnDataAgg* pColAgg = NULL;
 
@@ -263,78 +252,383 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
-static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
-  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
-  SGroupbyOperatorInfo* pInfo = pOperator->info;
+#define GROUP_HASH_PRIME   0x9E3779B97F4A7C15ULL
+#define GROUP_HASH_NULL    0x5851F42D4C957F2DULL
+#define GROUP_HASH_MIX(h, v) (((h) ^ (v)) * GROUP_HASH_PRIME)
 
-  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
-  int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
-  //  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
-  // qError("QInfo:0x%"PRIx64" group by not supported on double/float columns, abort", GET_TASKID(pRuntimeEnv));
-  //    return;
-  //  }
+static FORCE_INLINE uint64_t groupHashFinal(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  return h;
+}
 
-  int32_t len = 0;
-  terrno = TSDB_CODE_SUCCESS;
+static void cleanupGroupHashTable(SGroupHashTable* pTable) {
+  taosMemoryFreeClear(pTable->pSlots);
+  taosMemoryFreeClear(pTable->pEntries);
+  taosMemoryFreeClear(pTable->pRowKeys);
+  taosMemoryFreeClear(pTable->pRowKeyLen);
+  taosMemoryFreeClear(pTable->pRowHash);
+  taosMemoryFreeClear(pTable->pRowGroup);
+  taosMemoryFreeClear(pTable->pRowLocal);
+  taosMemoryFreeClear(pTable->pLocalGroup);
+  taosMemoryFreeClear(pTable->pLocalStart);
+  taosMemoryFreeClear(pTable->pLocalCount);
+  taosMemoryFreeClear(pTable->pIndex);
+}
 
-  int32_t num = 0;
-  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
-    // Compare with the previous row of this column, and do not set the output buffer again if they are identical.
-    if (!pInfo->isInit) {
-      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-      if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-        T_LONG_JMP(pTaskInfo->env, terrno);
+static int32_t groupHashTableEnsureRows(SGroupHashTable* pTable, int32_t rows, int32_t keyLen) {
+  if (rows <= pTable->rowCapacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t cap = TMAX(rows, 4096);
+
+  char* pRowKeys = taosMemoryRealloc(pTable->pRowKeys, (int64_t)cap * keyLen);
+  if (pRowKeys == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pTable->pRowKeys = pRowKeys;
+
+  uint64_t* pRowHash = taosMemoryRealloc(pTable->pRowHash, cap * sizeof(uint64_t));
+  if (pRowHash == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pTable->pRowHash = pRowHash;
+
+  int32_t** pArrays[] = {&pTable->pRowKeyLen,  &pTable->pRowGroup,   &pTable->pRowLocal, &pTable->pLocalGroup,
+                         &pTable->pLocalStart, &pTable->pLocalCount, &pTable->pIndex};
+  for (int32_t i = 0; i < tListLen(pArrays); ++i) {
+    int32_t* p = taosMemoryRealloc(*pArrays[i], cap * sizeof(int32_t));
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    *pArrays[i] = p;
+  }
+
+  pTable->rowCapacity = cap;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t groupHashTableRehash(SGroupHashTable* pTable) {
+  uint32_t    cap = (pTable->capacity == 0) ? 4096 : pTable->capacity * 2;
+  SGroupSlot* pSlots = taosMemoryCalloc(cap, sizeof(SGroupSlot));
+  if (pSlots == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < pTable->numOfEntries; ++i) {
+    uint64_t h = pTable->pEntries[i].hash;
+    uint32_t pos = (uint32_t)h & (cap - 1);
+    while (pSlots[pos].entry != 0) {
+      pos = (pos + 1) & (cap - 1);
+    }
+
+    pSlots[pos].tag = (uint32_t)(h >> 32);
+    pSlots[pos].entry = i + 1;
+  }
+
+  taosMemoryFree(pTable->pSlots);
+  pTable->pSlots = pSlots;
+  pTable->capacity = cap;
+  return TSDB_CODE_SUCCESS;
+}
+
+// pKey must stay valid as long as the table, the key of the result row of the group is used.
+static int32_t groupHashTableAddEntry(SGroupHashTable* pTable, uint64_t hash, uint64_t groupId, const char* pKey,
+                                      int32_t keyLen, int32_t* pEntry) {
+  if (pTable->numOfEntries == pTable->entryCapacity) {
+    int32_t      cap = (pTable->entryCapacity == 0) ? 1024 : pTable->entryCapacity * 2;
+    SGroupEntry* p = taosMemoryRealloc(pTable->pEntries, cap * sizeof(SGroupEntry));
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pTable->pEntries = p;
+    pTable->entryCapacity = cap;
+  }
+
+  // keep the load factor under 1/2
+  if ((pTable->numOfEntries + 1) * 2 > pTable->capacity) {
+    int32_t code = groupHashTableRehash(pTable);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  SGroupEntry* pEntryInfo = &pTable->pEntries[pTable->numOfEntries];
+  pEntryInfo->hash = hash;
+  pEntryInfo->groupId = groupId;
+  pEntryInfo->pKey = pKey;
+  pEntryInfo->keyLen = keyLen;
+  pEntryInfo->mark = 0;
+  pEntryInfo->localId = 0;
+
+  uint32_t pos = (uint32_t)hash & (pTable->capacity - 1);
+  while (pTable->pSlots[pos].entry != 0) {
+    pos = (pos + 1) & (pTable->capacity - 1);
+  }
+
+  pTable->pSlots[pos].tag = (uint32_t)(hash >> 32);
+  pTable->pSlots[pos].entry = ++pTable->numOfEntries;
+
+  *pEntry = pTable->numOfEntries - 1;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t groupHashTableFind(SGroupHashTable* pTable, uint64_t hash, uint64_t groupId, const char* pKey,
+                                  int32_t keyLen) {
+  if (pTable->capacity == 0) {
+    return -1;
+  }
+
+  uint32_t tag = (uint32_t)(hash >> 32);
+  uint32_t pos = (uint32_t)hash & (pTable->capacity - 1);
+  while (pTable->pSlots[pos].entry != 0) {
+    SGroupSlot* pSlot = &pTable->pSlots[pos];
+    if (pSlot->tag == tag) {
+      SGroupEntry* pEntry = &pTable->pEntries[pSlot->entry - 1];
+      if (pEntry->hash == hash && pEntry->groupId == groupId && pEntry->keyLen == keyLen &&
+          memcmp(pEntry->pKey, pKey, keyLen) == 0) {
+        return pSlot->entry - 1;
       }
-      pInfo->isInit = true;
-      num++;
-      continue;
     }
 
-    bool equal = groupKeyCompare(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j, numOfGroupCols);
-    if (equal) {
-      num++;
+    pos = (pos + 1) & (pTable->capacity - 1);
+  }
+
+  return -1;
+}
+
+// Build the group key of every row column by column, the same layout as buildGroupKeys, and hash it on the way.
+static int32_t buildBlockGroupKeys(SGroupbyOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  SGroupHashTable* pTable = &pInfo->groupTable;
+  int32_t          rows = pBlock->info.rows;
+  int32_t          numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
+  int32_t          stride = pInfo->groupKeyLen;
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pTable->pRowKeyLen[j] = numOfGroupCols;
+    pTable->pRowHash[j] = 0;
+  }
+
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pInfo->pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    SColumnDataAgg*  pColAgg = (pBlock->pBlockAgg != NULL) ? pBlock->pBlockAgg[pCol->slotId] : NULL;
+    char*            pKey = pTable->pRowKeys;
+
+    if (!IS_VAR_DATA_TYPE(pCol->type)) {
+      int32_t bytes = pCol->bytes;
+      for (int32_t j = 0; j < rows; ++j, pKey += stride) {
+        if (colDataIsNull(pColInfoData, rows, j, pColAgg)) {
+          pKey[i] = 1;
+          pTable->pRowHash[j] = GROUP_HASH_MIX(pTable->pRowHash[j], GROUP_HASH_NULL);
+          continue;
+        }
+
+        const char* val = pColInfoData->pData + (int64_t)j * bytes;
+        uint64_t    v = 0;
+        memcpy(&v, val, TMIN(bytes, sizeof(v)));
+        memcpy(pKey + pTable->pRowKeyLen[j], val, bytes);
+
+        pKey[i] = 0;
+        pTable->pRowKeyLen[j] += bytes;
+        pTable->pRowHash[j] = GROUP_HASH_MIX(pTable->pRowHash[j], v);
+      }
       continue;
     }
 
-    // The first row of a new block does not belongs to the previous existed group
-    if (j == 0) {
-      num++;
-      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-      if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-        T_LONG_JMP(pTaskInfo->env, terrno);
+    for (int32_t j = 0; j < rows; ++j, pKey += stride) {
+      if (colDataIsNull(pColInfoData, rows, j, pColAgg)) {
+        pKey[i] = 1;
+        pTable->pRowHash[j] = GROUP_HASH_MIX(pTable->pRowHash[j], GROUP_HASH_NULL);
+        continue;
+      }
+
+      const char* val = colDataGetData(pColInfoData, j);
+      int32_t     len = 0;
+      if (pCol->type == TSDB_DATA_TYPE_JSON) {
+        if (tTagIsJson(val)) {
+          return TSDB_CODE_QRY_JSON_IN_GROUP_ERROR;
+        }
+        len = getJsonValueLen(val);
+      } else {
+        len = varDataTLen(val);
+        ASSERT(len <= pCol->bytes);
       }
+
+      memcpy(pKey + pTable->pRowKeyLen[j], val, len);
+      pKey[i] = 0;
+      pTable->pRowKeyLen[j] += len;
+      pTable->pRowHash[j] = GROUP_HASH_MIX(pTable->pRowHash[j], MurmurHash3_64(val, len));
+    }
+  }
+
+  uint64_t groupId = pBlock->info.id.groupId;
+  for (int32_t j = 0; j < rows; ++j) {
+    pTable->pRowHash[j] = groupHashFinal(GROUP_HASH_MIX(pTable->pRowHash[j], groupId));
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Map every row of the block to a group entry, new groups get their result row right away.
+static void resolveBlockGroups(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupHashTable*      pTable = &pInfo->groupTable;
+  uint64_t              groupId = pBlock->info.id.groupId;
+  int32_t               prev = -1;
+
+  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+    char*    pKey = pTable->pRowKeys + (int64_t)j * pInfo->groupKeyLen;
+    int32_t  keyLen = pTable->pRowKeyLen[j];
+    uint64_t hash = pTable->pRowHash[j];
+
+    // the rows of a group usually come together
+    if (prev >= 0 && pTable->pRowHash[j - 1] == hash && pTable->pRowKeyLen[j - 1] == keyLen &&
+        memcmp(pKey - pInfo->groupKeyLen, pKey, keyLen) == 0) {
+      pTable->pRowGroup[j] = prev;
       continue;
     }
 
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+    int32_t entry = groupHashTableFind(pTable, hash, groupId, pKey, keyLen);
+    if (entry < 0) {
+      SResultRow* pResultRow =
+          doSetResultOutBufByKey(pInfo->aggSup.pResultBuf, &pInfo->binfo.resultRowInfo, pKey, keyLen, true, groupId,
+                                 pTaskInfo, false, &pInfo->aggSup);
+
+      // the entry shares the key of the result row, which doSetResultOutBufByKey left in aggSup.keyBuf
+      SAggSupporter* pSup = &pInfo->aggSup;
+      void*          pPos = tSimpleHashGet(pSup->pResultRowHashTable, pSup->keyBuf, GET_RES_WINDOW_KEY_LEN(keyLen));
+      const char*    pRowKey = (const char*)tSimpleHashGetKey(pPos, NULL) + sizeof(uint64_t);
+
+      int32_t code = groupHashTableAddEntry(pTable, hash, groupId, pRowKey, keyLen, &entry);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+      pTable->pEntries[entry].pos = (SResultRowPosition){.pageId = pResultRow->pageId, .offset = pResultRow->offset};
     }
 
-    int32_t rowIndex = j - num;
-    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
-                                    pOperator->exprSupp.numOfExprs);
+    pTable->pRowGroup[j] = entry;
+    prev = entry;
+  }
+}
 
-    // assign the group keys or user input constant values if required
-    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
-    recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-    num = 1;
+static void setGroupResultOutputBufByPos(SOperatorInfo* pOperator, SResultRowPosition* pPos) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SResultRowInfo*       pResultRowInfo = &pInfo->binfo.resultRowInfo;
+  SDiskbasedBuf*        pBuf = pInfo->aggSup.pResultBuf;
+
+  SResultRow* pResultRow = getResultRowByPos(pBuf, pPos, true);
+  if (pResultRow == NULL) {
+    T_LONG_JMP(pTaskInfo->env, terrno);
+  }
+
+  // release the page of the previous group, the same as doSetResultOutBufByKey does
+  if (pResultRowInfo->cur.pageId != -1 && pResultRowInfo->cur.pageId != pPos->pageId) {
+    SFilePage* pPage = getBufPage(pBuf, pResultRowInfo->cur.pageId);
+    if (pPage == NULL) {
+      qError("failed to get buffer, code:%s, %s", tstrerror(terrno), GET_TASKID(pTaskInfo));
+      T_LONG_JMP(pTaskInfo->env, terrno);
+    }
+    releaseBufPage(pBuf, pPage);
+  }
+
+  pResultRowInfo->cur = *pPos;
+  setResultRowInitCtx(pResultRow, pOperator->exprSupp.pCtx, pOperator->exprSupp.numOfExprs,
+                      pOperator->exprSupp.rowEntryInfoOffset);
+}
+
+static void doAggregateGroupRows(SOperatorInfo* pOperator, SGroupEntry* pEntry, int32_t rowIndex, int32_t num,
+                                 int32_t totalRows) {
+  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
+
+  setGroupResultOutputBufByPos(pOperator, &pEntry->pos);
+  applyAggFunctionOnPartialTuples(pOperator->pTaskInfo, pCtx, NULL, rowIndex, num, totalRows,
+                                  pOperator->exprSupp.numOfExprs);
+
+  // assign the group keys or user input constant values if required
+  doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, totalRows, rowIndex);
+}
+
+static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupHashTable*      pTable = &pInfo->groupTable;
+  int32_t               rows = pBlock->info.rows;
+
+  if (rows == 0) {
+    return;
+  }
+
+  int32_t code = groupHashTableEnsureRows(pTable, rows, pInfo->groupKeyLen);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  code = buildBlockGroupKeys(pInfo, pBlock);
+  if (code != TSDB_CODE_SUCCESS) {  // group by json error
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  resolveBlockGroups(pOperator, pBlock);
+
+  // number the groups of this block densely and count their rows
+  int32_t numOfLocal = 0;
+  int32_t numOfRuns = 0;
+  int32_t mark = ++pTable->mark;
+  for (int32_t j = 0; j < rows; ++j) {
+    SGroupEntry* pEntry = &pTable->pEntries[pTable->pRowGroup[j]];
+    if (pEntry->mark != mark) {
+      pEntry->mark = mark;
+      pEntry->localId = numOfLocal;
+      pTable->pLocalGroup[numOfLocal] = pTable->pRowGroup[j];
+      pTable->pLocalCount[numOfLocal] = 0;
+      numOfLocal += 1;
+    }
+
+    pTable->pRowLocal[j] = pEntry->localId;
+    pTable->pLocalCount[pEntry->localId] += 1;
+    if (j == 0 || pTable->pRowGroup[j] != pTable->pRowGroup[j - 1]) {
+      numOfRuns += 1;
+    }
   }
 
-  if (num > 0) {
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+  if (numOfRuns == numOfLocal) {  // every group is already contiguous
+    int32_t start = 0;
+    for (int32_t j = 1; j <= rows; ++j) {
+      if (j == rows || pTable->pRowGroup[j] != pTable->pRowGroup[start]) {
+        doAggregateGroupRows(pOperator, &pTable->pEntries[pTable->pRowGroup[start]], start, j - start, rows);
+        start = j;
+      }
     }
+    return;
+  }
 
-    int32_t rowIndex = pBlock->info.rows - num;
-    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
-                                    pOperator->exprSupp.numOfExprs);
-    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
+  // stable counting sort of the rows by group, so each aggregate function is invoked once per group of the block and
+  // the rows of a group keep their original order.
+  int32_t offset = 0;
+  for (int32_t i = 0; i < numOfLocal; ++i) {
+    pTable->pLocalStart[i] = offset;
+    offset += pTable->pLocalCount[i];
+    pTable->pLocalCount[i] = pTable->pLocalStart[i];
+  }
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pTable->pIndex[pTable->pLocalCount[pTable->pRowLocal[j]]++] = j;
+  }
+
+  code = blockDataReorder(pBlock, pTable->pIndex);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  for (int32_t i = 0; i < numOfLocal; ++i) {
+    int32_t start = pTable->pLocalStart[i];
+    doAggregateGroupRows(pOperator, &pTable->pEntries[pTable->pLocalGroup[i]], start,
+                         pTable->pLocalCount[i] - start, rows);
   }
 }
 
@@ -451,15 +745,12 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
   initResultSizeInfo(&pOperator->resultInfo, 4096);
   blockDataEnsureCapacity(pInfo->binfo.pRes, pOperator->resultInfo.capacity);
 
-  code = initGroupOptrInfo(&pInfo->pGroupColVals, &pInfo->groupKeyLen, &pInfo->keyBuf, pInfo->pGroupCols);
-  if (code != TSDB_CODE_SUCCESS) {
-    goto _error;
-  }
+  pInfo->groupKeyLen = getGroupKeyLen(pInfo->pGroupCols);
 
   int32_t    num = 0;
   SExprInfo* pExprInfo = createExprInfo(pAggNode->pAggFuncs, pAggNode->pGroupKeys, &num);
   code = initAggSup(&pOperator->exprSupp, &pInfo->aggSup, pExprInfo, num, pInfo->groupKeyLen, pTaskInfo->id.str,
-                    pTaskInfo->streamInfo.pState);
+                    pTaskInfo->streamInfo.pState, pTaskInfo->pMemAccount);
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
@@ -871,6 +1162,9 @@ SOperatorInfo* createPartitionOperatorInfo(SOperatorInfo* downstream, SPartition
   }
 
   int32_t code = createDiskbasedBuf(&pInfo->pBuf, defaultPgsz, defaultBufsz, pTaskInfo->id.str, tsTempDir);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = dBufSetMemAccount(pInfo->pBuf, pTaskInfo->pMemAccount);
+  }
   if (code != TSDB_CODE_SUCCESS) {
     terrno = code;
     pTaskInfo->code = code;
@@ -0,0 +1,729 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "executorimpl.h"
+#include "filter.h"
+#include "os.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+#include "thash.h"
+#include "tpagedbuf.h"
+#include "tsimplehash.h"
+#include "tsort.h"
+
+/*
+ * The right child is the build side: its blocks are copied and every row is chained into a hash table keyed by the
+ * bytes of its join key columns. The left child is then streamed through the table. When the build side outgrows
+ * queryHashJoinBufSize, both children are split into HJOIN_PARTITION_NUM partitions by the hash of the key and
+ * written to a disk based buffer, and the partitions are joined one after another.
+ */
+#define HJOIN_PARTITION_NUM 16
+
+typedef struct SHJoinKeyCol {
+  int32_t slotId;
+  int8_t  type;
+  int32_t bytes;
+} SHJoinKeyCol;
+
+typedef struct SHJoinTargetCol {
+  bool    fromLeft;
+  int32_t srcSlotId;
+} SHJoinTargetCol;
+
+typedef struct SHJoinRowRef {
+  int32_t blockIdx;
+  int32_t rowIdx;
+  int32_t next;  // next row with the same key, -1 for the end of the chain
+} SHJoinRowRef;
+
+typedef struct SHJoinPartition {
+  SSDataBlock* pBuildRows;  // rows not written to the buffer yet
+  SSDataBlock* pProbeRows;
+  SArray*      pBuildPages;  // ids of the pages in the disk based buffer
+  SArray*      pProbePages;
+} SHJoinPartition;
+
+typedef struct SHJoinOperatorInfo {
+  SSDataBlock*     pRes;
+  int32_t          joinType;
+  SArray*          pLeftKeys;   // SHJoinKeyCol
+  SArray*          pRightKeys;  // SHJoinKeyCol
+  SHJoinTargetCol* pTargets;
+  char*            pKeyBuf;
+  int32_t          keyBufSize;
+  SNode*           pCondAfterJoin;
+
+  // hash table over the build side
+  SArray*    pBuildBlocks;  // SSDataBlock*
+  SArray*    pRowRefs;      // SHJoinRowRef
+  SSHashObj* pKeyHash;      // key -> index of the first row in pRowRefs
+  int64_t    blockSize;
+  int64_t    memLimit;
+
+  // probe cursor
+  SSDataBlock* pProbe;
+  bool         ownProbe;  // pProbe is loaded from the buffer instead of being the block of the left child
+  int32_t      probeRow;
+  int32_t      matchRef;  // next build row to join with probeRow, -1 if none
+
+  // spill to disk
+  bool            spilled;
+  SDiskbasedBuf*  pBuf;
+  int32_t         pageSize;
+  SSDataBlock*    pBuildProto;
+  SSDataBlock*    pProbeProto;
+  SHJoinPartition parts[HJOIN_PARTITION_NUM];
+  int32_t         partIdx;
+  int32_t         pageIdx;
+} SHJoinOperatorInfo;
+
+static int32_t      doOpenHashJoin(SOperatorInfo* pOperator);
+static SSDataBlock* doHashJoin(SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
+
+static int32_t initKeyCols(SNodeList* pKeys, SArray** pKeyCols, int32_t* pKeyLen) {
+  *pKeyCols = taosArrayInit(LIST_LENGTH(pKeys), sizeof(SHJoinKeyCol));
+  if (NULL == *pKeyCols) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t keyLen = 0;
+  SNode*  pNode = NULL;
+  FOREACH(pNode, pKeys) {
+    SColumnNode* pCol = (SColumnNode*)pNode;
+    SHJoinKeyCol key = {.slotId = pCol->slotId, .type = pCol->node.resType.type, .bytes = pCol->node.resType.bytes};
+    taosArrayPush(*pKeyCols, &key);
+    keyLen += key.bytes + (IS_VAR_DATA_TYPE(key.type) ? VARSTR_HEADER_SIZE : 0);
+  }
+
+  *pKeyLen = TMAX(*pKeyLen, keyLen);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t initTargetCols(SHJoinOperatorInfo* pInfo, SExprInfo* pExprInfo, int32_t numOfExprs,
+                              int32_t leftBlockId) {
+  pInfo->pTargets = taosMemoryCalloc(numOfExprs, sizeof(SHJoinTargetCol));
+  if (NULL == pInfo->pTargets) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfExprs; ++i) {
+    SColumn* pCol = pExprInfo[i].base.pParam[0].pCol;
+    pInfo->pTargets[i].fromLeft = (pCol->dataBlockId == leftBlockId);
+    pInfo->pTargets[i].srcSlotId = pCol->slotId;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t getSideRowSize(SPhysiNode* pChild, int32_t* numOfCols) {
+  *numOfCols = LIST_LENGTH(pChild->pOutputDataBlockDesc->pSlots);
+  return pChild->pOutputDataBlockDesc->totalRowSize;
+}
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHJoinOperatorInfo));
+  SOperatorInfo*      pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pOperator == NULL || pInfo == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  int32_t numOfCols = 0;
+  pInfo->pRes = createDataBlockFromDescNode(pJoinNode->node.pOutputDataBlockDesc);
+
+  SExprInfo* pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+  blockDataEnsureCapacity(pInfo->pRes, pOperator->resultInfo.capacity);
+
+  setOperatorInfo(pOperator, "HashJoinOperator", QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, false, OP_NOT_OPENED, pInfo,
+                  pTaskInfo);
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+
+  pInfo->joinType = pJoinNode->joinType;
+  pInfo->memLimit = tsQueryHashJoinBufSize * 1048576L;
+  pInfo->matchRef = -1;
+
+  code = initKeyCols(pJoinNode->pOnLeft, &pInfo->pLeftKeys, &pInfo->keyBufSize);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = initKeyCols(pJoinNode->pOnRight, &pInfo->pRightKeys, &pInfo->keyBufSize);
+  }
+  if (code == TSDB_CODE_SUCCESS) {
+    code = initTargetCols(pInfo, pExprInfo, numOfCols, pDownstream[0]->resultDataBlockId);
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pInfo->pKeyBuf = taosMemoryMalloc(pInfo->keyBufSize);
+  pInfo->pBuildBlocks = taosArrayInit(8, POINTER_BYTES);
+  pInfo->pRowRefs = taosArrayInit(4096, sizeof(SHJoinRowRef));
+  pInfo->pKeyHash = tSimpleHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (NULL == pInfo->pKeyBuf || NULL == pInfo->pBuildBlocks || NULL == pInfo->pRowRefs || NULL == pInfo->pKeyHash) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  // one buffer page has to hold a row of either side
+  int32_t leftCols = 0, rightCols = 0;
+  int32_t leftRowSize = getSideRowSize((SPhysiNode*)nodesListGetNode(pJoinNode->node.pChildren, 0), &leftCols);
+  int32_t rightRowSize = getSideRowSize((SPhysiNode*)nodesListGetNode(pJoinNode->node.pChildren, 1), &rightCols);
+  pInfo->pageSize =
+      TMAX(getProperSortPageSize(leftRowSize, leftCols), getProperSortPageSize(rightRowSize, rightCols));
+
+  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
+    SNodeList* pCondList = NULL;
+    nodesListMakeAppend(&pCondList, nodesCloneNode(pJoinNode->pOnConditions));
+    nodesListMakeAppend(&pCondList, nodesCloneNode(pJoinNode->node.pConditions));
+    code = nodesMergeConds(&pInfo->pCondAfterJoin, &pCondList);
+    nodesDestroyList(pCondList);
+  } else if (pJoinNode->pOnConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->pOnConditions);
+  } else if (pJoinNode->node.pConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->node.pConditions);
+  }
+  if (code == TSDB_CODE_SUCCESS) {
+    code = filterInitFromNode(pInfo->pCondAfterJoin, &pOperator->exprSupp.pFilterInfo, 0);
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pOperator->fpSet =
+      createOperatorFpSet(doOpenHashJoin, doHashJoin, NULL, destroyHashJoinOperator, optrDefaultBufFn, NULL);
+  code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = code;
+  return NULL;
+}
+
+static void clearBuildTable(SHJoinOperatorInfo* pInfo) {
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pBuildBlocks); ++i) {
+    blockDataDestroy(taosArrayGetP(pInfo->pBuildBlocks, i));
+  }
+  taosArrayClear(pInfo->pBuildBlocks);
+  taosArrayClear(pInfo->pRowRefs);
+  tSimpleHashClear(pInfo->pKeyHash);
+  pInfo->blockSize = 0;
+}
+
+void destroyHashJoinOperator(void* param) {
+  SHJoinOperatorInfo* pInfo = (SHJoinOperatorInfo*)param;
+
+  if (pInfo->pBuildBlocks != NULL) {
+    clearBuildTable(pInfo);
+  }
+  taosArrayDestroy(pInfo->pBuildBlocks);
+  taosArrayDestroy(pInfo->pRowRefs);
+  tSimpleHashCleanup(pInfo->pKeyHash);
+
+  for (int32_t i = 0; i < HJOIN_PARTITION_NUM; ++i) {
+    SHJoinPartition* pPart = &pInfo->parts[i];
+    blockDataDestroy(pPart->pBuildRows);
+    blockDataDestroy(pPart->pProbeRows);
+    taosArrayDestroy(pPart->pBuildPages);
+    taosArrayDestroy(pPart->pProbePages);
+  }
+  if (pInfo->ownProbe) {
+    blockDataDestroy(pInfo->pProbe);
+  }
+  blockDataDestroy(pInfo->pBuildProto);
+  blockDataDestroy(pInfo->pProbeProto);
+  destroyDiskbasedBuf(pInfo->pBuf);
+
+  taosArrayDestroy(pInfo->pLeftKeys);
+  taosArrayDestroy(pInfo->pRightKeys);
+  taosMemoryFree(pInfo->pTargets);
+  taosMemoryFree(pInfo->pKeyBuf);
+  nodesDestroyNode(pInfo->pCondAfterJoin);
+
+  pInfo->pRes = blockDataDestroy(pInfo->pRes);
+  taosMemoryFreeClear(param);
+}
+
+// Returns the length of the key of the row, or -1 if any of its key columns is null, which never matches.
+static int32_t buildRowKey(SHJoinOperatorInfo* pInfo, SArray* pKeys, SSDataBlock* pBlock, int32_t rowIndex) {
+  int32_t len = 0;
+  size_t  numOfKeys = taosArrayGetSize(pKeys);
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    SHJoinKeyCol*    pKey = taosArrayGet(pKeys, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pKey->slotId);
+    if (colDataIsNull_s(pCol, rowIndex)) {
+      return -1;
+    }
+
+    char* pData = colDataGetData(pCol, rowIndex);
+    if (IS_VAR_DATA_TYPE(pKey->type)) {
+      // the length header is kept, so that concatenated keys stay unambiguous
+      memcpy(pInfo->pKeyBuf + len, pData, varDataTLen(pData));
+      len += varDataTLen(pData);
+    } else {
+      memcpy(pInfo->pKeyBuf + len, pData, pKey->bytes);
+      len += pKey->bytes;
+    }
+  }
+  return len;
+}
+
+static int32_t getKeyPartition(const char* pKey, int32_t len) {
+  // the low bits of the hash value pick the slot in the hash table of the partition, so use the high bits here
+  return (MurmurHash3_32(pKey, len) >> 24) % HJOIN_PARTITION_NUM;
+}
+
+static int32_t addBuildBlock(SHJoinOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  int32_t blockIdx = taosArrayGetSize(pInfo->pBuildBlocks);
+  if (NULL == taosArrayPush(pInfo->pBuildBlocks, &pBlock)) {
+    blockDataDestroy(pBlock);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pInfo->blockSize += blockDataGetSize(pBlock);
+
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int32_t len = buildRowKey(pInfo, pInfo->pRightKeys, pBlock, i);
+    if (len < 0) {
+      continue;
+    }
+
+    SHJoinRowRef ref = {.blockIdx = blockIdx, .rowIdx = i, .next = -1};
+    int32_t      refIdx = taosArrayGetSize(pInfo->pRowRefs);
+    int32_t*     pHead = tSimpleHashGet(pInfo->pKeyHash, pInfo->pKeyBuf, len);
+    if (NULL != pHead) {
+      ref.next = *pHead;
+      *pHead = refIdx;
+    } else if (tSimpleHashPut(pInfo->pKeyHash, pInfo->pKeyBuf, len, &refIdx, sizeof(int32_t)) != 0) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    if (NULL == taosArrayPush(pInfo->pRowRefs, &ref)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int64_t getBuildTableSize(SHJoinOperatorInfo* pInfo) {
+  return pInfo->blockSize + taosArrayGetSize(pInfo->pRowRefs) * sizeof(SHJoinRowRef) +
+         tSimpleHashGetMemSize(pInfo->pKeyHash);
+}
+
+static int32_t flushPartitionRows(SHJoinOperatorInfo* pInfo, SSDataBlock* pRows, SArray* pPageIdList) {
+  if (pRows->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t pageId = -1;
+  void*   pPage = getNewBufPage(pInfo->pBuf, &pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  blockDataToBuf(pPage, pRows);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pInfo->pBuf, pPage);
+
+  taosArrayPush(pPageIdList, &pageId);
+  blockDataCleanup(pRows);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t appendPartitionRow(SHJoinOperatorInfo* pInfo, SSDataBlock** ppRows, SArray* pPageIdList,
+                                  SSDataBlock* pBlock, int32_t rowIndex) {
+  if (*ppRows == NULL) {
+    // a block of partition rows always fits in one page of the buffer
+    *ppRows = createOneDataBlock(pBlock, false);
+    if (*ppRows == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    blockDataGetRowSize(*ppRows);
+    int32_t code = blockDataEnsureCapacity(*ppRows, blockDataGetCapacityInRow(*ppRows, pInfo->pageSize));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  SSDataBlock* pRows = *ppRows;
+  size_t       numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, i);
+    SColumnInfoData* pDst = taosArrayGet(pRows->pDataBlock, i);
+    bool             isNull = colDataIsNull_s(pSrc, rowIndex);
+    int32_t code = colDataAppend(pDst, pRows->info.rows, isNull ? NULL : colDataGetData(pSrc, rowIndex), isNull);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  pRows->info.rows += 1;
+  if (pRows->info.rows >= pRows->info.capacity) {
+    return flushPartitionRows(pInfo, pRows, pPageIdList);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t partitionBlock(SHJoinOperatorInfo* pInfo, SSDataBlock* pBlock, bool build) {
+  SArray* pKeys = build ? pInfo->pRightKeys : pInfo->pLeftKeys;
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int32_t len = buildRowKey(pInfo, pKeys, pBlock, i);
+    if (len < 0) {
+      continue;
+    }
+
+    SHJoinPartition* pPart = &pInfo->parts[getKeyPartition(pInfo->pKeyBuf, len)];
+    int32_t          code = build ? appendPartitionRow(pInfo, &pPart->pBuildRows, pPart->pBuildPages, pBlock, i)
+                                  : appendPartitionRow(pInfo, &pPart->pProbeRows, pPart->pProbePages, pBlock, i);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t startSpill(SHJoinOperatorInfo* pInfo, SExecTaskInfo* pTaskInfo) {
+  const char* idStr = GET_TASKID(pTaskInfo);
+
+  if (!osTempSpaceAvailable()) {
+    qError("hash join spill failed since %s, %s", terrstr(TSDB_CODE_NO_AVAIL_DISK), idStr);
+    return TSDB_CODE_NO_AVAIL_DISK;
+  }
+
+  int32_t inMemBufSize = (int32_t)TMIN(pInfo->memLimit, INT32_MAX);
+  int32_t code = createDiskbasedBuf(&pInfo->pBuf, pInfo->pageSize, inMemBufSize, "hashJoinBuf", tsTempDir);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+  dBufSetPrintInfo(pInfo->pBuf);
+
+  code = dBufSetMemAccount(pInfo->pBuf, pTaskInfo->pMemAccount);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  for (int32_t i = 0; i < HJOIN_PARTITION_NUM; ++i) {
+    pInfo->parts[i].pBuildPages = taosArrayInit(4, sizeof(int32_t));
+    pInfo->parts[i].pProbePages = taosArrayInit(4, sizeof(int32_t));
+    if (NULL == pInfo->parts[i].pBuildPages || NULL == pInfo->parts[i].pProbePages) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  qDebug("hash join build side exceeds %" PRId64 " bytes, spill to %d partitions, %s", pInfo->memLimit,
+         HJOIN_PARTITION_NUM, idStr);
+
+  // move the rows kept so far into the partitions
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pBuildBlocks); ++i) {
+    code = partitionBlock(pInfo, taosArrayGetP(pInfo->pBuildBlocks, i), true);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+  clearBuildTable(pInfo);
+
+  pInfo->spilled = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doBuildHashTable(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  SOperatorInfo*      pBuildOp = pOperator->pDownstream[1];
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  while (1) {
+    SSDataBlock* pBlock = pBuildOp->fpSet.getNextFn(pBuildOp);
+    if (pBlock == NULL) {
+      break;
+    }
+    if (pBlock->info.rows == 0) {
+      continue;
+    }
+
+    if (pInfo->pBuildProto == NULL) {
+      pInfo->pBuildProto = createOneDataBlock(pBlock, false);
+      if (pInfo->pBuildProto == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    if (pInfo->spilled) {
+      code = partitionBlock(pInfo, pBlock, true);
+    } else {
+      SSDataBlock* pCopy = createOneDataBlock(pBlock, true);
+      code = (pCopy == NULL) ? TSDB_CODE_OUT_OF_MEMORY : addBuildBlock(pInfo, pCopy);
+      if (code == TSDB_CODE_SUCCESS && getBuildTableSize(pInfo) > pInfo->memLimit) {
+        code = startSpill(pInfo, pOperator->pTaskInfo);
+      }
+    }
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  if (!pInfo->spilled) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (int32_t i = 0; i < HJOIN_PARTITION_NUM && code == TSDB_CODE_SUCCESS; ++i) {
+    if (pInfo->parts[i].pBuildRows != NULL) {
+      code = flushPartitionRows(pInfo, pInfo->parts[i].pBuildRows, pInfo->parts[i].pBuildPages);
+    }
+  }
+  return code;
+}
+
+static int32_t doPartitionProbeSide(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  SOperatorInfo*      pProbeOp = pOperator->pDownstream[0];
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  while (1) {
+    SSDataBlock* pBlock = pProbeOp->fpSet.getNextFn(pProbeOp);
+    if (pBlock == NULL) {
+      break;
+    }
+    if (pBlock->info.rows == 0) {
+      continue;
+    }
+
+    if (pInfo->pProbeProto == NULL) {
+      pInfo->pProbeProto = createOneDataBlock(pBlock, false);
+      if (pInfo->pProbeProto == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    code = partitionBlock(pInfo, pBlock, false);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  for (int32_t i = 0; i < HJOIN_PARTITION_NUM && code == TSDB_CODE_SUCCESS; ++i) {
+    if (pInfo->parts[i].pProbeRows != NULL) {
+      code = flushPartitionRows(pInfo, pInfo->parts[i].pProbeRows, pInfo->parts[i].pProbePages);
+    }
+  }
+  return code;
+}
+
+static int32_t loadPage(SHJoinOperatorInfo* pInfo, SSDataBlock* pProto, int32_t pageId, SSDataBlock** ppBlock) {
+  void* pPage = getBufPage(pInfo->pBuf, pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  SSDataBlock* pBlock = createOneDataBlock(pProto, false);
+  int32_t      code = (pBlock == NULL) ? TSDB_CODE_OUT_OF_MEMORY : blockDataFromBuf(pBlock, pPage);
+  releaseBufPage(pInfo->pBuf, pPage);
+  if (code != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(pBlock);
+    return code;
+  }
+
+  *ppBlock = pBlock;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t loadBuildPartition(SHJoinOperatorInfo* pInfo, SHJoinPartition* pPart) {
+  for (int32_t i = 0; i < taosArrayGetSize(pPart->pBuildPages); ++i) {
+    SSDataBlock* pBlock = NULL;
+    int32_t      code = loadPage(pInfo, pInfo->pBuildProto, *(int32_t*)taosArrayGet(pPart->pBuildPages, i), &pBlock);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = addBuildBlock(pInfo, pBlock);
+    }
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static void setProbeBlock(SHJoinOperatorInfo* pInfo, SSDataBlock* pBlock, bool own) {
+  if (pInfo->ownProbe) {
+    blockDataDestroy(pInfo->pProbe);
+  }
+  pInfo->pProbe = pBlock;
+  pInfo->ownProbe = own;
+  pInfo->probeRow = 0;
+  pInfo->matchRef = -1;
+}
+
+// Moves the probe cursor to the next block. Returns false if the probe side is exhausted.
+static bool nextProbeBlock(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*      pTaskInfo = pOperator->pTaskInfo;
+
+  if (!pInfo->spilled) {
+    SOperatorInfo* pProbeOp = pOperator->pDownstream[0];
+    SSDataBlock*   pBlock = pProbeOp->fpSet.getNextFn(pProbeOp);
+    setProbeBlock(pInfo, pBlock, false);
+    return pBlock != NULL;
+  }
+
+  while (pInfo->partIdx < HJOIN_PARTITION_NUM) {
+    SHJoinPartition* pPart = &pInfo->parts[pInfo->partIdx];
+    int32_t          code = TSDB_CODE_SUCCESS;
+
+    // the partition is only loaded when it has rows on both sides
+    if (pInfo->pageIdx == 0 && taosArrayGetSize(pPart->pProbePages) > 0 && taosArrayGetSize(pPart->pBuildPages) > 0) {
+      code = loadBuildPartition(pInfo, pPart);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
+
+    if (taosArrayGetSize(pInfo->pRowRefs) > 0 && pInfo->pageIdx < taosArrayGetSize(pPart->pProbePages)) {
+      SSDataBlock* pBlock = NULL;
+      code = loadPage(pInfo, pInfo->pProbeProto, *(int32_t*)taosArrayGet(pPart->pProbePages, pInfo->pageIdx), &pBlock);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+      pInfo->pageIdx += 1;
+      setProbeBlock(pInfo, pBlock, true);
+      return true;
+    }
+
+    clearBuildTable(pInfo);
+    pInfo->partIdx += 1;
+    pInfo->pageIdx = 0;
+  }
+
+  setProbeBlock(pInfo, NULL, false);
+  return false;
+}
+
+static void appendJoinedRow(SOperatorInfo* pOperator, SSDataBlock* pRes, SSDataBlock* pProbe, int32_t probeRow,
+                            SSDataBlock* pBuild, int32_t buildRow) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+
+  for (int32_t i = 0; i < pOperator->exprSupp.numOfExprs; ++i) {
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, i);
+    SHJoinTargetCol* pTarget = &pInfo->pTargets[i];
+    SSDataBlock*     pSrcBlock = pTarget->fromLeft ? pProbe : pBuild;
+    int32_t          rowIndex = pTarget->fromLeft ? probeRow : buildRow;
+    SColumnInfoData* pSrc = taosArrayGet(pSrcBlock->pDataBlock, pTarget->srcSlotId);
+
+    if (colDataIsNull_s(pSrc, rowIndex)) {
+      colDataAppendNULL(pDst, pRes->info.rows);
+    } else {
+      colDataAppend(pDst, pRes->info.rows, colDataGetData(pSrc, rowIndex), false);
+    }
+  }
+  pRes->info.rows += 1;
+}
+
+static void doHashJoinImpl(SOperatorInfo* pOperator, SSDataBlock* pRes) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t             capacity = pOperator->resultInfo.capacity;
+
+  while (pRes->info.rows < capacity) {
+    if (pInfo->matchRef >= 0) {
+      SHJoinRowRef* pRef = taosArrayGet(pInfo->pRowRefs, pInfo->matchRef);
+      appendJoinedRow(pOperator, pRes, pInfo->pProbe, pInfo->probeRow, taosArrayGetP(pInfo->pBuildBlocks, pRef->blockIdx),
+                      pRef->rowIdx);
+      pInfo->matchRef = pRef->next;
+      if (pInfo->matchRef < 0) {
+        pInfo->probeRow += 1;
+      }
+      continue;
+    }
+
+    if (pInfo->pProbe == NULL || pInfo->probeRow >= pInfo->pProbe->info.rows) {
+      if (!nextProbeBlock(pOperator)) {
+        setOperatorCompleted(pOperator);
+        break;
+      }
+      continue;
+    }
+
+    int32_t len = buildRowKey(pInfo, pInfo->pLeftKeys, pInfo->pProbe, pInfo->probeRow);
+    int32_t* pHead = (len < 0) ? NULL : tSimpleHashGet(pInfo->pKeyHash, pInfo->pKeyBuf, len);
+    if (pHead == NULL) {
+      pInfo->probeRow += 1;
+    } else {
+      pInfo->matchRef = *pHead;
+    }
+  }
+}
+
+static int32_t doOpenHashJoin(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+
+  if (OPTR_IS_OPENED(pOperator)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t st = taosGetTimestampUs();
+  int32_t code = doBuildHashTable(pOperator);
+  if (code == TSDB_CODE_SUCCESS && pInfo->spilled) {
+    code = doPartitionProbeSide(pOperator);
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // nothing can match an empty build side, the probe side is not read at all
+  if (!pInfo->spilled && taosArrayGetSize(pInfo->pRowRefs) == 0) {
+    setOperatorCompleted(pOperator);
+  }
+
+  pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
+  OPTR_SET_OPENED(pOperator);
+  return TSDB_CODE_SUCCESS;
+}
+
+SSDataBlock* doHashJoin(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*      pTaskInfo = pOperator->pTaskInfo;
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  int32_t code = pOperator->fpSet._openFn(pOperator);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  SSDataBlock* pRes = pInfo->pRes;
+  blockDataCleanup(pRes);
+
+  while (pOperator->status != OP_EXEC_DONE) {
+    doHashJoinImpl(pOperator, pRes);
+    if (pOperator->exprSupp.pFilterInfo != NULL) {
+      doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
+    }
+    if (pRes->info.rows > 0) {
+      break;
+    }
+  }
+
+  pRes->info.dataLoad = 1;
+  return (pRes->info.rows > 0) ? pRes : NULL;
+}
@@ -112,7 +112,7 @@ SOperatorInfo* createProjectOperatorInfo(SOperatorInfo* downstream, SProjectPhys
 
   initResultSizeInfo(&pOperator->resultInfo, numOfRows);
   code = initAggSup(&pOperator->exprSupp, &pInfo->aggSup, pExprInfo, numOfCols, keyBufSize, pTaskInfo->id.str,
-                    pTaskInfo->streamInfo.pState);
+                    pTaskInfo->streamInfo.pState, pTaskInfo->pMemAccount);
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
@@ -398,7 +398,7 @@ SOperatorInfo* createIndefinitOutputOperatorInfo(SOperatorInfo* downstream, SPhy
   blockDataEnsureCapacity(pResBlock, numOfRows);
 
   int32_t code = initAggSup(pSup, &pInfo->aggSup, pExprInfo, numOfExpr, keyBufSize, pTaskInfo->id.str,
-                            pTaskInfo->streamInfo.pState);
+                            pTaskInfo->streamInfo.pState, pTaskInfo->pMemAccount);
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
@@ -286,6 +286,40 @@ bool applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo
   return false;
 }
 
+static EDealRes collectFilterColIdWalker(SNode* pNode, void* pContext) {
+  if (QUERY_NODE_COLUMN == nodeType(pNode)) {
+    SColumnNode* pCol = (SColumnNode*)pNode;
+    if (pCol->colType == COLUMN_TYPE_COLUMN) {
+      int16_t colId = pCol->colId;
+      taosArrayPush((SArray*)pContext, &colId);
+    }
+  }
+
+  return DEAL_RES_CONTINUE;
+}
+
+// the data columns referred by the filter, which are loaded before the filter is applied on a file block
+static SArray* extractFilterColIds(SNode* pConditions) {
+  if (pConditions == NULL) {
+    return NULL;
+  }
+
+  SArray* pColIds = taosArrayInit(4, sizeof(int16_t));
+  if (pColIds != NULL) {
+    nodesWalkExpr(pConditions, collectFilterColIdWalker, pColIds);
+  }
+
+  return pColIds;
+}
+
+static bool dataBlockMayContain(void* param, int16_t colId, int8_t type, const void* pVal) {
+  return tsdbDataBlockMayContain((STsdbReader*)param, colId, type, pVal);
+}
+
+static int32_t loadRestOfDataBlock(void* param, const int8_t* pSelect) {
+  return tsdbRetrieveDataBlockRest((STsdbReader*)param, pSelect);
+}
+
 static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
                              uint32_t* status) {
   SExecTaskInfo*          pTaskInfo = pOperator->pTaskInfo;
@@ -333,6 +367,19 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
 
   ASSERT(*status == FUNC_DATA_REQUIRED_DATA_LOAD);
 
+  // try to filter data block according to the bloom filters of the columns in equal conditions
+  if (pOperator->exprSupp.pFilterInfo != NULL && (!loadSMA)) {
+    bool keep = filterBloomExecute(pOperator->exprSupp.pFilterInfo, dataBlockMayContain, pTableScanInfo->dataReader);
+    if (!keep) {
+      qDebug("%s data block filter out by bloom filter, brange:%" PRId64 "-%" PRId64 ", rows:%d",
+             GET_TASKID(pTaskInfo), pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+      pCost->filterOutBlocks += 1;
+      (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
   // try to filter data block according to sma info
   if (pOperator->exprSupp.pFilterInfo != NULL && (!loadSMA)) {
     bool success = doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo);
@@ -367,7 +414,10 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalCheckedRows += pBlock->info.rows;
   pCost->loadBlocks += 1;
 
-  SSDataBlock* p = tsdbRetrieveDataBlock(pTableScanInfo->dataReader, NULL);
+  // only the columns required by the filter are loaded at first, the rest are loaded for the qualified rows
+  SFilterInfo* pFilterInfo = pOperator->exprSupp.pFilterInfo;
+  SSDataBlock* p = tsdbRetrieveDataBlock(pTableScanInfo->dataReader,
+                                         (pFilterInfo != NULL) ? pTableScanInfo->pFilterColIds : NULL);
   if (p == NULL) {
     return terrno;
   }
@@ -378,9 +428,17 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   // restore the previous value
   pCost->totalRows -= pBlock->info.rows;
 
-  if (pOperator->exprSupp.pFilterInfo != NULL) {
+  if (pFilterInfo != NULL) {
     int64_t st = taosGetTimestampUs();
-    doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+    if (tsdbIsDataBlockPartial(pTableScanInfo->dataReader)) {
+      int32_t code = doFilterAndLoad(pBlock, pFilterInfo, &pTableScanInfo->matchInfo, loadRestOfDataBlock,
+                                     pTableScanInfo->dataReader);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    } else {
+      doFilter(pBlock, pFilterInfo, &pTableScanInfo->matchInfo);
+    }
 
     double el = (taosGetTimestampUs() - st) / 1000.0;
     pTableScanInfo->readRecorder.filterTime += el;
@@ -833,6 +891,7 @@ static void destroyTableScanOperatorInfo(void* param) {
   STableScanInfo* pTableScanInfo = (STableScanInfo*)param;
   blockDataDestroy(pTableScanInfo->pResBlock);
   cleanupQueryTableDataCond(&pTableScanInfo->base.cond);
+  taosArrayDestroy(pTableScanInfo->base.pFilterColIds);
 
   tsdbReaderClose(pTableScanInfo->base.dataReader);
   pTableScanInfo->base.dataReader = NULL;
@@ -895,6 +954,8 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
     goto _error;
   }
 
+  pInfo->base.pFilterColIds = extractFilterColIds((SNode*)pTableScanNode->scan.node.pConditions);
+
   pInfo->currentGroupId = -1;
   pInfo->assignBlockUid = pTableScanNode->assignBlockUid;
   pInfo->hasGroupByTag = pTableScanNode->pGroupTags ? true : false;
@@ -2647,6 +2708,7 @@ int32_t startGroupTableMergeScan(SOperatorInfo* pOperator) {
                                              pInfo->pSortInputBlock, pTaskInfo->id.str);
 
   tsortSetFetchRawDataFp(pInfo->pSortHandle, getTableDataBlockImpl, NULL, NULL);
+  tsortSetMemAccount(pInfo->pSortHandle, pTaskInfo->pMemAccount);
 
   // one table has one data block
   int32_t numOfTable = tableEndIdx - tableStartIdx + 1;
@@ -2805,6 +2867,7 @@ SSDataBlock* doTableMergeScan(SOperatorInfo* pOperator) {
 void destroyTableMergeScanOperatorInfo(void* param) {
   STableMergeScanInfo* pTableScanInfo = (STableMergeScanInfo*)param;
   cleanupQueryTableDataCond(&pTableScanInfo->base.cond);
+  taosArrayDestroy(pTableScanInfo->base.pFilterColIds);
 
   int32_t numOfTable = taosArrayGetSize(pTableScanInfo->queryConds);
 
@@ -2909,6 +2972,8 @@ SOperatorInfo* createTableMergeScanOperatorInfo(STableScanPhysiNode* pTableScanN
     goto _error;
   }
 
+  pInfo->base.pFilterColIds = extractFilterColIds((SNode*)pTableScanNode->scan.node.pConditions);
+
   initResultSizeInfo(&pOperator->resultInfo, 1024);
   pInfo->pResBlock = createDataBlockFromDescNode(pDescNode);
   blockDataEnsureCapacity(pInfo->pResBlock, pOperator->resultInfo.capacity);
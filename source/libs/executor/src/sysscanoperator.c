@@ -1426,7 +1426,13 @@ static SSDataBlock* sysTableScanFromMNode(SOperatorInfo* pOperator, SSysTableSca
     }
 
     char* pStart = pRsp->data;
-    extractDataBlockFromFetchRsp(pInfo->pRes, pRsp->data, pInfo->matchInfo.pList, &pStart);
+    code = extractDataBlockFromFetchRsp(pInfo->pRes, pRsp->data, pInfo->matchInfo.pList, &pStart);
+    if (code != TSDB_CODE_SUCCESS) {
+      qError("%s failed to extract meta data from mnode since %s", GET_TASKID(pTaskInfo), tstrerror(code));
+      taosMemoryFree(pRsp);
+      pTaskInfo->code = code;
+      return NULL;
+    }
     updateLoadRemoteInfo(&pInfo->loadInfo, pRsp->numOfRows, pRsp->compLen, startTs, pOperator);
 
     // todo log the filter info
@@ -56,6 +56,14 @@ struct SSortHandle {
   _sort_fetch_block_fn_t  fetchfp;
   _sort_merge_compar_fn_t comparFn;
   SMultiwayMergeTreeInfo* pMergeTree;
+
+  // top-N sort, the rows kept in pDataBlock are organized by a bounded heap
+  int64_t  maxRows;
+  int32_t* pHeap;
+  int32_t  heapSize;
+  int32_t  numOfReplaced;
+
+  SMemAccount* pMemAccount;
 };
 
 static int32_t msortComparFn(const void* pLeft, const void* pRight, void* param);
@@ -86,6 +94,7 @@ SSortHandle* tsortCreateSortHandle(SArray* pSortInfo, int32_t type, int32_t page
   pSortHandle->pOrderedSource = taosArrayInit(4, POINTER_BYTES);
   pSortHandle->cmpParam.orderInfo = pSortInfo;
   pSortHandle->cmpParam.cmpGroupId = false;
+  pSortHandle->cmpParam.keyLen = -1;
 
   tsortSetComparFp(pSortHandle, msortComparFn);
 
@@ -101,6 +110,7 @@ static int32_t sortComparCleanup(SMsortComparParam* cmpParam) {
   for (int32_t i = 0; i < cmpParam->numOfSources; ++i) {
     SSortSource* pSource = cmpParam->pSources[i];
     blockDataDestroy(pSource->src.pBlock);
+    taosMemoryFreeClear(pSource->pKeys);
     taosMemoryFreeClear(pSource);
   }
 
@@ -127,6 +137,7 @@ void tsortClearOrderdSource(SArray* pOrderedSource) {
       (*pSource)->src.pBlock = NULL;
     }
 
+    taosMemoryFreeClear((*pSource)->pKeys);
     taosMemoryFreeClear(*pSource);
   }
 
@@ -146,6 +157,7 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
   destroyDiskbasedBuf(pSortHandle->pBuf);
   taosMemoryFreeClear(pSortHandle->idStr);
   blockDataDestroy(pSortHandle->pDataBlock);
+  taosMemoryFreeClear(pSortHandle->pHeap);
 
   tsortClearOrderdSource(pSortHandle->pOrderedSource);
   taosArrayDestroy(pSortHandle->pOrderedSource);
@@ -197,6 +209,11 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+
+    code = dBufSetMemAccount(pHandle->pBuf, pHandle->pMemAccount);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
   SArray* pPageIdList = taosArrayInit(4, sizeof(int32_t));
@@ -260,6 +277,9 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
     code = createDiskbasedBuf(&pHandle->pBuf, pHandle->pageSize, pHandle->numOfPages * pHandle->pageSize,
                               "sortComparInit", tsTempDir);
     dBufSetPrintInfo(pHandle->pBuf);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = dBufSetMemAccount(pHandle->pBuf, pHandle->pMemAccount);
+    }
     if (code != TSDB_CODE_SUCCESS) {
       terrno = code;
       return code;
@@ -289,6 +309,8 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
         return code;
       }
 
+      pSource->keyValid = false;
+
       releaseBufPage(pHandle->pBuf, pPage);
     }
   } else {
@@ -298,6 +320,7 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
     for (int32_t i = 0; i < pParam->numOfSources; ++i) {
       SSortSource* pSource = pParam->pSources[i];
       pSource->src.pBlock = pHandle->fetchfp(pSource->param);
+      pSource->keyValid = false;
 
       // set current source is done
       if (pSource->src.pBlock == NULL) {
@@ -339,6 +362,7 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
    */
   if (pSource->src.rowIndex >= pSource->src.pBlock->info.rows) {
     pSource->src.rowIndex = 0;
+    pSource->keyValid = false;
 
     if (pHandle->type == SORT_SINGLESOURCE_SORT) {
       pSource->pageIndex++;
@@ -419,46 +443,18 @@ static SSDataBlock* getSortedBlockDataInner(SSortHandle* pHandle, SMsortComparPa
   return (pHandle->pDataBlock->info.rows > 0) ? pHandle->pDataBlock : NULL;
 }
 
-int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
-  int32_t pLeftIdx = *(int32_t*)pLeft;
-  int32_t pRightIdx = *(int32_t*)pRight;
-
-  SMsortComparParam* pParam = (SMsortComparParam*)param;
-
-  SArray* pInfo = pParam->orderInfo;
-
-  SSortSource* pLeftSource = pParam->pSources[pLeftIdx];
-  SSortSource* pRightSource = pParam->pSources[pRightIdx];
-
-  // this input is exhausted, set the special value to denote this
-  if (pLeftSource->src.rowIndex == -1) {
-    return 1;
-  }
-
-  if (pRightSource->src.rowIndex == -1) {
-    return -1;
-  }
-
-  SSDataBlock* pLeftBlock = pLeftSource->src.pBlock;
-  SSDataBlock* pRightBlock = pRightSource->src.pBlock;
-
-  if (pParam->cmpGroupId) {
-    if (pLeftBlock->info.id.groupId != pRightBlock->info.id.groupId) {
-      return pLeftBlock->info.id.groupId < pRightBlock->info.id.groupId ? -1 : 1;
-    }
-  }
-
-  for (int32_t i = 0; i < pInfo->size; ++i) {
+static int32_t tsortCompareRow(SArray* pInfo, int32_t start, SSDataBlock* pLeftBlock, int32_t leftIndex,
+                               SSDataBlock* pRightBlock, int32_t rightIndex) {
+  for (int32_t i = start; i < pInfo->size; ++i) {
     SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pInfo, i);
     SColumnInfoData* pLeftColInfoData = TARRAY_GET_ELEM(pLeftBlock->pDataBlock, pOrder->slotId);
 
     bool leftNull = false;
     if (pLeftColInfoData->hasNull) {
       if (pLeftBlock->pBlockAgg == NULL) {
-        leftNull = colDataIsNull_s(pLeftColInfoData, pLeftSource->src.rowIndex);
+        leftNull = colDataIsNull_s(pLeftColInfoData, leftIndex);
       } else {
-        leftNull =
-            colDataIsNull(pLeftColInfoData, pLeftBlock->info.rows, pLeftSource->src.rowIndex, pLeftBlock->pBlockAgg[i]);
+        leftNull = colDataIsNull(pLeftColInfoData, pLeftBlock->info.rows, leftIndex, pLeftBlock->pBlockAgg[i]);
       }
     }
 
@@ -466,10 +462,9 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
     bool             rightNull = false;
     if (pRightColInfoData->hasNull) {
       if (pRightBlock->pBlockAgg == NULL) {
-        rightNull = colDataIsNull_s(pRightColInfoData, pRightSource->src.rowIndex);
+        rightNull = colDataIsNull_s(pRightColInfoData, rightIndex);
       } else {
-        rightNull = colDataIsNull(pRightColInfoData, pRightBlock->info.rows, pRightSource->src.rowIndex,
-                                  pRightBlock->pBlockAgg[i]);
+        rightNull = colDataIsNull(pRightColInfoData, pRightBlock->info.rows, rightIndex, pRightBlock->pBlockAgg[i]);
       }
     }
 
@@ -485,8 +480,8 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
       return pOrder->nullFirst ? -1 : 1;
     }
 
-    void* left1 = colDataGetData(pLeftColInfoData, pLeftSource->src.rowIndex);
-    void* right1 = colDataGetData(pRightColInfoData, pRightSource->src.rowIndex);
+    void* left1 = colDataGetData(pLeftColInfoData, leftIndex);
+    void* right1 = colDataGetData(pRightColInfoData, rightIndex);
 
     __compar_fn_t fn = getKeyComparFunc(pLeftColInfoData->info.type, pOrder->order);
 
@@ -500,6 +495,83 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
   return 0;
 }
 
+// the keys of a block are encoded when it is compared the first time, and reused until the next block is loaded
+static const char* tsortGetSortKey(SSortSource* pSource, const SMsortComparParam* pParam) {
+  if (pParam->keyLen <= 0) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pSource->src.pBlock;
+  if (!pSource->keyValid) {
+    if (pSource->keyCapacity < pBlock->info.rows) {
+      char* p = taosMemoryRealloc(pSource->pKeys, (int64_t)pBlock->info.rows * pParam->keyLen);
+      if (p == NULL) {
+        return NULL;
+      }
+
+      pSource->pKeys = p;
+      pSource->keyCapacity = pBlock->info.rows;
+    }
+
+    if (blockDataEncodeSortKeys(pBlock, pParam->orderInfo, pParam->keyLen, pSource->pKeys, pParam->keyLen) !=
+        TSDB_CODE_SUCCESS) {
+      return NULL;
+    }
+
+    pSource->keyValid = true;
+  }
+
+  return pSource->pKeys + (int64_t)pSource->src.rowIndex * pParam->keyLen;
+}
+
+int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
+  int32_t pLeftIdx = *(int32_t*)pLeft;
+  int32_t pRightIdx = *(int32_t*)pRight;
+
+  SMsortComparParam* pParam = (SMsortComparParam*)param;
+
+  SArray* pInfo = pParam->orderInfo;
+
+  SSortSource* pLeftSource = pParam->pSources[pLeftIdx];
+  SSortSource* pRightSource = pParam->pSources[pRightIdx];
+
+  // this input is exhausted, set the special value to denote this
+  if (pLeftSource->src.rowIndex == -1) {
+    return 1;
+  }
+
+  if (pRightSource->src.rowIndex == -1) {
+    return -1;
+  }
+
+  SSDataBlock* pLeftBlock = pLeftSource->src.pBlock;
+  SSDataBlock* pRightBlock = pRightSource->src.pBlock;
+
+  if (pParam->cmpGroupId) {
+    if (pLeftBlock->info.id.groupId != pRightBlock->info.id.groupId) {
+      return pLeftBlock->info.id.groupId < pRightBlock->info.id.groupId ? -1 : 1;
+    }
+  }
+
+  if (pParam->keyLen < 0) {
+    pParam->keyLen = blockDataGetSortKeyLen(pLeftBlock, pInfo, &pParam->numOfExact);
+  }
+
+  const char* pLeftKey = tsortGetSortKey(pLeftSource, pParam);
+  const char* pRightKey = tsortGetSortKey(pRightSource, pParam);
+  if (pLeftKey == NULL || pRightKey == NULL) {
+    return tsortCompareRow(pInfo, 0, pLeftBlock, pLeftSource->src.rowIndex, pRightBlock, pRightSource->src.rowIndex);
+  }
+
+  int32_t ret = memcmp(pLeftKey, pRightKey, pParam->keyLen);
+  if (ret != 0 || pParam->numOfExact == taosArrayGetSize(pInfo)) {
+    return ret;
+  }
+
+  return tsortCompareRow(pInfo, pParam->numOfExact, pLeftBlock, pLeftSource->src.rowIndex, pRightBlock,
+                         pRightSource->src.rowIndex);
+}
+
 static int32_t doInternalMergeSort(SSortHandle* pHandle) {
   size_t numOfSources = taosArrayGetSize(pHandle->pOrderedSource);
   if (numOfSources == 0) {
@@ -634,6 +706,115 @@ int32_t getProperSortPageSize(size_t rowSize, uint32_t numOfCols) {
   return pgSize;
 }
 
+// the root of the heap is the kept row which comes last in the sort order
+static FORCE_INLINE int32_t topNCompare(SSortHandle* pHandle, int32_t left, int32_t right) {
+  return tsortCompareRow(pHandle->pSortInfo, 0, pHandle->pDataBlock, pHandle->pHeap[left], pHandle->pDataBlock,
+                         pHandle->pHeap[right]);
+}
+
+static void topNSiftUp(SSortHandle* pHandle, int32_t pos) {
+  while (pos > 0) {
+    int32_t parent = (pos - 1) >> 1;
+    if (topNCompare(pHandle, pos, parent) <= 0) {
+      break;
+    }
+
+    TSWAP(pHandle->pHeap[pos], pHandle->pHeap[parent]);
+    pos = parent;
+  }
+}
+
+static void topNSiftDown(SSortHandle* pHandle, int32_t pos) {
+  while (1) {
+    int32_t largest = pos;
+    int32_t left = (pos << 1) + 1;
+    int32_t right = left + 1;
+
+    if (left < pHandle->heapSize && topNCompare(pHandle, left, largest) > 0) {
+      largest = left;
+    }
+    if (right < pHandle->heapSize && topNCompare(pHandle, right, largest) > 0) {
+      largest = right;
+    }
+    if (largest == pos) {
+      break;
+    }
+
+    TSWAP(pHandle->pHeap[pos], pHandle->pHeap[largest]);
+    pos = largest;
+  }
+}
+
+static int32_t topNSetRow(SSDataBlock* pDst, int32_t dstIndex, const SSDataBlock* pSrc, int32_t srcIndex) {
+  int32_t numOfCols = taosArrayGetSize(pDst->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+
+    if (pSrcCol->pData == NULL || colDataIsNull_s(pSrcCol, srcIndex)) {
+      colDataAppendNULL(pDstCol, dstIndex);
+      continue;
+    }
+
+    // the slot may be taken by a null value of the replaced row
+    if (!IS_VAR_DATA_TYPE(pDstCol->info.type)) {
+      colDataClearNull_f(pDstCol->nullbitmap, dstIndex);
+    }
+
+    int32_t code = colDataAppend(pDstCol, dstIndex, colDataGetData(pSrcCol, srcIndex), false);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t topNAddBlock(SSortHandle* pHandle, const SSDataBlock* pBlock) {
+  SSDataBlock* pKept = pHandle->pDataBlock;
+
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    if (pHandle->heapSize < pHandle->maxRows) {
+      int32_t code = topNSetRow(pKept, pKept->info.rows, pBlock, i);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+
+      pHandle->pHeap[pHandle->heapSize] = pKept->info.rows;
+      pKept->info.rows += 1;
+      topNSiftUp(pHandle, pHandle->heapSize++);
+      continue;
+    }
+
+    // not ahead of the last kept row, drop it
+    int32_t top = pHandle->pHeap[0];
+    if (tsortCompareRow(pHandle->pSortInfo, 0, (SSDataBlock*)pBlock, i, pKept, top) >= 0) {
+      continue;
+    }
+
+    int32_t code = topNSetRow(pKept, top, pBlock, i);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+    topNSiftDown(pHandle, 0);
+
+    // the replaced var type values are left in the buffer, squeeze them out once they are as many as the kept ones
+    if (pKept->info.hasVarCol && ++pHandle->numOfReplaced >= pHandle->heapSize) {
+      code = blockDataReorder(pKept, pHandle->pHeap);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+
+      for (int32_t j = 0; j < pHandle->heapSize; ++j) {
+        pHandle->pHeap[j] = j;
+      }
+      pHandle->numOfReplaced = 0;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t createInitialSources(SSortHandle* pHandle) {
   size_t sortBufSize = pHandle->numOfPages * pHandle->pageSize;
   int32_t code = 0;
@@ -659,13 +840,27 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         pHandle->numOfPages = 1024;
         sortBufSize = pHandle->numOfPages * pHandle->pageSize;
         pHandle->pDataBlock = createOneDataBlock(pBlock, false);
+
+        // the external sort is needed only if the kept rows do not fit in the sort buffer
+        if (pHandle->maxRows > 0 && pHandle->maxRows * blockDataGetRowSize(pBlock) <= sortBufSize) {
+          pHandle->pHeap = taosMemoryMalloc(pHandle->maxRows * sizeof(int32_t));
+          if (pHandle->pHeap == NULL || blockDataEnsureCapacity(pHandle->pDataBlock, pHandle->maxRows) != 0) {
+            code = TSDB_CODE_OUT_OF_MEMORY;
+          }
+        }
       }
 
       if (pHandle->beforeFp != NULL) {
         pHandle->beforeFp(pBlock, pHandle->param);
       }
 
-      code = blockDataMerge(pHandle->pDataBlock, pBlock);
+      if (code == TSDB_CODE_SUCCESS) {
+        if (pHandle->pHeap != NULL) {
+          code = topNAddBlock(pHandle, pBlock);
+        } else {
+          code = blockDataMerge(pHandle->pDataBlock, pBlock);
+        }
+      }
       if (code != TSDB_CODE_SUCCESS) {
         if (source->param && !source->onlyRef) {
           taosMemoryFree(source->param);
@@ -679,7 +874,7 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       }
 
       size_t size = blockDataGetSize(pHandle->pDataBlock);
-      if (size > sortBufSize) {
+      if (size > sortBufSize && pHandle->pHeap == NULL) {
         // Perform the in-memory sort and then flush data in the buffer into disk.
         int64_t p = taosGetTimestampUs();
         code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
@@ -727,7 +922,7 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       pHandle->sortElapsed += el;
 
       // All sorted data can fit in memory, external memory sort is not needed. Return to directly
-      if (size <= sortBufSize && pHandle->pBuf == NULL) {
+      if ((size <= sortBufSize || pHandle->pHeap != NULL) && pHandle->pBuf == NULL) {
         pHandle->cmpParam.numOfSources = 1;
         pHandle->inMemSort = true;
 
@@ -801,6 +996,10 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp) {
   return TSDB_CODE_SUCCESS;
 }
 
+void tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows) { pHandle->maxRows = maxRows; }
+
+void tsortSetMemAccount(SSortHandle* pHandle, SMemAccount* pAccount) { pHandle->pMemAccount = pAccount; }
+
 int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId) {
   pHandle->cmpParam.cmpGroupId = compareGroupId;
   return TSDB_CODE_SUCCESS;
@@ -877,7 +1076,11 @@ SSortExecInfo tsortGetSortExecInfo(SSortHandle* pHandle) {
     info.sortBuffer = 2 * 1048576;   // 2mb by default
   } else {
     info.sortBuffer = pHandle->pageSize * pHandle->numOfPages;
-    info.sortMethod = pHandle->inMemSort ? SORT_QSORT_T : SORT_SPILLED_MERGE_SORT_T;
+    if (pHandle->pHeap != NULL) {
+      info.sortMethod = SORT_TOPN_HEAP_T;
+    } else {
+      info.sortMethod = pHandle->inMemSort ? SORT_QSORT_T : SORT_SPILLED_MERGE_SORT_T;
+    }
     info.loops = pHandle->loops;
 
     if (pHandle->pBuf != NULL) {
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "tmemaccount.h"
+
+namespace {
+
+const int32_t SOURCE_BLOCK_ID = 1;
+const int32_t AGG_BLOCK_ID = 2;
+const int32_t NAME_LEN = 16;
+const int64_t NULL_KEY = INT64_MIN;  // a row of the source with a null id
+
+// group key: id, or NULL_KEY for null, and name
+typedef std::pair<int64_t, std::string> SGroupKey;
+// result of a group: count(v), sum(v)
+typedef std::pair<int64_t, int64_t> SGroupRes;
+
+// rows (id bigint, name varchar, v int) returned in blocks of rowsPerBlock rows
+struct SGroupSource {
+  std::vector<int64_t>     ids;
+  std::vector<std::string> names;
+  std::vector<int32_t>     values;
+  int32_t                  rowsPerBlock = 1000;
+  int32_t                  pos = 0;
+  SSDataBlock*             pBlock = NULL;
+
+  void append(int64_t id, const std::string& name, int32_t value) {
+    ids.push_back(id);
+    names.push_back(name);
+    values.push_back(value);
+  }
+};
+
+SSDataBlock* getGroupSourceBlock(SOperatorInfo* pOperator) {
+  SGroupSource* pSource = static_cast<SGroupSource*>(pOperator->info);
+  if (pSource->pos >= (int32_t)pSource->ids.size()) {
+    return NULL;
+  }
+
+  if (pSource->pBlock == NULL) {
+    pSource->pBlock = createDataBlock();
+    pSource->pBlock->info.id.blockId = pOperator->resultDataBlockId;
+
+    SColumnInfoData idCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    blockDataAppendColInfo(pSource->pBlock, &idCol);
+    SColumnInfoData nameCol = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, NAME_LEN + VARSTR_HEADER_SIZE, 2);
+    blockDataAppendColInfo(pSource->pBlock, &nameCol);
+    SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 3);
+    blockDataAppendColInfo(pSource->pBlock, &valCol);
+    blockDataEnsureCapacity(pSource->pBlock, pSource->rowsPerBlock);
+  } else {
+    blockDataCleanup(pSource->pBlock);
+  }
+
+  SSDataBlock*     pBlock = pSource->pBlock;
+  SColumnInfoData* pIdCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  SColumnInfoData* pNameCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+  SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 2));
+  int32_t          numOfRows = std::min(pSource->rowsPerBlock, (int32_t)pSource->ids.size() - pSource->pos);
+  for (int32_t i = 0; i < numOfRows; ++i, ++pSource->pos) {
+    int64_t id = pSource->ids[pSource->pos];
+    char    name[NAME_LEN + VARSTR_HEADER_SIZE];
+    STR_WITH_SIZE_TO_VARSTR(name, pSource->names[pSource->pos].c_str(), pSource->names[pSource->pos].size());
+
+    colDataAppend(pIdCol, i, reinterpret_cast<const char*>(&id), id == NULL_KEY);
+    colDataAppend(pNameCol, i, name, false);
+    colDataAppend(pValCol, i, reinterpret_cast<const char*>(&pSource->values[pSource->pos]), false);
+  }
+
+  pBlock->info.rows = numOfRows;
+  pBlock->info.dataLoad = 1;
+  return pBlock;
+}
+
+void destroyGroupSource(void* param) {
+  SGroupSource* pSource = static_cast<SGroupSource*>(param);
+  blockDataDestroy(pSource->pBlock);
+  delete pSource;
+}
+
+SOperatorInfo* createGroupSourceOperator(SGroupSource* pSource) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  pOperator->name = "groupSourceOperator4Test";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_EXCHANGE;  // scanned in ascending order, the same as an exchange
+  pOperator->info = pSource;
+  pOperator->resultDataBlockId = SOURCE_BLOCK_ID;
+  pOperator->fpSet.getNextFn = getGroupSourceBlock;
+  pOperator->fpSet.closeFn = destroyGroupSource;
+  return pOperator;
+}
+
+SColumnNode* createColumn(int32_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = SOURCE_BLOCK_ID;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return pCol;
+}
+
+STargetNode* createTarget(int32_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = AGG_BLOCK_ID;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return pTarget;
+}
+
+SFunctionNode* createAggFunc(const char* name) {
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  tstrncpy(pFunc->functionName, name, sizeof(pFunc->functionName));
+  nodesListMakeAppend(&pFunc->pParameterList, (SNode*)createColumn(2, TSDB_DATA_TYPE_INT, sizeof(int32_t)));
+
+  char msg[128] = {0};
+  EXPECT_EQ(fmGetFuncInfo(pFunc, msg, sizeof(msg)), TSDB_CODE_SUCCESS) << msg;
+  return pFunc;
+}
+
+// select count(v), sum(v), id, name group by id, name
+SAggPhysiNode* createGroupNode() {
+  SAggPhysiNode* pAgg = (SAggPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_AGG);
+
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = AGG_BLOCK_ID;
+  int8_t  aType[] = {TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_VARCHAR};
+  int32_t aBytes[] = {sizeof(int64_t), sizeof(int64_t), sizeof(int64_t), NAME_LEN + VARSTR_HEADER_SIZE};
+  for (int32_t i = 0; i < 4; ++i) {
+    SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+    pSlot->slotId = i;
+    pSlot->dataType.type = aType[i];
+    pSlot->dataType.bytes = aBytes[i];
+    pSlot->output = true;
+    nodesListMakeAppend(&pDesc->pSlots, (SNode*)pSlot);
+    pDesc->totalRowSize += aBytes[i];
+    pDesc->outputRowSize += aBytes[i];
+  }
+  pAgg->node.pOutputDataBlockDesc = pDesc;
+
+  nodesListMakeAppend(&pAgg->pAggFuncs, (SNode*)createTarget(0, (SNode*)createAggFunc("count")));
+  nodesListMakeAppend(&pAgg->pAggFuncs, (SNode*)createTarget(1, (SNode*)createAggFunc("sum")));
+  nodesListMakeAppend(&pAgg->pGroupKeys,
+                      (SNode*)createTarget(2, (SNode*)createColumn(0, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t))));
+  nodesListMakeAppend(&pAgg->pGroupKeys, (SNode*)createTarget(3, (SNode*)createColumn(1, TSDB_DATA_TYPE_VARCHAR,
+                                                                                        NAME_LEN + VARSTR_HEADER_SIZE)));
+  return pAgg;
+}
+
+std::map<SGroupKey, SGroupRes> expectedGroups(const SGroupSource& source) {
+  std::map<SGroupKey, SGroupRes> groups;
+  for (size_t i = 0; i < source.ids.size(); ++i) {
+    SGroupRes& res = groups[SGroupKey(source.ids[i], source.names[i])];
+    res.first += 1;
+    res.second += source.values[i];
+  }
+  return groups;
+}
+
+class GroupbyTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() { ASSERT_EQ(fmFuncMgtInit(), TSDB_CODE_SUCCESS); }
+
+  void SetUp() override {
+    tstrncpy(tsTempDir, TD_TMP_DIR_PATH, PATH_MAX);
+    osUpdate();
+
+    memset(&taskInfo, 0, sizeof(taskInfo));
+    taskInfo.id.str = (char*)"groupbyTest";
+    taskInfo.execModel = OPTR_EXEC_MODEL_BATCH;
+    taskInfo.pMemAccount = taosMemAccountCreate(NULL, "task", -1);
+  }
+
+  void TearDown() override { taosMemAccountDestroy(taskInfo.pMemAccount); }
+
+  // Runs the group by on the source, which is owned by the operator from now on. Returns the code of the task.
+  int32_t runGroupby(SGroupSource* pSource, std::map<SGroupKey, SGroupRes>& groups) {
+    SOperatorInfo* pDownstream = createGroupSourceOperator(pSource);
+    SAggPhysiNode* pAgg = createGroupNode();
+    SOperatorInfo* pOperator = createGroupOperatorInfo(pDownstream, pAgg, &taskInfo);
+    if (pOperator == NULL) {
+      nodesDestroyNode((SNode*)pAgg);
+      destroyOperatorInfo(pDownstream);
+      return taskInfo.code;
+    }
+
+    groups.clear();
+    int32_t code = setjmp(taskInfo.env);
+    if (code == TSDB_CODE_SUCCESS) {
+      while (1) {
+        SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+        if (pRes == NULL) break;
+
+        SColumnInfoData* pCountCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+        SColumnInfoData* pSumCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+        SColumnInfoData* pIdCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 2));
+        SColumnInfoData* pNameCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 3));
+        for (int32_t i = 0; i < pRes->info.rows; ++i) {
+          int64_t     id = colDataIsNull_s(pIdCol, i) ? NULL_KEY : *(int64_t*)colDataGetData(pIdCol, i);
+          const char* name = colDataGetData(pNameCol, i);
+          SGroupKey   key(id, std::string(varDataVal(name), varDataLen(name)));
+
+          EXPECT_EQ(groups.count(key), 0) << "group " << key.first << "," << key.second << " returned twice";
+          groups[key] = SGroupRes(*(int64_t*)colDataGetData(pCountCol, i), *(int64_t*)colDataGetData(pSumCol, i));
+        }
+      }
+    }
+
+    destroyOperatorInfo(pOperator);
+    nodesDestroyNode((SNode*)pAgg);
+    return code;
+  }
+
+  SExecTaskInfo taskInfo;
+};
+
+}  // namespace
+
+// Groups come in runs, so each block is aggregated without reordering its rows.
+TEST_F(GroupbyTest, contiguousGroups) {
+  SGroupSource* pSource = new SGroupSource();
+  pSource->rowsPerBlock = 100;
+  for (int32_t i = 0; i < 1000; ++i) {
+    pSource->append(i / 30, (i / 30) % 2 ? "odd" : "even", i);
+  }
+
+  std::map<SGroupKey, SGroupRes> expected = expectedGroups(*pSource);
+  std::map<SGroupKey, SGroupRes> groups;
+  ASSERT_EQ(runGroupby(pSource, groups), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(expected.size(), 34);
+  ASSERT_EQ(groups, expected);
+}
+
+// Rows of the groups interleave, with null ids and names that tell groups of the same id apart. There are more groups
+// than the initial capacity of the group table, which is rehashed on the way.
+TEST_F(GroupbyTest, interleavedGroups) {
+  SGroupSource* pSource = new SGroupSource();
+  pSource->rowsPerBlock = 777;
+  for (int32_t i = 0; i < 50000; ++i) {
+    int64_t     id = (i % 11 == 0) ? NULL_KEY : (i * 7919) % 5003;
+    std::string name = (i % 3 == 0) ? "a" : "name" + std::to_string(i % 2);
+    pSource->append(id, name, i % 1000 - 500);
+  }
+
+  std::map<SGroupKey, SGroupRes> expected = expectedGroups(*pSource);
+  std::map<SGroupKey, SGroupRes> groups;
+  ASSERT_EQ(runGroupby(pSource, groups), TSDB_CODE_SUCCESS);
+  ASSERT_GT(expected.size(), 4096);
+  ASSERT_EQ(groups.size(), expected.size());
+  ASSERT_EQ(groups, expected);
+}
+
+#pragma GCC diagnostic pop
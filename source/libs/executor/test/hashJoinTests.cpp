@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+#include "tmemaccount.h"
+
+namespace {
+
+const int32_t LEFT_BLOCK_ID = 1;
+const int32_t RIGHT_BLOCK_ID = 2;
+const int32_t JOIN_BLOCK_ID = 3;
+const int64_t NULL_KEY = INT64_MIN;  // a row of the source with a null key
+
+// joined row: left key, left value, right value
+typedef std::tuple<int64_t, int32_t, int32_t> SJoinedRow;
+
+// rows of one child of the join, returned in blocks of rowsPerBlock rows
+struct SJoinSource {
+  std::vector<int64_t> keys;
+  std::vector<int32_t> values;
+  int32_t              rowsPerBlock = 1000;
+  int32_t              pos = 0;
+  SSDataBlock*         pBlock = NULL;
+
+  void append(int64_t key, int32_t value) {
+    keys.push_back(key);
+    values.push_back(value);
+  }
+};
+
+SSDataBlock* getJoinSourceBlock(SOperatorInfo* pOperator) {
+  SJoinSource* pSource = static_cast<SJoinSource*>(pOperator->info);
+  if (pSource->pos >= (int32_t)pSource->keys.size()) {
+    return NULL;
+  }
+
+  if (pSource->pBlock == NULL) {
+    pSource->pBlock = createDataBlock();
+    pSource->pBlock->info.id.blockId = pOperator->resultDataBlockId;
+
+    SColumnInfoData keyCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    blockDataAppendColInfo(pSource->pBlock, &keyCol);
+    SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+    blockDataAppendColInfo(pSource->pBlock, &valCol);
+    blockDataEnsureCapacity(pSource->pBlock, pSource->rowsPerBlock);
+  } else {
+    blockDataCleanup(pSource->pBlock);
+  }
+
+  SSDataBlock*     pBlock = pSource->pBlock;
+  SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+  int32_t          numOfRows = std::min(pSource->rowsPerBlock, (int32_t)pSource->keys.size() - pSource->pos);
+  for (int32_t i = 0; i < numOfRows; ++i, ++pSource->pos) {
+    int64_t key = pSource->keys[pSource->pos];
+    colDataAppend(pKeyCol, i, reinterpret_cast<const char*>(&key), key == NULL_KEY);
+    colDataAppend(pValCol, i, reinterpret_cast<const char*>(&pSource->values[pSource->pos]), false);
+  }
+
+  pBlock->info.rows = numOfRows;
+  pBlock->info.dataLoad = 1;
+  return pBlock;
+}
+
+void destroyJoinSource(void* param) {
+  SJoinSource* pSource = static_cast<SJoinSource*>(param);
+  blockDataDestroy(pSource->pBlock);
+  delete pSource;
+}
+
+SOperatorInfo* createJoinSourceOperator(SJoinSource* pSource, int32_t blockId) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  pOperator->name = "joinSourceOperator4Test";
+  pOperator->info = pSource;
+  pOperator->resultDataBlockId = blockId;
+  pOperator->fpSet.getNextFn = getJoinSourceBlock;
+  pOperator->fpSet.closeFn = destroyJoinSource;
+  return pOperator;
+}
+
+SColumnNode* createColumn(int32_t blockId, int32_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return pCol;
+}
+
+SDataBlockDescNode* createBlockDesc(int32_t blockId, const std::vector<int8_t>& types) {
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = blockId;
+  for (size_t i = 0; i < types.size(); ++i) {
+    SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+    pSlot->slotId = i;
+    pSlot->dataType.type = types[i];
+    pSlot->dataType.bytes = tDataTypes[types[i]].bytes;
+    pSlot->output = true;
+    nodesListMakeAppend(&pDesc->pSlots, (SNode*)pSlot);
+    pDesc->totalRowSize += pSlot->dataType.bytes;
+    pDesc->outputRowSize += pSlot->dataType.bytes;
+  }
+  return pDesc;
+}
+
+// left.key = right.key, projecting left.key, left.value and right.value
+SHashJoinPhysiNode* createJoinNode() {
+  SHashJoinPhysiNode* pJoin = (SHashJoinPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  pJoin->joinType = JOIN_TYPE_INNER;
+  pJoin->node.pOutputDataBlockDesc =
+      createBlockDesc(JOIN_BLOCK_ID, {TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_INT});
+
+  int32_t blockIds[] = {LEFT_BLOCK_ID, RIGHT_BLOCK_ID};
+  for (int32_t i = 0; i < 2; ++i) {
+    SPhysiNode* pChild = (SPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_PROJECT);
+    pChild->pOutputDataBlockDesc = createBlockDesc(blockIds[i], {TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_INT});
+    nodesListMakeAppend(&pJoin->node.pChildren, (SNode*)pChild);
+  }
+
+  nodesListMakeAppend(&pJoin->pOnLeft, (SNode*)createColumn(LEFT_BLOCK_ID, 0, TSDB_DATA_TYPE_BIGINT, 8));
+  nodesListMakeAppend(&pJoin->pOnRight, (SNode*)createColumn(RIGHT_BLOCK_ID, 0, TSDB_DATA_TYPE_BIGINT, 8));
+
+  SColumnNode* aTargetCols[] = {createColumn(LEFT_BLOCK_ID, 0, TSDB_DATA_TYPE_BIGINT, 8),
+                                createColumn(LEFT_BLOCK_ID, 1, TSDB_DATA_TYPE_INT, 4),
+                                createColumn(RIGHT_BLOCK_ID, 1, TSDB_DATA_TYPE_INT, 4)};
+  for (int32_t i = 0; i < 3; ++i) {
+    STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+    pTarget->dataBlockId = JOIN_BLOCK_ID;
+    pTarget->slotId = i;
+    pTarget->pExpr = (SNode*)aTargetCols[i];
+    nodesListMakeAppend(&pJoin->pTargets, (SNode*)pTarget);
+  }
+  return pJoin;
+}
+
+// the join of the two sources, every left row with every right row of the same non-null key
+std::vector<SJoinedRow> expectedJoin(const SJoinSource& left, const SJoinSource& right) {
+  std::map<int64_t, std::vector<int32_t>> rightRows;
+  for (size_t j = 0; j < right.keys.size(); ++j) {
+    if (right.keys[j] != NULL_KEY) rightRows[right.keys[j]].push_back(right.values[j]);
+  }
+
+  std::vector<SJoinedRow> rows;
+  for (size_t i = 0; i < left.keys.size(); ++i) {
+    auto it = rightRows.find(left.keys[i]);
+    if (left.keys[i] == NULL_KEY || it == rightRows.end()) continue;
+    for (size_t j = 0; j < it->second.size(); ++j) {
+      rows.push_back(SJoinedRow(left.keys[i], left.values[i], it->second[j]));
+    }
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+class HashJoinTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    bufSize = tsQueryHashJoinBufSize;
+    tstrncpy(tsTempDir, TD_TMP_DIR_PATH, PATH_MAX);
+    osUpdate();
+
+    memset(&taskInfo, 0, sizeof(taskInfo));
+    taskInfo.id.str = (char*)"hashJoinTest";
+    taskInfo.pMemAccount = taosMemAccountCreate(NULL, "task", -1);
+  }
+
+  void TearDown() override {
+    tsQueryHashJoinBufSize = bufSize;
+    taosMemAccountDestroy(taskInfo.pMemAccount);
+  }
+
+  // Runs the join of the sources, which are owned by the operator from now on. Returns the code of the task.
+  int32_t runJoin(SJoinSource* pLeft, SJoinSource* pRight, std::vector<SJoinedRow>& rows) {
+    SOperatorInfo* aDownstream[2] = {createJoinSourceOperator(pLeft, LEFT_BLOCK_ID),
+                                     createJoinSourceOperator(pRight, RIGHT_BLOCK_ID)};
+    SHashJoinPhysiNode* pJoin = createJoinNode();
+    SOperatorInfo*      pOperator = createHashJoinOperatorInfo(aDownstream, 2, pJoin, &taskInfo);
+    nodesDestroyNode((SNode*)pJoin);
+    if (pOperator == NULL) {
+      destroyOperatorInfo(aDownstream[0]);
+      destroyOperatorInfo(aDownstream[1]);
+      return taskInfo.code;
+    }
+
+    rows.clear();
+    int32_t code = setjmp(taskInfo.env);
+    if (code == TSDB_CODE_SUCCESS) {
+      while (1) {
+        SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+        if (pRes == NULL) break;
+
+        SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+        SColumnInfoData* pLeftCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+        SColumnInfoData* pRightCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 2));
+        for (int32_t i = 0; i < pRes->info.rows; ++i) {
+          rows.push_back(SJoinedRow(*(int64_t*)colDataGetData(pKeyCol, i), *(int32_t*)colDataGetData(pLeftCol, i),
+                                    *(int32_t*)colDataGetData(pRightCol, i)));
+        }
+      }
+      std::sort(rows.begin(), rows.end());
+    }
+
+    destroyOperatorInfo(pOperator);
+    return code;
+  }
+
+  int32_t        bufSize = 0;
+  SExecTaskInfo taskInfo;
+};
+
+}  // namespace
+
+TEST_F(HashJoinTest, inMemory) {
+  SJoinSource* pLeft = new SJoinSource();
+  SJoinSource* pRight = new SJoinSource();
+
+  // every key is on the build side once, half of the probe rows find no match
+  for (int32_t i = 0; i < 3000; ++i) pRight->append(i * 2, i);
+  for (int32_t i = 0; i < 5000; ++i) pLeft->append(i, -i);
+
+  std::vector<SJoinedRow> expected = expectedJoin(*pLeft, *pRight);
+  std::vector<SJoinedRow> rows;
+  ASSERT_EQ(runJoin(pLeft, pRight, rows), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(expected.size(), 2500);
+  ASSERT_EQ(rows, expected);
+
+  // the build side fits in memory, no buffer page is taken
+  SMemAccountStat stat = {0};
+  taosMemAccountGetStat(taskInfo.pMemAccount, &stat);
+  ASSERT_EQ(stat.peak, 0);
+}
+
+TEST_F(HashJoinTest, nullAndDuplicateKeys) {
+  SJoinSource* pLeft = new SJoinSource();
+  SJoinSource* pRight = new SJoinSource();
+  pLeft->rowsPerBlock = 7;
+  pRight->rowsPerBlock = 5;
+
+  // null keys never match, not even each other, duplicates on both sides give every pair
+  for (int32_t i = 0; i < 40; ++i) {
+    pLeft->append(i % 4 == 0 ? NULL_KEY : i % 6, i);
+    pRight->append(i % 3 == 0 ? NULL_KEY : i % 5, 100 + i);
+  }
+
+  std::vector<SJoinedRow> expected = expectedJoin(*pLeft, *pRight);
+  std::vector<SJoinedRow> rows;
+  ASSERT_EQ(runJoin(pLeft, pRight, rows), TSDB_CODE_SUCCESS);
+  ASSERT_GT(expected.size(), 0);
+  ASSERT_EQ(rows, expected);
+
+  // a build side of null keys only joins nothing
+  pLeft = new SJoinSource();
+  pRight = new SJoinSource();
+  for (int32_t i = 0; i < 10; ++i) {
+    pLeft->append(NULL_KEY, i);
+    pRight->append(NULL_KEY, i);
+  }
+  ASSERT_EQ(runJoin(pLeft, pRight, rows), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(rows.size(), 0);
+}
+
+TEST_F(HashJoinTest, spilled) {
+  SJoinSource* pLeft = new SJoinSource();
+  SJoinSource* pRight = new SJoinSource();
+
+  // the build side outgrows 1MB after the first blocks, the rest of it and the whole probe side are partitioned
+  tsQueryHashJoinBufSize = 1;
+  for (int32_t i = 0; i < 150000; ++i) {
+    pRight->append(i % 13 == 0 ? NULL_KEY : i % 50000, i);
+  }
+  for (int32_t i = 0; i < 60000; ++i) {
+    pLeft->append(i % 17 == 0 ? NULL_KEY : (i * 7) % 70000, -i);
+  }
+
+  std::vector<SJoinedRow> expected = expectedJoin(*pLeft, *pRight);
+  std::vector<SJoinedRow> rows;
+  ASSERT_EQ(runJoin(pLeft, pRight, rows), TSDB_CODE_SUCCESS);
+  ASSERT_GT(expected.size(), 100000);
+  ASSERT_EQ(rows.size(), expected.size());
+  ASSERT_EQ(rows, expected);
+
+  // the partitions went through the buffer pages, and all of them are given back
+  SMemAccountStat stat = {0};
+  taosMemAccountGetStat(taskInfo.pMemAccount, &stat);
+  ASSERT_GT(stat.peak, 0);
+  ASSERT_EQ(stat.used, 0);
+}
+
+#pragma GCC diagnostic pop
@@ -14,9 +14,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
 #include <tglobal.h>
 #include <tsort.h>
-#include <iostream>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -393,4 +395,101 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+namespace {
+typedef struct {
+  SSDataBlock* pBlock;
+  int32_t      numOfBlocks;
+  int32_t      rows;
+  int32_t      next;
+} STopNInfo;
+
+SSDataBlock* getTopNDummyBlock(void* param) {
+  STopNInfo* pInfo = (STopNInfo*)param;
+  if (pInfo->numOfBlocks-- <= 0) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInfo->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, pInfo->rows);
+
+  char buf[32] = {0};
+  for (int32_t i = 0; i < pInfo->rows; ++i, ++pInfo->next) {
+    int32_t v = (pInfo->next * 7919) % 100003;
+    colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&v, false);
+
+    int32_t len = sprintf(varDataVal(buf), "row:%d", v);
+    varDataSetLen(buf, len);
+    colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, buf, v % 3 == 0);
+  }
+
+  pBlock->info.rows = pInfo->rows;
+  return pBlock;
+}
+}  // namespace
+
+TEST(testCase, topN_sort_Test) {
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_DESC;
+  oi.slotId = 0;
+  SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi);
+
+  STopNInfo info = {0};
+  info.pBlock = createDataBlock();
+  info.numOfBlocks = 20;
+  info.rows = 1000;
+
+  SColumnInfoData col0 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  blockDataAppendColInfo(info.pBlock, &col0);
+  SColumnInfoData col1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 20, 2);
+  blockDataAppendColInfo(info.pBlock, &col1);
+  info.pBlock->info.hasVarCol = true;
+
+  std::vector<int32_t> expected;
+  for (int32_t i = 0; i < info.numOfBlocks * info.rows; ++i) {
+    expected.push_back((i * 7919) % 100003);
+  }
+  std::sort(expected.begin(), expected.end(), std::greater<int32_t>());
+
+  int32_t      maxRows = 100;
+  SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, -1, -1, NULL, "test_topN");
+  tsortSetFetchRawDataFp(phandle, getTopNDummyBlock, NULL, NULL);
+  tsortSetMaxRows(phandle, maxRows);
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &info;
+  ps->onlyRef = true;
+  tsortAddSource(phandle, ps);
+  ASSERT_EQ(tsortOpen(phandle), 0);
+  ASSERT_EQ(tsortGetSortExecInfo(phandle).sortMethod, SORT_TOPN_HEAP_T);
+
+  char    buf[32] = {0};
+  int32_t row = 0;
+  while (1) {
+    STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+    if (pTupleHandle == NULL) {
+      break;
+    }
+
+    ASSERT_LT(row, maxRows);
+    int32_t v = *(int32_t*)tsortGetValue(pTupleHandle, 0);
+    ASSERT_EQ(v, expected[row]);
+
+    ASSERT_EQ(tsortIsNullVal(pTupleHandle, 1), v % 3 == 0);
+    if (v % 3 != 0) {
+      char* p = (char*)tsortGetValue(pTupleHandle, 1);
+      sprintf(buf, "row:%d", v);
+      ASSERT_EQ(varDataLen(p), strlen(buf));
+      ASSERT_EQ(strncmp(varDataVal(p), buf, varDataLen(p)), 0);
+    }
+    row++;
+  }
+  ASSERT_EQ(row, maxRows);
+
+  tsortDestroySortHandle(phandle);
+  taosArrayDestroy(orderInfo);
+  blockDataDestroy(info.pBlock);
+}
+
 #pragma GCC diagnostic pop
@@ -386,6 +386,8 @@ static int32_t logicScanCopy(const SScanLogicNode* pSrc, SScanLogicNode* pDst) {
   CLONE_NODE_LIST_FIELD(pTags);
   CLONE_NODE_FIELD(pSubtable);
   COPY_SCALAR_FIELD(igLastNull);
+  COPY_SCALAR_FIELD(sliceIdx);
+  COPY_SCALAR_FIELD(numOfSlices);
   return TSDB_CODE_SUCCESS;
 }
 
@@ -665,11 +665,64 @@ static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode*
   }
 }
 
+static bool pushDownCondOptIsHashKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (OP_TYPE_EQUAL != pOper->opType || QUERY_NODE_COLUMN != nodeType(pOper->pLeft) ||
+      QUERY_NODE_COLUMN != nodeType(pOper->pRight) ||
+      !isHashJoinKeyType(&((SExprNode*)pOper->pLeft)->resType, &((SExprNode*)pOper->pRight)->resType)) {
+    return false;
+  }
+
+  SNodeList* pLeftCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 0))->pTargets;
+  SNodeList* pRightCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 1))->pTargets;
+  if (pushDownCondOptBelongThisTable(pOper->pLeft, pLeftCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pRightCols);
+  } else if (pushDownCondOptBelongThisTable(pOper->pLeft, pRightCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pLeftCols);
+  }
+  return false;
+}
+
+static bool pushDownCondOptContainHashKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond)) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
+    if (LOGIC_COND_TYPE_AND != pLogicCond->condType) {
+      return false;
+    }
+    SNode* pSubCond = NULL;
+    FOREACH(pSubCond, pLogicCond->pParameterList) {
+      if (pushDownCondOptIsHashKeyEqualCond(pJoin, pSubCond)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return pushDownCondOptIsHashKeyEqualCond(pJoin, pCond);
+}
+
+// A join without the primary key equal condition is executed as a hash join, whose output is not ordered by
+// timestamp, so it is only allowed when nothing above the join depends on the time order.
+static bool pushDownCondOptCanHashJoin(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
+  if (pCxt->pPlanCxt->streamQuery || JOIN_TYPE_INNER != pJoin->joinType) {
+    return false;
+  }
+  SLogicNode* pParent = pJoin->node.pParent;
+  if (NULL != pParent && pParent->requireDataOrder > DATA_ORDER_LEVEL_NONE) {
+    return false;
+  }
+  return pushDownCondOptContainHashKeyEqualCond(pJoin, pJoin->pOnConditions);
+}
+
 static int32_t pushDownCondOptCheckJoinOnCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   if (NULL == pJoin->pOnConditions) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_NOT_SUPPORT_CROSS_JOIN);
   }
-  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions) &&
+      !pushDownCondOptCanHashJoin(pCxt, pJoin)) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
   }
   return TSDB_CODE_SUCCESS;
@@ -725,8 +778,14 @@ static int32_t pushDownCondOptPartJoinOnCond(SJoinLogicNode* pJoin, SNode** ppMe
 
 static int32_t pushDownCondOptJoinExtractMergeCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   int32_t code = pushDownCondOptCheckJoinOnCond(pCxt, pJoin);
-  SNode*  pJoinMergeCond = NULL;
-  SNode*  pJoinOnCond = NULL;
+  if (TSDB_CODE_SUCCESS == code && !pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+    // hash join, all of the on conditions stay where they are
+    pJoin->node.resultDataOrder = DATA_ORDER_LEVEL_NONE;
+    return code;
+  }
+
+  SNode* pJoinMergeCond = NULL;
+  SNode* pJoinOnCond = NULL;
   if (TSDB_CODE_SUCCESS == code) {
     code = pushDownCondOptPartJoinOnCond(pJoin, &pJoinMergeCond, &pJoinOnCond);
   }
@@ -1094,6 +1153,10 @@ static int32_t sortPriKeyOptGetSequencingNodesImpl(SLogicNode* pNode, bool group
       return nodesListMakeAppend(pSequencingNodes, (SNode*)pNode);
     }
     case QUERY_NODE_LOGIC_PLAN_JOIN: {
+      if (NULL == ((SJoinLogicNode*)pNode)->pMergeCondition) {
+        *pNotOptimize = true;
+        return TSDB_CODE_SUCCESS;
+      }
       int32_t code = sortPriKeyOptGetSequencingNodesImpl((SLogicNode*)nodesListGetNode(pNode->pChildren, 0), groupSort,
                                                          pNotOptimize, pSequencingNodes);
       if (TSDB_CODE_SUCCESS == code) {
@@ -2455,7 +2518,8 @@ static int32_t tagScanOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubp
 }
 
 static bool pushDownLimitOptShouldBeOptimized(SLogicNode* pNode) {
-  if (NULL == pNode->pLimit || 1 != LIST_LENGTH(pNode->pChildren) ||
+  // the limit of the sort node applies to the sorted rows, see sortLimitOptimize
+  if (NULL == pNode->pLimit || 1 != LIST_LENGTH(pNode->pChildren) || QUERY_NODE_LOGIC_PLAN_SORT == nodeType(pNode) ||
       QUERY_NODE_LOGIC_PLAN_SCAN != nodeType(nodesListGetNode(pNode->pChildren, 0))) {
     return false;
   }
@@ -2477,6 +2541,42 @@ static int32_t pushDownLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLog
   return TSDB_CODE_SUCCESS;
 }
 
+static bool sortLimitOptShouldBeOptimized(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_PROJECT != nodeType(pNode) || NULL == pNode->pLimit || NULL != pNode->pSlimit ||
+      NULL != pNode->pConditions || 1 != LIST_LENGTH(pNode->pChildren)) {
+    return false;
+  }
+
+  // the global sort only, the limit of a group sort applies to each group
+  SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pNode->pChildren, 0);
+  if (QUERY_NODE_LOGIC_PLAN_SORT != nodeType(pChild) || ((SSortLogicNode*)pChild)->groupSort ||
+      NULL != pChild->pLimit || NULL != pChild->pSlimit || NULL != pChild->pConditions) {
+    return false;
+  }
+  return ((SLimitNode*)pNode->pLimit)->limit >= 0;
+}
+
+// order by ... limit n offset m: the sort keeps the first n + m rows only, so that it is done by a bounded heap
+static int32_t sortLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan) {
+  SLogicNode* pProject = optFindPossibleNode(pLogicSubplan->pNode, sortLimitOptShouldBeOptimized);
+  if (NULL == pProject) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SLimitNode* pLimit = (SLimitNode*)nodesCloneNode(pProject->pLimit);
+  if (NULL == pLimit) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pLimit->limit += pLimit->offset;
+  pLimit->offset = 0;
+
+  SLogicNode* pSort = (SLogicNode*)nodesListGetNode(pProject->pChildren, 0);
+  pSort->pLimit = (SNode*)pLimit;
+  pCxt->optimized = true;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 typedef struct STbCntScanOptInfo {
   SAggLogicNode*  pAgg;
   SScanLogicNode* pScan;
@@ -2729,6 +2829,7 @@ static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "LastRowScan",                .optimizeFunc = lastRowScanOptimize},
   {.pName = "TagScan",                    .optimizeFunc = tagScanOptimize},
   {.pName = "PushDownLimit",              .optimizeFunc = pushDownLimitOptimize},
+  {.pName = "SortLimit",                  .optimizeFunc = sortLimitOptimize},
   {.pName = "TableCountScan",             .optimizeFunc = tableCountScanOptimize},
 };
 // clang-format on
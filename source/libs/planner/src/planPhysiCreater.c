@@ -560,9 +560,12 @@ static int32_t createTableScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubp
   memcpy(pTableScan->scanSeq, pScanLogicNode->scanSeq, sizeof(pScanLogicNode->scanSeq));
   pTableScan->scanRange = pScanLogicNode->scanRange;
   pTableScan->ratio = pScanLogicNode->ratio;
+  pTableScan->sliceIdx = pScanLogicNode->sliceIdx;
+  pTableScan->numOfSlices = TMAX(pScanLogicNode->numOfSlices, 1);
   if (pScanLogicNode->pVgroupList) {
     vgroupInfoToNodeAddr(pScanLogicNode->pVgroupList->vgroups, &pSubplan->execNode);
-    pSubplan->execNodeStat.tableNum = pScanLogicNode->pVgroupList->vgroups[0].numOfTable;
+    pSubplan->execNodeStat.tableNum =
+        (pScanLogicNode->pVgroupList->vgroups[0].numOfTable + pTableScan->numOfSlices - 1) / pTableScan->numOfSlices;
   }
   tNameGetFullDbName(&pScanLogicNode->tableName, pSubplan->dbFName);
   pTableScan->dataRequired = pScanLogicNode->dataRequired;
@@ -662,8 +665,8 @@ static int32_t createScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubplan,
   return TSDB_CODE_FAILED;
 }
 
-static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
-                                   SPhysiNode** pPhyNode) {
+static int32_t createMergeJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                        SPhysiNode** pPhyNode) {
   SSortMergeJoinPhysiNode* pJoin =
       (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN);
   if (NULL == pJoin) {
@@ -717,6 +720,148 @@ static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren
   return code;
 }
 
+static bool isHashJoinKeyCond(SNode* pCond, int16_t leftDataBlockId, int16_t rightDataBlockId) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (OP_TYPE_EQUAL != pOper->opType || QUERY_NODE_COLUMN != nodeType(pOper->pLeft) ||
+      QUERY_NODE_COLUMN != nodeType(pOper->pRight)) {
+    return false;
+  }
+
+  SColumnNode* pLeft = (SColumnNode*)pOper->pLeft;
+  SColumnNode* pRight = (SColumnNode*)pOper->pRight;
+  if (!isHashJoinKeyType(&pLeft->node.resType, &pRight->node.resType)) {
+    return false;
+  }
+  return (pLeft->dataBlockId == leftDataBlockId && pRight->dataBlockId == rightDataBlockId) ||
+         (pLeft->dataBlockId == rightDataBlockId && pRight->dataBlockId == leftDataBlockId);
+}
+
+static int32_t addHashJoinKey(SHashJoinPhysiNode* pJoin, int16_t leftDataBlockId, SOperatorNode* pOper) {
+  SNode* pLeft = pOper->pLeft;
+  SNode* pRight = pOper->pRight;
+  if (((SColumnNode*)pLeft)->dataBlockId != leftDataBlockId) {
+    TSWAP(pLeft, pRight);
+  }
+
+  int32_t code = nodesListMakeStrictAppend(&pJoin->pOnLeft, nodesCloneNode(pLeft));
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(&pJoin->pOnRight, nodesCloneNode(pRight));
+  }
+  return code;
+}
+
+// Split the on conditions into the equi-join keys of both children and the conditions evaluated on the joined rows.
+// pSlotOnCond is pOnCond with the slots of the children set.
+static int32_t partHashJoinOnCond(SHashJoinPhysiNode* pJoin, int16_t leftDataBlockId, int16_t rightDataBlockId,
+                                  SNode* pOnCond, SNode* pSlotOnCond, SNode** pOtherCond) {
+  int32_t    code = TSDB_CODE_SUCCESS;
+  SNodeList* pOtherConds = NULL;
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pOnCond) &&
+      LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)pOnCond)->condType) {
+    SNode* pCond = NULL;
+    SNode* pSlotCond = NULL;
+    FORBOTH(pCond, ((SLogicConditionNode*)pOnCond)->pParameterList, pSlotCond,
+            ((SLogicConditionNode*)pSlotOnCond)->pParameterList) {
+      if (isHashJoinKeyCond(pSlotCond, leftDataBlockId, rightDataBlockId)) {
+        code = addHashJoinKey(pJoin, leftDataBlockId, (SOperatorNode*)pSlotCond);
+      } else {
+        code = nodesListMakeStrictAppend(&pOtherConds, nodesCloneNode(pCond));
+      }
+      if (TSDB_CODE_SUCCESS != code) {
+        break;
+      }
+    }
+  } else if (isHashJoinKeyCond(pSlotOnCond, leftDataBlockId, rightDataBlockId)) {
+    code = addHashJoinKey(pJoin, leftDataBlockId, (SOperatorNode*)pSlotOnCond);
+  } else {
+    code = nodesListMakeStrictAppend(&pOtherConds, nodesCloneNode(pOnCond));
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL == pJoin->pOnLeft) {
+    planError("hash join has no equi-join key");
+    code = TSDB_CODE_PLAN_INTERNAL_ERROR;
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesMergeConds(pOtherCond, &pOtherConds);
+  }
+  nodesDestroyList(pOtherConds);
+  return code;
+}
+
+static int32_t createHashJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                       SPhysiNode** pPhyNode) {
+  SHashJoinPhysiNode* pJoin =
+      (SHashJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  if (NULL == pJoin) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SDataBlockDescNode* pLeftDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 0))->pOutputDataBlockDesc;
+  SDataBlockDescNode* pRightDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 1))->pOutputDataBlockDesc;
+  SNode*              pSlotOnCond = NULL;
+  SNode*              pOtherCond = NULL;
+
+  pJoin->joinType = pJoinLogicNode->joinType;
+  int32_t code = setNodeSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->pOnConditions,
+                               &pSlotOnCond);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = partHashJoinOnCond(pJoin, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->pOnConditions,
+                              pSlotOnCond, &pOtherCond);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setListSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->node.pTargets,
+                         &pJoin->pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, pJoin->pTargets, pJoin->node.pOutputDataBlockDesc);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    SNodeList* pCondCols = nodesMakeList();
+    if (NULL == pCondCols) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    } else {
+      code = nodesCollectColumnsFromNode(pOtherCond, NULL, COLLECT_COL_TYPE_ALL, &pCondCols);
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      code = addDataBlockSlots(pCxt, pCondCols, pJoin->node.pOutputDataBlockDesc);
+    }
+    nodesDestroyList(pCondCols);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    code = setNodeSlotId(pCxt, pJoin->node.pOutputDataBlockDesc->dataBlockId, -1, pOtherCond, &pJoin->pOnConditions);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setConditionsSlotId(pCxt, (const SLogicNode*)pJoinLogicNode, (SPhysiNode*)pJoin);
+  }
+
+  nodesDestroyNode(pSlotOnCond);
+  nodesDestroyNode(pOtherCond);
+
+  if (TSDB_CODE_SUCCESS == code) {
+    *pPhyNode = (SPhysiNode*)pJoin;
+  } else {
+    nodesDestroyNode((SNode*)pJoin);
+  }
+
+  return code;
+}
+
+static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                   SPhysiNode** pPhyNode) {
+  // without the primary key equal condition the inputs are not ordered by the join keys, so they are hashed instead
+  if (NULL == pJoinLogicNode->pMergeCondition) {
+    return createHashJoinPhysiNode(pCxt, pChildren, pJoinLogicNode, pPhyNode);
+  }
+  return createMergeJoinPhysiNode(pCxt, pChildren, pJoinLogicNode, pPhyNode);
+}
+
 typedef struct SRewritePrecalcExprsCxt {
   int32_t    errCode;
   int32_t    planNodeId;
@@ -1651,6 +1796,10 @@ static int32_t createDataDispatcher(SPhysiPlanContext* pCxt, const SPhysiNode* p
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
+  // the planner runs on the consumer side, so the compression of the fetched blocks is decided here for the query
+  pDispatcher->compress = (tsCompressColData >= 0);
+  pDispatcher->compressThreshold = tsCompressColData;
+
   *pSink = (SDataSinkNode*)pDispatcher;
   return TSDB_CODE_SUCCESS;
 }
@@ -38,7 +38,7 @@ static SLogicSubplan* singleCloneSubLogicPlan(SScaleOutContext* pCxt, SLogicSubp
   return pDst;
 }
 
-static int32_t doSetScanVgroup(SLogicNode* pNode, const SVgroupInfo* pVgroup, bool* pFound) {
+static int32_t doSetScanVgroup(SLogicNode* pNode, const SVgroupInfo* pVgroup, int32_t sliceIdx, bool* pFound) {
   if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pNode)) {
     SScanLogicNode* pScan = (SScanLogicNode*)pNode;
     pScan->pVgroupList = taosMemoryCalloc(1, sizeof(SVgroupsInfo) + sizeof(SVgroupInfo));
@@ -46,12 +46,13 @@ static int32_t doSetScanVgroup(SLogicNode* pNode, const SVgroupInfo* pVgroup, bo
       return TSDB_CODE_OUT_OF_MEMORY;
     }
     memcpy(pScan->pVgroupList->vgroups, pVgroup, sizeof(SVgroupInfo));
+    pScan->sliceIdx = sliceIdx;
     *pFound = true;
     return TSDB_CODE_SUCCESS;
   }
   SNode* pChild = NULL;
   FOREACH(pChild, pNode->pChildren) {
-    int32_t code = doSetScanVgroup((SLogicNode*)pChild, pVgroup, pFound);
+    int32_t code = doSetScanVgroup((SLogicNode*)pChild, pVgroup, sliceIdx, pFound);
     if (TSDB_CODE_SUCCESS != code || *pFound) {
       return code;
     }
@@ -59,19 +60,30 @@ static int32_t doSetScanVgroup(SLogicNode* pNode, const SVgroupInfo* pVgroup, bo
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t setScanVgroup(SLogicNode* pNode, const SVgroupInfo* pVgroup) {
+static int32_t setScanVgroup(SLogicNode* pNode, const SVgroupInfo* pVgroup, int32_t sliceIdx) {
   bool found = false;
-  return doSetScanVgroup(pNode, pVgroup, &found);
+  return doSetScanVgroup(pNode, pVgroup, sliceIdx, &found);
+}
+
+static int32_t getScanNumOfSlices(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pNode)) {
+    return TMAX(((SScanLogicNode*)pNode)->numOfSlices, 1);
+  }
+  if (1 == LIST_LENGTH(pNode->pChildren)) {
+    return getScanNumOfSlices((SLogicNode*)nodesListGetNode(pNode->pChildren, 0));
+  }
+  return 1;
 }
 
 static int32_t scaleOutByVgroups(SScaleOutContext* pCxt, SLogicSubplan* pSubplan, int32_t level, SNodeList* pGroup) {
   int32_t code = TSDB_CODE_SUCCESS;
-  for (int32_t i = 0; i < pSubplan->pVgroupList->numOfVgroups; ++i) {
+  int32_t numOfSlices = getScanNumOfSlices(pSubplan->pNode);
+  for (int32_t i = 0; i < pSubplan->pVgroupList->numOfVgroups * numOfSlices; ++i) {
     SLogicSubplan* pNewSubplan = singleCloneSubLogicPlan(pCxt, pSubplan, level);
     if (NULL == pNewSubplan) {
       return TSDB_CODE_OUT_OF_MEMORY;
     }
-    code = setScanVgroup(pNewSubplan->pNode, pSubplan->pVgroupList->vgroups + i);
+    code = setScanVgroup(pNewSubplan->pNode, pSubplan->pVgroupList->vgroups + i / numOfSlices, i % numOfSlices);
     if (TSDB_CODE_SUCCESS == code) {
       code = nodesListStrictAppend(pGroup, (SNode*)pNewSubplan);
     }
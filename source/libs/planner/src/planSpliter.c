@@ -51,6 +51,28 @@ static void splSetSubplanVgroups(SLogicSubplan* pSubplan, SLogicNode* pNode) {
   }
 }
 
+// The table list of a vnode can be scanned by several subplans at once, each of which takes the tables whose uid
+// falls in its slice. This is only valid when the parent subplan merges the results, which is what the super table
+// split guarantees.
+static int32_t splGetScanNumOfSlices(bool streamQuery, SScanLogicNode* pScan) {
+  if (streamQuery || QUERY_POLICY_QNODE == tsQueryPolicy || TSDB_SUPER_TABLE != pScan->tableType ||
+      (SCAN_TYPE_TABLE != pScan->scanType && SCAN_TYPE_TABLE_MERGE != pScan->scanType)) {
+    return 1;
+  }
+  return tsQueryScanParallelism;
+}
+
+static void splSetScanSlices(bool streamQuery, SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pNode)) {
+    SScanLogicNode* pScan = (SScanLogicNode*)pNode;
+    pScan->numOfSlices = splGetScanNumOfSlices(streamQuery, pScan);
+  } else {
+    if (1 == LIST_LENGTH(pNode->pChildren)) {
+      splSetScanSlices(streamQuery, (SLogicNode*)nodesListGetNode(pNode->pChildren, 0));
+    }
+  }
+}
+
 static SLogicSubplan* splCreateScanSubplan(SSplitContext* pCxt, SLogicNode* pNode, int32_t flag) {
   SLogicSubplan* pSubplan = (SLogicSubplan*)nodesMakeNode(QUERY_NODE_LOGIC_SUBPLAN);
   if (NULL == pSubplan) {
@@ -62,6 +84,9 @@ static SLogicSubplan* splCreateScanSubplan(SSplitContext* pCxt, SLogicNode* pNod
   pSubplan->pNode = pNode;
   pSubplan->pNode->pParent = NULL;
   splSetSubplanVgroups(pSubplan, pNode);
+  if (SPLIT_FLAG_TEST_MASK(flag, SPLIT_FLAG_STABLE_SPLIT)) {
+    splSetScanSlices(pCxt->pPlanCxt->streamQuery, pNode);
+  }
   SPLIT_FLAG_SET_MASK(pSubplan->splitFlag, flag);
   return pSubplan;
 }
@@ -229,7 +254,8 @@ static bool stbSplHasGatherExecFunc(const SNodeList* pFuncs) {
 }
 
 static bool stbSplIsMultiTbScan(bool streamQuery, SScanLogicNode* pScan) {
-  return (NULL != pScan->pVgroupList && pScan->pVgroupList->numOfVgroups > 1);
+  return (NULL != pScan->pVgroupList &&
+          pScan->pVgroupList->numOfVgroups * splGetScanNumOfSlices(streamQuery, pScan) > 1);
 }
 
 static bool stbSplHasMultiTbScan(bool streamQuery, SLogicNode* pNode) {
@@ -521,12 +547,13 @@ static int32_t stbSplCreatePartWindowNode(SWindowLogicNode* pMergeWindow, SLogic
   return code;
 }
 
-static int32_t stbSplGetNumOfVgroups(SLogicNode* pNode) {
+static int32_t stbSplGetNumOfChannels(bool streamQuery, SLogicNode* pNode) {
   if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pNode)) {
-    return ((SScanLogicNode*)pNode)->pVgroupList->numOfVgroups;
+    SScanLogicNode* pScan = (SScanLogicNode*)pNode;
+    return pScan->pVgroupList->numOfVgroups * splGetScanNumOfSlices(streamQuery, pScan);
   } else {
     if (1 == LIST_LENGTH(pNode->pChildren)) {
-      return stbSplGetNumOfVgroups((SLogicNode*)nodesListGetNode(pNode->pChildren, 0));
+      return stbSplGetNumOfChannels(streamQuery, (SLogicNode*)nodesListGetNode(pNode->pChildren, 0));
     }
   }
   return 0;
@@ -538,7 +565,7 @@ static int32_t stbSplCreateMergeNode(SSplitContext* pCxt, SLogicSubplan* pSubpla
   if (NULL == pMerge) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
-  pMerge->numOfChannels = stbSplGetNumOfVgroups(pPartChild);
+  pMerge->numOfChannels = stbSplGetNumOfChannels(pCxt->pPlanCxt->streamQuery, pPartChild);
   pMerge->srcGroupId = pCxt->groupId;
   pMerge->node.precision = pPartChild->precision;
   pMerge->pMergeKeys = pMergeKeys;
@@ -310,3 +310,11 @@ int32_t adjustLogicNodeDataRequirement(SLogicNode* pNode, EDataOrderLevel requir
   }
   return code;
 }
+
+bool isHashJoinKeyType(const SDataType* pLeft, const SDataType* pRight) {
+  // the keys are compared by their bytes, which is not the equality of floating point numbers
+  if (pLeft->type != pRight->type || IS_FLOAT_TYPE(pLeft->type) || TSDB_DATA_TYPE_JSON == pLeft->type) {
+    return false;
+  }
+  return true;
+}
@@ -151,3 +151,13 @@ TEST_F(PlanOptimizeTest, pushDownLimit) {
 
   run("SELECT c1 FROM st1 LIMIT 20 OFFSET 10");
 }
+
+TEST_F(PlanOptimizeTest, sortLimit) {
+  useDb("root", "test");
+
+  run("SELECT c1 FROM t1 ORDER BY c2 DESC LIMIT 10");
+
+  run("SELECT c1 FROM st1 ORDER BY c2 LIMIT 20 OFFSET 10");
+
+  run("SELECT c1 FROM st1 PARTITION BY tbname ORDER BY c2 LIMIT 10");
+}
@@ -14,6 +14,7 @@
  */
 
 #include "planTestUtil.h"
+#include "tglobal.h"
 
 using namespace std;
 
@@ -40,3 +41,21 @@ TEST_F(PlanSuperTableTest, orderBy) {
 
   run("SELECT -1 * c1, c1 FROM st1 ORDER BY -1 * c1");
 }
+
+TEST_F(PlanSuperTableTest, scanParallelism) {
+  useDb("root", "test");
+
+  tsQueryScanParallelism = 4;
+
+  run("SELECT COUNT(*), SUM(c1) FROM st1");
+
+  run("SELECT COUNT(*) FROM st1 INTERVAL(10s)");
+
+  run("SELECT c1 FROM st1 ORDER BY ts");
+
+  run("SELECT COUNT(*) FROM st1 PARTITION BY TBNAME");
+
+  run("SELECT t1.c1, t2.c1 FROM st1 t1 JOIN st2 t2 ON t1.ts = t2.ts");
+
+  tsQueryScanParallelism = 1;
+}
@@ -38,6 +38,9 @@ extern "C" {
 
 #define FILTER_RM_UNIT_MIN_ROWS 100
 
+#define FILTER_VEC_CHUNK_ROWS 1024  // rows evaluated per kernel call, must be a multiple of 64
+#define FILTER_VEC_IN_MAX_NUM 8     // IN lists up to this size are compared inline instead of via hash
+
 enum {
   FLD_TYPE_COLUMN = 1,
   FLD_TYPE_VALUE = 2,
@@ -214,6 +217,16 @@ typedef struct SFilterComUnit {
   int8_t   rfunc;
 } SFilterComUnit;
 
+// fixed-width unit evaluated by the vectorized kernels, the values are stored in the column type
+typedef struct SFilterVecUnit {
+  uint8_t optr;   // lower bound operator for a range
+  uint8_t optr2;  // upper bound operator for a range, 0 if none
+  int32_t inNum;
+  int64_t val;
+  int64_t val2;
+  int64_t inVals[FILTER_VEC_IN_MAX_NUM];
+} SFilterVecUnit;
+
 typedef struct SFilterPCtx {
   SHashObj *valHash;
   SHashObj *unitHash;
@@ -250,6 +263,7 @@ struct SFilterInfo {
   SFilterGroup     *groups;
   SFilterUnit      *units;
   SFilterComUnit   *cunits;
+  SFilterVecUnit   *vunits;     // NULL if any unit can not be vectorized
   uint8_t          *unitRes;    // result
   uint8_t          *unitFlags;  // got result
   SFilterRangeCtx **colRange;
@@ -488,6 +502,10 @@ struct SFilterInfo {
 extern bool          filterDoCompare(__compar_fn_t func, uint8_t optr, void *left, void *right);
 extern __compar_fn_t filterGetCompFunc(int32_t type, int32_t optr);
 extern __compar_fn_t filterGetCompFuncEx(int32_t lType, int32_t rType, int32_t optr);
+extern bool          filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                                       int16_t numOfCols, int32_t *numOfQualified);
+extern bool          filterExecuteImplVec(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                                          int16_t numOfCols, int32_t *numOfQualified);
 
 #ifdef __cplusplus
 }
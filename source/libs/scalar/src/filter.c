@@ -1866,6 +1866,7 @@ void filterFreeInfo(SFilterInfo *info) {
   }
 
   taosMemoryFreeClear(info->cunits);
+  taosMemoryFreeClear(info->vunits);
   taosMemoryFreeClear(info->blkUnitRes);
   taosMemoryFreeClear(info->blkUnits);
 
@@ -2817,6 +2818,107 @@ int32_t filterUpdateComUnits(SFilterInfo *info) {
   return TSDB_CODE_SUCCESS;
 }
 
+static bool filterVecSupportedUnit(SFilterInfo *info, uint32_t uidx, SFilterVecUnit *vunit) {
+  SFilterUnit    *unit = &info->units[uidx];
+  SFilterComUnit *cunit = &info->cunits[uidx];
+  uint8_t         type = cunit->dataType;
+
+  if (!IS_MATHABLE_TYPE(type)) {
+    return false;
+  }
+
+  vunit->optr = cunit->optr;
+  vunit->optr2 = 0;
+
+  switch (cunit->optr) {
+    case OP_TYPE_IS_NULL:
+    case OP_TYPE_IS_NOT_NULL:
+      return true;
+    case OP_TYPE_IN:
+    case OP_TYPE_NOT_IN: {
+      SFilterField *right = FILTER_UNIT_RIGHT_FIELD(info, unit);
+      SHashObj     *pSet = (SHashObj *)cunit->valData;
+      if (pSet == NULL || !FILTER_GET_FLAG(right->flag, FLD_DATA_IS_HASH) ||
+          taosHashGetSize(pSet) > FILTER_VEC_IN_MAX_NUM) {
+        return false;
+      }
+
+      // the hash compares the raw bytes, the inline list does the same
+      vunit->inNum = 0;
+      void *pIter = taosHashIterate(pSet, NULL);
+      while (pIter) {
+        size_t keyLen = 0;
+        void  *key = taosHashGetKey(pIter, &keyLen);
+        if (keyLen != tDataTypes[type].bytes) {
+          taosHashCancelIterate(pSet, pIter);
+          return false;
+        }
+
+        vunit->inVals[vunit->inNum] = 0;
+        memcpy(&vunit->inVals[vunit->inNum++], key, keyLen);
+        pIter = taosHashIterate(pSet, pIter);
+      }
+      return true;
+    }
+    case OP_TYPE_EQUAL:
+    case OP_TYPE_NOT_EQUAL:
+    case OP_TYPE_GREATER_THAN:
+    case OP_TYPE_GREATER_EQUAL:
+    case OP_TYPE_LOWER_THAN:
+    case OP_TYPE_LOWER_EQUAL:
+      break;
+    default:
+      return false;
+  }
+
+  if (cunit->valData == NULL) {
+    return false;
+  }
+
+  memcpy(&vunit->val, cunit->valData, tDataTypes[type].bytes);
+
+  if (unit->compare.optr2) {
+    if (cunit->valData2 == NULL) {
+      return false;
+    }
+
+    vunit->optr2 = unit->compare.optr2;
+    memcpy(&vunit->val2, cunit->valData2, tDataTypes[type].bytes);
+  }
+
+  // a NaN constant has its own ordering in compareFloatVal/compareDoubleVal, leave it to the row path
+  if (type == TSDB_DATA_TYPE_FLOAT) {
+    return !isnan(GET_FLOAT_VAL(&vunit->val)) && !isnan(GET_FLOAT_VAL(&vunit->val2));
+  } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+    return !isnan(GET_DOUBLE_VAL(&vunit->val)) && !isnan(GET_DOUBLE_VAL(&vunit->val2));
+  }
+
+  return true;
+}
+
+int32_t filterGenerateVecUnits(SFilterInfo *info) {
+  taosMemoryFreeClear(info->vunits);
+
+  if (info->unitNum == 0 || info->cunits == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SFilterVecUnit *vunits = taosMemoryCalloc(info->unitNum, sizeof(*vunits));
+  if (vunits == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    if (!filterVecSupportedUnit(info, i, &vunits[i])) {
+      taosMemoryFree(vunits);
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
+  info->vunits = vunits;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t filterRmUnitByRange(SFilterInfo *info, SColumnDataAgg *pDataStatis, int32_t numOfCols, int32_t numOfRows) {
   int32_t rmUnit = 0;
 
@@ -3326,6 +3428,253 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   return all;
 }
 
+#define FLT_VEC_INT_EQUAL(_x, _y) ((_x) == (_y))
+
+// same results as filterDoCompare on gDataCompare, with eq/gt standing for the compare function returning 0/positive
+#define FLT_VEC_COMPARE(_type, _eq, _pData, _n, _optr, _pVal, _r)                             \
+  do {                                                                                        \
+    const _type *v = (const _type *)(_pData);                                                 \
+    _type        c;                                                                           \
+    memcpy(&c, (_pVal), sizeof(_type));                                                       \
+    switch (_optr) {                                                                          \
+      case OP_TYPE_EQUAL:                                                                     \
+        for (int32_t j = 0; j < (_n); ++j) (_r)[j] = _eq(v[j], c);                            \
+        break;                                                                                \
+      case OP_TYPE_NOT_EQUAL:                                                                 \
+        for (int32_t j = 0; j < (_n); ++j) (_r)[j] = !_eq(v[j], c);                           \
+        break;                                                                                \
+      case OP_TYPE_GREATER_THAN:                                                              \
+        for (int32_t j = 0; j < (_n); ++j) (_r)[j] = (!_eq(v[j], c)) & (v[j] > c);            \
+        break;                                                                                \
+      case OP_TYPE_GREATER_EQUAL:                                                             \
+        for (int32_t j = 0; j < (_n); ++j) (_r)[j] = (_eq(v[j], c)) | (v[j] > c);             \
+        break;                                                                                \
+      case OP_TYPE_LOWER_THAN:                                                                \
+        for (int32_t j = 0; j < (_n); ++j) (_r)[j] = !((_eq(v[j], c)) | (v[j] > c));          \
+        break;                                                                                \
+      case OP_TYPE_LOWER_EQUAL:                                                               \
+        for (int32_t j = 0; j < (_n); ++j) (_r)[j] = !((!_eq(v[j], c)) & (v[j] > c));         \
+        break;                                                                                \
+      default:                                                                                \
+        memset((_r), 0, (_n));                                                                \
+        break;                                                                                \
+    }                                                                                         \
+  } while (0)
+
+#define FLT_VEC_IN(_type, _pData, _n, _vals, _num, _r)                  \
+  do {                                                                  \
+    const _type *v = (const _type *)(_pData);                           \
+    memset((_r), 0, (_n));                                              \
+    for (int32_t k = 0; k < (_num); ++k) {                              \
+      _type c;                                                          \
+      memcpy(&c, &(_vals)[k], sizeof(_type));                           \
+      for (int32_t j = 0; j < (_n); ++j) (_r)[j] |= (v[j] == c);        \
+    }                                                                   \
+  } while (0)
+
+static void filterVecCompare(uint8_t type, uint8_t optr, const void *pData, int32_t n, const void *pVal, uint8_t *r) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      FLT_VEC_COMPARE(int8_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      FLT_VEC_COMPARE(int16_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      FLT_VEC_COMPARE(int32_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      FLT_VEC_COMPARE(int64_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      FLT_VEC_COMPARE(uint8_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      FLT_VEC_COMPARE(uint16_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      FLT_VEC_COMPARE(uint32_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      FLT_VEC_COMPARE(uint64_t, FLT_VEC_INT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      FLT_VEC_COMPARE(float, FLT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      FLT_VEC_COMPARE(double, FLT_EQUAL, pData, n, optr, pVal, r);
+      break;
+    default:
+      memset(r, 0, n);
+      break;
+  }
+}
+
+static void filterVecIn(int32_t bytes, const void *pData, int32_t n, const int64_t *vals, int32_t num, uint8_t *r) {
+  switch (bytes) {
+    case sizeof(uint8_t):
+      FLT_VEC_IN(uint8_t, pData, n, vals, num, r);
+      break;
+    case sizeof(uint16_t):
+      FLT_VEC_IN(uint16_t, pData, n, vals, num, r);
+      break;
+    case sizeof(uint32_t):
+      FLT_VEC_IN(uint32_t, pData, n, vals, num, r);
+      break;
+    default:
+      FLT_VEC_IN(uint64_t, pData, n, vals, num, r);
+      break;
+  }
+}
+
+// pack one 0/1 byte per row into a bitmap laid out like the column null bitmap
+static FORCE_INLINE void filterVecPackBits(const uint8_t *r, int32_t n, uint8_t *bm) {
+  int32_t j = 0;
+  for (; j + 8 <= n; j += 8) {
+    uint64_t x;
+    memcpy(&x, r + j, sizeof(x));
+    bm[j >> 3] = (uint8_t)((x * 0x8040201008040201ULL) >> 56);
+  }
+
+  if (j < n) {
+    uint64_t x = 0;
+    memcpy(&x, r + j, n - j);
+    bm[j >> 3] = (uint8_t)((x * 0x8040201008040201ULL) >> 56);
+  }
+}
+
+static void filterVecExecUnit(SFilterComUnit *cunit, SFilterVecUnit *vunit, int32_t start, int32_t n, uint8_t *buf,
+                              uint8_t *bm) {
+  SColumnInfoData *pCol = (SColumnInfoData *)cunit->colData;
+  int32_t          len = BitmapLen(n);
+  const uint8_t   *pNull = NULL;
+
+  if (pCol->hasNull && pCol->nullbitmap != NULL) {
+    pNull = (const uint8_t *)pCol->nullbitmap + (start >> NBIT);
+  }
+
+  if (vunit->optr == OP_TYPE_IS_NULL) {
+    if (pCol->pData == NULL) {
+      memset(bm, 0xFF, len);
+    } else if (pNull != NULL) {
+      memcpy(bm, pNull, len);
+    } else {
+      memset(bm, 0, len);
+    }
+    return;
+  }
+
+  if (vunit->optr == OP_TYPE_IS_NOT_NULL) {
+    if (pCol->pData == NULL) {
+      memset(bm, 0, len);
+    } else if (pNull != NULL) {
+      for (int32_t k = 0; k < len; ++k) bm[k] = ~pNull[k];
+    } else {
+      memset(bm, 0xFF, len);
+    }
+    return;
+  }
+
+  if (pCol->pData == NULL) {
+    memset(bm, 0, len);
+    return;
+  }
+
+  const char *pData = pCol->pData + (int64_t)start * pCol->info.bytes;
+
+  if (vunit->optr == OP_TYPE_IN || vunit->optr == OP_TYPE_NOT_IN) {
+    filterVecIn(pCol->info.bytes, pData, n, vunit->inVals, vunit->inNum, buf);
+    if (vunit->optr == OP_TYPE_NOT_IN) {
+      for (int32_t j = 0; j < n; ++j) buf[j] ^= 1;
+    }
+  } else {
+    filterVecCompare(cunit->dataType, vunit->optr, pData, n, &vunit->val, buf);
+    if (vunit->optr2) {
+      uint8_t *buf2 = buf + FILTER_VEC_CHUNK_ROWS;
+      filterVecCompare(cunit->dataType, vunit->optr2, pData, n, &vunit->val2, buf2);
+      for (int32_t j = 0; j < n; ++j) buf[j] &= buf2[j];
+    }
+  }
+
+  filterVecPackBits(buf, n, bm);
+
+  if (pNull != NULL) {
+    for (int32_t k = 0; k < len; ++k) bm[k] &= ~pNull[k];
+  }
+}
+
+bool filterExecuteImplVec(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                          int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool         all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  int8_t  *p = (int8_t *)pRes->pData;
+  int32_t  qualified = 0;
+  uint8_t  buf[FILTER_VEC_CHUNK_ROWS * 2];
+  uint64_t unitBm[FILTER_VEC_CHUNK_ROWS / 64];
+  uint64_t groupBm[FILTER_VEC_CHUNK_ROWS / 64];
+  uint64_t resBm[FILTER_VEC_CHUNK_ROWS / 64];
+
+  for (int32_t start = 0; start < numOfRows; start += FILTER_VEC_CHUNK_ROWS) {
+    int32_t n = TMIN(FILTER_VEC_CHUNK_ROWS, numOfRows - start);
+    int32_t words = (n + 63) / 64;
+
+    memset(resBm, 0, sizeof(resBm));
+
+    for (uint32_t g = 0; g < info->groupNum; ++g) {
+      SFilterGroup *group = &info->groups[g];
+      uint64_t      any = 0;
+
+      for (uint32_t u = 0; u < group->unitNum; ++u) {
+        uint32_t uidx = group->unitIdxs[u];
+        unitBm[words - 1] = 0;
+        filterVecExecUnit(&info->cunits[uidx], &info->vunits[uidx], start, n, buf, (uint8_t *)unitBm);
+
+        any = 0;
+        for (int32_t w = 0; w < words; ++w) {
+          groupBm[w] = (u == 0) ? unitBm[w] : (groupBm[w] & unitBm[w]);
+          any |= groupBm[w];
+        }
+
+        if (any == 0) {
+          break;
+        }
+      }
+
+      if (any != 0) {
+        for (int32_t w = 0; w < words; ++w) {
+          resBm[w] |= groupBm[w];
+        }
+      }
+    }
+
+    // expand the selection bitmap back to one bool per row
+    const uint8_t *bm = (const uint8_t *)resBm;
+    int8_t        *pOut = p + start;
+    for (int32_t j = 0; j < n; j += 8) {
+      uint64_t x = ((bm[j >> 3] * 0x8040201008040201ULL) >> 7) & 0x0101010101010101ULL;
+      memcpy(pOut + j, &x, TMIN(8, n - j));
+    }
+
+    for (int32_t j = 0; j < n; ++j) {
+      qualified += pOut[j];
+    }
+  }
+
+  *numOfQualified += qualified;
+  if (qualified < numOfRows) {
+    all = false;
+  }
+
+  return all;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3338,7 +3687,7 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
   }
 
   if (info->unitNum > 1) {
-    info->func = filterExecuteImpl;
+    info->func = info->vunits ? filterExecuteImplVec : filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
   }
 
@@ -3352,6 +3701,11 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (info->vunits) {
+    info->func = filterExecuteImplVec;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->cunits[0].rfunc >= 0) {
     info->func = filterExecuteImplRange;
     return TSDB_CODE_SUCCESS;
@@ -3389,6 +3743,8 @@ int32_t filterPreprocess(SFilterInfo *info) {
 
   filterGenerateComInfo(info);
 
+  filterGenerateVecUnits(info);
+
 _return:
 
   filterSetExecFunc(info);
@@ -3461,6 +3817,43 @@ _return:
   return code;
 }
 
+// Check whether a data block may have rows passing the filter, with the equal conditions of each group looked up by
+// fp, usually in the bloom filters of the block. It returns false only when every group has an equal condition whose
+// value is surely absent.
+bool filterBloomExecute(SFilterInfo *info, filter_may_contain_fn fp, void *param) {
+  if (info->scalarMode) {
+    return true;
+  }
+
+  if (FILTER_EMPTY_RES(info)) {
+    return false;
+  }
+
+  if (FILTER_ALL_RES(info) || info->cunits == NULL) {
+    return true;
+  }
+
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *group = &info->groups[g];
+    bool          absent = false;
+
+    for (uint32_t u = 0; u < group->unitNum && !absent; ++u) {
+      SFilterComUnit *cunit = &info->cunits[group->unitIdxs[u]];
+      if (cunit->optr != OP_TYPE_EQUAL || cunit->valData == NULL) {
+        continue;
+      }
+
+      absent = !fp(param, (int16_t)cunit->colId, (int8_t)cunit->dataType, cunit->valData);
+    }
+
+    if (!absent) {
+      return true;
+    }
+  }
+
+  return info->groupNum == 0;
+}
+
 bool filterRangeExecute(SFilterInfo *info, SColumnDataAgg **pDataStatis, int32_t numOfCols, int32_t numOfRows) {
   if (info->scalarMode) {
     return true;
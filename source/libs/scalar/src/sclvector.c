@@ -1069,6 +1069,168 @@ static void doReleaseVec(SColumnInfoData *pCol, int32_t type) {
   }
 }
 
+#define VECTOR_MATH_CHUNK 256
+
+// widen rows [start, start + num) of a fixed length column to double, same as getVectorDoubleValueFn
+static const double *vectorGetDoubles(const SColumnInfoData *pCol, int32_t start, int32_t num, double *buf) {
+#define GET_DOUBLES(T)                             \
+  do {                                             \
+    const T *src = (const T *)pCol->pData + start; \
+    for (int32_t j = 0; j < num; ++j) {            \
+      buf[j] = (double)src[j];                     \
+    }                                              \
+    return buf;                                    \
+  } while (0)
+
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_DOUBLE:
+      return (const double *)pCol->pData + start;
+    case TSDB_DATA_TYPE_FLOAT:
+      GET_DOUBLES(float);
+    case TSDB_DATA_TYPE_BOOL:
+      GET_DOUBLES(bool);
+    case TSDB_DATA_TYPE_TINYINT:
+      GET_DOUBLES(int8_t);
+    case TSDB_DATA_TYPE_UTINYINT:
+      GET_DOUBLES(uint8_t);
+    case TSDB_DATA_TYPE_SMALLINT:
+      GET_DOUBLES(int16_t);
+    case TSDB_DATA_TYPE_USMALLINT:
+      GET_DOUBLES(uint16_t);
+    case TSDB_DATA_TYPE_INT:
+      GET_DOUBLES(int32_t);
+    case TSDB_DATA_TYPE_UINT:
+      GET_DOUBLES(uint32_t);
+    case TSDB_DATA_TYPE_UBIGINT:
+      GET_DOUBLES(uint64_t);
+    default:  // bigint and timestamp
+      GET_DOUBLES(int64_t);
+  }
+#undef GET_DOUBLES
+}
+
+// or the null bitmap of an input column into the output, a word at a time
+static void vectorMathMergeNull(const SColumnInfoData *pInputCol, SColumnInfoData *pOutputCol, int32_t numOfRows) {
+  if (!pInputCol->hasNull || pInputCol->nullbitmap == NULL) return;
+
+  int32_t len = BitmapLen(numOfRows);
+  int32_t j = 0;
+  for (; j + sizeof(uint64_t) <= len; j += sizeof(uint64_t)) {
+    uint64_t in, out;
+    memcpy(&in, pInputCol->nullbitmap + j, sizeof(uint64_t));
+    memcpy(&out, pOutputCol->nullbitmap + j, sizeof(uint64_t));
+    out |= in;
+    memcpy(pOutputCol->nullbitmap + j, &out, sizeof(uint64_t));
+  }
+  for (; j < len; ++j) {
+    pOutputCol->nullbitmap[j] |= pInputCol->nullbitmap[j];
+  }
+}
+
+// zero the values of null rows and set hasNull, as colDataAppendNULL does
+static void vectorMathFinishNull(SColumnInfoData *pOutputCol, int32_t numOfRows) {
+  double *output = (double *)pOutputCol->pData;
+  int32_t len = BitmapLen(numOfRows);
+
+  for (int32_t j = 0; j < len; j += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, pOutputCol->nullbitmap + j, TMIN(sizeof(uint64_t), len - j));
+    if (word == 0) continue;
+
+    int32_t end = TMIN((j + sizeof(uint64_t)) * 8, numOfRows);
+    for (int32_t row = j * 8; row < end; ++row) {
+      if (colDataIsNull_f(pOutputCol->nullbitmap, row)) {
+        output[row] = 0;
+      }
+    }
+    pOutputCol->hasNull = true;
+  }
+}
+
+// expr computes from a (left) and b (right), exprLConst is used when the left operand is a constant
+#define VECTOR_MATH_LOOP(expr, exprLConst)          \
+  do {                                              \
+    if (leftConst) {                                \
+      const double a = l[0];                        \
+      for (int32_t j = 0; j < num; ++j) {           \
+        const double b = r[j];                      \
+        out[j] = (exprLConst);                      \
+      }                                             \
+    } else if (rightConst) {                        \
+      const double b = r[0];                        \
+      for (int32_t j = 0; j < num; ++j) {           \
+        const double a = l[j];                      \
+        out[j] = (expr);                            \
+      }                                             \
+    } else {                                        \
+      for (int32_t j = 0; j < num; ++j) {           \
+        const double a = l[j];                      \
+        const double b = r[j];                      \
+        out[j] = (expr);                            \
+      }                                             \
+    }                                               \
+  } while (0)
+
+// typed kernels of +, -, *, / over the raw buffers of numeric columns. The inputs are widened to double
+// chunk by chunk and computed in tight loops, nulls are merged by bitmap. Returns false if the generic
+// row by row path shall be used, that is for var/json data, descending order and constant null inputs.
+static bool vectorMathKernel(SScalarParam *pLeft, SScalarParam *pRight, SColumnInfoData *pLeftCol,
+                             SColumnInfoData *pRightCol, SColumnInfoData *pOutputCol, int32_t _ord, int32_t optr) {
+  if (_ord != TSDB_ORDER_ASC || pLeftCol != pLeft->columnData || pRightCol != pRight->columnData ||
+      !IS_MATHABLE_TYPE(pLeftCol->info.type) || !IS_MATHABLE_TYPE(pRightCol->info.type) ||
+      pOutputCol->info.type != TSDB_DATA_TYPE_DOUBLE) {
+    return false;
+  }
+
+  bool leftConst = pLeft->numOfRows != pRight->numOfRows && pLeft->numOfRows == 1;
+  bool rightConst = pLeft->numOfRows != pRight->numOfRows && pRight->numOfRows == 1;
+  if (pLeft->numOfRows != pRight->numOfRows && !leftConst && !rightConst) {
+    return false;
+  }
+  if ((leftConst && colDataIsNull_s(pLeftCol, 0)) || (rightConst && colDataIsNull_s(pRightCol, 0))) {
+    return false;
+  }
+
+  double  lBuf[VECTOR_MATH_CHUNK];
+  double  rBuf[VECTOR_MATH_CHUNK];
+  int32_t numOfRows = TMAX(pLeft->numOfRows, pRight->numOfRows);
+  if (optr == OP_TYPE_DIV && rightConst && *vectorGetDoubles(pRightCol, 0, 1, rBuf) == 0) {
+    return false;
+  }
+
+  for (int32_t start = 0; start < numOfRows; start += VECTOR_MATH_CHUNK) {
+    int32_t       num = TMIN(VECTOR_MATH_CHUNK, numOfRows - start);
+    const double *l = vectorGetDoubles(pLeftCol, leftConst ? 0 : start, leftConst ? 1 : num, lBuf);
+    const double *r = vectorGetDoubles(pRightCol, rightConst ? 0 : start, rightConst ? 1 : num, rBuf);
+    double       *out = (double *)pOutputCol->pData + start;
+
+    switch (optr) {
+      case OP_TYPE_ADD:
+        VECTOR_MATH_LOOP(a + b, b + a);
+        break;
+      case OP_TYPE_SUB:
+        VECTOR_MATH_LOOP(a - b, (b - a) * -1);
+        break;
+      case OP_TYPE_MULTI:
+        VECTOR_MATH_LOOP(a * b, b * a);
+        break;
+      default:
+        VECTOR_MATH_LOOP(a / b, a / b);
+        if (!rightConst) {  // divide by 0 check
+          for (int32_t j = 0; j < num; ++j) {
+            if (r[j] == 0) colDataSetNull_f(pOutputCol->nullbitmap, start + j);
+          }
+        }
+        break;
+    }
+  }
+
+  if (!leftConst) vectorMathMergeNull(pLeftCol, pOutputCol, numOfRows);
+  if (!rightConst) vectorMathMergeNull(pRightCol, pOutputCol, numOfRows);
+  vectorMathFinishNull(pOutputCol, numOfRows);
+  return true;
+}
+
 void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t _ord) {
   SColumnInfoData *pOutputCol = pOut->columnData;
 
@@ -1114,7 +1276,9 @@ void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
-    if (pLeft->numOfRows == pRight->numOfRows) {
+    if (vectorMathKernel(pLeft, pRight, pLeftCol, pRightCol, pOutputCol, _ord, OP_TYPE_ADD)) {
+      // done by the typed kernel
+    } else if (pLeft->numOfRows == pRight->numOfRows) {
       for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
         if (IS_NULL) {
           colDataAppendNULL(pOutputCol, i);
@@ -1215,7 +1379,9 @@ void vectorMathSub(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
-    if (pLeft->numOfRows == pRight->numOfRows) {
+    if (vectorMathKernel(pLeft, pRight, pLeftCol, pRightCol, pOutputCol, _ord, OP_TYPE_SUB)) {
+      // done by the typed kernel
+    } else if (pLeft->numOfRows == pRight->numOfRows) {
       for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
         if (IS_NULL) {
           colDataAppendNULL(pOutputCol, i);
@@ -1270,7 +1436,9 @@ void vectorMathMultiply(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
   double *output = (double *)pOutputCol->pData;
-  if (pLeft->numOfRows == pRight->numOfRows) {
+  if (vectorMathKernel(pLeft, pRight, pLeftCol, pRightCol, pOutputCol, _ord, OP_TYPE_MULTI)) {
+    // done by the typed kernel
+  } else if (pLeft->numOfRows == pRight->numOfRows) {
     for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
       if (IS_NULL) {
         colDataAppendNULL(pOutputCol, i);
@@ -1303,7 +1471,9 @@ void vectorMathDivide(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *p
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
   double *output = (double *)pOutputCol->pData;
-  if (pLeft->numOfRows == pRight->numOfRows) {
+  if (vectorMathKernel(pLeft, pRight, pLeftCol, pRightCol, pOutputCol, _ord, OP_TYPE_DIV)) {
+    // done by the typed kernel
+  } else if (pLeft->numOfRows == pRight->numOfRows) {
     for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
       if (IS_NULL || (getVectorDoubleValueFnRight(RIGHT_COL, i) == 0)) {  // divide by 0 check
         colDataAppendNULL(pOutputCol, i);
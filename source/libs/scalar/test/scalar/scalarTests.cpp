@@ -32,10 +32,12 @@
 #endif
 #include "os.h"
 
+#include "filter.h"
 #include "filterInt.h"
 #include "nodes.h"
 #include "parUtil.h"
 #include "scalar.h"
+#include "sclvector.h"
 #include "stub.h"
 #include "taos.h"
 #include "tdatablock.h"
@@ -1992,6 +1994,223 @@ TEST(columnTest, greater_and_lower) {
   nodesDestroyNode(logicNode);
 }
 
+SColumnInfoData *scltMakeColumnData(int32_t type, int32_t bytes, int32_t rows) {
+  SColumnInfoData *pCol = (SColumnInfoData *)taosMemoryCalloc(1, sizeof(SColumnInfoData));
+  pCol->info = createColumnInfo(0, type, bytes);
+  colInfoDataEnsureCapacity(pCol, rows, true);
+  return pCol;
+}
+
+TEST(columnTest, int_column_arith_double_column) {
+  const int32_t rowNum = 1000;  // spans several kernel chunks
+  SScalarParam  left = {0}, right = {0}, constant = {0}, out = {0};
+
+  left.columnData = scltMakeColumnData(TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum);
+  right.columnData = scltMakeColumnData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), rowNum);
+  constant.columnData = scltMakeColumnData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 1);
+  left.numOfRows = right.numOfRows = rowNum;
+  constant.numOfRows = 1;
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    int32_t lv = i - 500;
+    double  rv = (i % 7) * 0.5;
+    colDataAppend(left.columnData, i, (const char *)&lv, i % 13 == 0);
+    colDataAppend(right.columnData, i, (const char *)&rv, i % 17 == 0);
+  }
+  double cv = 1.8;
+  colDataAppend(constant.columnData, 0, (const char *)&cv, false);
+
+  EOperatorType ops[] = {OP_TYPE_ADD, OP_TYPE_SUB, OP_TYPE_MULTI, OP_TYPE_DIV};
+  for (int32_t k = 0; k < sizeof(ops) / sizeof(ops[0]); ++k) {
+    _bin_scalar_fn_t fn = getBinScalarOperatorFn(ops[k]);
+
+    // column op column
+    out.columnData = scltMakeColumnData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), rowNum);
+    fn(&left, &right, &out, TSDB_ORDER_ASC);
+    ASSERT_EQ(out.numOfRows, rowNum);
+    for (int32_t i = 0; i < rowNum; ++i) {
+      double lv = i - 500, rv = (i % 7) * 0.5;
+      bool   isNull = (i % 13 == 0) || (i % 17 == 0) || (ops[k] == OP_TYPE_DIV && rv == 0);
+      ASSERT_EQ(colDataIsNull_s(out.columnData, i), isNull);
+      double expect = isNull ? 0 : (ops[k] == OP_TYPE_ADD ? lv + rv : ops[k] == OP_TYPE_SUB ? lv - rv
+                                                                  : ops[k] == OP_TYPE_MULTI ? lv * rv : lv / rv);
+      ASSERT_EQ(*(double *)colDataGetData(out.columnData, i), expect);
+    }
+    colDataDestroy(out.columnData);
+    taosMemoryFree(out.columnData);
+
+    // constant op column
+    out.columnData = scltMakeColumnData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), rowNum);
+    fn(&constant, &left, &out, TSDB_ORDER_ASC);
+    for (int32_t i = 0; i < rowNum; ++i) {
+      double lv = i - 500;
+      bool   isNull = (i % 13 == 0) || (ops[k] == OP_TYPE_DIV && lv == 0);
+      ASSERT_EQ(colDataIsNull_s(out.columnData, i), isNull);
+      double expect = isNull ? 0 : (ops[k] == OP_TYPE_ADD ? cv + lv : ops[k] == OP_TYPE_SUB ? cv - lv
+                                                                  : ops[k] == OP_TYPE_MULTI ? cv * lv : cv / lv);
+      ASSERT_EQ(*(double *)colDataGetData(out.columnData, i), expect);
+    }
+    colDataDestroy(out.columnData);
+    taosMemoryFree(out.columnData);
+  }
+
+  colDataDestroy(left.columnData);
+  taosMemoryFree(left.columnData);
+  colDataDestroy(right.columnData);
+  taosMemoryFree(right.columnData);
+  colDataDestroy(constant.columnData);
+  taosMemoryFree(constant.columnData);
+}
+
+TEST(columnTest, int_double_column_vector_filter) {
+  const int32_t rowNum = 3000;  // spans several kernel chunks
+  SSDataBlock  *src = NULL;
+  SNode        *pCol1 = NULL, *pCol2 = NULL, *pVal = NULL, *listNode = NULL;
+  SNode        *opNodes[5] = {0}, *logicNodes[3] = {0};
+  int32_t      *v1 = (int32_t *)taosMemoryCalloc(rowNum, sizeof(int32_t));
+  double       *v2 = (double *)taosMemoryCalloc(rowNum, sizeof(double));
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    v1[i] = i % 100 - 50;
+    v2[i] = (i % 9) * 0.5;
+  }
+
+  scltMakeColumnNode(&pCol1, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, v1);
+  scltMakeColumnNode(&pCol2, &src, TSDB_DATA_TYPE_DOUBLE, sizeof(double), rowNum, v2);
+  SColumnInfoData *pData1 = (SColumnInfoData *)taosArrayGet(src->pDataBlock, ((SColumnNode *)pCol1)->slotId);
+  SColumnInfoData *pData2 = (SColumnInfoData *)taosArrayGet(src->pDataBlock, ((SColumnNode *)pCol2)->slotId);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    if (i % 11 == 0) colDataAppendNULL(pData1, i);
+    if (i % 13 == 0) colDataAppendNULL(pData2, i);
+  }
+
+  // (c1 > 10 and c1 <= 30) or (c2 in (1.5, 3.0) and c1 < 0) or c2 is null
+  int32_t lower = 10, upper = 30, zero = 0;
+  double  in1 = 1.5, in2 = 3.0;
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &lower);
+  scltMakeOpNode(&opNodes[0], OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pCol1, pVal);
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &upper);
+  scltMakeOpNode(&opNodes[1], OP_TYPE_LOWER_EQUAL, TSDB_DATA_TYPE_BOOL, nodesCloneNode(pCol1), pVal);
+  scltMakeLogicNode(&logicNodes[0], LOGIC_COND_TYPE_AND, opNodes, 2);
+
+  SNodeList *list = nodesMakeList();
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_DOUBLE, &in1);
+  nodesListAppend(list, pVal);
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_DOUBLE, &in2);
+  nodesListAppend(list, pVal);
+  scltMakeListNode(&listNode, list, TSDB_DATA_TYPE_DOUBLE);
+  scltMakeOpNode(&opNodes[2], OP_TYPE_IN, TSDB_DATA_TYPE_BOOL, pCol2, listNode);
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &zero);
+  scltMakeOpNode(&opNodes[3], OP_TYPE_LOWER_THAN, TSDB_DATA_TYPE_BOOL, nodesCloneNode(pCol1), pVal);
+  scltMakeLogicNode(&logicNodes[1], LOGIC_COND_TYPE_AND, &opNodes[2], 2);
+
+  scltMakeOpNode(&opNodes[4], OP_TYPE_IS_NULL, TSDB_DATA_TYPE_BOOL, nodesCloneNode(pCol2), NULL);
+  logicNodes[2] = opNodes[4];
+
+  SNode *pTree = NULL;
+  scltMakeLogicNode(&pTree, LOGIC_COND_TYPE_OR, logicNodes, 3);
+
+  SFilterInfo *filter = NULL;
+  ASSERT_EQ(filterInitFromNode(pTree, &filter, 0), 0);
+  ASSERT_TRUE(filter->func == filterExecuteImplVec);
+
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(src->pDataBlock), src->pDataBlock};
+  ASSERT_EQ(filterSetDataFromSlotId(filter, &param), 0);
+
+  SColumnInfoData *pRes = NULL;
+  int32_t          status = 0;
+  filterExecute(filter, src, &pRes, NULL, param.numOfCols, &status);
+  ASSERT_EQ(status, FILTER_RESULT_PARTIAL_QUALIFIED);
+
+  // the row by row executor must agree
+  SColumnInfoData *pRowRes = scltMakeColumnData(TSDB_DATA_TYPE_BOOL, sizeof(bool), rowNum);
+  int32_t          qualified = 0;
+  filterExecuteImpl(filter, rowNum, pRowRes, NULL, param.numOfCols, &qualified);
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    bool null1 = (i % 11 == 0), null2 = (i % 13 == 0);
+    bool expect = (!null1 && v1[i] > 10 && v1[i] <= 30) ||
+                  (!null1 && !null2 && (v2[i] == 1.5 || v2[i] == 3.0) && v1[i] < 0) || null2;
+    ASSERT_EQ(((int8_t *)pRes->pData)[i], expect);
+    ASSERT_EQ(((int8_t *)pRowRes->pData)[i], expect);
+  }
+
+  colDataDestroy(pRes);
+  taosMemoryFree(pRes);
+  colDataDestroy(pRowRes);
+  taosMemoryFree(pRowRes);
+  filterFreeInfo(filter);
+  nodesDestroyNode(pTree);
+  blockDataDestroy(src);
+  taosMemoryFree(v1);
+  taosMemoryFree(v2);
+}
+
+typedef struct SScltBlockValues {
+  int32_t     c1;
+  const char *c2;
+  int32_t     c3;
+} SScltBlockValues;
+
+// a data block holding a single value for each column
+static bool scltBlockMayContain(void *param, int16_t colId, int8_t type, const void *pVal) {
+  SScltBlockValues *pValues = (SScltBlockValues *)param;
+  if (colId == 1) {
+    return type == TSDB_DATA_TYPE_INT && *(int32_t *)pVal == pValues->c1;
+  } else if (colId == 2) {
+    return type == TSDB_DATA_TYPE_BINARY && varDataLen(pVal) == strlen(pValues->c2) &&
+           memcmp(varDataVal(pVal), pValues->c2, varDataLen(pVal)) == 0;
+  } else {
+    return *(int32_t *)pVal == pValues->c3;
+  }
+}
+
+TEST(columnTest, bloom_filter_block_skip) {
+  SNode *pCol[3] = {0}, *pVal = NULL;
+  SNode *opNodes[3] = {0}, *logicNodes[2] = {0};
+  int32_t types[3] = {TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BINARY, TSDB_DATA_TYPE_INT};
+  int32_t bytes[3] = {sizeof(int32_t), 10 + VARSTR_HEADER_SIZE, sizeof(int32_t)};
+
+  for (int32_t i = 0; i < 3; ++i) {
+    scltMakeColumnNode(&pCol[i], NULL, types[i], bytes[i], 0, NULL);
+    ((SColumnNode *)pCol[i])->slotId = i;
+    ((SColumnNode *)pCol[i])->colId = i + 1;
+  }
+
+  // (c1 = 5 and c2 = 'abc') or c3 = 7
+  int32_t v1 = 5, v3 = 7;
+  char    v2[16] = {0};
+  varDataSetLen(v2, 3);
+  memcpy(varDataVal(v2), "abc", 3);
+
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &v1);
+  scltMakeOpNode(&opNodes[0], OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pCol[0], pVal);
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_BINARY, v2);
+  scltMakeOpNode(&opNodes[1], OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pCol[1], pVal);
+  scltMakeLogicNode(&logicNodes[0], LOGIC_COND_TYPE_AND, opNodes, 2);
+  scltMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &v3);
+  scltMakeOpNode(&opNodes[2], OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pCol[2], pVal);
+  logicNodes[1] = opNodes[2];
+
+  SNode *pTree = NULL;
+  scltMakeLogicNode(&pTree, LOGIC_COND_TYPE_OR, logicNodes, 2);
+
+  SFilterInfo *filter = NULL;
+  ASSERT_EQ(filterInitFromNode(pTree, &filter, 0), 0);
+
+  SScltBlockValues both = {5, "abc", 0};
+  SScltBlockValues second = {5, "xyz", 7};
+  SScltBlockValues noString = {5, "xyz", 0};
+  SScltBlockValues noInt = {6, "abc", 0};
+  ASSERT_TRUE(filterBloomExecute(filter, scltBlockMayContain, &both));
+  ASSERT_TRUE(filterBloomExecute(filter, scltBlockMayContain, &second));
+  ASSERT_FALSE(filterBloomExecute(filter, scltBlockMayContain, &noString));
+  ASSERT_FALSE(filterBloomExecute(filter, scltBlockMayContain, &noInt));
+
+  filterFreeInfo(filter);
+  nodesDestroyNode(pTree);
+}
+
 void scltMakeDataBlock(SScalarParam **pInput, int32_t type, void *pVal, int32_t num, bool setVal) {
   SScalarParam *input = (SScalarParam *)taosMemoryCalloc(1, sizeof(SScalarParam));
   int32_t       bytes;
@@ -122,8 +122,12 @@ int32_t streamTaskEnqueue(SStreamTask* pTask, const SStreamDispatchReq* pReq, SR
     // decode
     /*pData->blocks = pReq->data;*/
     /*pBlock->sourceVer = pReq->sourceVer;*/
-    streamDispatchReqToData(pReq, pData);
-    if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
+    if (streamDispatchReqToData(pReq, pData) < 0) {
+      qError("task %d failed to decode dispatched blocks from task %d since %s", pTask->taskId, pReq->upstreamTaskId,
+             terrstr());
+      taosFreeQitem(pData);
+      status = TASK_INPUT_STATUS__FAILED;
+    } else if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
       status = TASK_INPUT_STATUS__NORMAL;
     } else {
       status = TASK_INPUT_STATUS__FAILED;
@@ -163,8 +167,11 @@ int32_t streamTaskEnqueueRetrieve(SStreamTask* pTask, SStreamRetrieveReq* pReq,
     // decode
     /*pData->blocks = pReq->data;*/
     /*pBlock->sourceVer = pReq->sourceVer;*/
-    streamRetrieveReqToData(pReq, pData);
-    if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
+    if (streamRetrieveReqToData(pReq, pData) < 0) {
+      qError("task %d failed to decode retrieve req from task %d since %s", pTask->taskId, pReq->srcTaskId, terrstr());
+      taosFreeQitem(pData);
+      status = TASK_INPUT_STATUS__FAILED;
+    } else if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
       status = TASK_INPUT_STATUS__NORMAL;
     } else {
       status = TASK_INPUT_STATUS__FAILED;
@@ -25,6 +25,7 @@
 #include "syncRespMgr.h"
 #include "syncSnapshot.h"
 #include "syncUtil.h"
+#include "wal.h"
 
 static bool syncIsMsgBlock(tmsg_t type) {
   return (type == TDMT_VND_CREATE_TABLE) || (type == TDMT_VND_ALTER_TABLE) || (type == TDMT_VND_DROP_TABLE) ||
@@ -397,6 +398,8 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
 
   SSyncLogStore* pLogStore = pNode->pLogStore;
   int64_t        matchIndex = pBuf->matchIndex;
+  bool           groupCommit = walGroupCommitEnabled(pNode->pWal);
+  int64_t        persistedIndex = matchIndex;
 
   while (pBuf->matchIndex + 1 < pBuf->endIndex) {
     int64_t index = pBuf->matchIndex + 1;
@@ -448,13 +451,29 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
       goto _out;
     }
     ASSERT(pEntry->index == pBuf->matchIndex);
+    persistedIndex = pEntry->index;
 
-    // update my match index
-    matchIndex = pBuf->matchIndex;
-    syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, pBuf->matchIndex);
+    // update my match index, with group commit only once the batch is on disk
+    if (!groupCommit) {
+      matchIndex = pBuf->matchIndex;
+      syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, pBuf->matchIndex);
+    }
   }  // end of while
 
 _out:
+  // one flush and fsync for the whole batch of group committed entries
+  if (groupCommit && persistedIndex > matchIndex) {
+    if (walFsync(pNode->pWal, false) < 0) {
+      sError("vgId:%d, failed to flush sync log entries since %s. index:%" PRId64 "-%" PRId64, pNode->vgId,
+             terrstr(), matchIndex + 1, persistedIndex);
+    }
+    // a failed flush drops the batch, only what the wal still holds is matched
+    persistedIndex = TMIN(persistedIndex, walGetLastVer(pNode->pWal));
+    if (persistedIndex > matchIndex) {
+      matchIndex = persistedIndex;
+      syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, matchIndex);
+    }
+  }
   pBuf->matchIndex = matchIndex;
   if (pMatchTerm) {
     *pMatchTerm = pBuf->entries[(matchIndex + pBuf->size) % pBuf->size].pItem->term;
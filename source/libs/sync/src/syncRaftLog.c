@@ -219,7 +219,15 @@ static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntr
 
   ASSERT(pEntry->index == index);
 
-  walFsync(pWal, forceSync);
+  if (!walGroupCommitEnabled(pWal)) {
+    walFsync(pWal, forceSync);
+  } else if (forceSync && walFsync(pWal, forceSync) < 0) {
+    // with group commit, the log buffer syncs once for all entries it persists, a forced sync also flushes the
+    // pending batch, and a failed flush drops the entry just appended
+    sNError(pData->pSyncNode, "wal fsync error, index:%" PRId64 ", err:0x%x, msg:%s", pEntry->index, terrno,
+            terrstr());
+    return -1;
+  }
 
   sNTrace(pData->pSyncNode, "write index:%" PRId64 ", type:%s, origin type:%s, elapsed:%" PRId64, pEntry->index,
           TMSG_INFO(pEntry->msgType), TMSG_INFO(pEntry->originalRpcType), tsElapsed);
@@ -166,6 +166,12 @@ int64_t walGetSeq();
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
 
+// group commit section
+int32_t walFlushWriteBuf(SWal* pWal);
+void    walFlushBeforeRead(SWal* pWal, int64_t ver);
+void    walDestroyWriteBuf(SWal* pWal);
+// group commit section end
+
 #ifdef __cplusplus
 }
 #endif
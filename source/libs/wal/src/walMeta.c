@@ -835,6 +835,11 @@ int walSaveMeta(SWal* pWal) {
   char tmpFnameStr[WAL_FILE_LEN];
   int  n;
 
+  // meta must not refer to entries still held by group commit
+  if (walFlushWriteBuf(pWal) < 0) {
+    return -1;
+  }
+
   // fsync the idx and log file at first to ensure validity of meta
   if (taosFsyncFile(pWal->pIdxFile) < 0) {
     wError("vgId:%d, failed to sync idx file due to %s", pWal->cfg.vgId, strerror(errno));
@@ -17,6 +17,7 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tcompare.h"
+#include "tglobal.h"
 #include "tref.h"
 #include "walInt.h"
 
@@ -143,6 +144,9 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   pWal->writeHead.head.protoVer = WAL_PROTO_VER;
   pWal->writeHead.magic = WAL_MAGIC;
 
+  // init group commit buffer
+  pWal->writeBuf.firstVer = -1;
+
   // load meta
   (void)walLoadMeta(pWal);
 
@@ -233,6 +237,7 @@ static void walFreeObj(void *wal) {
   SWal *pWal = wal;
   wDebug("vgId:%d, wal:%p is freed", pWal->cfg.vgId, pWal);
 
+  walDestroyWriteBuf(pWal);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFreeClear(pWal);
 }
@@ -249,9 +254,24 @@ static bool walNeedFsync(SWal *pWal) {
   return false;
 }
 
-static void walUpdateSeq() {
-  taosMsleep(WAL_REFRESH_MS);
-  atomic_add_fetch_32(&tsWal.seq, 1);
+static void walUpdateSeq() { atomic_add_fetch_32(&tsWal.seq, 1); }
+
+// flush group commit batches that have waited longer than tsWalGroupCommitDelay
+static void walFlushAll() {
+  int64_t now = taosGetTimestampMs();
+  SWal   *pWal = taosIterateRef(tsWal.refSetId, 0);
+  while (pWal) {
+    if (atomic_load_64(&pWal->writeBuf.firstVer) != -1) {
+      taosThreadMutexLock(&pWal->mutex);
+      if (pWal->writeBuf.firstVer != -1 && now - pWal->writeBuf.firstTs >= tsWalGroupCommitDelay &&
+          walFlushWriteBuf(pWal) < 0) {
+        wError("vgId:%d, failed to flush group commit since %s", pWal->cfg.vgId, terrstr());
+        pWal->writeBuf.code = terrno;
+      }
+      taosThreadMutexUnlock(&pWal->mutex);
+    }
+    pWal = taosIterateRef(tsWal.refSetId, pWal->refId);
+  }
 }
 
 static void walFsyncAll() {
@@ -260,6 +280,14 @@ static void walFsyncAll() {
     if (walNeedFsync(pWal)) {
       wTrace("vgId:%d, do fsync, level:%d seq:%d rseq:%d", pWal->cfg.vgId, pWal->cfg.level, pWal->fsyncSeq,
              atomic_load_32(&tsWal.seq));
+      if (atomic_load_64(&pWal->writeBuf.firstVer) != -1) {
+        taosThreadMutexLock(&pWal->mutex);
+        if (walFlushWriteBuf(pWal) < 0) {
+          wError("vgId:%d, failed to flush group commit since %s", pWal->cfg.vgId, terrstr());
+          pWal->writeBuf.code = terrno;
+        }
+        taosThreadMutexUnlock(&pWal->mutex);
+      }
       int32_t code = taosFsyncFile(pWal->pLogFile);
       if (code != 0) {
         wError("vgId:%d, file:%" PRId64 ".log, failed to fsync since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
@@ -272,9 +300,21 @@ static void walFsyncAll() {
 
 static void *walThreadFunc(void *param) {
   setThreadName("wal");
+  int64_t lastSeqTs = taosGetTimestampMs();
   while (1) {
-    walUpdateSeq();
-    walFsyncAll();
+    if (tsWalGroupCommitSize > 0) {
+      taosMsleep(TMIN(tsWalGroupCommitDelay, WAL_REFRESH_MS));
+      walFlushAll();
+    } else {
+      taosMsleep(WAL_REFRESH_MS);
+    }
+
+    int64_t now = taosGetTimestampMs();
+    if (now - lastSeqTs >= WAL_REFRESH_MS) {
+      lastSeqTs = now;
+      walUpdateSeq();
+      walFsyncAll();
+    }
 
     if (atomic_load_8(&tsWal.stop)) break;
   }
@@ -224,6 +224,8 @@ int32_t walReadSeekVer(SWalReader *pReader, int64_t ver) {
   if (ver < pWal->vers.snapshotVer) {
   }
 
+  walFlushBeforeRead(pWal, ver);
+
   if (walReadSeekVerImpl(pReader, ver) < 0) {
     return -1;
   }
@@ -239,6 +241,8 @@ static int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer) {
 
   wDebug("vgId:%d, wal starts to fetch head, index:%" PRId64, pRead->pWal->cfg.vgId, fetchVer);
 
+  walFlushBeforeRead(pRead->pWal, fetchVer);
+
   if (pRead->curInvalid || pRead->curVersion != fetchVer) {
     if (walReadSeekVer(pRead, fetchVer) < 0) {
       pRead->curVersion = fetchVer;
@@ -354,6 +358,8 @@ int32_t walFetchHead(SWalReader *pRead, int64_t ver, SWalCkHead *pHead) {
     return -1;
   }
 
+  walFlushBeforeRead(pRead->pWal, ver);
+
   if (pRead->curInvalid || pRead->curVersion != ver) {
     code = walReadSeekVer(pRead, ver);
     if (code < 0) {
@@ -490,6 +496,8 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
     return -1;
   }
 
+  walFlushBeforeRead(pReader->pWal, ver);
+
   taosThreadMutexLock(&pReader->mutex);
 
   if (pReader->curInvalid || pReader->curVersion != ver) {
@@ -19,6 +19,8 @@
 #include "tglobal.h"
 #include "walInt.h"
 
+static void walResetWriteBuf(SWal *pWal);
+
 int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   taosThreadMutexLock(&pWal->mutex);
 
@@ -36,6 +38,7 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
     }
   }
 
+  walResetWriteBuf(pWal);
   taosCloseFile(&pWal->pLogFile);
   taosCloseFile(&pWal->pIdxFile);
 
@@ -109,6 +112,12 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
 
+  // entries to truncate may still be in the group commit buffer
+  if (walFlushWriteBuf(pWal) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
   // find correct file
   if (ver < walGetLastFileFirstVer(pWal)) {
     // change current files
@@ -382,6 +391,10 @@ END:
 
 int32_t walRollImpl(SWal *pWal) {
   int32_t code = 0;
+  if (walFlushWriteBuf(pWal) < 0) {
+    code = -1;
+    goto END;
+  }
   if (pWal->pIdxFile != NULL) {
     code = taosCloseFile(&pWal->pIdxFile);
     if (code != 0) {
@@ -438,6 +451,127 @@ END:
   return code;
 }
 
+bool walGroupCommitEnabled(SWal *pWal) { return tsWalGroupCommitSize > 0; }
+
+static void walResetWriteBuf(SWal *pWal) {
+  pWal->writeBuf.logLen = 0;
+  pWal->writeBuf.idxLen = 0;
+  atomic_store_64(&pWal->writeBuf.firstVer, -1);
+}
+
+void walDestroyWriteBuf(SWal *pWal) {
+  taosMemoryFreeClear(pWal->writeBuf.pLog);
+  taosMemoryFreeClear(pWal->writeBuf.pIdx);
+  pWal->writeBuf.logCap = 0;
+  pWal->writeBuf.idxCap = 0;
+  walResetWriteBuf(pWal);
+}
+
+static int32_t walReserveWriteBuf(uint8_t **ppBuf, int64_t *pCap, int64_t size) {
+  if (size <= *pCap) return 0;
+
+  int64_t cap = TMAX(*pCap, 4096);
+  while (cap < size) cap <<= 1;
+
+  uint8_t *pBuf = taosMemoryRealloc(*ppBuf, cap);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  *ppBuf = pBuf;
+  *pCap = cap;
+  return 0;
+}
+
+// append the current write head, body and idx entry to the group commit buffer
+static int32_t walBufferEntry(SWal *pWal, int64_t ver, int64_t offset, const void *body, int32_t bodyLen) {
+  SWalWriteBuf *pBuf = &pWal->writeBuf;
+  int64_t       logLen = pBuf->logLen + sizeof(SWalCkHead) + bodyLen;
+
+  if (walReserveWriteBuf(&pBuf->pLog, &pBuf->logCap, logLen) < 0 ||
+      walReserveWriteBuf(&pBuf->pIdx, &pBuf->idxCap, pBuf->idxLen + sizeof(SWalIdxEntry)) < 0) {
+    wError("vgId:%d, failed to buffer log entry since %s. ver:%" PRId64, pWal->cfg.vgId, terrstr(), ver);
+    return -1;
+  }
+
+  SWalIdxEntry entry = {.ver = ver, .offset = offset};
+  memcpy(pBuf->pIdx + pBuf->idxLen, &entry, sizeof(SWalIdxEntry));
+  pBuf->idxLen += sizeof(SWalIdxEntry);
+
+  memcpy(pBuf->pLog + pBuf->logLen, &pWal->writeHead, sizeof(SWalCkHead));
+  memcpy(pBuf->pLog + pBuf->logLen + sizeof(SWalCkHead), body, bodyLen);
+  pBuf->logLen = logLen;
+
+  if (pBuf->firstVer == -1) {
+    pBuf->logOffset = offset;
+    pBuf->firstTs = taosGetTimestampMs();
+    atomic_store_64(&pBuf->firstVer, ver);
+  }
+  return 0;
+}
+
+// write all buffered entries with one write to the idx file and one to the log file, mutex must be held
+int32_t walFlushWriteBuf(SWal *pWal) {
+  SWalWriteBuf *pBuf = &pWal->writeBuf;
+  if (pBuf->firstVer == -1) return 0;
+
+  SWalFileInfo *pFileInfo = walGetCurFileInfo(pWal);
+  int64_t       idxOffset = (pBuf->firstVer - pFileInfo->firstVer) * sizeof(SWalIdxEntry);
+
+  wDebug("vgId:%d, wal flush group commit, ver:%" PRId64 "-%" PRId64 ", size:%" PRId64, pWal->cfg.vgId,
+         pBuf->firstVer, pWal->vers.lastVer, pBuf->logLen);
+
+  if (taosWriteFile(pWal->pIdxFile, pBuf->pIdx, pBuf->idxLen) != pBuf->idxLen) {
+    wError("vgId:%d, failed to write idx entries due to %s. ver:%" PRId64, pWal->cfg.vgId, strerror(errno),
+           pBuf->firstVer);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+
+  if (taosWriteFile(pWal->pLogFile, pBuf->pLog, pBuf->logLen) != pBuf->logLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
+           strerror(errno));
+    goto _err;
+  }
+
+  walResetWriteBuf(pWal);
+  return 0;
+
+_err:
+  // the whole batch is dropped, as a failed single write drops its entry
+  if (taosFtruncateFile(pWal->pLogFile, pBuf->logOffset) < 0) {
+    wFatal("vgId:%d, failed to ftruncate logfile to offset:%" PRId64 " during recovery due to %s", pWal->cfg.vgId,
+           pBuf->logOffset, strerror(errno));
+    terrno = TAOS_SYSTEM_ERROR(errno);
+  }
+  if (taosFtruncateFile(pWal->pIdxFile, idxOffset) < 0) {
+    wFatal("vgId:%d, failed to ftruncate idxfile to offset:%" PRId64 " during recovery due to %s", pWal->cfg.vgId,
+           idxOffset, strerror(errno));
+    terrno = TAOS_SYSTEM_ERROR(errno);
+  }
+
+  pWal->vers.lastVer = pBuf->firstVer - 1;
+  pWal->totSize -= pBuf->logLen;
+  pFileInfo->lastVer = pBuf->firstVer - 1;
+  pFileInfo->fileSize = pBuf->logOffset;
+  walResetWriteBuf(pWal);
+  return -1;
+}
+
+void walFlushBeforeRead(SWal *pWal, int64_t ver) {
+  int64_t firstVer = atomic_load_64(&pWal->writeBuf.firstVer);
+  if (firstVer == -1 || ver < firstVer) return;
+
+  taosThreadMutexLock(&pWal->mutex);
+  if (walFlushWriteBuf(pWal) < 0) {
+    wError("vgId:%d, failed to flush group commit before read since %s. ver:%" PRId64, pWal->cfg.vgId, terrstr(),
+           ver);
+    pWal->writeBuf.code = terrno;
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
 static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
   SWalIdxEntry  entry = {.ver = ver, .offset = offset};
   SWalFileInfo *pFileInfo = walGetCurFileInfo(pWal);
@@ -460,6 +594,16 @@ static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
   return 0;
 }
 
+static FORCE_INLINE void walUpdateWriteStatus(SWal *pWal, SWalFileInfo *pFileInfo, int64_t index, int32_t bodyLen) {
+  if (pWal->vers.firstVer == -1) {
+    pWal->vers.firstVer = 0;
+  }
+  pWal->vers.lastVer = index;
+  pWal->totSize += sizeof(SWalCkHead) + bodyLen;
+  pFileInfo->lastVer = index;
+  pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
+}
+
 static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta,
                                          const void *body, int32_t bodyLen) {
   int64_t code = 0;
@@ -480,6 +624,20 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   wDebug("vgId:%d, wal write log %" PRId64 ", msgType: %s, cksum head %u cksum body %u", pWal->cfg.vgId, index,
          TMSG_INFO(msgType), pWal->writeHead.cksumHead, pWal->writeHead.cksumBody);
 
+  if (walGroupCommitEnabled(pWal)) {
+    if (walBufferEntry(pWal, index, offset, body, bodyLen) < 0) {
+      return -1;
+    }
+    walUpdateWriteStatus(pWal, pFileInfo, index, bodyLen);
+
+    SWalWriteBuf *pBuf = &pWal->writeBuf;
+    if (pBuf->logLen >= (int64_t)tsWalGroupCommitSize * 1024 ||
+        taosGetTimestampMs() - pBuf->firstTs >= tsWalGroupCommitDelay) {
+      return walFlushWriteBuf(pWal);
+    }
+    return 0;
+  }
+
   code = walWriteIndex(pWal, index, offset);
   if (code < 0) {
     goto END;
@@ -501,15 +659,7 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
     goto END;
   }
 
-  // set status
-  if (pWal->vers.firstVer == -1) {
-    pWal->vers.firstVer = 0;
-  }
-  pWal->vers.lastVer = index;
-  pWal->totSize += sizeof(SWalCkHead) + bodyLen;
-  pFileInfo->lastVer = index;
-  pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
-
+  walUpdateWriteStatus(pWal, pFileInfo, index, bodyLen);
   return 0;
 
 END:
@@ -605,14 +755,29 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
   return walWriteWithSyncInfo(pWal, index, msgType, syncMeta, body, bodyLen);
 }
 
-void walFsync(SWal *pWal, bool forceFsync) {
+int32_t walFsync(SWal *pWal, bool forceFsync) {
+  int32_t code = 0;
+
   taosThreadMutexLock(&pWal->mutex);
-  if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
+  if (pWal->writeBuf.code != 0) {
+    // a background flush dropped entries since the last call
+    terrno = pWal->writeBuf.code;
+    pWal->writeBuf.code = 0;
+    code = -1;
+  }
+  if (walFlushWriteBuf(pWal) < 0) {
+    wError("vgId:%d, failed to flush group commit since %s", pWal->cfg.vgId, terrstr());
+    code = -1;
+  }
+  if (code == 0 && (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0))) {
     wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
     if (taosFsyncFile(pWal->pLogFile) < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
              strerror(errno));
+      code = -1;
     }
   }
   taosThreadMutexUnlock(&pWal->mutex);
+  return code;
 }
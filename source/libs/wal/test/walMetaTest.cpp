@@ -3,6 +3,7 @@
 #include <iostream>
 #include <queue>
 
+#include "tglobal.h"
 #include "walInt.h"
 
 const char* ranStr = "tvapq02tcp";
@@ -361,6 +362,59 @@ TEST_F(WalKeepEnv, readHandleRead) {
   walCloseReader(pRead);
 }
 
+TEST_F(WalKeepEnv, groupCommit) {
+  walResetEnv();
+  int32_t groupCommitSize = tsWalGroupCommitSize;
+  int32_t groupCommitDelay = tsWalGroupCommitDelay;
+  tsWalGroupCommitSize = 1;
+  tsWalGroupCommitDelay = 1000;
+
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+
+  for (int i = 0; i < 100; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, i);
+    int len = strlen(newStr);
+    code = walWrite(pWal, i, 0, newStr, len);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pWal->vers.lastVer, i);
+  }
+  // the tail of the last batch has not reached the files yet
+  ASSERT_NE(pWal->writeBuf.firstVer, -1);
+
+  for (int i = 0; i < 1000; i++) {
+    int ver = taosRand() % 100;
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, ver);
+    int len = strlen(newStr);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+    for (int j = 0; j < len; j++) {
+      EXPECT_EQ(newStr[j], pRead->pHead->head.body[j]);
+    }
+  }
+  walCloseReader(pRead);
+
+  for (int i = 100; i < 110; i++) {
+    code = walWrite(pWal, i, 0, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+  }
+  code = walRollback(pWal, 105);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->vers.lastVer, 104);
+  ASSERT_EQ(pWal->writeBuf.firstVer, -1);
+
+  walFsync(pWal, true);
+  ASSERT_EQ(walGetCurFileInfo(pWal)->fileSize, taosLSeekFile(pWal->pLogFile, 0, SEEK_END));
+
+  tsWalGroupCommitSize = groupCommitSize;
+  tsWalGroupCommitDelay = groupCommitDelay;
+}
+
 TEST_F(WalRetentionEnv, repairMeta1) {
   walResetEnv();
   int code;
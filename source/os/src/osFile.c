@@ -416,7 +416,25 @@ int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset)
   int64_t ret = _read(pFile->fd, buf, count);
   _lseeki64(pFile->fd, pos, SEEK_SET);
 #else
-  int64_t ret = pread(pFile->fd, buf, count, offset);
+  int64_t ret = 0;
+  int64_t readbytes;
+  char   *tbuf = (char *)buf;
+
+  while (ret < count) {
+    readbytes = pread(pFile->fd, (void *)(tbuf + ret), (size_t)(count - ret), offset + ret);
+    if (readbytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      } else {
+        ret = -1;
+        break;
+      }
+    } else if (readbytes == 0) {
+      break;
+    }
+
+    ret += readbytes;
+  }
 #endif
 #if FILE_WITH_LOCK
   taosThreadRwlockUnlock(&(pFile->rwlock));
@@ -647,6 +665,19 @@ int32_t taosFsyncFile(TdFilePtr pFile) {
   return 0;
 }
 
+// hint the kernel to start reading [offset, offset + len) in background, it is only a hint and never fails hard
+int32_t taosPrefetchFile(TdFilePtr pFile, int64_t offset, int64_t len) {
+  if (pFile == NULL || pFile->fd < 0) {
+    return 0;
+  }
+
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  return 0;
+#else
+  return posix_fadvise(pFile->fd, offset, len, POSIX_FADV_WILLNEED);
+#endif
+}
+
 int64_t taosFSendFile(TdFilePtr pFileOut, TdFilePtr pFileIn, int64_t *offset, int64_t size) {
   if (pFileOut == NULL || pFileIn == NULL) {
     return 0;
@@ -153,6 +153,326 @@ void taosqsort(void *src, int64_t numOfElem, int64_t size, const void *param, __
   taosMemoryFreeClear(buf);
 }
 
+#define PDQ_INSERTION_SORT_THRESHOLD 24
+#define PDQ_NINTHER_THRESHOLD        128
+#define PDQ_PARTIAL_INSERTION_LIMIT  8
+
+typedef struct SPdqSortParam {
+  char             *src;
+  int64_t           size;
+  const void       *param;
+  __ext_compar_fn_t comparFn;
+  char             *swapBuf;
+  char             *pivotBuf;
+} SPdqSortParam;
+
+#define pdqElem(_p, _i)          ((_p)->src + (_p)->size * (_i))
+#define pdqLess(_p, _l, _r)      ((_p)->comparFn((_l), (_r), (_p)->param) < 0)
+#define pdqSwap(_p, _i, _j)      doswap(pdqElem(_p, _i), pdqElem(_p, _j), (_p)->size, (_p)->swapBuf)
+#define pdqMove(_p, _dst, _src) memcpy((_dst), (_src), (_p)->size)
+
+static void pdqInsertSort(SPdqSortParam *p, int64_t begin, int64_t end) {
+  for (int64_t i = begin + 1; i < end; ++i) {
+    if (!pdqLess(p, pdqElem(p, i), pdqElem(p, i - 1))) {
+      continue;
+    }
+
+    int64_t j = i;
+    pdqMove(p, p->swapBuf, pdqElem(p, i));
+    do {
+      pdqMove(p, pdqElem(p, j), pdqElem(p, j - 1));
+      j -= 1;
+    } while (j > begin && pdqLess(p, p->swapBuf, pdqElem(p, j - 1)));
+    pdqMove(p, pdqElem(p, j), p->swapBuf);
+  }
+}
+
+// give up once too many elements have been moved, the range is probably not nearly sorted
+static bool pdqPartialInsertSort(SPdqSortParam *p, int64_t begin, int64_t end) {
+  int64_t limit = 0;
+  for (int64_t i = begin + 1; i < end; ++i) {
+    if (!pdqLess(p, pdqElem(p, i), pdqElem(p, i - 1))) {
+      continue;
+    }
+
+    int64_t j = i;
+    pdqMove(p, p->swapBuf, pdqElem(p, i));
+    do {
+      pdqMove(p, pdqElem(p, j), pdqElem(p, j - 1));
+      j -= 1;
+    } while (j > begin && pdqLess(p, p->swapBuf, pdqElem(p, j - 1)));
+    pdqMove(p, pdqElem(p, j), p->swapBuf);
+
+    limit += i - j;
+    if (limit > PDQ_PARTIAL_INSERTION_LIMIT) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void pdqSort2(SPdqSortParam *p, int64_t a, int64_t b) {
+  if (pdqLess(p, pdqElem(p, b), pdqElem(p, a))) {
+    pdqSwap(p, a, b);
+  }
+}
+
+static void pdqSort3(SPdqSortParam *p, int64_t a, int64_t b, int64_t c) {
+  pdqSort2(p, a, b);
+  pdqSort2(p, b, c);
+  pdqSort2(p, a, b);
+}
+
+static void pdqSiftDown(SPdqSortParam *p, int64_t begin, int64_t parent, int64_t num) {
+  while (1) {
+    int64_t child = 2 * parent + 1;
+    if (child >= num) {
+      break;
+    }
+
+    if (child + 1 < num && pdqLess(p, pdqElem(p, begin + child), pdqElem(p, begin + child + 1))) {
+      child += 1;
+    }
+
+    if (!pdqLess(p, pdqElem(p, begin + parent), pdqElem(p, begin + child))) {
+      break;
+    }
+
+    pdqSwap(p, begin + parent, begin + child);
+    parent = child;
+  }
+}
+
+static void pdqHeapSort(SPdqSortParam *p, int64_t begin, int64_t end) {
+  int64_t num = end - begin;
+  for (int64_t i = num / 2 - 1; i >= 0; --i) {
+    pdqSiftDown(p, begin, i, num);
+  }
+
+  for (int64_t i = num - 1; i > 0; --i) {
+    pdqSwap(p, begin, begin + i);
+    pdqSiftDown(p, begin, 0, i);
+  }
+}
+
+// elements less than the pivot at src[begin] go to its left, the others to its right
+static int64_t pdqPartitionRight(SPdqSortParam *p, int64_t begin, int64_t end, bool *alreadyPartitioned) {
+  char *pivot = p->pivotBuf;
+  pdqMove(p, pivot, pdqElem(p, begin));
+
+  int64_t first = begin;
+  int64_t last = end;
+
+  // the median selection guarantees there is an element not less than the pivot
+  while (pdqLess(p, pdqElem(p, ++first), pivot)) {
+  }
+
+  if (first - 1 == begin) {
+    while (first < last && !pdqLess(p, pdqElem(p, --last), pivot)) {
+    }
+  } else {
+    while (!pdqLess(p, pdqElem(p, --last), pivot)) {
+    }
+  }
+
+  *alreadyPartitioned = first >= last;
+
+  while (first < last) {
+    pdqSwap(p, first, last);
+    while (pdqLess(p, pdqElem(p, ++first), pivot)) {
+    }
+    while (!pdqLess(p, pdqElem(p, --last), pivot)) {
+    }
+  }
+
+  int64_t pivotPos = first - 1;
+  pdqMove(p, pdqElem(p, begin), pdqElem(p, pivotPos));
+  pdqMove(p, pdqElem(p, pivotPos), pivot);
+  return pivotPos;
+}
+
+// elements equal to the pivot go to its left, used when the range is full of duplicated values
+static int64_t pdqPartitionLeft(SPdqSortParam *p, int64_t begin, int64_t end) {
+  char *pivot = p->pivotBuf;
+  pdqMove(p, pivot, pdqElem(p, begin));
+
+  int64_t first = begin;
+  int64_t last = end;
+
+  while (pdqLess(p, pivot, pdqElem(p, --last))) {
+  }
+
+  if (last + 1 == end) {
+    while (first < last && !pdqLess(p, pivot, pdqElem(p, ++first))) {
+    }
+  } else {
+    while (!pdqLess(p, pivot, pdqElem(p, ++first))) {
+    }
+  }
+
+  while (first < last) {
+    pdqSwap(p, first, last);
+    while (pdqLess(p, pivot, pdqElem(p, --last))) {
+    }
+    while (!pdqLess(p, pivot, pdqElem(p, ++first))) {
+    }
+  }
+
+  pdqMove(p, pdqElem(p, begin), pdqElem(p, last));
+  pdqMove(p, pdqElem(p, last), pivot);
+  return last;
+}
+
+static void pdqSortImpl(SPdqSortParam *p, int64_t begin, int64_t end, int32_t badAllowed, bool leftmost) {
+  while (1) {
+    int64_t num = end - begin;
+    if (num < PDQ_INSERTION_SORT_THRESHOLD) {
+      pdqInsertSort(p, begin, end);
+      return;
+    }
+
+    // move the median of three (or the pseudo median of nine) to src[begin]
+    int64_t half = num / 2;
+    if (num > PDQ_NINTHER_THRESHOLD) {
+      pdqSort3(p, begin, begin + half, end - 1);
+      pdqSort3(p, begin + 1, begin + (half - 1), end - 2);
+      pdqSort3(p, begin + 2, begin + (half + 1), end - 3);
+      pdqSort3(p, begin + (half - 1), begin + half, begin + (half + 1));
+      pdqSwap(p, begin, begin + half);
+    } else {
+      pdqSort3(p, begin + half, begin, end - 1);
+    }
+
+    // the pivot of the parent partition is equal to this pivot, all elements equal to it can be skipped
+    if (!leftmost && !pdqLess(p, pdqElem(p, begin - 1), pdqElem(p, begin))) {
+      begin = pdqPartitionLeft(p, begin, end) + 1;
+      continue;
+    }
+
+    bool    alreadyPartitioned = false;
+    int64_t pivotPos = pdqPartitionRight(p, begin, end, &alreadyPartitioned);
+
+    int64_t lSize = pivotPos - begin;
+    int64_t rSize = end - (pivotPos + 1);
+    if (lSize < num / 8 || rSize < num / 8) {
+      if (--badAllowed == 0) {
+        pdqHeapSort(p, begin, end);
+        return;
+      }
+
+      // break the patterns that lead to the unbalanced partition
+      if (lSize >= PDQ_INSERTION_SORT_THRESHOLD) {
+        pdqSwap(p, begin, begin + lSize / 4);
+        pdqSwap(p, pivotPos - 1, pivotPos - lSize / 4);
+        if (lSize > PDQ_NINTHER_THRESHOLD) {
+          pdqSwap(p, begin + 1, begin + (lSize / 4 + 1));
+          pdqSwap(p, begin + 2, begin + (lSize / 4 + 2));
+          pdqSwap(p, pivotPos - 2, pivotPos - (lSize / 4 + 1));
+          pdqSwap(p, pivotPos - 3, pivotPos - (lSize / 4 + 2));
+        }
+      }
+
+      if (rSize >= PDQ_INSERTION_SORT_THRESHOLD) {
+        pdqSwap(p, pivotPos + 1, pivotPos + (1 + rSize / 4));
+        pdqSwap(p, end - 1, end - rSize / 4);
+        if (rSize > PDQ_NINTHER_THRESHOLD) {
+          pdqSwap(p, pivotPos + 2, pivotPos + (2 + rSize / 4));
+          pdqSwap(p, pivotPos + 3, pivotPos + (3 + rSize / 4));
+          pdqSwap(p, end - 2, end - (1 + rSize / 4));
+          pdqSwap(p, end - 3, end - (2 + rSize / 4));
+        }
+      }
+    } else if (alreadyPartitioned && pdqPartialInsertSort(p, begin, pivotPos) &&
+               pdqPartialInsertSort(p, pivotPos + 1, end)) {
+      return;
+    }
+
+    pdqSortImpl(p, begin, pivotPos, badAllowed, leftmost);
+    begin = pivotPos + 1;
+    leftmost = false;
+  }
+}
+
+void taosPdqSort(void *src, int64_t numOfElem, int64_t size, const void *param, __ext_compar_fn_t comparFn) {
+  if (numOfElem <= 1) {
+    return;
+  }
+
+  char *buf = taosMemoryCalloc(2, size);  // the swap buffer and the pivot buffer
+  if (buf == NULL) {
+    taosqsort(src, numOfElem, size, param, comparFn);
+    return;
+  }
+
+  SPdqSortParam p = {
+      .src = src, .size = size, .param = param, .comparFn = comparFn, .swapBuf = buf, .pivotBuf = buf + size};
+
+  int32_t badAllowed = 1;
+  while ((numOfElem >> badAllowed) > 0) {
+    badAllowed += 1;
+  }
+
+  pdqSortImpl(&p, 0, numOfElem, badAllowed, true);
+  taosMemoryFreeClear(buf);
+}
+
+int32_t taosRadixSort(void *src, int64_t numOfElem, int64_t size, int32_t keyLen) {
+  if (numOfElem <= 1 || keyLen <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t *pCount = taosMemoryCalloc(keyLen, 256 * sizeof(int64_t));
+  char    *pTmp = taosMemoryMalloc(numOfElem * size);
+  if (pCount == NULL || pTmp == NULL) {
+    taosMemoryFree(pCount);
+    taosMemoryFree(pTmp);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the histograms of all key bytes are collected in one pass, since the scatter does not change them
+  for (int64_t i = 0; i < numOfElem; ++i) {
+    const uint8_t *pKey = (const uint8_t *)elePtrAt(src, size, i);
+    for (int32_t b = 0; b < keyLen; ++b) {
+      pCount[b * 256 + pKey[b]] += 1;
+    }
+  }
+
+  char *pFrom = src;
+  char *pTo = pTmp;
+  for (int32_t b = keyLen - 1; b >= 0; --b) {
+    int64_t *pBucket = &pCount[b * 256];
+
+    // all elements have the same value of this byte, skip the pass
+    const uint8_t *pFirst = (const uint8_t *)pFrom;
+    if (pBucket[pFirst[b]] == numOfElem) {
+      continue;
+    }
+
+    int64_t offset = 0;
+    for (int32_t v = 0; v < 256; ++v) {
+      int64_t n = pBucket[v];
+      pBucket[v] = offset;
+      offset += n;
+    }
+
+    for (int64_t i = 0; i < numOfElem; ++i) {
+      char *pElem = pFrom + i * size;
+      memcpy(pTo + pBucket[(uint8_t)pElem[b]]++ * size, pElem, size);
+    }
+
+    TSWAP(pFrom, pTo);
+  }
+
+  if (pFrom != src) {
+    memcpy(src, pFrom, numOfElem * size);
+  }
+
+  taosMemoryFree(pCount);
+  taosMemoryFree(pTmp);
+  return TSDB_CODE_SUCCESS;
+}
+
 void *taosbsearch(const void *key, const void *base, int32_t nmemb, int32_t size, __compar_fn_t compar, int32_t flags) {
   uint8_t *p;
   int32_t  lidx;
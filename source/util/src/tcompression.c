@@ -95,15 +95,75 @@ void tsCompressExit() { tdszExit(); }
 
 /*
  * Compress Integer (Simple8B).
+ *
+ * The zigzag deltas and their selectors are computed by a per-type pre-pass over a window of the input, so the
+ * packing loop below never looks at the data type. For types narrower than BIGINT the deltas can not overflow and
+ * the pre-pass is a branch-free loop the compiler vectorizes.
  */
+#define SIMPLE8B_WINDOW 1024
+
+// indexed by the bit width of a zigzag value, 0..64. Widths above 60 can not be encoded and are rejected by the
+// caller, but they still get a selector so the lookup stays in bounds.
+static const char SIMPLE8B_BIT_TO_SELECTOR[LONG_BYTES * BITS_PER_BYTE + 1] = {
+    0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 13, 13, 14, 14, 14, 14, 14,
+    14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+
+#define SIMPLE8B_SELECTOR_OF(v) SIMPLE8B_BIT_TO_SELECTOR[(v) ? (LONG_BYTES * BITS_PER_BYTE) - BUILDIN_CLZL(v) : 0]
+
+#define SIMPLE8B_ZIGZAG_NARROW(T)                                      \
+  do {                                                                 \
+    const T *pIn = (const T *)input;                                   \
+    int64_t  prev = (start == 0) ? 0 : (int64_t)pIn[start - 1];        \
+    for (int32_t j = 0; j < n; j++) {                                  \
+      int64_t curr = (int64_t)pIn[start + j];                          \
+      aZigzag[j] = ZIGZAG_ENCODE(int64_t, curr - prev);                \
+      prev = curr;                                                     \
+    }                                                                  \
+    for (int32_t j = 0; j < n; j++) {                                  \
+      aSelector[j] = SIMPLE8B_SELECTOR_OF(aZigzag[j]);                 \
+    }                                                                  \
+  } while (0)
+
+// compute the zigzag deltas of input[start, start + n), return false if the values can not be encoded
+static bool tsSimple8bZigzag(const char *const input, int32_t start, int32_t n, const char type, uint64_t *aZigzag,
+                             char *aSelector) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      SIMPLE8B_ZIGZAG_NARROW(int8_t);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      SIMPLE8B_ZIGZAG_NARROW(int16_t);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      SIMPLE8B_ZIGZAG_NARROW(int32_t);
+      break;
+    case TSDB_DATA_TYPE_BIGINT: {
+      const int64_t *pIn = (const int64_t *)input;
+      int64_t        prev = (start == 0) ? 0 : pIn[start - 1];
+      bool           valid = true;
+      for (int32_t j = 0; j < n; j++) {
+        int64_t curr = pIn[start + j];
+        int64_t diff = (int64_t)((uint64_t)curr - (uint64_t)prev);
+        // the subtraction overflows iff the operands differ in sign and the result takes the sign of prev
+        valid &= (((curr ^ prev) & (curr ^ diff)) >= 0);
+        aZigzag[j] = ZIGZAG_ENCODE(int64_t, diff);
+        valid &= (aZigzag[j] < SIMPLE8B_MAX_INT64);
+        aSelector[j] = SIMPLE8B_SELECTOR_OF(aZigzag[j]);
+        prev = curr;
+      }
+      return valid;
+    }
+  }
+
+  return true;
+}
+
 int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
   // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
   // 12  13  14  15
   char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
   int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-  char    bit_to_selector[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 13, 13,
-                               14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
-                               15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
 
   // get the byte limit.
   int32_t word_length = 0;
@@ -127,88 +187,55 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
 
   int32_t byte_limit = nelements * word_length + 1;
   int32_t opos = 1;
-  int64_t prev_value = 0;
+
+  // window of precomputed zigzag deltas covering input[wStart, wEnd)
+  uint64_t aZigzag[SIMPLE8B_WINDOW];
+  char     aSelector[SIMPLE8B_WINDOW];
+  int32_t  wStart = 0;
+  int32_t  wEnd = 0;
 
   for (int32_t i = 0; i < nelements;) {
+    // a word looks at most 241 values ahead
+    if (wEnd < nelements && wEnd - i <= selector_to_elems[0]) {
+      int32_t nKeep = wEnd - i;
+      memmove(aZigzag, aZigzag + (i - wStart), nKeep * sizeof(uint64_t));
+      memmove(aSelector, aSelector + (i - wStart), nKeep);
+      int32_t n = TMIN(nelements - wEnd, SIMPLE8B_WINDOW - nKeep);
+      if (!tsSimple8bZigzag(input, wEnd, n, type, aZigzag + nKeep, aSelector + nKeep)) goto _copy_and_exit;
+      wStart = i;
+      wEnd += n;
+    }
+
+    const uint64_t *pZigzag = aZigzag + (i - wStart);
+    const char     *pSelector = aSelector + (i - wStart);
+    int32_t         nLeft = wEnd - i;
+
     char    selector = 0;
     char    bit = 0;
     int32_t elems = 0;
-    int64_t prev_value_tmp = prev_value;
-
-    for (int32_t j = i; j < nelements; j++) {
-      // Read data from the input stream and convert it to INT64 type.
-      int64_t curr_value = 0;
-      switch (type) {
-        case TSDB_DATA_TYPE_TINYINT:
-          curr_value = (int64_t)(*((int8_t *)input + j));
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          curr_value = (int64_t)(*((int16_t *)input + j));
-          break;
-        case TSDB_DATA_TYPE_INT:
-          curr_value = (int64_t)(*((int32_t *)input + j));
-          break;
-        case TSDB_DATA_TYPE_BIGINT:
-          curr_value = (int64_t)(*((int64_t *)input + j));
-          break;
-      }
-      // Get difference.
-      if (!safeInt64Add(curr_value, -prev_value_tmp)) goto _copy_and_exit;
-
-      int64_t diff = curr_value - prev_value_tmp;
-      // Zigzag encode the value.
-      uint64_t zigzag_value = ZIGZAG_ENCODE(int64_t, diff);
 
-      if (zigzag_value >= SIMPLE8B_MAX_INT64) goto _copy_and_exit;
-
-      int64_t tmp_bit;
-      if (zigzag_value == 0) {
-        // Take care here, __builtin_clzl give wrong anser for value 0;
-        tmp_bit = 0;
-      } else {
-        tmp_bit = (LONG_BYTES * BITS_PER_BYTE) - BUILDIN_CLZL(zigzag_value);
-      }
-
-      if (elems + 1 <= selector_to_elems[(int32_t)selector] &&
-          elems + 1 <= selector_to_elems[(int32_t)(bit_to_selector[(int32_t)tmp_bit])]) {
+    for (int32_t j = 0; j < nLeft; j++) {
+      // selector_to_elems is decreasing, so the word can hold one more value iff the wider selector can
+      char sel = selector > pSelector[j] ? selector : pSelector[j];
+      if (elems + 1 <= selector_to_elems[(int32_t)sel]) {
         // If can hold another one.
-        selector = selector > bit_to_selector[(int32_t)tmp_bit] ? selector : bit_to_selector[(int32_t)tmp_bit];
+        selector = sel;
         elems++;
-        bit = bit_per_integer[(int32_t)selector];
       } else {
         // if cannot hold another one.
         while (elems < selector_to_elems[(int32_t)selector]) selector++;
         elems = selector_to_elems[(int32_t)selector];
-        bit = bit_per_integer[(int32_t)selector];
         break;
       }
-      prev_value_tmp = curr_value;
     }
+    bit = bit_per_integer[(int32_t)selector];
 
     uint64_t buffer = 0;
     buffer |= (uint64_t)selector;
     for (int32_t k = 0; k < elems; k++) {
-      int64_t curr_value = 0; /* get current values */
-      switch (type) {
-        case TSDB_DATA_TYPE_TINYINT:
-          curr_value = (int64_t)(*((int8_t *)input + i));
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          curr_value = (int64_t)(*((int16_t *)input + i));
-          break;
-        case TSDB_DATA_TYPE_INT:
-          curr_value = (int64_t)(*((int32_t *)input + i));
-          break;
-        case TSDB_DATA_TYPE_BIGINT:
-          curr_value = (int64_t)(*((int64_t *)input + i));
-          break;
-      }
-      int64_t  diff = curr_value - prev_value;
-      uint64_t zigzag_value = ZIGZAG_ENCODE(int64_t, diff);
-      buffer |= ((zigzag_value & INT64MASK(bit)) << (bit * k + 4));
-      i++;
-      prev_value = curr_value;
+      buffer |= ((pZigzag[k] & INT64MASK(bit)) << (bit * k + 4));
     }
+    i += elems;
 
     // Output the encoded value to the output.
     if (opos + sizeof(buffer) <= byte_limit) {
@@ -227,8 +254,171 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
   return opos;
 }
 
-int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
+/*
+ * Decompress Integer (Simple8B).
+ *
+ * Each 64-bit word carries a 4-bit selector and a run of zigzag-encoded deltas of the same width. The word is
+ * decoded into int64 values; the AVX2 kernel extracts four deltas at a time with variable shifts and turns them
+ * into values by an in-register prefix sum, the scalar kernel does the same one value at a time. The kernels only
+ * differ in speed, the decoded values are bit-identical.
+ */
+static const char    SIMPLE8B_BIT_PER_INTEGER[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int32_t SIMPLE8B_SELECTOR_TO_ELEMS[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+static FORCE_INLINE int64_t tsDecodeSimple8bWord(uint64_t w, int32_t num, int64_t prev_value, int64_t *p) {
+  int32_t  selector = (int32_t)(w & INT64MASK(4));
+  int32_t  bit = SIMPLE8B_BIT_PER_INTEGER[selector];
+  uint64_t mask = INT64MASK(bit);
+
+  if (selector == 0 || selector == 1) {
+    for (int32_t i = 0; i < num; i++) {
+      p[i] = prev_value;
+    }
+    return prev_value;
+  }
+
+  for (int32_t i = 0, v = 4; i < num; i++, v += bit) {
+    uint64_t zigzag_value = ((w >> v) & mask);
+    prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+    p[i] = prev_value;
+  }
+
+  return prev_value;
+}
+
+#if __AVX2__
+// inclusive prefix sum of four int64 lanes, plus the carry-in broadcasted in prev
+static FORCE_INLINE __m256i tsPrefixSumI64x4(__m256i x, __m256i prev) {
+  // [x0, x0+x1, x2, x2+x3]
+  x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+  // [0, 0, x0+x1, x0+x1]
+  __m256i carry = _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 1, 0, 0)), _mm256_setzero_si256(), 0x0F);
+  x = _mm256_add_epi64(x, carry);
+  return _mm256_add_epi64(x, prev);
+}
+
+// inclusive prefix xor of four int64 lanes, plus the carry-in broadcasted in prev
+static FORCE_INLINE __m256i tsPrefixXorI64x4(__m256i x, __m256i prev) {
+  x = _mm256_xor_si256(x, _mm256_slli_si256(x, 8));
+  __m256i carry = _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 1, 0, 0)), _mm256_setzero_si256(), 0x0F);
+  x = _mm256_xor_si256(x, carry);
+  return _mm256_xor_si256(x, prev);
+}
+
+// inclusive prefix xor of eight int32 lanes, plus the carry-in broadcasted in prev
+static FORCE_INLINE __m256i tsPrefixXorI32x8(__m256i x, __m256i prev) {
+  x = _mm256_xor_si256(x, _mm256_slli_si256(x, 4));
+  x = _mm256_xor_si256(x, _mm256_slli_si256(x, 8));
+  __m256i carry = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(3)), _mm256_setzero_si256(), 0x0F);
+  x = _mm256_xor_si256(x, carry);
+  return _mm256_xor_si256(x, prev);
+}
+
+static FORCE_INLINE int64_t tsDecodeSimple8bWordAVX2(uint64_t w, int32_t num, int64_t prev_value, int64_t *p) {
+  // wide fields leave too few lanes per word to pay for the setup
+  int32_t selector = (int32_t)(w & INT64MASK(4));
+  if (selector == 0 || selector == 1 || num < 8) {
+    return tsDecodeSimple8bWord(w, num, prev_value, p);
+  }
+
+  int32_t  bit = SIMPLE8B_BIT_PER_INTEGER[selector];
+  uint64_t mask = INT64MASK(bit);
+  int32_t  batch = num >> 2;
+
+  __m256i base = _mm256_set1_epi64x(w);
+  __m256i maskVal = _mm256_set1_epi64x(mask);
+  __m256i one = _mm256_set1_epi64x(1);
+  __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
+  __m256i inc = _mm256_set1_epi64x(bit << 2);
+  __m256i prev = _mm256_set1_epi64x(prev_value);
+
+  for (int32_t i = 0; i < batch; ++i) {
+    __m256i zigzagVal = _mm256_and_si256(_mm256_srlv_epi64(base, shiftBits), maskVal);
 
+    // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+    __m256i signmask = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(zigzagVal, one));
+    __m256i delta = _mm256_xor_si256(_mm256_srli_epi64(zigzagVal, 1), signmask);
+
+    prev = tsPrefixSumI64x4(delta, prev);
+    _mm256_storeu_si256((__m256i *)&p[i << 2], prev);
+    prev = _mm256_permute4x64_epi64(prev, _MM_SHUFFLE(3, 3, 3, 3));
+
+    shiftBits = _mm256_add_epi64(shiftBits, inc);
+  }
+
+  if (batch > 0) {
+    prev_value = p[(batch << 2) - 1];
+  }
+
+  // handle the remain values
+  for (int32_t i = batch << 2, v = 4 + bit * (batch << 2); i < num; i++, v += bit) {
+    uint64_t zigzag_value = ((w >> v) & mask);
+    prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+    p[i] = prev_value;
+  }
+
+  return prev_value;
+}
+#endif
+
+#define SIMPLE8B_DECODE(decodeFn, T)                                           \
+  do {                                                                         \
+    T          *p = (T *)output;                                               \
+    const char *ip = input;                                                    \
+    int32_t     _pos = 0;                                                      \
+    int64_t     prev_value = 0;                                                \
+    int64_t     buf[240]; /* max elements in one word */                       \
+    while (_pos < nelements) {                                                 \
+      uint64_t w = 0;                                                          \
+      memcpy(&w, ip, LONG_BYTES);                                              \
+      ip += LONG_BYTES;                                                        \
+                                                                               \
+      int32_t num = SIMPLE8B_SELECTOR_TO_ELEMS[(int32_t)(w & INT64MASK(4))];   \
+      if (num > nelements - _pos) num = nelements - _pos;                      \
+                                                                               \
+      if (sizeof(T) == LONG_BYTES) {                                           \
+        prev_value = decodeFn(w, num, prev_value, (int64_t *)(p + _pos));      \
+      } else {                                                                 \
+        prev_value = decodeFn(w, num, prev_value, buf);                        \
+        for (int32_t i = 0; i < num; i++) {                                    \
+          p[_pos + i] = (T)buf[i];                                             \
+        }                                                                      \
+      }                                                                        \
+      _pos += num;                                                             \
+    }                                                                          \
+  } while (0)
+
+#define SIMPLE8B_DECODE_TYPES(decodeFn)        \
+  do {                                         \
+    switch (type) {                            \
+      case TSDB_DATA_TYPE_BIGINT:              \
+        SIMPLE8B_DECODE(decodeFn, int64_t);    \
+        break;                                 \
+      case TSDB_DATA_TYPE_INT:                 \
+        SIMPLE8B_DECODE(decodeFn, int32_t);    \
+        break;                                 \
+      case TSDB_DATA_TYPE_SMALLINT:            \
+        SIMPLE8B_DECODE(decodeFn, int16_t);    \
+        break;                                 \
+      case TSDB_DATA_TYPE_TINYINT:             \
+        SIMPLE8B_DECODE(decodeFn, int8_t);     \
+        break;                                 \
+    }                                          \
+  } while (0)
+
+static void tsDecompressSimple8b(const char *const input, const int32_t nelements, char *const output,
+                                 const char type) {
+  SIMPLE8B_DECODE_TYPES(tsDecodeSimple8bWord);
+}
+
+#if __AVX2__
+static void tsDecompressSimple8bAVX2(const char *const input, const int32_t nelements, char *const output,
+                                     const char type) {
+  SIMPLE8B_DECODE_TYPES(tsDecodeSimple8bWordAVX2);
+}
+#endif
+
+int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
   int32_t word_length = 0;
   switch (type) {
     case TSDB_DATA_TYPE_BIGINT:
@@ -254,246 +444,16 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
     return nelements * word_length;
   }
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-
-  const char *ip = input + 1;
-  int32_t     count = 0;
-  int32_t     _pos = 0;
-  int64_t     prev_value = 0;
-
+  // the kernel is chosen once for the whole column instead of per word
 #if __AVX2__
-  while (1) {
-    if (_pos == nelements) break;
-
-    uint64_t w = 0;
-    memcpy(&w, ip, LONG_BYTES);
-
-    char    selector = (char)(w & INT64MASK(4));       // selector = 4
-    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
-    int32_t elems = selector_to_elems[(int32_t)selector];
-
-    // Optimize the performance, by remove the constantly switch operation.
-    int32_t  v = 4;
-    uint64_t zigzag_value = 0;
-    uint64_t mask = INT64MASK(bit);
-
-    switch (type) {
-      case TSDB_DATA_TYPE_BIGINT: {
-        int64_t* p = (int64_t*) output;
-
-        int32_t gRemainder = (nelements - _pos);
-        int32_t num = (gRemainder > elems)? elems:gRemainder;
-
-        int32_t batch = num >> 2;
-        int32_t remain = num & 0x03;
-        if (selector == 0 || selector == 1) {
-          if (tsAVX2Enable && tsSIMDBuiltins) {
-            for (int32_t i = 0; i < batch; ++i) {
-              __m256i prev = _mm256_set1_epi64x(prev_value);
-              _mm256_storeu_si256((__m256i *)&p[_pos], prev);
-              _pos += 4;
-            }
-
-            for (int32_t i = 0; i < remain; ++i) {
-              p[_pos++] = prev_value;
-            }
-          } else {
-            for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-              p[_pos++] = prev_value;
-              v += bit;
-            }
-          }
-        } else {
-          if (tsAVX2Enable && tsSIMDBuiltins) {
-            __m256i base = _mm256_set1_epi64x(w);
-            __m256i maskVal = _mm256_set1_epi64x(mask);
-
-            __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
-            __m256i inc = _mm256_set1_epi64x(bit << 2);
-
-            for (int32_t i = 0; i < batch; ++i) {
-              __m256i after = _mm256_srlv_epi64(base, shiftBits);
-              __m256i zigzagVal = _mm256_and_si256(after, maskVal);
-
-              // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
-              __m256i signmask = _mm256_and_si256(_mm256_set1_epi64x(1), zigzagVal);
-              signmask = _mm256_sub_epi64(_mm256_setzero_si256(), signmask);
-              // get the four zigzag values here
-              __m256i delta = _mm256_xor_si256(_mm256_srli_epi64(zigzagVal, 1), signmask);
-
-              // calculate the cumulative sum (prefix sum) for each number
-              // decode[0] = prev_value + final[0]
-              // decode[1] = decode[0] + final[1]   -----> prev_value + final[0] + final[1]
-              // decode[2] = decode[1] + final[2]   -----> prev_value + final[0] + final[1] + final[2]
-              // decode[3] = decode[2] + final[3]   -----> prev_value + final[0] + final[1] + final[2] + final[3]
-
-              //  1, 2, 3, 4
-              //+ 0, 1, 0, 3
-              //  1, 3, 3, 7
-              // shift and add for the first round
-              __m128i prev = _mm_set1_epi64x(prev_value);
-              __m256i x =  _mm256_slli_si256(delta, 8);
-
-              delta = _mm256_add_epi64(delta, x);
-              _mm256_storeu_si256((__m256i *)&p[_pos], delta);
-
-              //  1, 3, 3, 7
-              //+ 0, 0, 3, 3
-              //  1, 3, 6, 10
-              // shift and add operation for the second round
-              __m128i firstPart = _mm_loadu_si128((__m128i *)&p[_pos]);
-              __m128i secondItem = _mm_set1_epi64x(p[_pos + 1]);
-              __m128i secPart = _mm_add_epi64(_mm_loadu_si128((__m128i *)&p[_pos + 2]), secondItem);
-              firstPart = _mm_add_epi64(firstPart, prev);
-              secPart = _mm_add_epi64(secPart, prev);
-
-              // save it in the memory
-              _mm_storeu_si128((__m128i *)&p[_pos], firstPart);
-              _mm_storeu_si128((__m128i *)&p[_pos + 2], secPart);
-
-              shiftBits = _mm256_add_epi64(shiftBits, inc);
-              prev_value = p[_pos + 3];
-//              uDebug("_pos:%d %"PRId64", %"PRId64", %"PRId64", %"PRId64, _pos, p[_pos], p[_pos+1], p[_pos+2], p[_pos+3]);
-              _pos += 4;
-            }
-
-            // handle the remain value
-            for (int32_t i = 0; i < remain; i++) {
-              zigzag_value = ((w >> (v + (batch * bit * 4))) & mask);
-              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-              p[_pos++] = prev_value;
-//              uDebug("_pos:%d %"PRId64, _pos-1, p[_pos-1]);
-
-              v += bit;
-            }
-          } else {
-            for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-              zigzag_value = ((w >> v) & mask);
-              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-              p[_pos++] = prev_value;
-//              uDebug("_pos:%d %"PRId64, _pos-1, p[_pos-1]);
-
-              v += bit;
-            }
-          }
-        }
-      } break;
-      case TSDB_DATA_TYPE_INT: {
-        int32_t* p = (int32_t*) output;
-
-        if (selector == 0 || selector == 1) {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            p[_pos++] = (int32_t)prev_value;
-          }
-        } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-            p[_pos++] = (int32_t)prev_value;
-            v += bit;
-          }
-        }
-      } break;
-      case TSDB_DATA_TYPE_SMALLINT: {
-        int16_t* p = (int16_t*) output;
-
-        if (selector == 0 || selector == 1) {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            p[_pos++] = (int16_t)prev_value;
-          }
-        } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-            p[_pos++] = (int16_t)prev_value;
-            v += bit;
-          }
-        }
-      } break;
-
-      case TSDB_DATA_TYPE_TINYINT: {
-        int8_t *p = (int8_t *)output;
-
-        if (selector == 0 || selector == 1) {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            p[_pos++] = (int8_t)prev_value;
-          }
-        } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-            p[_pos++] = (int8_t)prev_value;
-            v += bit;
-          }
-        }
-      } break;
-    }
-
-    ip += LONG_BYTES;
-  }
-
-  return nelements * word_length;
-#else
-
-  while (1) {
-    if (count == nelements) break;
-
-    uint64_t w = 0;
-    memcpy(&w, ip, LONG_BYTES);
-
-    char    selector = (char)(w & INT64MASK(4));       // selector = 4
-    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
-    int32_t elems = selector_to_elems[(int32_t)selector];
-
-    for (int32_t i = 0; i < elems; i++) {
-      uint64_t zigzag_value;
-
-      if (selector == 0 || selector == 1) {
-        zigzag_value = 0;
-      } else {
-        zigzag_value = ((w >> (4 + bit * i)) & INT64MASK(bit));
-      }
-      int64_t diff = ZIGZAG_DECODE(int64_t, zigzag_value);
-      int64_t curr_value = diff + prev_value;
-      prev_value = curr_value;
-
-      switch (type) {
-        case TSDB_DATA_TYPE_BIGINT:
-          *((int64_t *)output + _pos) = (int64_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_INT:
-          *((int32_t *)output + _pos) = (int32_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          *((int16_t *)output + _pos) = (int16_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_TINYINT:
-          *((int8_t *)output + _pos) = (int8_t)curr_value;
-          _pos++;
-          break;
-        default:
-          perror("Wrong integer types.\n");
-          return -1;
-      }
-      count++;
-      if (count == nelements) break;
-    }
-    ip += LONG_BYTES;
+  if (tsAVX2Enable && tsSIMDBuiltins) {
+    tsDecompressSimple8bAVX2(input + 1, nelements, output, type);
+    return nelements * word_length;
   }
+#endif
 
+  tsDecompressSimple8b(input + 1, nelements, output, type);
   return nelements * word_length;
-#endif
 }
 
 /* ----------------------------------------------Bool Compression
@@ -745,6 +705,61 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
+// little-endian load of 1 to 8 bytes with fixed size loads instead of a variable length memcpy
+static FORCE_INLINE uint64_t tsReadBytesLE(const char *const input, int32_t nbytes) {
+  uint64_t v = 0;
+  if (nbytes >= LONG_BYTES) {
+    memcpy(&v, input, LONG_BYTES);
+    return v;
+  }
+
+  int32_t off = 0;
+  if (nbytes & 4) {
+    uint32_t x;
+    memcpy(&x, input, 4);
+    v = x;
+    off = 4;
+  }
+  if (nbytes & 2) {
+    uint16_t x;
+    memcpy(&x, input + off, 2);
+    v |= ((uint64_t)x) << (off * BITS_PER_BYTE);
+    off += 2;
+  }
+  if (nbytes & 1) {
+    v |= ((uint64_t)(uint8_t)input[off]) << (off * BITS_PER_BYTE);
+  }
+  return v;
+}
+
+// in-place inclusive prefix sum with carry-in, the sums wrap around like the int64 additions of the encoder
+static int64_t tsPrefixSumI64(int64_t *p, int32_t n, int64_t carry) {
+  int32_t i = 0;
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDBuiltins) {
+    __m256i prev = _mm256_set1_epi64x(carry);
+    for (; i + 4 <= n; i += 4) {
+      prev = tsPrefixSumI64x4(_mm256_loadu_si256((__m256i *)&p[i]), prev);
+      _mm256_storeu_si256((__m256i *)&p[i], prev);
+      prev = _mm256_permute4x64_epi64(prev, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    if (i > 0) carry = p[i - 1];
+  }
+#endif
+  for (; i < n; i++) {
+    carry = (int64_t)((uint64_t)carry + (uint64_t)p[i]);
+    p[i] = carry;
+  }
+  return carry;
+}
+
+#define DECOMPRESS_CHUNK_SIZE 256
+
+/*
+ * The timestamps are decoded in chunks of two passes: the delta-of-deltas are unpacked into the output first,
+ * then two prefix sums turn them into deltas and values. Splitting the passes takes the serial additions out of
+ * the byte parsing loop and lets the prefix sums run four lanes at a time, the chunks keep both passes in cache.
+ */
 int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelements, char *const output) {
   ASSERTS(nelements >= 0, "nelements is negative");
   if (nelements == 0) return 0;
@@ -757,58 +772,47 @@ int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelement
 
     int32_t ipos = 1, opos = 0;
     int8_t  nbytes = 0;
+    uint8_t flags = 0;
     int64_t prev_value = 0;
     int64_t prev_delta = 0;
-    int64_t delta_of_delta = 0;
-
-    while (1) {
-      uint8_t flags = input[ipos++];
-      // Decode dd1
-      uint64_t dd1 = 0;
-      nbytes = flags & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd1)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd1, input + ipos, nbytes);
+
+    while (opos < nelements) {
+      int32_t start = opos;
+      int32_t end = TMIN(nelements, start + DECOMPRESS_CHUNK_SIZE);
+
+      for (; opos < end; opos++) {
+        if ((opos & 0x01) == 0) {
+          flags = input[ipos++];
         }
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd1);
-      }
-      ipos += nbytes;
-      if (opos == 0) {
-        prev_value = delta_of_delta;
-        prev_delta = 0;
-        ostream[opos++] = delta_of_delta;
-      } else {
-        prev_delta = delta_of_delta + prev_delta;
-        prev_value = prev_value + prev_delta;
-        ostream[opos++] = prev_value;
+
+        uint64_t dd = 0;
+        nbytes = flags & INT8MASK(4);
+        flags >>= 4;
+        if (nbytes != 0) {
+          if (is_bigendian()) {
+            memcpy(((char *)(&dd)) + LONG_BYTES - nbytes, input + ipos, nbytes);
+          } else {
+            dd = tsReadBytesLE(input + ipos, nbytes);
+          }
+          ipos += nbytes;
+        }
+        ostream[opos] = ZIGZAG_DECODE(int64_t, dd);
       }
-      if (opos == nelements) return nelements * LONG_BYTES;
 
-      // Decode dd2
-      uint64_t dd2 = 0;
-      nbytes = (flags >> 4) & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
+      if (start == 0) {
+        // the first value is stored as is and the delta before the second one is 0
+        prev_value = ostream[0];
+        ostream[0] = 0;
+        prev_delta = tsPrefixSumI64(ostream, end, 0);   // delta of delta -> delta
+        ostream[0] = prev_value;
+        prev_value = tsPrefixSumI64(ostream, end, 0);  // delta -> value
       } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd2)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd2, input + ipos, nbytes);
-        }
-        // zigzag_decoding
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd2);
+        prev_delta = tsPrefixSumI64(ostream + start, end - start, prev_delta);
+        prev_value = tsPrefixSumI64(ostream + start, end - start, prev_value);
       }
-      ipos += nbytes;
-      prev_delta = delta_of_delta + prev_delta;
-      prev_value = prev_value + prev_delta;
-      ostream[opos++] = prev_value;
-      if (opos == nelements) return nelements * LONG_BYTES;
     }
 
+    return nelements * LONG_BYTES;
   } else {
     ASSERT(0);
     return -1;
@@ -924,39 +928,63 @@ uint64_t decodeDoubleValue(const char *const input, int32_t *const ipos, uint8_t
   return diff;
 }
 
-int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements, char *const output) {
-  // output stream
-  double *ostream = (double *)output;
+// in-place inclusive prefix xor with carry-in
+static uint64_t tsPrefixXorU64(uint64_t *p, int32_t n, uint64_t carry) {
+  int32_t i = 0;
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDBuiltins) {
+    __m256i prev = _mm256_set1_epi64x(carry);
+    for (; i + 4 <= n; i += 4) {
+      prev = tsPrefixXorI64x4(_mm256_loadu_si256((__m256i *)&p[i]), prev);
+      _mm256_storeu_si256((__m256i *)&p[i], prev);
+      prev = _mm256_permute4x64_epi64(prev, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    if (i > 0) carry = p[i - 1];
+  }
+#endif
+  for (; i < n; i++) {
+    carry ^= p[i];
+    p[i] = carry;
+  }
+  return carry;
+}
 
+int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements, char *const output) {
   if (input[0] == 1) {
     memcpy(output, input + 1, nelements * DOUBLE_BYTES);
     return nelements * DOUBLE_BYTES;
   }
 
-  uint8_t  flags = 0;
-  int32_t  ipos = 1;
-  int32_t  opos = 0;
-  uint64_t prev_value = 0;
+  // unpack a chunk of xor diffs first, then resolve the values with a prefix xor
+  uint64_t *ostream = (uint64_t *)output;
+  uint8_t   flags = 0;
+  int32_t   ipos = 1;
+  int32_t   opos = 0;
+  uint64_t  prev_value = 0;
 
-  for (int32_t i = 0; i < nelements; i++) {
-    if ((i & 0x01) == 0) {
-      flags = input[ipos++];
-    }
+  while (opos < nelements) {
+    int32_t start = opos;
+    int32_t end = TMIN(nelements, start + DECOMPRESS_CHUNK_SIZE);
 
-    uint8_t flag = flags & INT8MASK(4);
-    flags >>= 4;
+    for (; opos < end; opos++) {
+      if ((opos & 0x01) == 0) {
+        flags = input[ipos++];
+      }
 
-    uint64_t diff = decodeDoubleValue(input, &ipos, flag);
-    union {
-      uint64_t bits;
-      double   real;
-    } curr;
+      uint8_t flag = flags & INT8MASK(4);
+      flags >>= 4;
 
-    uint64_t predicted = prev_value;
-    curr.bits = predicted ^ diff;
-    prev_value = curr.bits;
+      if (is_bigendian()) {
+        ostream[opos] = decodeDoubleValue(input, &ipos, flag);
+      } else {
+        int32_t nbytes = (flag & INT8MASK(3)) + 1;
+        int32_t shift_width = (LONG_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3);
+        ostream[opos] = tsReadBytesLE(input + ipos, nbytes) << shift_width;
+        ipos += nbytes;
+      }
+    }
 
-    ostream[opos++] = curr.real;
+    prev_value = tsPrefixXorU64(ostream + start, end - start, prev_value);
   }
 
   return nelements * DOUBLE_BYTES;
@@ -1071,38 +1099,63 @@ uint32_t decodeFloatValue(const char *const input, int32_t *const ipos, uint8_t
   return diff;
 }
 
-int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, char *const output) {
-  float *ostream = (float *)output;
+// in-place inclusive prefix xor with carry-in
+static uint32_t tsPrefixXorU32(uint32_t *p, int32_t n, uint32_t carry) {
+  int32_t i = 0;
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDBuiltins) {
+    __m256i prev = _mm256_set1_epi32(carry);
+    for (; i + 8 <= n; i += 8) {
+      prev = tsPrefixXorI32x8(_mm256_loadu_si256((__m256i *)&p[i]), prev);
+      _mm256_storeu_si256((__m256i *)&p[i], prev);
+      prev = _mm256_permutevar8x32_epi32(prev, _mm256_set1_epi32(7));
+    }
+    if (i > 0) carry = p[i - 1];
+  }
+#endif
+  for (; i < n; i++) {
+    carry ^= p[i];
+    p[i] = carry;
+  }
+  return carry;
+}
 
+int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, char *const output) {
   if (input[0] == 1) {
     memcpy(output, input + 1, nelements * FLOAT_BYTES);
     return nelements * FLOAT_BYTES;
   }
 
-  uint8_t  flags = 0;
-  int32_t  ipos = 1;
-  int32_t  opos = 0;
-  uint32_t prev_value = 0;
+  // unpack a chunk of xor diffs first, then resolve the values with a prefix xor
+  uint32_t *ostream = (uint32_t *)output;
+  uint8_t   flags = 0;
+  int32_t   ipos = 1;
+  int32_t   opos = 0;
+  uint32_t  prev_value = 0;
 
-  for (int32_t i = 0; i < nelements; i++) {
-    if (i % 2 == 0) {
-      flags = input[ipos++];
-    }
+  while (opos < nelements) {
+    int32_t start = opos;
+    int32_t end = TMIN(nelements, start + DECOMPRESS_CHUNK_SIZE);
 
-    uint8_t flag = flags & INT8MASK(4);
-    flags >>= 4;
+    for (; opos < end; opos++) {
+      if (opos % 2 == 0) {
+        flags = input[ipos++];
+      }
 
-    uint32_t diff = decodeFloatValue(input, &ipos, flag);
-    union {
-      uint32_t bits;
-      float    real;
-    } curr;
+      uint8_t flag = flags & INT8MASK(4);
+      flags >>= 4;
 
-    uint32_t predicted = prev_value;
-    curr.bits = predicted ^ diff;
-    prev_value = curr.bits;
+      if (is_bigendian()) {
+        ostream[opos] = decodeFloatValue(input, &ipos, flag);
+      } else {
+        int32_t nbytes = (flag & INT8MASK(3)) + 1;
+        int32_t shift_width = (FLOAT_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3);
+        ostream[opos] = ((uint32_t)tsReadBytesLE(input + ipos, nbytes)) << shift_width;
+        ipos += nbytes;
+      }
+    }
 
-    ostream[opos++] = curr.real;
+    prev_value = tsPrefixXorU32(ostream + start, end - start, prev_value);
   }
 
   return nelements * FLOAT_BYTES;
@@ -1189,7 +1242,10 @@ static int32_t tCompBool(SCompressor *pCmprsor, const void *pData, int32_t nData
 static int32_t tCompBoolEnd(SCompressor *pCmprsor, const uint8_t **ppData, int32_t *nData);
 
 static int32_t tCompIntStart(SCompressor *pCmprsor, int8_t type, int8_t cmprAlg);
-static int32_t tCompInt(SCompressor *pCmprsor, const void *pData, int32_t nData);
+static int32_t tCompI8(SCompressor *pCmprsor, const void *pData, int32_t nData);
+static int32_t tCompI16(SCompressor *pCmprsor, const void *pData, int32_t nData);
+static int32_t tCompI32(SCompressor *pCmprsor, const void *pData, int32_t nData);
+static int32_t tCompI64(SCompressor *pCmprsor, const void *pData, int32_t nData);
 static int32_t tCompIntEnd(SCompressor *pCmprsor, const uint8_t **ppData, int32_t *nData);
 
 static int32_t tCompFloatStart(SCompressor *pCmprsor, int8_t type, int8_t cmprAlg);
@@ -1248,7 +1304,7 @@ static struct {
      .bytes = 1,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI8,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI8,
      .putI64 = tPutI64OfI8},
@@ -1256,7 +1312,7 @@ static struct {
      .bytes = 2,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI16,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI16,
      .putI64 = tPutI64OfI16},
@@ -1264,7 +1320,7 @@ static struct {
      .bytes = 4,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI32,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI32,
      .putI64 = tPutI64OfI32},
@@ -1272,7 +1328,7 @@ static struct {
      .bytes = 8,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI64,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI64,
      .putI64 = tPutI64OfI64},
@@ -1320,7 +1376,7 @@ static struct {
      .bytes = 1,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI8,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI8,
      .putI64 = tPutI64OfI8},
@@ -1328,7 +1384,7 @@ static struct {
      .bytes = 2,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI16,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI16,
      .putI64 = tPutI64OfI16},
@@ -1336,7 +1392,7 @@ static struct {
      .bytes = 4,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI32,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI32,
      .putI64 = tPutI64OfI32},
@@ -1344,7 +1400,7 @@ static struct {
      .bytes = 8,
      .isVarLen = 0,
      .startFn = tCompIntStart,
-     .cmprFn = tCompInt,
+     .cmprFn = tCompI64,
      .endFn = tCompIntEnd,
      .getI64 = tGetI64OfI64,
      .putI64 = tPutI64OfI64},
@@ -1545,28 +1601,23 @@ static int32_t tCompTimestamp(SCompressor *pCmprsor, const void *pData, int32_t
     pCmprsor->ts_prev_val = ts;
     pCmprsor->ts_prev_delta = delta;
 
+    uint8_t nBytes = vZigzag ? (LONG_BYTES - BUILDIN_CLZL(vZigzag) / BITS_PER_BYTE) : 0;
     if ((pCmprsor->nVal & 0x1) == 0) {
+      // room for the flag and both values of the pair
       if (pCmprsor->autoAlloc && (code = tRealloc(&pCmprsor->pBuf, pCmprsor->nBuf + 17))) {
         return code;
       }
 
       pCmprsor->ts_flag_p = pCmprsor->pBuf + pCmprsor->nBuf;
       pCmprsor->nBuf++;
-      pCmprsor->ts_flag_p[0] = 0;
-      while (vZigzag) {
-        pCmprsor->pBuf[pCmprsor->nBuf] = (vZigzag & 0xff);
-        pCmprsor->nBuf++;
-        pCmprsor->ts_flag_p[0]++;
-        vZigzag >>= 8;
-      }
+      pCmprsor->ts_flag_p[0] = nBytes;
     } else {
-      while (vZigzag) {
-        pCmprsor->pBuf[pCmprsor->nBuf] = (vZigzag & 0xff);
-        pCmprsor->nBuf++;
-        pCmprsor->ts_flag_p[0] += 0x10;
-        vZigzag >>= 8;
-      }
+      pCmprsor->ts_flag_p[0] |= (nBytes << 4);
+    }
+    for (uint8_t i = 0; i < nBytes; i++) {
+      pCmprsor->pBuf[pCmprsor->nBuf + i] = (uint8_t)(vZigzag >> (BITS_PER_BYTE * i));
     }
+    pCmprsor->nBuf += nBytes;
   } else {
   _copy_cmpr:
     if (pCmprsor->autoAlloc && (code = tRealloc(&pCmprsor->pBuf, pCmprsor->nBuf + sizeof(ts)))) {
@@ -1695,13 +1746,13 @@ _exit:
   return code;
 }
 
-static int32_t tCompInt(SCompressor *pCmprsor, const void *pData, int32_t nData) {
+// the value is read by the per-type wrappers below, so no type dispatch happens per value
+static FORCE_INLINE int32_t tCompInt(SCompressor *pCmprsor, int64_t val, const void *pData, int32_t nData) {
   int32_t code = 0;
 
   ASSERT(nData == DATA_TYPE_INFO[pCmprsor->type].bytes);
 
   if (pCmprsor->pBuf[0] == 0) {
-    int64_t val = DATA_TYPE_INFO[pCmprsor->type].getI64(pData);
 
     if (!I64_SAFE_ADD(val, -pCmprsor->i_prev)) {
       code = tCompIntSwitchToCopy(pCmprsor);
@@ -1787,6 +1838,22 @@ static int32_t tCompInt(SCompressor *pCmprsor, const void *pData, int32_t nData)
   return code;
 }
 
+static int32_t tCompI8(SCompressor *pCmprsor, const void *pData, int32_t nData) {
+  return tCompInt(pCmprsor, tGetI64OfI8(pData), pData, nData);
+}
+
+static int32_t tCompI16(SCompressor *pCmprsor, const void *pData, int32_t nData) {
+  return tCompInt(pCmprsor, tGetI64OfI16(pData), pData, nData);
+}
+
+static int32_t tCompI32(SCompressor *pCmprsor, const void *pData, int32_t nData) {
+  return tCompInt(pCmprsor, tGetI64OfI32(pData), pData, nData);
+}
+
+static int32_t tCompI64(SCompressor *pCmprsor, const void *pData, int32_t nData) {
+  return tCompInt(pCmprsor, tGetI64OfI64(pData), pData, nData);
+}
+
 static int32_t tCompIntEnd(SCompressor *pCmprsor, const uint8_t **ppData, int32_t *nData) {
   int32_t code = 0;
 
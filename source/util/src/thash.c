@@ -27,6 +27,11 @@
 
 #define HASH_NEED_RESIZE(_h) ((_h)->size >= (_h)->capacity * HASH_DEFAULT_LOAD_FACTOR)
 
+// the striped hash table picks the sub table by the high bits and the slot in it by the low bits of the hash value
+#define HASH_STRIPE_BITS     4
+#define HASH_STRIPE_NUM      (1 << HASH_STRIPE_BITS)
+#define HASH_STRIPE_INDEX(v) ((v) >> (32 - HASH_STRIPE_BITS))
+
 #define GET_HASH_NODE_KEY(_n)  ((char *)(_n) + sizeof(SHashNode) + (_n)->dataLen)
 #define GET_HASH_NODE_DATA(_n) ((char *)(_n) + sizeof(SHashNode))
 #define GET_HASH_PNODE(_n)     ((SHashNode *)((char *)(_n) - sizeof(SHashNode)))
@@ -67,6 +72,7 @@ struct SHashObj {
   bool              enableUpdate;  // enable update
   SArray           *pMemBlock;     // memory block allocated for SHashEntry
   _hash_before_fn_t callbackFp;    // function invoked before return the value to caller
+  SHashObj        **pStripe;       // sub tables of the HASH_STRIPED_LOCK table, NULL for the others
 //  int64_t           compTimes;
 };
 
@@ -135,6 +141,10 @@ static FORCE_INLINE void taosHashEntryRUnlock(const SHashObj *pHashObj, SHashEnt
   taosRUnLockLatch(&pe->latch);
 }
 
+static FORCE_INLINE SHashObj *taosHashGetStripe(SHashObj *pHashObj, uint32_t hashVal) {
+  return (pHashObj->pStripe == NULL) ? pHashObj : pHashObj->pStripe[HASH_STRIPE_INDEX(hashVal)];
+}
+
 static FORCE_INLINE int32_t taosHashCapacity(int32_t length) {
   int32_t len = (length < HASH_MAX_CAPACITY ? length : HASH_MAX_CAPACITY);
 
@@ -167,6 +177,14 @@ static FORCE_INLINE SHashNode *doSearchInEntryList(SHashObj *pHashObj, SHashEntr
  */
 static void taosHashTableResize(SHashObj *pHashObj);
 
+/**
+ * enlarge the hash list at once to hold num more elements without exceeding the load factor
+ *
+ * @param pHashObj
+ * @param num
+ */
+static void taosHashTableReserve(SHashObj *pHashObj, int64_t num);
+
 /**
  * allocate and initialize a hash node
  *
@@ -234,6 +252,36 @@ static FORCE_INLINE bool taosHashTableEmpty(const SHashObj *pHashObj);
  */
 static FORCE_INLINE bool taosHashTableEmpty(const SHashObj *pHashObj) { return taosHashGetSize(pHashObj) == 0; }
 
+static SHashObj *taosHashInitStriped(size_t capacity, _hash_fn_t fn, bool update) {
+  SHashObj *pHashObj = (SHashObj *)taosMemoryCalloc(1, sizeof(SHashObj));
+  if (pHashObj == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pHashObj->equalFp = memcmp;
+  pHashObj->hashFp = fn;
+  pHashObj->type = HASH_STRIPED_LOCK;
+  pHashObj->enableUpdate = update;
+
+  pHashObj->pStripe = (SHashObj **)taosMemoryCalloc(HASH_STRIPE_NUM, sizeof(SHashObj *));
+  if (pHashObj->pStripe == NULL) {
+    taosMemoryFree(pHashObj);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+    pHashObj->pStripe[i] = taosHashInit(capacity / HASH_STRIPE_NUM, fn, update, HASH_ENTRY_LOCK);
+    if (pHashObj->pStripe[i] == NULL) {
+      taosHashCleanup(pHashObj);
+      return NULL;
+    }
+  }
+
+  return pHashObj;
+}
+
 SHashObj *taosHashInit(size_t capacity, _hash_fn_t fn, bool update, SHashLockTypeE type) {
   if (fn == NULL) {
     assert(0);
@@ -244,6 +292,10 @@ SHashObj *taosHashInit(size_t capacity, _hash_fn_t fn, bool update, SHashLockTyp
     capacity = 4;
   }
 
+  if (type == HASH_STRIPED_LOCK) {
+    return taosHashInitStriped(capacity, fn, update);
+  }
+
   SHashObj *pHashObj = (SHashObj *)taosMemoryMalloc(sizeof(SHashObj));
   if (pHashObj == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -261,6 +313,7 @@ SHashObj *taosHashInit(size_t capacity, _hash_fn_t fn, bool update, SHashLockTyp
   pHashObj->enableUpdate = update;
   pHashObj->freeFp = NULL;
   pHashObj->callbackFp = NULL;
+  pHashObj->pStripe = NULL;
 
   ASSERT((pHashObj->capacity & (pHashObj->capacity - 1)) == 0);
 
@@ -302,12 +355,18 @@ SHashObj *taosHashInit(size_t capacity, _hash_fn_t fn, bool update, SHashLockTyp
 void taosHashSetEqualFp(SHashObj *pHashObj, _equal_fn_t fp) {
   if (pHashObj != NULL && fp != NULL) {
     pHashObj->equalFp = fp;
+    for (int32_t i = 0; pHashObj->pStripe != NULL && i < HASH_STRIPE_NUM; ++i) {
+      pHashObj->pStripe[i]->equalFp = fp;
+    }
   }
 }
 
 void taosHashSetFreeFp(SHashObj *pHashObj, _hash_free_fn_t fp) {
   if (pHashObj != NULL && fp != NULL) {
     pHashObj->freeFp = fp;
+    for (int32_t i = 0; pHashObj->pStripe != NULL && i < HASH_STRIPE_NUM; ++i) {
+      pHashObj->pStripe[i]->freeFp = fp;
+    }
   }
 }
 
@@ -315,41 +374,27 @@ int32_t taosHashGetSize(const SHashObj *pHashObj) {
   if (pHashObj == NULL) {
     return 0;
   }
-  return (int32_t)atomic_load_64((int64_t *)&pHashObj->size);
-}
-
-int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t size) {
-  if (pHashObj == NULL || key == NULL || keyLen == 0) {
-    terrno = TSDB_CODE_INVALID_PTR;
-    return -1;
-  }
 
-  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
-
-  // need the resize process, write lock applied
-  if (HASH_NEED_RESIZE(pHashObj)) {
-    taosHashWLock(pHashObj);
-    taosHashTableResize(pHashObj);
-    taosHashWUnlock(pHashObj);
+  if (pHashObj->pStripe != NULL) {
+    int64_t size = 0;
+    for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+      size += atomic_load_64(&pHashObj->pStripe[i]->size);
+    }
+    return (int32_t)size;
   }
 
-  // disable resize
-  taosHashRLock(pHashObj);
+  return (int32_t)atomic_load_64((int64_t *)&pHashObj->size);
+}
 
+// put one element into the hash table, the caller holds the read lock of the table to disable the resize process
+static int32_t doHashPutInEntry(SHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal, const void *data,
+                                size_t size) {
   uint32_t    slot = HASH_INDEX(hashVal, pHashObj->capacity);
   SHashEntry *pe = pHashObj->hashList[slot];
 
   taosHashEntryWLock(pHashObj, pe);
 
   SHashNode *pNode = pe->next;
-#if 0
-  if (pe->num > 0) {
-    assert(pNode != NULL);
-  } else {
-    assert(pNode == NULL);
-  }
-#endif
-
   SHashNode *prev = NULL;
   while (pNode) {
     if ((pNode->keyLen == keyLen) && (*(pHashObj->equalFp))(GET_HASH_NODE_KEY(pNode), key, keyLen) == 0 &&
@@ -362,42 +407,140 @@ int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const vo
     pNode = pNode->next;
   }
 
+  int32_t code = 0;
   if (pNode == NULL) {
     // no data in hash table with the specified key, add it into hash table
     SHashNode *pNewNode = doCreateHashNode(key, keyLen, data, size, hashVal);
     if (pNewNode == NULL) {
-      return -1;
+      code = -1;
+    } else {
+      pushfrontNodeInEntryList(pe, pNewNode);
+      assert(pe->next != NULL);
+      atomic_add_fetch_64(&pHashObj->size, 1);
+    }
+  } else if (pHashObj->enableUpdate) {
+    SHashNode *pNewNode = doCreateHashNode(key, keyLen, data, size, hashVal);
+    if (pNewNode == NULL) {
+      code = -1;
+    } else {
+      doUpdateHashNode(pHashObj, pe, prev, pNode, pNewNode);
     }
+  } else {
+    // not support the update operation, return error
+    terrno = TSDB_CODE_DUP_KEY;
+    code = HASH_KEY_ALREADY_EXISTS;
+  }
 
-    pushfrontNodeInEntryList(pe, pNewNode);
-    assert(pe->next != NULL);
+  taosHashEntryWUnlock(pHashObj, pe);
+  return code;
+}
 
-    taosHashEntryWUnlock(pHashObj, pe);
+int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t size) {
+  if (pHashObj == NULL || key == NULL || keyLen == 0) {
+    terrno = TSDB_CODE_INVALID_PTR;
+    return -1;
+  }
 
-    // enable resize
-    taosHashRUnlock(pHashObj);
-    atomic_add_fetch_64(&pHashObj->size, 1);
+  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
+  pHashObj = taosHashGetStripe(pHashObj, hashVal);
 
+  // need the resize process, write lock applied
+  if (HASH_NEED_RESIZE(pHashObj)) {
+    taosHashWLock(pHashObj);
+    taosHashTableResize(pHashObj);
+    taosHashWUnlock(pHashObj);
+  }
+
+  // disable resize
+  taosHashRLock(pHashObj);
+  int32_t code = doHashPutInEntry(pHashObj, key, keyLen, hashVal, data, size);
+  taosHashRUnlock(pHashObj);
+
+  return code;
+}
+
+static int32_t doHashPutBatch(SHashObj *pHashObj, const char *keys, size_t keyLen, const char *data, size_t size,
+                              const uint32_t *pHashVal, const int32_t *pIndex, int32_t num) {
+  taosHashWLock(pHashObj);
+  taosHashTableReserve(pHashObj, num);
+  taosHashWUnlock(pHashObj);
+
+  int32_t code = 0;
+
+  taosHashRLock(pHashObj);
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t     idx = (pIndex != NULL) ? pIndex[i] : i;
+    const char *pData = (data != NULL) ? data + idx * size : NULL;
+
+    int32_t ret = doHashPutInEntry(pHashObj, keys + idx * keyLen, keyLen, pHashVal[idx], pData, size);
+    if (ret == -1) {
+      code = -1;
+      break;
+    } else if (ret != 0) {
+      code = ret;
+    }
+  }
+  taosHashRUnlock(pHashObj);
+
+  return code;
+}
+
+int32_t taosHashPutBatch(SHashObj *pHashObj, const void *keys, size_t keyLen, const void *data, size_t size,
+                         int32_t num) {
+  if (pHashObj == NULL || keys == NULL || keyLen == 0) {
+    terrno = TSDB_CODE_INVALID_PTR;
+    return -1;
+  }
+
+  if (num <= 0) {
     return 0;
+  }
+
+  uint32_t *pHashVal = taosMemoryMalloc(num * (sizeof(uint32_t) + sizeof(int32_t)));
+  if (pHashVal == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < num; ++i) {
+    pHashVal[i] = (*pHashObj->hashFp)((const char *)keys + i * keyLen, (uint32_t)keyLen);
+  }
+
+  int32_t code = 0;
+  if (pHashObj->pStripe == NULL) {
+    code = doHashPutBatch(pHashObj, keys, keyLen, data, size, pHashVal, NULL, num);
   } else {
-    // not support the update operation, return error
-    if (pHashObj->enableUpdate) {
-      SHashNode *pNewNode = doCreateHashNode(key, keyLen, data, size, hashVal);
-      if (pNewNode == NULL) {
-        return -1;
-      }
+    // group the elements by sub table, so that each sub table is locked once
+    int32_t *pIndex = (int32_t *)(pHashVal + num);
+    int32_t  offset[HASH_STRIPE_NUM + 1] = {0};
+    for (int32_t i = 0; i < num; ++i) {
+      offset[HASH_STRIPE_INDEX(pHashVal[i]) + 1] += 1;
+    }
+    for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+      offset[i + 1] += offset[i];
+    }
 
-      doUpdateHashNode(pHashObj, pe, prev, pNode, pNewNode);
-    } else {
-      terrno = TSDB_CODE_DUP_KEY;
+    int32_t pos[HASH_STRIPE_NUM];
+    memcpy(pos, offset, sizeof(pos));
+    for (int32_t i = 0; i < num; ++i) {
+      pIndex[pos[HASH_STRIPE_INDEX(pHashVal[i])]++] = i;
     }
 
-    taosHashEntryWUnlock(pHashObj, pe);
+    for (int32_t i = 0; i < HASH_STRIPE_NUM && code != -1; ++i) {
+      int32_t n = offset[i + 1] - offset[i];
+      if (n == 0) {
+        continue;
+      }
 
-    // enable resize
-    taosHashRUnlock(pHashObj);
-    return pHashObj->enableUpdate ? 0 : -2;
+      int32_t ret = doHashPutBatch(pHashObj->pStripe[i], keys, keyLen, data, size, pHashVal, pIndex + offset[i], n);
+      if (ret != 0) {
+        code = ret;
+      }
+    }
   }
+
+  taosMemoryFree(pHashVal);
+  return code;
 }
 
 static void *taosHashGetImpl(SHashObj *pHashObj, const void *key, size_t keyLen, void **d, int32_t *size, bool addRef);
@@ -425,12 +568,13 @@ void *taosHashGetImpl(SHashObj *pHashObj, const void *key, size_t keyLen, void *
     return NULL;
   }
 
+  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
+  pHashObj = taosHashGetStripe(pHashObj, hashVal);
+
   if ((atomic_load_64((int64_t *)&pHashObj->size) == 0)) {
     return NULL;
   }
 
-  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
-
   // only add the read lock to disable the resize process
   taosHashRLock(pHashObj);
 
@@ -503,6 +647,7 @@ int32_t taosHashRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
   }
 
   uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
+  pHashObj = taosHashGetStripe(pHashObj, hashVal);
 
   // disable the resize process
   taosHashRLock(pHashObj);
@@ -561,6 +706,13 @@ void taosHashClear(SHashObj *pHashObj) {
     return;
   }
 
+  if (pHashObj->pStripe != NULL) {
+    for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+      taosHashClear(pHashObj->pStripe[i]);
+    }
+    return;
+  }
+
   SHashNode *pNode, *pNext;
 
   taosHashWLock(pHashObj);
@@ -596,6 +748,15 @@ void taosHashCleanup(SHashObj *pHashObj) {
     return;
   }
 
+  if (pHashObj->pStripe != NULL) {
+    for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+      taosHashCleanup(pHashObj->pStripe[i]);
+    }
+    taosMemoryFree(pHashObj->pStripe);
+    taosMemoryFree(pHashObj);
+    return;
+  }
+
   taosHashClear(pHashObj);
   taosMemoryFreeClear(pHashObj->hashList);
 
@@ -618,6 +779,13 @@ int32_t taosHashGetMaxOverflowLinkLength(const SHashObj *pHashObj) {
 
   int32_t num = 0;
 
+  if (pHashObj->pStripe != NULL) {
+    for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+      num = TMAX(num, taosHashGetMaxOverflowLinkLength(pHashObj->pStripe[i]));
+    }
+    return num;
+  }
+
   taosHashRLock((SHashObj *)pHashObj);
   for (int32_t i = 0; i < pHashObj->size; ++i) {
     SHashEntry *pEntry = pHashObj->hashList[i];
@@ -633,12 +801,30 @@ int32_t taosHashGetMaxOverflowLinkLength(const SHashObj *pHashObj) {
   return num;
 }
 
+static void doHashTableResize(SHashObj *pHashObj, int32_t newCapacity);
+
 void taosHashTableResize(SHashObj *pHashObj) {
   if (!HASH_NEED_RESIZE(pHashObj)) {
     return;
   }
 
-  int32_t newCapacity = (int32_t)(pHashObj->capacity << 1u);
+  doHashTableResize(pHashObj, (int32_t)(pHashObj->capacity << 1u));
+}
+
+void taosHashTableReserve(SHashObj *pHashObj, int64_t num) {
+  int64_t expect = (int64_t)((pHashObj->size + num) / HASH_DEFAULT_LOAD_FACTOR) + 1;
+  if (expect <= pHashObj->capacity) {
+    return;
+  }
+
+  int32_t newCapacity = taosHashCapacity((int32_t)TMIN(expect, HASH_MAX_CAPACITY));
+  if (newCapacity > pHashObj->capacity) {
+    doHashTableResize(pHashObj, newCapacity);
+  }
+}
+
+// the nodes in slot idx are moved to the slots with the same low bits, which are all behind idx
+static void doHashTableResize(SHashObj *pHashObj, int32_t newCapacity) {
   if (newCapacity > HASH_MAX_CAPACITY) {
     //    uDebug("current capacity:%zu, maximum capacity:%d, no resize applied due to limitation is reached",
     //           pHashObj->capacity, HASH_MAX_CAPACITY);
@@ -742,6 +928,14 @@ size_t taosHashGetMemSize(const SHashObj *pHashObj) {
     return 0;
   }
 
+  if (pHashObj->pStripe != NULL) {
+    size_t size = sizeof(SHashObj) + HASH_STRIPE_NUM * sizeof(void *);
+    for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+      size += taosHashGetMemSize(pHashObj->pStripe[i]);
+    }
+    return size;
+  }
+
   return (pHashObj->capacity * (sizeof(SHashEntry) + sizeof(void *))) + sizeof(SHashNode) * taosHashGetSize(pHashObj) +
          sizeof(SHashObj);
 }
@@ -804,7 +998,29 @@ static void *taosHashReleaseNode(SHashObj *pHashObj, void *p, int *slot) {
   return pNode;
 }
 
+static void *taosHashIterateStriped(SHashObj *pHashObj, void *p) {
+  int32_t i = 0;
+  if (p != NULL) {
+    i = HASH_STRIPE_INDEX(GET_HASH_PNODE(p)->hashVal);
+    void *data = taosHashIterate(pHashObj->pStripe[i], p);
+    if (data != NULL) {
+      return data;
+    }
+    i += 1;
+  }
+
+  for (; i < HASH_STRIPE_NUM; ++i) {
+    void *data = taosHashIterate(pHashObj->pStripe[i], NULL);
+    if (data != NULL) {
+      return data;
+    }
+  }
+
+  return NULL;
+}
+
 void *taosHashIterate(SHashObj *pHashObj, void *p) {
+  if (pHashObj != NULL && pHashObj->pStripe != NULL) return taosHashIterateStriped(pHashObj, p);
   if (pHashObj == NULL || pHashObj->size == 0) return NULL;
 
   int   slot = 0;
@@ -876,6 +1092,8 @@ void *taosHashIterate(SHashObj *pHashObj, void *p) {
 void taosHashCancelIterate(SHashObj *pHashObj, void *p) {
   if (pHashObj == NULL || p == NULL) return;
 
+  pHashObj = taosHashGetStripe(pHashObj, GET_HASH_PNODE(p)->hashVal);
+
   // only add the read lock to disable the resize process
   taosHashRLock(pHashObj);
 
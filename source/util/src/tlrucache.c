@@ -23,6 +23,7 @@
 
 typedef struct SLRUEntry      SLRUEntry;
 typedef struct SLRUEntryTable SLRUEntryTable;
+typedef struct SLRUFreqSketch SLRUFreqSketch;
 typedef struct SLRUCacheShard SLRUCacheShard;
 typedef struct SShardedCache  SShardedCache;
 
@@ -30,12 +31,11 @@ enum {
   TAOS_LRU_IN_CACHE = (1 << 0),  // Whether this entry is referenced by the hash table.
 
   TAOS_LRU_IS_HIGH_PRI = (1 << 1),  // Whether this entry is high priority entry.
-
-  TAOS_LRU_IN_HIGH_PRI_POOL = (1 << 2),  // Whether this entry is in high-pri pool.
-
-  TAOS_LRU_HAS_HIT = (1 << 3),  // Whether this entry has had any lookups (hits).
 };
 
+// Entries of a shard form a CLOCK ring. A lookup only sets the visited bit and takes a reference, both atomically, so
+// hits share the shard lock instead of serializing on it. The hash table holds one reference of its own, an entry is
+// freed when the last reference goes away.
 struct SLRUEntry {
   void               *value;
   _taos_lru_deleter_t deleter;
@@ -45,15 +45,14 @@ struct SLRUEntry {
   size_t              totalCharge;
   size_t              keyLength;
   uint32_t            hash;
-  uint32_t            refs;
+  int32_t             refs;
+  int8_t              visited;
   uint8_t             flags;
   char                keyData[1];
 };
 
-#define TAOS_LRU_ENTRY_IN_CACHE(h)     ((h)->flags & TAOS_LRU_IN_CACHE)
-#define TAOS_LRU_ENTRY_IN_HIGH_POOL(h) ((h)->flags & TAOS_LRU_IN_HIGH_PRI_POOL)
-#define TAOS_LRU_ENTRY_IS_HIGH_PRI(h)  ((h)->flags & TAOS_LRU_IS_HIGH_PRI)
-#define TAOS_LRU_ENTRY_HAS_HIT(h)      ((h)->flags & TAOS_LRU_HAS_HIT)
+#define TAOS_LRU_ENTRY_IN_CACHE(h)    ((h)->flags & TAOS_LRU_IN_CACHE)
+#define TAOS_LRU_ENTRY_IS_HIGH_PRI(h) ((h)->flags & TAOS_LRU_IS_HIGH_PRI)
 
 #define TAOS_LRU_ENTRY_SET_IN_CACHE(h, inCache) \
   do {                                          \
@@ -63,14 +62,6 @@ struct SLRUEntry {
       (h)->flags &= ~TAOS_LRU_IN_CACHE;         \
     }                                           \
   } while (0)
-#define TAOS_LRU_ENTRY_SET_IN_HIGH_POOL(h, inHigh) \
-  do {                                             \
-    if (inHigh) {                                  \
-      (h)->flags |= TAOS_LRU_IN_HIGH_PRI_POOL;     \
-    } else {                                       \
-      (h)->flags &= ~TAOS_LRU_IN_HIGH_PRI_POOL;    \
-    }                                              \
-  } while (0)
 #define TAOS_LRU_ENTRY_SET_PRIORITY(h, priority) \
   do {                                           \
     if (priority == TAOS_LRU_PRIORITY_HIGH) {    \
@@ -79,15 +70,16 @@ struct SLRUEntry {
       (h)->flags &= ~TAOS_LRU_IS_HIGH_PRI;       \
     }                                            \
   } while (0)
-#define TAOS_LRU_ENTRY_SET_HIT(h) ((h)->flags |= TAOS_LRU_HAS_HIT)
 
-#define TAOS_LRU_ENTRY_HAS_REFS(h) ((h)->refs > 0)
-#define TAOS_LRU_ENTRY_REF(h)      (++(h)->refs)
+// references held by handles, the one held by the hash table excluded
+#define TAOS_LRU_ENTRY_HANDLE_REFS(h) (atomic_load_32(&(h)->refs) - (TAOS_LRU_ENTRY_IN_CACHE(h) ? 1 : 0))
+#define TAOS_LRU_ENTRY_HAS_REFS(h)    (TAOS_LRU_ENTRY_HANDLE_REFS(h) > 0)
+#define TAOS_LRU_ENTRY_REF(h)         atomic_add_fetch_32(&(h)->refs, 1)
 
 static bool taosLRUEntryUnref(SLRUEntry *entry) {
-  assert(entry->refs > 0);
-  --entry->refs;
-  return entry->refs == 0;
+  int32_t refs = atomic_sub_fetch_32(&entry->refs, 1);
+  assert(refs >= 0);
+  return refs == 0;
 }
 
 static void taosLRUEntryFree(SLRUEntry *entry) {
@@ -136,6 +128,7 @@ static void taosLRUEntryTableApply(SLRUEntryTable *table, _taos_lru_table_func_t
 
 static void taosLRUEntryTableFree(SLRUEntry *entry) {
   if (!TAOS_LRU_ENTRY_HAS_REFS(entry)) {
+    entry->refs = 0;
     taosLRUEntryFree(entry);
   }
 }
@@ -221,112 +214,206 @@ static SLRUEntry *taosLRUEntryTableRemove(SLRUEntryTable *table, const void *key
   return result;
 }
 
+// Count-min sketch of the access frequency of keys, used by the TinyLFU admission. Counters saturate at 15 and are
+// halved once enough accesses have been sampled, so old popularity fades out.
+#define TAOS_LRU_SKETCH_DEPTH       4
+#define TAOS_LRU_SKETCH_MAX_FREQ    15
+#define TAOS_LRU_SKETCH_MIN_BITS    8
+#define TAOS_LRU_SKETCH_MAX_BITS    16
+#define TAOS_LRU_SKETCH_SAMPLE_RATE 10
+
+struct SLRUFreqSketch {
+  int8_t *counters;
+  int32_t widthBits;
+  int32_t samples;
+  int32_t resetAt;
+};
+
+static const uint32_t sketchSeeds[TAOS_LRU_SKETCH_DEPTH] = {0x97cb3127, 0xb492b66f, 0x9ae16a3b, 0x85ebca6b};
+
+static int taosLRUFreqSketchInit(SLRUFreqSketch *sketch, size_t capacity) {
+  // assume entries of some hundreds of bytes, a wider sketch does not pay off
+  int32_t widthBits = TAOS_LRU_SKETCH_MIN_BITS;
+  while (widthBits < TAOS_LRU_SKETCH_MAX_BITS && ((size_t)1 << widthBits) < capacity / 256) {
+    ++widthBits;
+  }
+
+  sketch->counters = taosMemoryCalloc(TAOS_LRU_SKETCH_DEPTH << widthBits, sizeof(int8_t));
+  if (!sketch->counters) {
+    return -1;
+  }
+
+  sketch->widthBits = widthBits;
+  sketch->samples = 0;
+  sketch->resetAt = TAOS_LRU_SKETCH_SAMPLE_RATE << widthBits;
+
+  return 0;
+}
+
+static void taosLRUFreqSketchCleanup(SLRUFreqSketch *sketch) {
+  taosMemoryFreeClear(sketch->counters);
+  sketch->widthBits = 0;
+}
+
+static FORCE_INLINE int8_t *taosLRUFreqSketchCounter(SLRUFreqSketch *sketch, uint32_t hash, int32_t row) {
+  uint32_t h = (hash ^ (hash >> 16)) * sketchSeeds[row];
+  return sketch->counters + ((size_t)row << sketch->widthBits) + (h >> (32 - sketch->widthBits));
+}
+
+// called with the shard lock held in either mode, a lost increment only makes the estimate a bit lower
+static void taosLRUFreqSketchIncrease(SLRUFreqSketch *sketch, uint32_t hash) {
+  for (int32_t i = 0; i < TAOS_LRU_SKETCH_DEPTH; ++i) {
+    int8_t *counter = taosLRUFreqSketchCounter(sketch, hash, i);
+    int8_t  freq = atomic_load_8(counter);
+    if (freq < TAOS_LRU_SKETCH_MAX_FREQ) {
+      atomic_val_compare_exchange_8(counter, freq, freq + 1);
+    }
+  }
+  atomic_add_fetch_32(&sketch->samples, 1);
+}
+
+static int32_t taosLRUFreqSketchEstimate(SLRUFreqSketch *sketch, uint32_t hash) {
+  int32_t freq = TAOS_LRU_SKETCH_MAX_FREQ;
+  for (int32_t i = 0; i < TAOS_LRU_SKETCH_DEPTH; ++i) {
+    freq = TMIN(freq, atomic_load_8(taosLRUFreqSketchCounter(sketch, hash, i)));
+  }
+  return freq;
+}
+
+// called with the shard lock held exclusively
+static void taosLRUFreqSketchAge(SLRUFreqSketch *sketch) {
+  if (sketch->samples < sketch->resetAt) {
+    return;
+  }
+
+  size_t size = TAOS_LRU_SKETCH_DEPTH << sketch->widthBits;
+  for (size_t i = 0; i < size; ++i) {
+    sketch->counters[i] >>= 1;
+  }
+  sketch->samples >>= 1;
+}
+
 struct SLRUCacheShard {
   size_t         capacity;
-  size_t         highPriPoolUsage;
   bool           strictCapacity;
   double         highPriPoolRatio;
-  double         highPriPoolCapacity;
-  SLRUEntry      lru;
-  SLRUEntry     *lruLowPri;
+  LRUAdmission   admission;
+  SLRUEntry      lru;        // sentinel of the CLOCK ring
+  SLRUEntry     *clockHand;  // next entry the eviction looks at
   SLRUEntryTable table;
-  size_t         usage;     // Memory size for entries residing in the cache.
-  size_t         lruUsage;  // Memory size for entries residing only in the LRU list.
-  TdThreadMutex  mutex;
+  SLRUFreqSketch sketch;
+  int64_t        usage;  // Memory size for entries residing in the cache, written under the exclusive lock but read without it on release
+  SLRUCacheStat  stat;
+  TdThreadRwlock lock;
 };
 
 #define TAOS_LRU_CACHE_SHARD_HASH32(key, len) (MurmurHash3_32((key), (len)))
 
-static void taosLRUCacheShardMaintainPoolSize(SLRUCacheShard *shard) {
-  while (shard->highPriPoolUsage > shard->highPriPoolCapacity) {
-    shard->lruLowPri = shard->lruLowPri->next;
-    assert(shard->lruLowPri != &shard->lru);
-    TAOS_LRU_ENTRY_SET_IN_HIGH_POOL(shard->lruLowPri, false);
-
-    assert(shard->highPriPoolUsage >= shard->lruLowPri->totalCharge);
-    shard->highPriPoolUsage -= shard->lruLowPri->totalCharge;
-  }
-}
-
 static void taosLRUCacheShardLRUInsert(SLRUCacheShard *shard, SLRUEntry *e) {
   assert(e->next == NULL);
   assert(e->prev == NULL);
 
-  if (shard->highPriPoolRatio > 0 && (TAOS_LRU_ENTRY_IS_HIGH_PRI(e) || TAOS_LRU_ENTRY_HAS_HIT(e))) {
-    e->next = &shard->lru;
-    e->prev = shard->lru.prev;
-
-    e->prev->next = e;
-    e->next->prev = e;
+  // right behind the hand, so a new entry gets a whole round before it is looked at
+  e->next = shard->clockHand;
+  e->prev = shard->clockHand->prev;
 
-    TAOS_LRU_ENTRY_SET_IN_HIGH_POOL(e, true);
-    shard->highPriPoolUsage += e->totalCharge;
-    taosLRUCacheShardMaintainPoolSize(shard);
-  } else {
-    e->next = shard->lruLowPri->next;
-    e->prev = shard->lruLowPri;
+  e->prev->next = e;
+  e->next->prev = e;
 
-    e->prev->next = e;
-    e->next->prev = e;
-
-    TAOS_LRU_ENTRY_SET_IN_HIGH_POOL(e, false);
-    shard->lruLowPri = e;
-  }
-
-  shard->lruUsage += e->totalCharge;
+  // high priority entries get a second chance when the cache reserves room for them
+  e->visited = (shard->highPriPoolRatio > 0 && TAOS_LRU_ENTRY_IS_HIGH_PRI(e)) ? 1 : 0;
 }
 
 static void taosLRUCacheShardLRURemove(SLRUCacheShard *shard, SLRUEntry *e) {
   assert(e->next);
   assert(e->prev);
 
-  if (shard->lruLowPri == e) {
-    shard->lruLowPri = e->prev;
+  if (shard->clockHand == e) {
+    shard->clockHand = e->next;
   }
   e->next->prev = e->prev;
   e->prev->next = e->next;
   e->prev = e->next = NULL;
+}
+
+// Remove e from the cache, the reference held by the hash table is dropped and e is appended to deleted if that was
+// the last one.
+static void taosLRUCacheShardDetach(SLRUCacheShard *shard, SLRUEntry *e, SArray *deleted) {
+  taosLRUCacheShardLRURemove(shard, e);
+  TAOS_LRU_ENTRY_SET_IN_CACHE(e, false);
+  assert(shard->usage >= e->totalCharge);
+  atomic_sub_fetch_64(&shard->usage, e->totalCharge);
+
+  if (taosLRUEntryUnref(e)) {
+    taosArrayPush(deleted, &e);
+  }
+}
 
-  assert(shard->lruUsage >= e->totalCharge);
-  shard->lruUsage -= e->totalCharge;
-  if (TAOS_LRU_ENTRY_IN_HIGH_POOL(e)) {
-    assert(shard->highPriPoolUsage >= e->totalCharge);
-    shard->highPriPoolUsage -= e->totalCharge;
+static SLRUEntry *taosLRUCacheShardFindVictim(SLRUCacheShard *shard) {
+  // the first round clears the visited bits, an unpinned entry must turn up in the second one
+  uint32_t steps = 2 * shard->table.elems + 2;
+  while (steps-- > 0) {
+    SLRUEntry *e = shard->clockHand;
+    shard->clockHand = e->next;
+    if (e == &shard->lru) {
+      continue;
+    }
+
+    if (atomic_load_32(&e->refs) > 1) {
+      continue;
+    }
+    if (atomic_load_8(&e->visited)) {
+      atomic_store_8(&e->visited, 0);
+      continue;
+    }
+
+    return e;
   }
+
+  return NULL;
 }
 
-static void taosLRUCacheShardEvictLRU(SLRUCacheShard *shard, size_t charge, SArray *deleted) {
-  while (shard->usage + charge > shard->capacity && shard->lru.next != &shard->lru) {
-    SLRUEntry *old = shard->lru.next;
-    assert(TAOS_LRU_ENTRY_IN_CACHE(old) && !TAOS_LRU_ENTRY_HAS_REFS(old));
+// Make room for charge, a negative freq means the caller is to be admitted whatever it costs. Returns false if the
+// caller lost the admission against a victim that is accessed more often.
+static bool taosLRUCacheShardEvictLRU(SLRUCacheShard *shard, size_t charge, int32_t freq, SArray *deleted) {
+  while (shard->usage + charge > shard->capacity && shard->table.elems > 0) {
+    SLRUEntry *old = taosLRUCacheShardFindVictim(shard);
+    if (old == NULL) {
+      break;
+    }
+
+    assert(TAOS_LRU_ENTRY_IN_CACHE(old));
+    if (freq >= 0 && taosLRUFreqSketchEstimate(&shard->sketch, old->hash) > freq) {
+      return false;
+    }
 
-    taosLRUCacheShardLRURemove(shard, old);
     taosLRUEntryTableRemove(&shard->table, old->keyData, old->keyLength, old->hash);
+    taosLRUCacheShardDetach(shard, old, deleted);
+    atomic_add_fetch_64(&shard->stat.evictions, 1);
+  }
 
-    TAOS_LRU_ENTRY_SET_IN_CACHE(old, false);
-    assert(shard->usage >= old->totalCharge);
-    shard->usage -= old->totalCharge;
+  return true;
+}
 
-    taosArrayPush(deleted, &old);
+static void taosLRUCacheShardFreeEntries(SArray *deleted) {
+  for (int i = 0; i < taosArrayGetSize(deleted); ++i) {
+    SLRUEntry *entry = taosArrayGetP(deleted, i);
+    taosLRUEntryFree(entry);
   }
+  taosArrayDestroy(deleted);
 }
 
 static void taosLRUCacheShardSetCapacity(SLRUCacheShard *shard, size_t capacity) {
   SArray *lastReferenceList = taosArrayInit(16, POINTER_BYTES);
 
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockWrlock(&shard->lock);
 
   shard->capacity = capacity;
-  shard->highPriPoolCapacity = capacity * shard->highPriPoolRatio;
-  taosLRUCacheShardEvictLRU(shard, 0, lastReferenceList);
+  taosLRUCacheShardEvictLRU(shard, 0, -1, lastReferenceList);
 
-  taosThreadMutexUnlock(&shard->mutex);
+  taosThreadRwlockUnlock(&shard->lock);
 
-  for (int i = 0; i < taosArrayGetSize(lastReferenceList); ++i) {
-    SLRUEntry *entry = taosArrayGetP(lastReferenceList, i);
-    taosLRUEntryFree(entry);
-  }
-  taosArrayDestroy(lastReferenceList);
+  taosLRUCacheShardFreeEntries(lastReferenceList);
 }
 
 static int taosLRUCacheShardInit(SLRUCacheShard *shard, size_t capacity, bool strict, double highPriPoolRatio,
@@ -335,22 +422,20 @@ static int taosLRUCacheShardInit(SLRUCacheShard *shard, size_t capacity, bool st
     return -1;
   }
 
-  taosThreadMutexInit(&shard->mutex, NULL);
+  taosThreadRwlockInit(&shard->lock, NULL);
 
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockWrlock(&shard->lock);
   shard->capacity = 0;
-  shard->highPriPoolUsage = 0;
   shard->strictCapacity = strict;
   shard->highPriPoolRatio = highPriPoolRatio;
-  shard->highPriPoolCapacity = 0;
+  shard->admission = TAOS_LRU_ADMIT_ALL;
 
   shard->usage = 0;
-  shard->lruUsage = 0;
 
   shard->lru.next = &shard->lru;
   shard->lru.prev = &shard->lru;
-  shard->lruLowPri = &shard->lru;
-  taosThreadMutexUnlock(&shard->mutex);
+  shard->clockHand = &shard->lru;
+  taosThreadRwlockUnlock(&shard->lock);
 
   taosLRUCacheShardSetCapacity(shard, capacity);
 
@@ -358,9 +443,10 @@ static int taosLRUCacheShardInit(SLRUCacheShard *shard, size_t capacity, bool st
 }
 
 static void taosLRUCacheShardCleanup(SLRUCacheShard *shard) {
-  taosThreadMutexDestroy(&shard->mutex);
+  taosThreadRwlockDestroy(&shard->lock);
 
   taosLRUEntryTableCleanup(&shard->table);
+  taosLRUFreqSketchCleanup(&shard->sketch);
 }
 
 static LRUStatus taosLRUCacheShardInsertEntry(SLRUCacheShard *shard, SLRUEntry *e, LRUHandle **handle,
@@ -368,11 +454,25 @@ static LRUStatus taosLRUCacheShardInsertEntry(SLRUCacheShard *shard, SLRUEntry *
   LRUStatus status = TAOS_LRU_STATUS_OK;
   SArray   *lastReferenceList = taosArrayInit(16, POINTER_BYTES);
 
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockWrlock(&shard->lock);
 
-  taosLRUCacheShardEvictLRU(shard, e->totalCharge, lastReferenceList);
+  int32_t freq = -1;
+  if (shard->admission == TAOS_LRU_ADMIT_TINY_LFU) {
+    taosLRUFreqSketchAge(&shard->sketch);
+    freq = taosLRUFreqSketchEstimate(&shard->sketch, e->hash);
+  }
 
-  if (shard->usage + e->totalCharge > shard->capacity && (shard->strictCapacity || handle == NULL)) {
+  if (!taosLRUCacheShardEvictLRU(shard, e->totalCharge, freq, lastReferenceList)) {
+    // not worth a place in the cache, but the caller still gets the value it asked for
+    TAOS_LRU_ENTRY_SET_IN_CACHE(e, false);
+    if (handle == NULL) {
+      taosArrayPush(lastReferenceList, &e);
+    } else {
+      TAOS_LRU_ENTRY_REF(e);
+      *handle = (LRUHandle *)e;
+    }
+    atomic_add_fetch_64(&shard->stat.rejections, 1);
+  } else if (shard->usage + e->totalCharge > shard->capacity && (shard->strictCapacity || handle == NULL)) {
     TAOS_LRU_ENTRY_SET_IN_CACHE(e, false);
     if (handle == NULL) {
       taosArrayPush(lastReferenceList, &e);
@@ -387,39 +487,26 @@ static LRUStatus taosLRUCacheShardInsertEntry(SLRUCacheShard *shard, SLRUEntry *
     }
   } else {
     SLRUEntry *old = taosLRUEntryTableInsert(&shard->table, e);
-    shard->usage += e->totalCharge;
+    TAOS_LRU_ENTRY_REF(e);
+    atomic_add_fetch_64(&shard->usage, e->totalCharge);
     if (old != NULL) {
       status = TAOS_LRU_STATUS_OK_OVERWRITTEN;
 
       assert(TAOS_LRU_ENTRY_IN_CACHE(old));
-      TAOS_LRU_ENTRY_SET_IN_CACHE(old, false);
-      if (!TAOS_LRU_ENTRY_HAS_REFS(old)) {
-        taosLRUCacheShardLRURemove(shard, old);
-        assert(shard->usage >= old->totalCharge);
-        shard->usage -= old->totalCharge;
-
-        taosArrayPush(lastReferenceList, &old);
-      }
+      taosLRUCacheShardDetach(shard, old, lastReferenceList);
     }
-    if (handle == NULL) {
-      taosLRUCacheShardLRUInsert(shard, e);
-    } else {
-      if (!TAOS_LRU_ENTRY_HAS_REFS(e)) {
-        TAOS_LRU_ENTRY_REF(e);
-      }
+    taosLRUCacheShardLRUInsert(shard, e);
+    if (handle != NULL) {
+      TAOS_LRU_ENTRY_REF(e);
 
       *handle = (LRUHandle *)e;
     }
+    atomic_add_fetch_64(&shard->stat.inserts, 1);
   }
 
-  taosThreadMutexUnlock(&shard->mutex);
+  taosThreadRwlockUnlock(&shard->lock);
 
-  for (int i = 0; i < taosArrayGetSize(lastReferenceList); ++i) {
-    SLRUEntry *entry = taosArrayGetP(lastReferenceList, i);
-
-    taosLRUEntryFree(entry);
-  }
-  taosArrayDestroy(lastReferenceList);
+  taosLRUCacheShardFreeEntries(lastReferenceList);
 
   return status;
 }
@@ -452,83 +539,70 @@ static LRUStatus taosLRUCacheShardInsert(SLRUCacheShard *shard, const void *key,
 static LRUHandle *taosLRUCacheShardLookup(SLRUCacheShard *shard, const void *key, size_t keyLen, uint32_t hash) {
   SLRUEntry *e = NULL;
 
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockRdlock(&shard->lock);
+  if (shard->admission == TAOS_LRU_ADMIT_TINY_LFU) {
+    taosLRUFreqSketchIncrease(&shard->sketch, hash);
+  }
+
   e = taosLRUEntryTableLookup(&shard->table, key, keyLen, hash);
   if (e != NULL) {
     assert(TAOS_LRU_ENTRY_IN_CACHE(e));
-    if (!TAOS_LRU_ENTRY_HAS_REFS(e)) {
-      taosLRUCacheShardLRURemove(shard, e);
-    }
     TAOS_LRU_ENTRY_REF(e);
-    TAOS_LRU_ENTRY_SET_HIT(e);
+    if (!atomic_load_8(&e->visited)) {
+      atomic_store_8(&e->visited, 1);
+    }
   }
 
-  taosThreadMutexUnlock(&shard->mutex);
+  taosThreadRwlockUnlock(&shard->lock);
+
+  atomic_add_fetch_64(e != NULL ? &shard->stat.hits : &shard->stat.misses, 1);
 
   return (LRUHandle *)e;
 }
 
 static void taosLRUCacheShardErase(SLRUCacheShard *shard, const void *key, size_t keyLen, uint32_t hash) {
-  bool lastReference = false;
-  taosThreadMutexLock(&shard->mutex);
+  SArray *lastReferenceList = taosArrayInit(1, POINTER_BYTES);
+
+  taosThreadRwlockWrlock(&shard->lock);
 
   SLRUEntry *e = taosLRUEntryTableRemove(&shard->table, key, keyLen, hash);
   if (e != NULL) {
     assert(TAOS_LRU_ENTRY_IN_CACHE(e));
-    TAOS_LRU_ENTRY_SET_IN_CACHE(e, false);
-    if (!TAOS_LRU_ENTRY_HAS_REFS(e)) {
-      taosLRUCacheShardLRURemove(shard, e);
-
-      assert(shard->usage >= e->totalCharge);
-      shard->usage -= e->totalCharge;
-      lastReference = true;
-    }
+    taosLRUCacheShardDetach(shard, e, lastReferenceList);
   }
 
-  taosThreadMutexUnlock(&shard->mutex);
+  taosThreadRwlockUnlock(&shard->lock);
 
-  if (lastReference) {
-    taosLRUEntryFree(e);
-  }
+  taosLRUCacheShardFreeEntries(lastReferenceList);
 }
 
 static void taosLRUCacheShardEraseUnrefEntries(SLRUCacheShard *shard) {
   SArray *lastReferenceList = taosArrayInit(16, POINTER_BYTES);
 
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockWrlock(&shard->lock);
 
-  while (shard->lru.next != &shard->lru) {
-    SLRUEntry *old = shard->lru.next;
-    assert(TAOS_LRU_ENTRY_IN_CACHE(old) && !TAOS_LRU_ENTRY_HAS_REFS(old));
-    taosLRUCacheShardLRURemove(shard, old);
-    taosLRUEntryTableRemove(&shard->table, old->keyData, old->keyLength, old->hash);
-    TAOS_LRU_ENTRY_SET_IN_CACHE(old, false);
-    assert(shard->usage >= old->totalCharge);
-    shard->usage -= old->totalCharge;
-
-    taosArrayPush(lastReferenceList, &old);
+  SLRUEntry *e = shard->lru.next;
+  while (e != &shard->lru) {
+    SLRUEntry *next = e->next;
+    assert(TAOS_LRU_ENTRY_IN_CACHE(e));
+    if (!TAOS_LRU_ENTRY_HAS_REFS(e)) {
+      taosLRUEntryTableRemove(&shard->table, e->keyData, e->keyLength, e->hash);
+      taosLRUCacheShardDetach(shard, e, lastReferenceList);
+    }
+    e = next;
   }
 
-  taosThreadMutexUnlock(&shard->mutex);
-
-  for (int i = 0; i < taosArrayGetSize(lastReferenceList); ++i) {
-    SLRUEntry *entry = taosArrayGetP(lastReferenceList, i);
+  taosThreadRwlockUnlock(&shard->lock);
 
-    taosLRUEntryFree(entry);
-  }
-
-  taosArrayDestroy(lastReferenceList);
+  taosLRUCacheShardFreeEntries(lastReferenceList);
 }
 
 static bool taosLRUCacheShardRef(SLRUCacheShard *shard, LRUHandle *handle) {
   SLRUEntry *e = (SLRUEntry *)handle;
-  taosThreadMutexLock(&shard->mutex);
 
-  assert(TAOS_LRU_ENTRY_HAS_REFS(e));
+  assert(e->refs > 0);
   TAOS_LRU_ENTRY_REF(e);
 
-  taosThreadMutexUnlock(&shard->mutex);
-
   return true;
 }
 
@@ -538,44 +612,47 @@ static bool taosLRUCacheShardRelease(SLRUCacheShard *shard, LRUHandle *handle, b
   }
 
   SLRUEntry *e = (SLRUEntry *)handle;
-  bool       lastReference = false;
-
-  taosThreadMutexLock(&shard->mutex);
-
-  lastReference = taosLRUEntryUnref(e);
-  if (lastReference && TAOS_LRU_ENTRY_IN_CACHE(e)) {
-    if (shard->usage > shard->capacity || eraseIfLastRef) {
-      assert(shard->lru.next == &shard->lru || eraseIfLastRef);
+  SArray    *lastReferenceList = NULL;
 
+  if (eraseIfLastRef) {
+    // no lookup can take a new reference while the lock is held exclusively
+    taosThreadRwlockWrlock(&shard->lock);
+    if (TAOS_LRU_ENTRY_IN_CACHE(e) && TAOS_LRU_ENTRY_HANDLE_REFS(e) == 1) {
       taosLRUEntryTableRemove(&shard->table, e->keyData, e->keyLength, e->hash);
+      taosLRUCacheShardLRURemove(shard, e);
       TAOS_LRU_ENTRY_SET_IN_CACHE(e, false);
-    } else {
-      taosLRUCacheShardLRUInsert(shard, e);
-
-      lastReference = false;
+      assert(shard->usage >= e->totalCharge);
+      atomic_sub_fetch_64(&shard->usage, e->totalCharge);
+      taosLRUEntryUnref(e);
     }
+    taosThreadRwlockUnlock(&shard->lock);
   }
 
-  if (lastReference && e->value) {
-    assert(shard->usage >= e->totalCharge);
-    shard->usage -= e->totalCharge;
+  if (taosLRUEntryUnref(e)) {
+    taosLRUEntryFree(e);
+    return true;
   }
 
-  taosThreadMutexUnlock(&shard->mutex);
+  // entries pinned by handles may have pushed the shard over its capacity
+  if (atomic_load_64(&shard->usage) > shard->capacity) {
+    lastReferenceList = taosArrayInit(16, POINTER_BYTES);
 
-  if (lastReference) {
-    taosLRUEntryFree(e);
+    taosThreadRwlockWrlock(&shard->lock);
+    taosLRUCacheShardEvictLRU(shard, 0, -1, lastReferenceList);
+    taosThreadRwlockUnlock(&shard->lock);
+
+    taosLRUCacheShardFreeEntries(lastReferenceList);
   }
 
-  return lastReference;
+  return false;
 }
 
 static size_t taosLRUCacheShardGetUsage(SLRUCacheShard *shard) {
   size_t usage = 0;
 
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockRdlock(&shard->lock);
   usage = shard->usage;
-  taosThreadMutexUnlock(&shard->mutex);
+  taosThreadRwlockUnlock(&shard->lock);
 
   return usage;
 }
@@ -583,22 +660,50 @@ static size_t taosLRUCacheShardGetUsage(SLRUCacheShard *shard) {
 static size_t taosLRUCacheShardGetPinnedUsage(SLRUCacheShard *shard) {
   size_t usage = 0;
 
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockRdlock(&shard->lock);
 
-  assert(shard->usage >= shard->lruUsage);
-  usage = shard->usage - shard->lruUsage;
+  for (SLRUEntry *e = shard->lru.next; e != &shard->lru; e = e->next) {
+    if (TAOS_LRU_ENTRY_HAS_REFS(e)) {
+      usage += e->totalCharge;
+    }
+  }
 
-  taosThreadMutexUnlock(&shard->mutex);
+  taosThreadRwlockUnlock(&shard->lock);
 
   return usage;
 }
 
 static void taosLRUCacheShardSetStrictCapacity(SLRUCacheShard *shard, bool strict) {
-  taosThreadMutexLock(&shard->mutex);
+  taosThreadRwlockWrlock(&shard->lock);
 
   shard->strictCapacity = strict;
 
-  taosThreadMutexUnlock(&shard->mutex);
+  taosThreadRwlockUnlock(&shard->lock);
+}
+
+static int taosLRUCacheShardSetAdmission(SLRUCacheShard *shard, LRUAdmission admission) {
+  int code = 0;
+
+  taosThreadRwlockWrlock(&shard->lock);
+
+  if (admission == TAOS_LRU_ADMIT_TINY_LFU && shard->sketch.counters == NULL) {
+    code = taosLRUFreqSketchInit(&shard->sketch, shard->capacity);
+  }
+  if (code == 0) {
+    shard->admission = admission;
+  }
+
+  taosThreadRwlockUnlock(&shard->lock);
+
+  return code;
+}
+
+static void taosLRUCacheShardGetStat(SLRUCacheShard *shard, SLRUCacheStat *stat) {
+  stat->hits += atomic_load_64(&shard->stat.hits);
+  stat->misses += atomic_load_64(&shard->stat.misses);
+  stat->inserts += atomic_load_64(&shard->stat.inserts);
+  stat->evictions += atomic_load_64(&shard->stat.evictions);
+  stat->rejections += atomic_load_64(&shard->stat.rejections);
 }
 
 struct SShardedCache {
@@ -817,3 +922,25 @@ bool taosLRUCacheIsStrictCapacity(SLRUCache *cache) {
 
   return strict;
 }
+
+void taosLRUCacheSetAdmission(SLRUCache *cache, LRUAdmission admission) {
+  uint32_t numShards = cache->numShards;
+
+  taosThreadMutexLock(&cache->shardedCache.capacityMutex);
+
+  for (int i = 0; i < numShards; ++i) {
+    if (taosLRUCacheShardSetAdmission(&cache->shards[i], admission) != 0) {
+      uWarn("failed to set the admission policy of lru cache shard %d, keep admitting all entries", i);
+    }
+  }
+
+  taosThreadMutexUnlock(&cache->shardedCache.capacityMutex);
+}
+
+void taosLRUCacheGetStat(SLRUCache *cache, SLRUCacheStat *stat) {
+  memset(stat, 0, sizeof(*stat));
+
+  for (int i = 0; i < cache->numShards; ++i) {
+    taosLRUCacheShardGetStat(&cache->shards[i], stat);
+  }
+}
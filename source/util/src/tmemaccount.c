@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "tmemaccount.h"
+#include "taoserror.h"
+#include "tlog.h"
+
+#define MEM_ACCOUNT_NAME_LEN 64
+
+struct SMemAccount {
+  int64_t      used;
+  int64_t      peak;
+  int64_t      limit;
+  int64_t      numOfRejects;
+  SMemAccount *pParent;
+  char         name[MEM_ACCOUNT_NAME_LEN];
+};
+
+static SMemAccount nodeAccount = {.limit = -1, .name = "node"};
+
+SMemAccount *taosMemAccountCreate(SMemAccount *pParent, const char *name, int64_t limit) {
+  SMemAccount *pAccount = taosMemoryCalloc(1, sizeof(SMemAccount));
+  if (pAccount == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pAccount->limit = limit;
+  pAccount->pParent = pParent;
+  if (name != NULL) {
+    tstrncpy(pAccount->name, name, tListLen(pAccount->name));
+  }
+
+  return pAccount;
+}
+
+void taosMemAccountDestroy(SMemAccount *pAccount) {
+  if (pAccount == NULL) {
+    return;
+  }
+
+  // whatever the owner did not give back is still charged to the ancestors
+  int64_t used = atomic_load_64(&pAccount->used);
+  if (used != 0 && pAccount->pParent != NULL) {
+    taosMemAccountRelease(pAccount->pParent, used);
+  }
+
+  taosMemoryFree(pAccount);
+}
+
+SMemAccount *taosMemAccountGetNode() { return &nodeAccount; }
+
+static void updatePeak(SMemAccount *pAccount, int64_t used) {
+  int64_t peak = atomic_load_64(&pAccount->peak);
+  while (used > peak) {
+    int64_t old = atomic_val_compare_exchange_64(&pAccount->peak, peak, used);
+    if (old == peak) {
+      break;
+    }
+    peak = old;
+  }
+}
+
+int32_t taosMemAccountReserve(SMemAccount *pAccount, int64_t size) {
+  for (SMemAccount *p = pAccount; p != NULL; p = p->pParent) {
+    int64_t used = atomic_add_fetch_64(&p->used, size);
+    int64_t limit = atomic_load_64(&p->limit);
+    if (limit >= 0 && used > limit) {
+      atomic_sub_fetch_64(&p->used, size);
+      atomic_add_fetch_64(&p->numOfRejects, 1);
+
+      // roll back the accounts below the one that refused
+      for (SMemAccount *q = pAccount; q != p; q = q->pParent) {
+        atomic_sub_fetch_64(&q->used, size);
+      }
+
+      uDebug("memory account %s refused %" PRId64 " bytes, used:%" PRId64 ", limit:%" PRId64, p->name, size,
+             used - size, limit);
+      terrno = TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+      return terrno;
+    }
+
+    updatePeak(p, used);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void taosMemAccountCharge(SMemAccount *pAccount, int64_t size) {
+  for (SMemAccount *p = pAccount; p != NULL; p = p->pParent) {
+    updatePeak(p, atomic_add_fetch_64(&p->used, size));
+  }
+}
+
+void taosMemAccountRelease(SMemAccount *pAccount, int64_t size) {
+  for (SMemAccount *p = pAccount; p != NULL; p = p->pParent) {
+    atomic_sub_fetch_64(&p->used, size);
+  }
+}
+
+void taosMemAccountSetLimit(SMemAccount *pAccount, int64_t limit) { atomic_store_64(&pAccount->limit, limit); }
+
+int64_t taosMemAccountGetUsed(SMemAccount *pAccount) { return atomic_load_64(&pAccount->used); }
+
+void taosMemAccountGetStat(SMemAccount *pAccount, SMemAccountStat *pStat) {
+  pStat->used = atomic_load_64(&pAccount->used);
+  pStat->peak = atomic_load_64(&pAccount->peak);
+  pStat->limit = atomic_load_64(&pAccount->limit);
+  pStat->numOfRejects = atomic_load_64(&pAccount->numOfRejects);
+}
@@ -4,6 +4,7 @@
 #include "tcompression.h"
 #include "tsimplehash.h"
 #include "tlog.h"
+#include "tworker.h"
 
 #define GET_PAYLOAD_DATA(_p)           ((char*)(_p)->pData + POINTER_BYTES)
 #define BUF_PAGE_IN_MEM(_p)            ((_p)->pData != NULL)
@@ -11,6 +12,27 @@
 #define HAS_DATA_IN_DISK(_p)           ((_p)->offset >= 0)
 #define NO_IN_MEM_AVAILABLE_PAGES(_b)  (listNEles((_b)->lruList) >= (_b)->inMemPages)
 
+// compressed page: | length of the page without the zero tail (4 bytes) | LZ4 string |
+#define COMP_PAGE_HEAD_SIZE  sizeof(int32_t)
+#define COMP_PAGE_EXTRA_SIZE (COMP_PAGE_HEAD_SIZE + 1)
+
+#define PAGE_IO_WRITE 1
+#define PAGE_IO_READ  2
+
+#define PAGE_IO_THREADS      4
+#define MAX_PENDING_IO_PAGES 16  // the query thread waits for the background writer beyond this number of pages
+
+#define DBUF_MIN_RESERVED_PAGES 2  // pages a buffer may keep in memory when its memory budget is used up by others
+
+typedef struct SPageIoTask {
+  int8_t  type;
+  bool    cancel;  // the page is flushed again after the read ahead is issued
+  int32_t pageId;
+  int32_t length;
+  int64_t offset;
+  char    data[];
+} SPageIoTask;
+
 typedef struct SPageDiskInfo {
   int64_t offset;
   int32_t length;
@@ -46,11 +68,23 @@ struct SDiskbasedBuf {
   bool      comp;              // compressed before flushed to disk
   uint64_t  nextPos;           // next page flush position
 
+  bool          asyncIo;     // flush and read ahead pages by the background I/O
+  struct SPageIoQueue* pIoQueue;  // page I/O tasks, executed one by one by the same I/O thread
+  SList*        ioPending;   // issued I/O tasks which are not finished yet, in the issue order
+  SPageIoTask*  pReadahead;  // the page read in advance
+  int32_t       ioCode;      // error of the background I/O
+  TdThreadMutex ioMutex;
+  TdThreadCond  ioCond;
+
+  SMemAccount* pAccount;  // memory budget of the in-memory pages
+
   char*               id;           // for debug purpose
   bool                printStatis;  // Print statistics info when closing this buffer.
   SDiskbasedBufStatis statis;
 };
 
+static int32_t dBufOpenIoQueue(SDiskbasedBuf* pBuf);
+
 static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   if (pBuf->path == NULL) {  // prepare the file name when needed it
     char path[PATH_MAX] = {0};
@@ -67,32 +101,386 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
     return TAOS_SYSTEM_ERROR(errno);
   }
 
+  // fall back to the synchronous I/O if the background I/O is not available
+  if (pBuf->asyncIo && dBufOpenIoQueue(pBuf) != TSDB_CODE_SUCCESS) {
+    uWarn("failed to open the page I/O queue, flush pages synchronously, %s", pBuf->id);
+    pBuf->asyncIo = false;
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+// the unused tail of a page is always zero, it is cut off before compression and restored after decompression
+static int32_t doCompressPage(SDiskbasedBuf* pBuf, const char* pPage, char* dst) {
   if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+    memcpy(dst, pPage, pBuf->pageSize);
+    return pBuf->pageSize;
   }
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
+  int32_t len = pBuf->pageSize;
+  while (len > 0 && pPage[len - 1] == 0) {
+    len -= 1;
+  }
 
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  *(int32_t*)dst = len;
+  int32_t size = tsCompressString((void*)pPage, len, 1, dst + COMP_PAGE_HEAD_SIZE, len + 1, ONE_STAGE_COMP, NULL, 0);
+  return (size < 0) ? size : (int32_t)(size + COMP_PAGE_HEAD_SIZE);
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+static int32_t doDecompressPage(SDiskbasedBuf* pBuf, const char* src, int32_t srcSize, char* pPage) {
   if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+    if (src != pPage) {
+      memcpy(pPage, src, srcSize);
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t len = *(int32_t*)src;
+  if (srcSize <= COMP_PAGE_HEAD_SIZE || len < 0 || len > pBuf->pageSize) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  int32_t size = tsDecompressString((void*)(src + COMP_PAGE_HEAD_SIZE), srcSize - COMP_PAGE_HEAD_SIZE, 1, pPage, len,
+                                    ONE_STAGE_COMP, NULL, 0);
+  if (size != len) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  memset(pPage + len, 0, pBuf->pageSize - len);
+  return TSDB_CODE_SUCCESS;
+}
+
+// The queue of a buffer is kept for the next buffer when the buffer is destroyed, since the I/O thread still refers
+// to the queue for a while after the last task in it is done. The idle queues are freed with the I/O threads.
+typedef struct SPageIoQueue {
+  STaosQueue*          queue;
+  SDiskbasedBuf*       pBuf;
+  struct SPageIoQueue* next;
+} SPageIoQueue;
+
+static SWWorkerPool  dBufIoPool = {.name = "paged-buf-io", .max = PAGE_IO_THREADS};
+static TdThreadMutex dBufIoMutex = TD_PTHREAD_MUTEX_INITIALIZER;
+static int8_t        dBufIoPoolState = 0;  // 0: not started, 1: running, 2: stopped
+static SPageIoQueue* dBufIdleIoQueues = NULL;
+
+static bool dBufAsyncIo = true;
+static bool dBufCompress = true;
+
+void dBufSetDefaultOptions(bool asyncIo, bool comp) {
+  dBufAsyncIo = asyncIo;
+  dBufCompress = comp;
+}
+
+static void dBufProcessIoTasks(SQueueInfo* pInfo, STaosQall* qall, int32_t numOfItems) {
+  SDiskbasedBuf* pBuf = ((SPageIoQueue*)pInfo->ahandle)->pBuf;
+
+  for (int32_t i = 0; i < numOfItems; ++i) {
+    SPageIoTask* pTask = NULL;
+    taosGetQitem(qall, (void**)&pTask);
+
+    int64_t ret = 0;
+    if (pTask->type == PAGE_IO_WRITE) {
+      ret = taosPWriteFile(pBuf->pFile, pTask->data, pTask->length, pTask->offset);
+    } else {
+      ret = taosPReadFile(pBuf->pFile, pTask->data, pTask->length, pTask->offset);
+    }
+
+    int32_t code = (ret == pTask->length) ? TSDB_CODE_SUCCESS : TAOS_SYSTEM_ERROR(errno);
+
+    taosThreadMutexLock(&pBuf->ioMutex);
+    SListNode* pn = tdListPopHead(pBuf->ioPending);
+    ASSERT(pn != NULL && *(SPageIoTask**)pn->data == pTask);
+    taosMemoryFree(pn);
+
+    if (pTask->type == PAGE_IO_WRITE) {
+      if (code != TSDB_CODE_SUCCESS) {
+        uError("failed to flush page:%d to disk, code:%s, %s", pTask->pageId, tstrerror(code), pBuf->id);
+        pBuf->ioCode = code;
+      }
+      taosFreeQitem(pTask);
+    } else if (code == TSDB_CODE_SUCCESS && !pTask->cancel) {
+      taosFreeQitem(pBuf->pReadahead);
+      pBuf->pReadahead = pTask;
+    } else {  // read ahead is only a hint, discard the failed one
+      taosFreeQitem(pTask);
+    }
+
+    taosThreadCondBroadcast(&pBuf->ioCond);
+    taosThreadMutexUnlock(&pBuf->ioMutex);
+  }
+}
+
+static SPageIoQueue* dBufAcquireIoQueue(SDiskbasedBuf* pBuf) {
+  SPageIoQueue* pIoQueue = NULL;
+
+  taosThreadMutexLock(&dBufIoMutex);
+  if (dBufIoPoolState == 0) {
+    if (tWWorkerInit(&dBufIoPool) != 0) {
+      goto _end;
+    }
+    dBufIoPoolState = 1;
+  }
+
+  if (dBufIoPoolState != 1) {
+    terrno = TSDB_CODE_APP_IS_STOPPING;
+    goto _end;
+  }
+
+  if (dBufIdleIoQueues != NULL) {
+    pIoQueue = dBufIdleIoQueues;
+    dBufIdleIoQueues = pIoQueue->next;
+  } else {
+    pIoQueue = taosMemoryCalloc(1, sizeof(SPageIoQueue));
+    if (pIoQueue == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      goto _end;
+    }
+
+    pIoQueue->queue = tWWorkerAllocQueue(&dBufIoPool, pIoQueue, (FItems)dBufProcessIoTasks);
+    if (pIoQueue->queue == NULL) {
+      taosMemoryFreeClear(pIoQueue);
+      goto _end;
+    }
+  }
+
+  pIoQueue->pBuf = pBuf;
+  pIoQueue->next = NULL;
+
+_end:
+  taosThreadMutexUnlock(&dBufIoMutex);
+  return pIoQueue;
+}
+
+static void dBufReleaseIoQueue(SPageIoQueue* pIoQueue) {
+  taosThreadMutexLock(&dBufIoMutex);
+  pIoQueue->pBuf = NULL;
+  if (dBufIoPoolState == 1) {
+    pIoQueue->next = dBufIdleIoQueues;
+    dBufIdleIoQueues = pIoQueue;
+  } else {  // the I/O threads are stopped already
+    tWWorkerFreeQueue(&dBufIoPool, pIoQueue->queue);
+    taosMemoryFree(pIoQueue);
+  }
+  taosThreadMutexUnlock(&dBufIoMutex);
+}
+
+void dBufCleanupIoPool() {
+  taosThreadMutexLock(&dBufIoMutex);
+  if (dBufIoPoolState == 1) {
+    tWWorkerCleanup(&dBufIoPool);
+
+    while (dBufIdleIoQueues != NULL) {
+      SPageIoQueue* pIoQueue = dBufIdleIoQueues;
+      dBufIdleIoQueues = pIoQueue->next;
+      tWWorkerFreeQueue(&dBufIoPool, pIoQueue->queue);
+      taosMemoryFree(pIoQueue);
+    }
+  }
+
+  dBufIoPoolState = 2;
+  taosThreadMutexUnlock(&dBufIoMutex);
+}
+
+static int32_t dBufOpenIoQueue(SDiskbasedBuf* pBuf) {
+  pBuf->ioPending = tdListNew(POINTER_BYTES);
+  if (pBuf->ioPending == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosThreadMutexInit(&pBuf->ioMutex, NULL);
+  taosThreadCondInit(&pBuf->ioCond, NULL);
+
+  pBuf->pIoQueue = dBufAcquireIoQueue(pBuf);
+  if (pBuf->pIoQueue == NULL) {
+    taosThreadCondDestroy(&pBuf->ioCond);
+    taosThreadMutexDestroy(&pBuf->ioMutex);
+    pBuf->ioPending = tdListFree(pBuf->ioPending);
+    return terrno;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// wait for all of the issued I/O tasks to be finished
+static void dBufWaitIoTasks(SDiskbasedBuf* pBuf) {
+  taosThreadMutexLock(&pBuf->ioMutex);
+  while (listNEles(pBuf->ioPending) > 0) {
+    taosThreadCondWait(&pBuf->ioCond, &pBuf->ioMutex);
+  }
+
+  taosFreeQitem(pBuf->pReadahead);
+  pBuf->pReadahead = NULL;
+  taosThreadMutexUnlock(&pBuf->ioMutex);
+}
+
+static void dBufCloseIoQueue(SDiskbasedBuf* pBuf) {
+  if (pBuf->pIoQueue == NULL) {
+    return;
+  }
+
+  dBufWaitIoTasks(pBuf);
+
+  dBufReleaseIoQueue(pBuf->pIoQueue);
+  pBuf->pIoQueue = NULL;
+  pBuf->ioPending = tdListFree(pBuf->ioPending);
+  taosThreadCondDestroy(&pBuf->ioCond);
+  taosThreadMutexDestroy(&pBuf->ioMutex);
+}
+
+static SPageIoTask* dBufNewIoTask(SDiskbasedBuf* pBuf, int8_t type, int32_t pageId, int32_t size) {
+  SPageIoTask* pTask = taosAllocateQitem(sizeof(SPageIoTask) + size, DEF_QITEM, 0);
+  if (pTask == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pTask->type = type;
+  pTask->cancel = false;
+  pTask->pageId = pageId;
+  pTask->length = size;
+  pTask->offset = -1;
+  return pTask;
+}
+
+static void dBufSubmitIoTask(SDiskbasedBuf* pBuf, SPageIoTask* pTask) {
+  taosThreadMutexLock(&pBuf->ioMutex);
+  tdListAppend(pBuf->ioPending, &pTask);
+  taosThreadMutexUnlock(&pBuf->ioMutex);
+
+  taosWriteQitem(pBuf->pIoQueue->queue, pTask);
+}
+
+// limit the memory held by the pages waiting to be written, and report the error of previous writes
+static int32_t dBufWaitIoSlot(SDiskbasedBuf* pBuf) {
+  int64_t st = taosGetTimestampUs();
+
+  taosThreadMutexLock(&pBuf->ioMutex);
+  while (listNEles(pBuf->ioPending) >= MAX_PENDING_IO_PAGES && pBuf->ioCode == TSDB_CODE_SUCCESS) {
+    taosThreadCondWait(&pBuf->ioCond, &pBuf->ioMutex);
+  }
+  int32_t code = pBuf->ioCode;
+  taosThreadMutexUnlock(&pBuf->ioMutex);
+
+  pBuf->statis.ioWaitUs += taosGetTimestampUs() - st;
+  return code;
+}
+
+// the page on disk is out of date, the read ahead copy of it must not be used any more
+static void dBufDropReadahead(SDiskbasedBuf* pBuf, int32_t pageId) {
+  taosThreadMutexLock(&pBuf->ioMutex);
+  if (pBuf->pReadahead != NULL && pBuf->pReadahead->pageId == pageId) {
+    taosFreeQitem(pBuf->pReadahead);
+    pBuf->pReadahead = NULL;
+  }
+
+  SListIter iter = {0};
+  tdListInitIter(pBuf->ioPending, &iter, TD_LIST_FORWARD);
+
+  SListNode* pn = NULL;
+  while ((pn = tdListNext(&iter)) != NULL) {
+    SPageIoTask* pTask = *(SPageIoTask**)pn->data;
+    if (pTask->type == PAGE_IO_READ && pTask->pageId == pageId) {
+      pTask->cancel = true;
+    }
+  }
+  taosThreadMutexUnlock(&pBuf->ioMutex);
+}
+
+// copy the on disk content of the page from the tasks of the background I/O, return false if it is not there
+static bool dBufLoadFromIoTasks(SDiskbasedBuf* pBuf, SPageInfo* pg, char* dst) {
+  bool    found = false;
+  int64_t st = taosGetTimestampUs();
+
+  taosThreadMutexLock(&pBuf->ioMutex);
+  while (1) {
+    bool pendingRead = false;
+
+    // the last write of this page is the latest content
+    SListIter iter = {0};
+    tdListInitIter(pBuf->ioPending, &iter, TD_LIST_BACKWARD);
+
+    SListNode* pn = NULL;
+    while ((pn = tdListNext(&iter)) != NULL) {
+      SPageIoTask* pTask = *(SPageIoTask**)pn->data;
+      if (pTask->pageId != pg->pageId || pTask->cancel) {
+        continue;
+      }
+
+      if (pTask->type == PAGE_IO_WRITE) {
+        ASSERT(pTask->offset == pg->offset && pTask->length == pg->length);
+        memcpy(dst, pTask->data, pTask->length);
+        pBuf->statis.pendingHits += 1;
+        found = true;
+        break;
+      }
+
+      pendingRead = true;
+    }
+
+    SPageIoTask* pAhead = pBuf->pReadahead;
+    if (!found && pAhead != NULL && pAhead->pageId == pg->pageId && pAhead->offset == pg->offset &&
+        pAhead->length == pg->length) {
+      memcpy(dst, pAhead->data, pAhead->length);
+      taosFreeQitem(pAhead);
+      pBuf->pReadahead = NULL;
+      pBuf->statis.readaheadHits += 1;
+      found = true;
+    }
+
+    if (found || !pendingRead) {
+      break;
+    }
+
+    // the page is being read ahead, wait for it instead of reading it again
+    taosThreadCondWait(&pBuf->ioCond, &pBuf->ioMutex);
+  }
+  taosThreadMutexUnlock(&pBuf->ioMutex);
+
+  pBuf->statis.ioWaitUs += taosGetTimestampUs() - st;
+  return found;
+}
+
+// read the page next to the reloaded one in the background, since the pages are usually reloaded in the order of
+// their id, e.g., the pages of a sorted run or a group
+static void dBufReadahead(SDiskbasedBuf* pBuf, int32_t pageId) {
+  SPageInfo** ppi = tSimpleHashGet(pBuf->all, &pageId, sizeof(int32_t));
+  if (ppi == NULL || *ppi == NULL || BUF_PAGE_IN_MEM(*ppi) || !HAS_DATA_IN_DISK(*ppi) || (*ppi)->length <= 0) {
+    return;
+  }
+
+  SPageInfo* pi = *ppi;
+  bool       skip = false;
+
+  taosThreadMutexLock(&pBuf->ioMutex);
+  if (listNEles(pBuf->ioPending) >= MAX_PENDING_IO_PAGES ||
+      (pBuf->pReadahead != NULL && pBuf->pReadahead->pageId == pageId)) {
+    skip = true;
+  } else {
+    SListIter iter = {0};
+    tdListInitIter(pBuf->ioPending, &iter, TD_LIST_FORWARD);
+
+    SListNode* pn = NULL;
+    while ((pn = tdListNext(&iter)) != NULL) {
+      if ((*(SPageIoTask**)pn->data)->pageId == pageId) {
+        skip = true;
+        break;
+      }
+    }
   }
+  taosThreadMutexUnlock(&pBuf->ioMutex);
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  if (skip) {
+    return;
   }
-  return data;
+
+  SPageIoTask* pTask = dBufNewIoTask(pBuf, PAGE_IO_READ, pageId, pi->length);
+  if (pTask == NULL) {
+    return;
+  }
+
+  pTask->offset = pi->offset;
+  dBufSubmitIoTask(pBuf, pTask);
+  pBuf->statis.readaheadPages += 1;
 }
 
 static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
@@ -129,17 +517,18 @@ static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
 
 static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
 
-static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const char* pData, int32_t size) {
-  int32_t ret = taosLSeekFile(pBuf->pFile, offset, SEEK_SET);
-  if (ret == -1) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
-  }
-
-  ret = (int32_t)taosWriteFile(pBuf->pFile, pData, size);
-  if (ret != size) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
+static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const char* pData, int32_t size,
+                                  SPageIoTask* pTask) {
+  if (pTask != NULL) {
+    pTask->offset = offset;
+    pTask->length = size;
+    dBufSubmitIoTask(pBuf, pTask);
+  } else {
+    int32_t ret = (int32_t)taosPWriteFile(pBuf->pFile, pData, size, offset);
+    if (ret != size) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      return terrno;
+    }
   }
 
   // extend the file
@@ -148,6 +537,7 @@ static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const cha
   }
 
   pBuf->statis.flushBytes += size;
+  pBuf->statis.rawFlushBytes += pBuf->pageSize;
   pBuf->statis.flushPages += 1;
 
   return TSDB_CODE_SUCCESS;
@@ -163,43 +553,56 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   int32_t size = pBuf->pageSize;
   int64_t offset = pg->offset;
 
-  char* t = NULL;
-  if ((!HAS_DATA_IN_DISK(pg)) || pg->dirty) {
-    void* payload = GET_PAYLOAD_DATA(pg);
-    t = doCompressData(payload, pBuf->pageSize, &size, pBuf);
+  if (pg->dirty) {
+    char*        t = GET_PAYLOAD_DATA(pg);
+    SPageIoTask* pTask = NULL;
+
+    // the page is handed to the background writer, so the in-memory page can be reused at once
+    if (pBuf->pIoQueue != NULL) {
+      int32_t code = dBufWaitIoSlot(pBuf);
+      if (code != TSDB_CODE_SUCCESS) {
+        terrno = code;
+        return NULL;
+      }
+
+      dBufDropReadahead(pBuf, pg->pageId);
+      pTask = dBufNewIoTask(pBuf, PAGE_IO_WRITE, pg->pageId, pBuf->pageSize + COMP_PAGE_EXTRA_SIZE);
+      if (pTask == NULL) {
+        return NULL;
+      }
+
+      size = doCompressPage(pBuf, t, pTask->data);
+      t = pTask->data;
+    } else if (pBuf->comp) {
+      size = doCompressPage(pBuf, t, pBuf->assistBuf);
+      t = pBuf->assistBuf;
+    }
+
     if (size < 0) {
       uError("failed to compress data when flushing data to disk, %s", pBuf->id);
+      taosFreeQitem(pTask);
       terrno = TSDB_CODE_INVALID_PARA;
       return NULL;
     }
-  }
 
-  // this page is flushed to disk for the first time
-  if (pg->dirty) {
+    // this page is flushed to disk for the first time
     if (!HAS_DATA_IN_DISK(pg)) {
       offset = allocateNewPositionInFile(pBuf, size);
       pBuf->nextPos += size;
-
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
-    } else {
+    } else if (pg->length < size) {
       // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        offset = allocateNewPositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
+      // 1. add current space to free list
+      SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
+      taosArrayPush(pBuf->pFree, &dinfo);
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
+      // 2. allocate new position, and update the info
+      offset = allocateNewPositionInFile(pBuf, size);
+      pBuf->nextPos += size;
+    }
+
+    int32_t code = doFlushBufPageImpl(pBuf, offset, t, size, pTask);
+    if (code != TSDB_CODE_SUCCESS) {
+      return NULL;
     }
   } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
     size = pg->length;
@@ -241,25 +644,34 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return TSDB_CODE_INVALID_PARA;
   }
 
-  int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-  if (ret == -1) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
-  }
+  // the compressed page may be a little larger than the page
+  char* pPage = GET_PAYLOAD_DATA(pg);
+  char* pSrc = pBuf->comp ? pBuf->assistBuf : pPage;
 
-  void* pPage = (void*)GET_PAYLOAD_DATA(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
-  if (ret != pg->length) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  if (pBuf->pIoQueue == NULL || !dBufLoadFromIoTasks(pBuf, pg, pSrc)) {
+    int64_t st = taosGetTimestampUs();
+    int32_t ret = (int32_t)taosPReadFile(pBuf->pFile, pSrc, pg->length, pg->offset);
+    if (ret != pg->length) {
+      ret = TAOS_SYSTEM_ERROR(errno);
+      return ret;
+    }
+    pBuf->statis.ioWaitUs += taosGetTimestampUs() - st;
   }
 
   pBuf->statis.loadBytes += pg->length;
   pBuf->statis.loadPages += 1;
 
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
-  return 0;
+  int32_t code = doDecompressPage(pBuf, pSrc, pg->length, pPage);
+  if (code != TSDB_CODE_SUCCESS) {
+    uError("failed to decompress buf page:%d, length:%d, %s", pg->pageId, pg->length, pBuf->id);
+    return code;
+  }
+
+  if (pBuf->pIoQueue != NULL) {
+    dBufReadahead(pBuf, pg->pageId + 1);
+  }
+
+  return TSDB_CODE_SUCCESS;
 }
 
 static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
@@ -355,6 +767,7 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
   pPBuf->fileSize = 0;
   pPBuf->pFree = taosArrayInit(4, sizeof(SFreeListItem));
   pPBuf->freePgList = tdListNew(POINTER_BYTES);
+  pPBuf->asyncIo = dBufAsyncIo;
 
   // at least more than 2 pages must be in memory
   if (inMemBufSize < pagesize * 2) {
@@ -382,6 +795,11 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
   pPBuf->prefix = (char*)dir;
   pPBuf->emptyDummyIdList = taosArrayInit(1, sizeof(int32_t));
 
+  setBufPageCompressOnDisk(pPBuf, dBufCompress);
+  if (pPBuf->comp && pPBuf->assistBuf == NULL) {
+    goto _error;
+  }
+
   //  qDebug("QInfo:0x%"PRIx64" create resBuf for output, page size:%d, inmem buf pages:%d, file:%s", qId,
   //  pPBuf->pageSize, pPBuf->inMemPages, pPBuf->path);
 
@@ -392,19 +810,43 @@ _error:
 }
 
 static char* doExtractPage(SDiskbasedBuf* pBuf) {
-  char* availablePage = NULL;
+  char*   availablePage = NULL;
+  int32_t size = getAllocPageSize(pBuf->pageSize);
+
   if (NO_IN_MEM_AVAILABLE_PAGES(pBuf)) {
     availablePage = evictBufPage(pBuf);
     if (availablePage == NULL) {
       uWarn("no available buf pages, current:%d, max:%d, reason: %s, %s", listNEles(pBuf->lruList), pBuf->inMemPages,
             terrstr(), pBuf->id)
     }
-  } else {
-    availablePage =
-        taosMemoryCalloc(1, getAllocPageSize(pBuf->pageSize));  // add extract bytes in case of zipped buffer increased.
-    if (availablePage == NULL) {
-      terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return availablePage;
+  }
+
+  if (pBuf->pAccount != NULL && taosMemAccountReserve(pBuf->pAccount, size) != 0) {
+    // the memory budget is used up, spill a page to disk and reuse its memory instead
+    if (getEldestUnrefedPage(pBuf) != NULL) {
+      return evictBufPage(pBuf);
+    }
+
+    // the budget may be taken by the other buffers of the task, which are able to spill their pages later, so the
+    // buffer is always allowed a few pages in memory beyond the budget
+    if (taosMemAccountGetUsed(pBuf->pAccount) >= DBUF_MIN_RESERVED_PAGES * size) {
+      terrno = TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+      uError("no buf page to spill when the memory budget is used up, current:%d, %s", listNEles(pBuf->lruList),
+             pBuf->id);
+      return NULL;
+    }
+
+    taosMemAccountCharge(pBuf->pAccount, size);
+    pBuf->statis.overdraftPages += 1;
+  }
+
+  availablePage = taosMemoryCalloc(1, size);  // add extract bytes in case of zipped buffer increased.
+  if (availablePage == NULL) {
+    if (pBuf->pAccount != NULL) {
+      taosMemAccountRelease(pBuf->pAccount, size);
     }
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
   }
 
   return availablePage;
@@ -558,6 +1000,8 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
 
   dBufPrintStatis(pBuf);
 
+  dBufCloseIoQueue(pBuf);
+
   bool needRemoveFile = false;
   if (pBuf->pFile != NULL) {
     needRemoveFile = true;
@@ -584,6 +1028,16 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
           ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
           ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
     }
+
+    if (ps->flushPages > 0) {
+      uDebug("compressed:%.2f Kb to %.2f Kb, pendingHits:%d, readahead:%d hits:%d, ioWait:%.2f ms, %s",
+             ps->rawFlushBytes / 1024.0, ps->flushBytes / 1024.0, ps->pendingHits, ps->readaheadPages,
+             ps->readaheadHits, ps->ioWaitUs / 1000.0, pBuf->id);
+    }
+
+    if (ps->overdraftPages > 0) {
+      uDebug("pages beyond the memory budget:%d, %s", ps->overdraftPages, pBuf->id);
+    }
   }
 
   if (needRemoveFile) {
@@ -612,6 +1066,8 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
 
   tSimpleHashCleanup(pBuf->all);
 
+  taosMemAccountDestroy(pBuf->pAccount);
+
   taosMemoryFreeClear(pBuf->id);
   taosMemoryFreeClear(pBuf->assistBuf);
   taosMemoryFreeClear(pBuf);
@@ -638,9 +1094,34 @@ void setBufPageDirty(void* pPage, bool dirty) {
 
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) {
   pBuf->comp = comp;
-  if (comp  && (pBuf->assistBuf == NULL)) {
-    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize + 2);  // EXTRA BYTES
+  if (comp && (pBuf->assistBuf == NULL)) {
+    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize + COMP_PAGE_EXTRA_SIZE);  // EXTRA BYTES
+  }
+}
+
+void setBufPageAsyncIo(SDiskbasedBuf* pBuf, bool async) {
+  if (pBuf->pFile == NULL) {
+    pBuf->asyncIo = async;
+  }
+}
+
+int32_t dBufSetMemAccount(SDiskbasedBuf* pBuf, SMemAccount* pParent) {
+  if (pParent == NULL || pBuf->pAccount != NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the pages in memory already are not charged, so are not released from the account either
+  if (listNEles(pBuf->lruList) > 0) {
+    uWarn("memory account ignored, %d pages allocated already, %s", listNEles(pBuf->lruList), pBuf->id);
+    return TSDB_CODE_SUCCESS;
   }
+
+  pBuf->pAccount = taosMemAccountCreate(pParent, pBuf->id, -1);
+  if (pBuf->pAccount == NULL) {
+    return terrno;
+  }
+
+  return TSDB_CODE_SUCCESS;
 }
 
 void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
@@ -655,6 +1136,10 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
   taosMemoryFreeClear(pNode);
   ppi->pn = NULL;
 
+  if (pBuf->pAccount != NULL) {
+    taosMemAccountRelease(pBuf->pAccount, getAllocPageSize(pBuf->pageSize));
+  }
+
   tdListAppend(pBuf->freePgList, &ppi);
 }
 
@@ -683,12 +1168,18 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
         "Kb\n",
         ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
         ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
+    printf("Before compressed:%.2f Kb, pendingHits:%d, readahead:%d (hits:%d), ioWait:%.2f ms\n",
+           ps->rawFlushBytes / 1024.0, ps->pendingHits, ps->readaheadPages, ps->readaheadHits, ps->ioWaitUs / 1000.0);
   } else {
     // printf("no page loaded\n");
   }
 }
 
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
+  if (pBuf->pIoQueue != NULL) {
+    dBufWaitIoTasks(pBuf);
+  }
+
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
@@ -698,6 +1189,10 @@ void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
 
   taosArrayClear(pBuf->pIdList);
 
+  if (pBuf->pAccount != NULL) {
+    taosMemAccountRelease(pBuf->pAccount, taosMemAccountGetUsed(pBuf->pAccount));
+  }
+
   tdListEmpty(pBuf->lruList);
   tdListEmpty(pBuf->freePgList);
 
@@ -21,6 +21,80 @@
 int64_t tsRpcQueueMemoryAllowed = 0;
 int64_t tsRpcQueueMemoryUsed = 0;
 
+#define QSET_MIN_SPIN_LOOPS 16
+#define QSET_MAX_SPIN_LOOPS 4096
+
+// Vyukov's intrusive MPSC list, writers only swap the tail. nodes are pushed under the queue mutex so that the
+// qset count can follow them, readers never see a node whose link is not stored yet
+static FORCE_INLINE void taosQueuePush(STaosQueue *queue, STaosQnode *pNode) {
+  pNode->next = NULL;
+  STaosQnode *prev = atomic_exchange_ptr(&queue->tail, pNode);
+  atomic_store_ptr(&prev->next, pNode);
+}
+
+// readers must be serialized, returns NULL if empty
+static STaosQnode *taosQueuePop(STaosQueue *queue) {
+  STaosQnode *head = queue->head;
+  STaosQnode *next = atomic_load_ptr(&head->next);
+
+  if (head == queue->stub) {
+    if (next == NULL) return NULL;
+    queue->head = next;
+    head = next;
+    next = atomic_load_ptr(&next->next);
+  }
+
+  if (next != NULL) {
+    queue->head = next;
+    return head;
+  }
+
+  if (head != atomic_load_ptr(&queue->tail)) return NULL;
+
+  taosQueuePush(queue, queue->stub);
+  next = atomic_load_ptr(&head->next);
+  if (next != NULL) {
+    queue->head = next;
+    return head;
+  }
+
+  return NULL;
+}
+
+// items still linked in the queue, readers must be serialized
+static int32_t taosQueueUnreadItems(STaosQueue *queue) {
+  int32_t num = 0;
+  for (STaosQnode *pNode = queue->head; pNode != NULL; pNode = atomic_load_ptr(&pNode->next)) {
+    if (pNode != queue->stub) num++;
+  }
+  return num;
+}
+
+// pop all linked nodes into a list, returns the number of nodes
+static int32_t taosQueuePopAll(STaosQueue *queue, STaosQnode **ppStart, int64_t *pMem) {
+  STaosQnode *pStart = NULL;
+  STaosQnode *pLast = NULL;
+  STaosQnode *pNode = NULL;
+  int32_t     num = 0;
+  int64_t     mem = 0;
+
+  while ((pNode = taosQueuePop(queue)) != NULL) {
+    if (pLast) {
+      pLast->next = pNode;
+    } else {
+      pStart = pNode;
+    }
+    pLast = pNode;
+    mem += pNode->size;
+    num++;
+  }
+  if (pLast) pLast->next = NULL;
+
+  *ppStart = pStart;
+  *pMem = mem;
+  return num;
+}
+
 STaosQueue *taosOpenQueue() {
   STaosQueue *queue = taosMemoryCalloc(1, sizeof(STaosQueue));
   if (queue == NULL) {
@@ -28,7 +102,18 @@ STaosQueue *taosOpenQueue() {
     return NULL;
   }
 
+  queue->stub = taosMemoryCalloc(1, sizeof(STaosQnode));
+  if (queue->stub == NULL) {
+    taosMemoryFree(queue);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  queue->head = queue->stub;
+  queue->tail = queue->stub;
+
   if (taosThreadMutexInit(&queue->mutex, NULL) != 0) {
+    taosMemoryFree(queue->stub);
+    taosMemoryFree(queue);
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
@@ -46,18 +131,17 @@ void taosSetQueueFp(STaosQueue *queue, FItem itemFp, FItems itemsFp) {
 void taosCloseQueue(STaosQueue *queue) {
   if (queue == NULL) return;
   STaosQnode *pTemp;
-  STaosQset  *qset;
-
-  taosThreadMutexLock(&queue->mutex);
-  STaosQnode *pNode = queue->head;
-  queue->head = NULL;
-  qset = queue->qset;
-  taosThreadMutexUnlock(&queue->mutex);
+  STaosQnode *pNode = NULL;
+  int64_t     mem = 0;
 
   if (queue->qset) {
-    taosRemoveFromQset(qset, queue);
+    taosRemoveFromQset(queue->qset, queue);
   }
 
+  taosThreadMutexLock(&queue->mutex);
+  (void)taosQueuePopAll(queue, &pNode, &mem);
+  taosThreadMutexUnlock(&queue->mutex);
+
   while (pNode) {
     pTemp = pNode;
     pNode = pNode->next;
@@ -65,6 +149,7 @@ void taosCloseQueue(STaosQueue *queue) {
   }
 
   taosThreadMutexDestroy(&queue->mutex);
+  taosMemoryFree(queue->stub);
   taosMemoryFree(queue);
 
   uDebug("queue:%p is closed", queue);
@@ -73,40 +158,25 @@ void taosCloseQueue(STaosQueue *queue) {
 bool taosQueueEmpty(STaosQueue *queue) {
   if (queue == NULL) return true;
 
-  bool empty = false;
-  taosThreadMutexLock(&queue->mutex);
-  if (queue->head == NULL && queue->tail == NULL && queue->numOfItems == 0 && queue->memOfItems == 0) {
-    empty = true;
-  }
-  taosThreadMutexUnlock(&queue->mutex);
-
-  return empty;
+  return atomic_load_32(&queue->numOfItems) == 0 && atomic_load_64(&queue->memOfItems) == 0;
 }
 
 void taosUpdateItemSize(STaosQueue *queue, int32_t items) {
   if (queue == NULL) return;
 
-  taosThreadMutexLock(&queue->mutex);
-  queue->numOfItems -= items;
-  taosThreadMutexUnlock(&queue->mutex);
+  atomic_sub_fetch_32(&queue->numOfItems, items);
 }
 
 int32_t taosQueueItemSize(STaosQueue *queue) {
   if (queue == NULL) return 0;
 
-  taosThreadMutexLock(&queue->mutex);
-  int32_t numOfItems = queue->numOfItems;
-  taosThreadMutexUnlock(&queue->mutex);
-
-  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, queue->numOfItems, queue->memOfItems);
+  int32_t numOfItems = atomic_load_32(&queue->numOfItems);
+  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, numOfItems, atomic_load_64(&queue->memOfItems));
   return numOfItems;
 }
 
 int64_t taosQueueMemorySize(STaosQueue *queue) {
-  taosThreadMutexLock(&queue->mutex);
-  int64_t memOfItems = queue->memOfItems;
-  taosThreadMutexUnlock(&queue->mutex);
-  return memOfItems;
+  return atomic_load_64(&queue->memOfItems);
 }
 
 void *taosAllocateQitem(int32_t size, EQItype itype, int64_t dataSize) {
@@ -153,28 +223,29 @@ void taosFreeQitem(void *pItem) {
   taosMemoryFree(pNode);
 }
 
+static FORCE_INLINE void taosQsetWakeup(STaosQset *qset) {
+  if (atomic_load_32(&qset->numOfWaiters) > 0) tsem_post(&qset->sem);
+}
+
 void taosWriteQitem(STaosQueue *queue, void *pItem) {
   STaosQnode *pNode = (STaosQnode *)(((char *)pItem) - sizeof(STaosQnode));
-  pNode->next = NULL;
 
-  taosThreadMutexLock(&queue->mutex);
+  // count first, so the queue never looks empty while holding an item
+  int32_t items = atomic_add_fetch_32(&queue->numOfItems, 1);
+  int64_t mem = atomic_add_fetch_64(&queue->memOfItems, pNode->size);
 
-  if (queue->tail) {
-    queue->tail->next = pNode;
-    queue->tail = pNode;
-  } else {
-    queue->head = pNode;
-    queue->tail = pNode;
+  // the qset count is updated under the queue mutex, as taosAddIntoQset and taosRemoveFromQset do, so the item is
+  // counted by the qset it is linked into, or by none if the queue is removed meanwhile
+  taosThreadMutexLock(&queue->mutex);
+  taosQueuePush(queue, pNode);
+  STaosQset *qset = queue->qset;
+  if (qset) {
+    atomic_add_fetch_32(&qset->numOfItems, 1);
+    taosQsetWakeup(qset);
   }
-
-  queue->numOfItems++;
-  queue->memOfItems += pNode->size;
-  if (queue->qset) atomic_add_fetch_32(&queue->qset->numOfItems, 1);
-  uTrace("item:%p is put into queue:%p, items:%d mem:%" PRId64, pItem, queue, queue->numOfItems, queue->memOfItems);
-
   taosThreadMutexUnlock(&queue->mutex);
 
-  if (queue->qset) tsem_post(&queue->qset->sem);
+  uTrace("item:%p is put into queue:%p, items:%d mem:%" PRId64, pItem, queue, items, mem);
 }
 
 int32_t taosReadQitem(STaosQueue *queue, void **ppItem) {
@@ -183,17 +254,14 @@ int32_t taosReadQitem(STaosQueue *queue, void **ppItem) {
 
   taosThreadMutexLock(&queue->mutex);
 
-  if (queue->head) {
-    pNode = queue->head;
+  pNode = taosQueuePop(queue);
+  if (pNode) {
     *ppItem = pNode->item;
-    queue->head = pNode->next;
-    if (queue->head == NULL) queue->tail = NULL;
-    queue->numOfItems--;
-    queue->memOfItems -= pNode->size;
+    int32_t items = atomic_sub_fetch_32(&queue->numOfItems, 1);
+    int64_t mem = atomic_sub_fetch_64(&queue->memOfItems, pNode->size);
     if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, 1);
     code = 1;
-    uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems,
-           queue->memOfItems);
+    uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, items, mem);
   }
 
   taosThreadMutexUnlock(&queue->mutex);
@@ -212,36 +280,26 @@ STaosQall *taosAllocateQall() {
 void taosFreeQall(STaosQall *qall) { taosMemoryFree(qall); }
 
 int32_t taosReadAllQitems(STaosQueue *queue, STaosQall *qall) {
-  int32_t numOfItems = 0;
-  bool    empty;
+  STaosQnode *pStart = NULL;
+  int32_t     numOfItems = 0;
+  int64_t     mem = 0;
 
   taosThreadMutexLock(&queue->mutex);
 
-  empty = queue->head == NULL;
-  if (!empty) {
-    memset(qall, 0, sizeof(STaosQall));
-    qall->current = queue->head;
-    qall->start = queue->head;
-    qall->numOfItems = queue->numOfItems;
-    numOfItems = qall->numOfItems;
-
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->numOfItems = 0;
-    queue->memOfItems = 0;
-    uTrace("read %d items from queue:%p, items:%d mem:%" PRId64, numOfItems, queue, queue->numOfItems,
-           queue->memOfItems);
-    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, qall->numOfItems);
+  numOfItems = taosQueuePopAll(queue, &pStart, &mem);
+  if (numOfItems > 0) {
+    int32_t items = atomic_sub_fetch_32(&queue->numOfItems, numOfItems);
+    int64_t left = atomic_sub_fetch_64(&queue->memOfItems, mem);
+    uTrace("read %d items from queue:%p, items:%d mem:%" PRId64, numOfItems, queue, items, left);
+    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, numOfItems);
   }
 
   taosThreadMutexUnlock(&queue->mutex);
 
   // if source queue is empty, we set destination qall to empty too.
-  if (empty) {
-    qall->current = NULL;
-    qall->start = NULL;
-    qall->numOfItems = 0;
-  }
+  qall->current = pStart;
+  qall->start = pStart;
+  qall->numOfItems = numOfItems;
   return numOfItems;
 }
 
@@ -272,6 +330,7 @@ STaosQset *taosOpenQset() {
 
   taosThreadMutexInit(&qset->mutex, NULL);
   tsem_init(&qset->sem, 0, 0);
+  qset->spinLoops = QSET_MIN_SPIN_LOOPS;
 
   uDebug("qset:%p is opened", qset);
   return qset;
@@ -302,9 +361,51 @@ void taosCloseQset(STaosQset *qset) {
 // thread to exit.
 void taosQsetThreadResume(STaosQset *qset) {
   uDebug("qset:%p, it will exit", qset);
+  atomic_add_fetch_32(&qset->numOfResumes, 1);
   tsem_post(&qset->sem);
 }
 
+static bool taosQsetTakeResume(STaosQset *qset) {
+  int32_t resumes = atomic_load_32(&qset->numOfResumes);
+  while (resumes > 0) {
+    int32_t old = atomic_val_compare_exchange_32(&qset->numOfResumes, resumes, resumes - 1);
+    if (old == resumes) return true;
+    resumes = old;
+  }
+  return false;
+}
+
+// wait until the qset has items, returns false if the thread is resumed to exit, which is checked first so that a
+// reader exits even if items are left. readers spin for a while before parking, the spin budget grows when items
+// come in while spinning, and shrinks when the reader has to park.
+static bool taosQsetWait(STaosQset *qset) {
+  int32_t spinLoops = atomic_load_32(&qset->spinLoops);
+
+  while (1) {
+    for (int32_t i = 0; i < spinLoops; ++i) {
+      if (atomic_load_32(&qset->numOfResumes) > 0) break;
+      if (atomic_load_32(&qset->numOfItems) > 0) {
+        if (spinLoops < QSET_MAX_SPIN_LOOPS) atomic_store_32(&qset->spinLoops, spinLoops << 1);
+        return true;
+      }
+      if ((i & (QSET_MIN_SPIN_LOOPS - 1)) == QSET_MIN_SPIN_LOOPS - 1) sched_yield();
+    }
+
+    if (taosQsetTakeResume(qset)) return false;
+    if (spinLoops > QSET_MIN_SPIN_LOOPS) atomic_store_32(&qset->spinLoops, spinLoops >> 1);
+
+    // writers check numOfWaiters after numOfItems is updated, so a wakeup can not be lost
+    atomic_add_fetch_32(&qset->numOfWaiters, 1);
+    while (atomic_load_32(&qset->numOfItems) <= 0 && atomic_load_32(&qset->numOfResumes) <= 0) {
+      tsem_wait(&qset->sem);
+    }
+    atomic_sub_fetch_32(&qset->numOfWaiters, 1);
+
+    if (taosQsetTakeResume(qset)) return false;
+    if (atomic_load_32(&qset->numOfItems) > 0) return true;
+  }
+}
+
 int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
   if (queue->qset) return -1;
 
@@ -316,8 +417,8 @@ int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
   qset->numOfQueues++;
 
   taosThreadMutexLock(&queue->mutex);
-  atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
-  queue->qset = qset;
+  atomic_add_fetch_32(&qset->numOfItems, taosQueueUnreadItems(queue));
+  atomic_store_ptr(&queue->qset, qset);
   taosThreadMutexUnlock(&queue->mutex);
 
   taosThreadMutexUnlock(&qset->mutex);
@@ -355,8 +456,8 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
       qset->numOfQueues--;
 
       taosThreadMutexLock(&queue->mutex);
-      atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
-      queue->qset = NULL;
+      atomic_sub_fetch_32(&qset->numOfItems, taosQueueUnreadItems(queue));
+      atomic_store_ptr(&queue->qset, NULL);
       queue->next = NULL;
       taosThreadMutexUnlock(&queue->mutex);
     }
@@ -371,89 +472,86 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
   STaosQnode *pNode = NULL;
   int32_t     code = 0;
 
-  tsem_wait(&qset->sem);
+  // another reader may take the item first, then wait again
+  while (code == 0 && taosQsetWait(qset)) {
+    taosThreadMutexLock(&qset->mutex);
 
-  taosThreadMutexLock(&qset->mutex);
+    for (int32_t i = 0; i < qset->numOfQueues; ++i) {
+      if (qset->current == NULL) qset->current = qset->head;
+      STaosQueue *queue = qset->current;
+      if (queue) qset->current = queue->next;
+      if (queue == NULL) break;
+
+      taosThreadMutexLock(&queue->mutex);
 
-  for (int32_t i = 0; i < qset->numOfQueues; ++i) {
-    if (qset->current == NULL) qset->current = qset->head;
-    STaosQueue *queue = qset->current;
-    if (queue) qset->current = queue->next;
-    if (queue == NULL) break;
-    if (queue->head == NULL) continue;
-
-    taosThreadMutexLock(&queue->mutex);
-
-    if (queue->head) {
-      pNode = queue->head;
-      *ppItem = pNode->item;
-      qinfo->ahandle = queue->ahandle;
-      qinfo->fp = queue->itemFp;
-      qinfo->queue = queue;
-      qinfo->timestamp = pNode->timestamp;
-
-      queue->head = pNode->next;
-      if (queue->head == NULL) queue->tail = NULL;
-      // queue->numOfItems--;
-      queue->memOfItems -= pNode->size;
-      atomic_sub_fetch_32(&qset->numOfItems, 1);
-      code = 1;
-      uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems - 1,
-             queue->memOfItems);
+      pNode = taosQueuePop(queue);
+      if (pNode) {
+        *ppItem = pNode->item;
+        qinfo->ahandle = queue->ahandle;
+        qinfo->fp = queue->itemFp;
+        qinfo->queue = queue;
+        qinfo->timestamp = pNode->timestamp;
+
+        // queue->numOfItems--;
+        int64_t mem = atomic_sub_fetch_64(&queue->memOfItems, pNode->size);
+        atomic_sub_fetch_32(&qset->numOfItems, 1);
+        code = 1;
+        uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue,
+               atomic_load_32(&queue->numOfItems) - 1, mem);
+      }
+
+      taosThreadMutexUnlock(&queue->mutex);
+      if (pNode) break;
     }
 
-    taosThreadMutexUnlock(&queue->mutex);
-    if (pNode) break;
+    taosThreadMutexUnlock(&qset->mutex);
   }
 
-  taosThreadMutexUnlock(&qset->mutex);
-
   return code;
 }
 
 int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
   STaosQueue *queue;
+  STaosQnode *pStart = NULL;
+  int64_t     mem = 0;
   int32_t     code = 0;
 
-  tsem_wait(&qset->sem);
-  taosThreadMutexLock(&qset->mutex);
+  // another reader may take the items first, then wait again
+  while (code == 0 && taosQsetWait(qset)) {
+    taosThreadMutexLock(&qset->mutex);
+
+    for (int32_t i = 0; i < qset->numOfQueues; ++i) {
+      if (qset->current == NULL) qset->current = qset->head;
+      queue = qset->current;
+      if (queue) qset->current = queue->next;
+      if (queue == NULL) break;
+
+      taosThreadMutexLock(&queue->mutex);
+
+      code = taosQueuePopAll(queue, &pStart, &mem);
+      if (code > 0) {
+        qall->current = pStart;
+        qall->start = pStart;
+        qall->numOfItems = code;
+        qinfo->ahandle = queue->ahandle;
+        qinfo->fp = queue->itemsFp;
+        qinfo->queue = queue;
+
+        // queue->numOfItems = 0;
+        int64_t left = atomic_sub_fetch_64(&queue->memOfItems, mem);
+        uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, left);
 
-  for (int32_t i = 0; i < qset->numOfQueues; ++i) {
-    if (qset->current == NULL) qset->current = qset->head;
-    queue = qset->current;
-    if (queue) qset->current = queue->next;
-    if (queue == NULL) break;
-    if (queue->head == NULL) continue;
-
-    taosThreadMutexLock(&queue->mutex);
-
-    if (queue->head) {
-      qall->current = queue->head;
-      qall->start = queue->head;
-      qall->numOfItems = queue->numOfItems;
-      code = qall->numOfItems;
-      qinfo->ahandle = queue->ahandle;
-      qinfo->fp = queue->itemsFp;
-      qinfo->queue = queue;
-
-      queue->head = NULL;
-      queue->tail = NULL;
-      // queue->numOfItems = 0;
-      queue->memOfItems = 0;
-      uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, queue->memOfItems);
-
-      atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
-      for (int32_t j = 1; j < qall->numOfItems; ++j) {
-        tsem_wait(&qset->sem);
+        atomic_sub_fetch_32(&qset->numOfItems, code);
       }
-    }
 
-    taosThreadMutexUnlock(&queue->mutex);
+      taosThreadMutexUnlock(&queue->mutex);
 
-    if (code != 0) break;
+      if (code != 0) break;
+    }
+
+    taosThreadMutexUnlock(&qset->mutex);
   }
 
-  taosThreadMutexUnlock(&qset->mutex);
   return code;
 }
 
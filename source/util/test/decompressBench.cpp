@@ -0,0 +1,94 @@
+// decompression throughput of the scalar and SIMD kernels, not run as a part of the unit tests
+#include <stdio.h>
+#include <vector>
+
+#include "tcompression.h"
+
+using namespace std;
+
+namespace {
+
+const int32_t kBenchElems = 1000000;
+const int32_t kBenchRounds = 20;
+
+typedef int32_t (*CmprFn)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t);
+
+double benchDecompress(void *pData, int32_t nEle, int32_t eleSize, CmprFn cmpr, CmprFn decmpr, bool simd) {
+  int32_t      nData = nEle * eleSize;
+  int32_t      nOut = nData * 2 + 64;
+  vector<char> cmprBuf(nOut);
+  vector<char> out(nData + 64);
+
+  int32_t nCmpr = cmpr(pData, nData, nEle, cmprBuf.data(), nOut, ONE_STAGE_COMP, NULL, 0);
+
+  char builtins = tsSIMDBuiltins;
+  if (!simd) {
+    tsSIMDBuiltins = 0;
+  }
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t r = 0; r < kBenchRounds; r++) {
+    decmpr(cmprBuf.data(), nCmpr, nEle, out.data(), nData, ONE_STAGE_COMP, NULL, 0);
+  }
+  int64_t et = taosGetTimestampUs();
+
+  tsSIMDBuiltins = builtins;
+
+  // million elements per second
+  return (double)nEle * kBenchRounds / (et - st);
+}
+
+void printBench(const char *name, void *pData, int32_t eleSize, CmprFn cmpr, CmprFn decmpr) {
+  double scalar = benchDecompress(pData, kBenchElems, eleSize, cmpr, decmpr, false);
+  double simd = benchDecompress(pData, kBenchElems, eleSize, cmpr, decmpr, true);
+  printf("%-10s scalar: %8.2f Melem/s, simd: %8.2f Melem/s\n", name, scalar, simd);
+}
+
+template <typename T>
+void genIntegers(vector<T> &data) {
+  int64_t v = 0;
+  for (size_t i = 0; i < data.size(); i++) {
+    v += taosRand() % 1000 - 500;
+    data[i] = (T)v;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma);
+#if __AVX2__
+  tsAVX2Enable = avx2;
+  tsSIMDBuiltins = avx2;
+#endif
+  printf("simd kernels:%s\n", (tsAVX2Enable && tsSIMDBuiltins) ? "avx2" : "none");
+
+  vector<int64_t> iData(kBenchElems);
+  genIntegers(iData);
+  printBench("bigint", iData.data(), sizeof(int64_t), tsCompressBigint, tsDecompressBigint);
+
+  vector<int32_t> i32Data(kBenchElems);
+  genIntegers(i32Data);
+  printBench("int", i32Data.data(), sizeof(int32_t), tsCompressInt, tsDecompressInt);
+
+  vector<int64_t> tsData(kBenchElems);
+  int64_t         ts = 1650803518000;
+  for (int32_t i = 0; i < kBenchElems; i++) {
+    ts += 1000 + taosRand() % 3;
+    tsData[i] = ts;
+  }
+  printBench("timestamp", tsData.data(), sizeof(int64_t), tsCompressTimestamp, tsDecompressTimestamp);
+
+  vector<double> dData(kBenchElems);
+  vector<float>  fData(kBenchElems);
+  double         v = 0;
+  for (int32_t i = 0; i < kBenchElems; i++) {
+    v += (taosRand() % 100) / 7.0;
+    dData[i] = v;
+    fData[i] = (float)v;
+  }
+  printBench("double", dData.data(), sizeof(double), tsCompressDouble, tsDecompressDouble);
+  printBench("float", fData.data(), sizeof(float), tsCompressFloat, tsDecompressFloat);
+  return 0;
+}
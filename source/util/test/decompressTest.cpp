@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "tcompression.h"
+
+using namespace std;
+
+namespace {
+
+typedef int32_t (*CmprFn)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t);
+
+// the SIMD kernels are off by default, turn them on if they are built in and the CPU supports them
+bool enableSimd() {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma);
+#if __AVX2__
+  tsAVX2Enable = avx2;
+  tsSIMDBuiltins = avx2;
+#endif
+  return tsAVX2Enable && tsSIMDBuiltins;
+}
+
+const bool simdEnabled = enableSimd();
+
+// decompress with the scalar and the SIMD kernels, both must give back the original data
+void checkRoundTrip(void *pData, int32_t nEle, int32_t eleSize, CmprFn cmpr, CmprFn decmpr) {
+  int32_t       nData = nEle * eleSize;
+  int32_t       nOut = nData * 2 + 64;
+  vector<char> cmprBuf(nOut);
+  vector<char> scalar(nData + 64);
+  vector<char> simd(nData + 64);
+
+  int32_t nCmpr = cmpr(pData, nData, nEle, cmprBuf.data(), nOut, ONE_STAGE_COMP, NULL, 0);
+  ASSERT_GT(nCmpr, 0);
+
+  tsSIMDBuiltins = 0;
+  ASSERT_EQ(decmpr(cmprBuf.data(), nCmpr, nEle, scalar.data(), nData, ONE_STAGE_COMP, NULL, 0), nData);
+
+  ASSERT_EQ(enableSimd(), simdEnabled);
+  ASSERT_EQ(decmpr(cmprBuf.data(), nCmpr, nEle, simd.data(), nData, ONE_STAGE_COMP, NULL, 0), nData);
+
+  ASSERT_EQ(memcmp(pData, scalar.data(), nData), 0);
+  ASSERT_EQ(memcmp(scalar.data(), simd.data(), nData), 0);
+}
+
+template <typename T>
+void genIntegers(vector<T> &data, int32_t mode) {
+  int64_t v = 0;
+  for (size_t i = 0; i < data.size(); i++) {
+    switch (mode) {
+      case 0:  // constant, selector 0 and 1
+        break;
+      case 1:  // small deltas
+        v += taosRand() % 3 - 1;
+        break;
+      case 2:  // medium deltas
+        v += taosRand() % 1000 - 500;
+        break;
+      default:  // large jumps
+        v += (taosRand() % 50 == 0) ? 0x7ffffffffffLL : 1;
+        break;
+    }
+    data[i] = (T)v;
+  }
+}
+
+template <typename T>
+void checkIntegers(CmprFn cmpr, CmprFn decmpr) {
+  int32_t sizes[] = {1, 3, 4, 5, 7, 8, 239, 240, 241, 4096, 10001};
+  for (int32_t mode = 0; mode < 4; mode++) {
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      vector<T> data(sizes[s]);
+      genIntegers(data, mode);
+      checkRoundTrip(data.data(), sizes[s], sizeof(T), cmpr, decmpr);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(TD_UTIL_DECOMPRESS_TEST, simple8b) {
+  // without AVX2 both decodes run the scalar kernels
+  RecordProperty("simd", simdEnabled ? "avx2" : "none");
+
+  checkIntegers<int8_t>(tsCompressTinyint, tsDecompressTinyint);
+  checkIntegers<int16_t>(tsCompressSmallint, tsDecompressSmallint);
+  checkIntegers<int32_t>(tsCompressInt, tsDecompressInt);
+  checkIntegers<int64_t>(tsCompressBigint, tsDecompressBigint);
+}
+
+TEST(TD_UTIL_DECOMPRESS_TEST, simple8b_extreme_delta) {
+  // zigzag deltas of 61..64 bits can not be packed, the block must fall back to the raw copy
+  vector<vector<int64_t>> cases = {
+      {INT64_MIN, INT64_MAX, INT64_MIN, INT64_MAX},
+      {0, INT64_MAX, 0, INT64_MIN},
+      {INT64_MAX, INT64_MAX - 1, INT64_MIN, INT64_MIN + 1},
+      {1, 2, 3, (int64_t)1 << 60, -((int64_t)1 << 60), 4, 5},
+  };
+  for (size_t c = 0; c < cases.size(); c++) {
+    for (int32_t n = 1; n <= (int32_t)cases[c].size(); n++) {
+      checkRoundTrip(cases[c].data(), n, sizeof(int64_t), tsCompressBigint, tsDecompressBigint);
+    }
+  }
+
+  // an extreme jump in the middle of a window of small deltas
+  vector<int64_t> data(4096);
+  genIntegers(data, 1);
+  data[2000] = INT64_MIN;
+  data[2001] = INT64_MAX;
+  checkRoundTrip(data.data(), data.size(), sizeof(int64_t), tsCompressBigint, tsDecompressBigint);
+}
+
+TEST(TD_UTIL_DECOMPRESS_TEST, timestamp) {
+  int32_t sizes[] = {1, 2, 3, 4, 5, 255, 256, 257, 10001};
+  for (int32_t mode = 0; mode < 3; mode++) {
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      vector<int64_t> data(sizes[s]);
+      int64_t         ts = 1650803518000;
+      for (size_t i = 0; i < data.size(); i++) {
+        ts += (mode == 0) ? 1000 : (mode == 1 ? 1000 + taosRand() % 10 : taosRand());
+        data[i] = ts;
+      }
+      checkRoundTrip(data.data(), sizes[s], sizeof(int64_t), tsCompressTimestamp, tsDecompressTimestamp);
+    }
+  }
+}
+
+TEST(TD_UTIL_DECOMPRESS_TEST, floating) {
+  int32_t sizes[] = {1, 2, 3, 7, 8, 9, 255, 256, 257, 10001};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    vector<double> dData(sizes[s]);
+    vector<float>  fData(sizes[s]);
+    double         v = 1.5;
+    for (int32_t i = 0; i < sizes[s]; i++) {
+      v += (taosRand() % 100) / 7.0;
+      dData[i] = v;
+      fData[i] = (float)v;
+    }
+    checkRoundTrip(dData.data(), sizes[s], sizeof(double), tsCompressDouble, tsDecompressDouble);
+    checkRoundTrip(fData.data(), sizes[s], sizeof(float), tsCompressFloat, tsDecompressFloat);
+  }
+}
+
+TEST(TD_UTIL_DECOMPRESS_TEST, stream_compress) {
+  int8_t  types[] = {TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT,
+                     TSDB_DATA_TYPE_TIMESTAMP};
+  int32_t bytes[] = {1, 2, 4, 8, 8};
+  CmprFn  decmprs[] = {tsDecompressTinyint, tsDecompressSmallint, tsDecompressInt, tsDecompressBigint,
+                       tsDecompressTimestamp};
+
+  SCompressor *pCmprsor = NULL;
+  ASSERT_EQ(tCompressorCreate(&pCmprsor), 0);
+
+  for (int32_t t = 0; t < 5; t++) {
+    for (int32_t mode = 0; mode < 4; mode++) {
+      int32_t         nEle = 5000 + mode;
+      vector<int64_t> data(nEle);
+      genIntegers(data, mode);
+      if (types[t] == TSDB_DATA_TYPE_TIMESTAMP) {
+        for (int32_t i = 0; i < nEle; i++) data[i] += 1650803518000 + i * 1000;
+      }
+
+      vector<char> in(nEle * bytes[t]);
+      for (int32_t i = 0; i < nEle; i++) {
+        memcpy(in.data() + i * bytes[t], &data[i], bytes[t]);  // little-endian narrowing
+      }
+
+      ASSERT_EQ(tCompressStart(pCmprsor, types[t], ONE_STAGE_COMP), 0);
+      for (int32_t i = 0; i < nEle; i++) {
+        ASSERT_EQ(tCompress(pCmprsor, in.data() + i * bytes[t], bytes[t]), 0);
+      }
+
+      const uint8_t *pOut = NULL;
+      int32_t        nOut = 0;
+      int32_t        nOrigin = 0;
+      ASSERT_EQ(tCompressEnd(pCmprsor, &pOut, &nOut, &nOrigin), 0);
+      ASSERT_EQ(nOrigin, nEle * bytes[t]);
+
+      vector<char> out(nOrigin + 64);
+      ASSERT_EQ(decmprs[t]((void *)pOut, nOut, nEle, out.data(), nOrigin, ONE_STAGE_COMP, NULL, 0), nOrigin);
+      ASSERT_EQ(memcmp(in.data(), out.data(), nOrigin), 0);
+    }
+  }
+
+  tCompressorDestroy(pCmprsor);
+}
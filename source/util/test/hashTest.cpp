@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <limits.h>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "os.h"
 #include "taos.h"
@@ -140,8 +142,122 @@ void noLockPerformanceTest() {
   taosHashCleanup(hashTable);
 }
 
+void stripedTest() {
+  SHashObj* hashTable =
+      (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_STRIPED_LOCK);
+  ASSERT_EQ(taosHashGetSize(hashTable), 0);
+
+  const int32_t        num = 10000;
+  std::vector<int64_t> keys(num);
+  std::vector<int32_t> vals(num);
+  for (int32_t i = 0; i < num; ++i) {
+    keys[i] = i * 7;
+    vals[i] = i;
+  }
+
+  ASSERT_EQ(taosHashPutBatch(hashTable, keys.data(), sizeof(int64_t), vals.data(), sizeof(int32_t), num), 0);
+  ASSERT_EQ(taosHashGetSize(hashTable), num);
+
+  // the existing keys are kept since update is not enabled
+  ASSERT_EQ(taosHashPutBatch(hashTable, keys.data(), sizeof(int64_t), vals.data(), sizeof(int32_t), 10),
+            HASH_KEY_ALREADY_EXISTS);
+  ASSERT_EQ(taosHashPut(hashTable, &keys[0], sizeof(int64_t), &vals[1], sizeof(int32_t)), HASH_KEY_ALREADY_EXISTS);
+  ASSERT_EQ(taosHashGetSize(hashTable), num);
+
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t* p = (int32_t*)taosHashGet(hashTable, &keys[i], sizeof(int64_t));
+    ASSERT_TRUE(p != nullptr);
+    ASSERT_EQ(*p, i);
+  }
+
+  int64_t missing = 1;
+  ASSERT_TRUE(taosHashGet(hashTable, &missing, sizeof(int64_t)) == nullptr);
+
+  // every element is visited once across the sub tables
+  int64_t sum = 0;
+  int32_t count = 0;
+  void*   p = taosHashIterate(hashTable, NULL);
+  while (p) {
+    sum += *(int32_t*)p;
+    count += 1;
+    p = taosHashIterate(hashTable, p);
+  }
+  ASSERT_EQ(count, num);
+  ASSERT_EQ(sum, (int64_t)num * (num - 1) / 2);
+
+  p = taosHashIterate(hashTable, NULL);
+  taosHashCancelIterate(hashTable, p);
+
+  int32_t* pAcquired = (int32_t*)taosHashAcquire(hashTable, &keys[5], sizeof(int64_t));
+  ASSERT_TRUE(pAcquired != nullptr);
+  ASSERT_EQ(taosHashRemove(hashTable, &keys[5], sizeof(int64_t)), 0);
+  ASSERT_TRUE(taosHashGet(hashTable, &keys[5], sizeof(int64_t)) == nullptr);
+  ASSERT_EQ(*pAcquired, 5);
+  taosHashRelease(hashTable, pAcquired);
+  ASSERT_EQ(taosHashGetSize(hashTable), num - 1);
+
+  for (int32_t i = 0; i < num / 2; ++i) {
+    taosHashRemove(hashTable, &keys[i], sizeof(int64_t));
+  }
+  ASSERT_EQ(taosHashGetSize(hashTable), num - num / 2);
+
+  taosHashClear(hashTable);
+  ASSERT_EQ(taosHashGetSize(hashTable), 0);
+  taosHashCleanup(hashTable);
+}
+
+/**
+ * compare the single latch table with the striped one, by looking up a shared key set from several threads while
+ * each thread also puts and removes keys of its own
+ */
+int64_t concurrentAccess(SHashLockTypeE type, int32_t numOfThreads) {
+  const int32_t numOfKeys = 100000;
+  const int32_t numOfLoops = 200000;
+
+  SHashObj* hashTable = (SHashObj*)taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, type);
+
+  std::vector<int64_t> keys(numOfKeys);
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    keys[i] = i;
+  }
+  EXPECT_EQ(taosHashPutBatch(hashTable, keys.data(), sizeof(int64_t), keys.data(), sizeof(int64_t), numOfKeys), 0);
+
+  int64_t st = taosGetTimestampUs();
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < numOfThreads; ++t) {
+    threads.emplace_back([hashTable, t]() {
+      for (int32_t i = 0; i < numOfLoops; ++i) {
+        int64_t  key = (i * 7919L + t * 104729L) % numOfKeys;
+        int64_t* p = (int64_t*)taosHashGet(hashTable, &key, sizeof(int64_t));
+        EXPECT_TRUE(p != nullptr && *p == key);
+
+        if (i % 16 == 0) {
+          int64_t own = numOfKeys + t * numOfLoops + i;
+          EXPECT_EQ(taosHashPut(hashTable, &own, sizeof(int64_t), &own, sizeof(int64_t)), 0);
+          EXPECT_EQ(taosHashRemove(hashTable, &own, sizeof(int64_t)), 0);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int64_t et = taosGetTimestampUs();
+
+  EXPECT_EQ(taosHashGetSize(hashTable), numOfKeys);
+  taosHashCleanup(hashTable);
+  return et - st;
+}
+
 void multithreadsTest() {
-  // todo
+  for (int32_t numOfThreads = 1; numOfThreads <= 8; numOfThreads *= 2) {
+    int64_t entryLock = concurrentAccess(HASH_ENTRY_LOCK, numOfThreads);
+    int64_t stripedLock = concurrentAccess(HASH_STRIPED_LOCK, numOfThreads);
+    printf("%d threads, entry lock:%" PRId64 " us, striped lock:%" PRId64 " us\n", numOfThreads, entryLock,
+           stripedLock);
+  }
 }
 
 // check the function robustness
@@ -410,6 +526,7 @@ TEST(testCase, hashTest) {
   simpleTest();
   stringKeyTest();
   noLockPerformanceTest();
+  stripedTest();
   multithreadsTest();
   acquireRleaseTest();
   // perfTest();
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "tlrucache.h"
+
+namespace {
+
+std::atomic<int32_t> numOfDeleted(0);
+
+void deleteValue(const void *key, size_t keyLen, void *value) { numOfDeleted++; }
+
+void *toValue(int64_t key) { return (void *)(intptr_t)(key + 1); }
+
+LRUStatus insertKey(SLRUCache *cache, int64_t key, LRUHandle **handle) {
+  return taosLRUCacheInsert(cache, &key, sizeof(key), toValue(key), 1, deleteValue, handle, TAOS_LRU_PRIORITY_LOW);
+}
+
+LRUHandle *lookupKey(SLRUCache *cache, int64_t key) { return taosLRUCacheLookup(cache, &key, sizeof(key)); }
+
+bool touchKey(SLRUCache *cache, int64_t key) {
+  LRUHandle *h = lookupKey(cache, key);
+  if (h == NULL) {
+    return false;
+  }
+  taosLRUCacheRelease(cache, h, false);
+  return true;
+}
+
+// fill the cache with keys looked up over and over, then scan twice as many keys once each
+int32_t hotKeysAfterScan(LRUAdmission admission) {
+  const int32_t kCapacity = 100;
+
+  SLRUCache *cache = taosLRUCacheInit(kCapacity, 0, 0.5);
+  taosLRUCacheSetAdmission(cache, admission);
+
+  for (int64_t key = 0; key < kCapacity; ++key) {
+    insertKey(cache, key, NULL);
+  }
+  for (int32_t round = 0; round < 10; ++round) {
+    for (int64_t key = 0; key < kCapacity; ++key) {
+      touchKey(cache, key);
+    }
+  }
+
+  for (int64_t key = 1000; key < 1000 + 2 * kCapacity; ++key) {
+    if (!touchKey(cache, key)) {
+      insertKey(cache, key, NULL);
+    }
+  }
+
+  int32_t numOfHot = 0;
+  for (int64_t key = 0; key < kCapacity; ++key) {
+    numOfHot += touchKey(cache, key);
+  }
+
+  EXPECT_LE(taosLRUCacheGetUsage(cache), kCapacity);
+  taosLRUCacheCleanup(cache);
+  return numOfHot;
+}
+
+}  // namespace
+
+TEST(lruCacheTest, insertLookupErase) {
+  numOfDeleted = 0;
+  SLRUCache *cache = taosLRUCacheInit(16, 0, 0.5);
+  ASSERT_NE(cache, nullptr);
+
+  LRUHandle *h = NULL;
+  ASSERT_EQ(insertKey(cache, 1, &h), TAOS_LRU_STATUS_OK);
+  ASSERT_NE(h, nullptr);
+  ASSERT_EQ(taosLRUCacheValue(cache, h), toValue(1));
+  ASSERT_EQ(taosLRUCacheGetPinnedUsage(cache), 1);
+  taosLRUCacheRelease(cache, h, false);
+  ASSERT_EQ(taosLRUCacheGetPinnedUsage(cache), 0);
+
+  h = lookupKey(cache, 1);
+  ASSERT_NE(h, nullptr);
+  ASSERT_EQ(taosLRUCacheValue(cache, h), toValue(1));
+  ASSERT_EQ(lookupKey(cache, 2), nullptr);
+
+  // an erased entry stays valid until the last handle is released
+  int64_t key = 1;
+  taosLRUCacheErase(cache, &key, sizeof(key));
+  ASSERT_EQ(lookupKey(cache, 1), nullptr);
+  ASSERT_EQ(taosLRUCacheGetUsage(cache), 0);
+  ASSERT_EQ(numOfDeleted, 0);
+  ASSERT_TRUE(taosLRUCacheRelease(cache, h, false));
+  ASSERT_EQ(numOfDeleted, 1);
+
+  ASSERT_EQ(insertKey(cache, 2, NULL), TAOS_LRU_STATUS_OK);
+  ASSERT_EQ(insertKey(cache, 2, NULL), TAOS_LRU_STATUS_OK_OVERWRITTEN);
+  ASSERT_EQ(numOfDeleted, 2);
+
+  SLRUCacheStat stat = {0};
+  taosLRUCacheGetStat(cache, &stat);
+  ASSERT_EQ(stat.hits, 1);
+  ASSERT_EQ(stat.misses, 2);
+  ASSERT_EQ(stat.inserts, 3);
+
+  taosLRUCacheCleanup(cache);
+  ASSERT_EQ(numOfDeleted, 3);
+}
+
+TEST(lruCacheTest, eraseIfLastRef) {
+  numOfDeleted = 0;
+  SLRUCache *cache = taosLRUCacheInit(16, 0, 0.5);
+
+  LRUHandle *h1 = NULL;
+  insertKey(cache, 1, &h1);
+  LRUHandle *h2 = lookupKey(cache, 1);
+  ASSERT_EQ(h1, h2);
+
+  // still referenced by h2, keep it
+  ASSERT_FALSE(taosLRUCacheRelease(cache, h1, true));
+  ASSERT_EQ(taosLRUCacheGetUsage(cache), 1);
+  ASSERT_TRUE(taosLRUCacheRelease(cache, h2, true));
+  ASSERT_EQ(taosLRUCacheGetUsage(cache), 0);
+  ASSERT_EQ(lookupKey(cache, 1), nullptr);
+  ASSERT_EQ(numOfDeleted, 1);
+
+  taosLRUCacheCleanup(cache);
+}
+
+TEST(lruCacheTest, evictUnpinned) {
+  numOfDeleted = 0;
+  SLRUCache *cache = taosLRUCacheInit(10, 0, 0.5);
+
+  LRUHandle *pinned = NULL;
+  insertKey(cache, 0, &pinned);
+  for (int64_t key = 1; key < 30; ++key) {
+    insertKey(cache, key, NULL);
+  }
+
+  ASSERT_EQ(taosLRUCacheGetUsage(cache), 10);
+  ASSERT_EQ(taosLRUCacheGetPinnedUsage(cache), 1);
+  ASSERT_EQ(numOfDeleted, 20);
+  ASSERT_TRUE(touchKey(cache, 0));
+
+  SLRUCacheStat stat = {0};
+  taosLRUCacheGetStat(cache, &stat);
+  ASSERT_EQ(stat.evictions, 20);
+  ASSERT_EQ(stat.rejections, 0);
+
+  // a strict cache refuses entries it can only hold by going over the capacity
+  taosLRUCacheSetStrictCapacity(cache, true);
+  taosLRUCacheSetCapacity(cache, 1);
+  LRUHandle *h = NULL;
+  ASSERT_EQ(insertKey(cache, 100, &h), TAOS_LRU_STATUS_INCOMPLETE);
+  ASSERT_EQ(h, nullptr);
+
+  taosLRUCacheRelease(cache, pinned, false);
+  taosLRUCacheCleanup(cache);
+  ASSERT_EQ(numOfDeleted, 30);
+}
+
+TEST(lruCacheTest, tinyLfuScanResistance) {
+  // all of the hot keys are pushed out by the scan without an admission policy
+  ASSERT_EQ(hotKeysAfterScan(TAOS_LRU_ADMIT_ALL), 0);
+  ASSERT_GE(hotKeysAfterScan(TAOS_LRU_ADMIT_TINY_LFU), 90);
+}
+
+TEST(lruCacheTest, tinyLfuRejectWithHandle) {
+  numOfDeleted = 0;
+  SLRUCache *cache = taosLRUCacheInit(10, 0, 0.5);
+  taosLRUCacheSetAdmission(cache, TAOS_LRU_ADMIT_TINY_LFU);
+
+  for (int64_t key = 0; key < 10; ++key) {
+    insertKey(cache, key, NULL);
+    for (int32_t i = 0; i < 10; ++i) {
+      touchKey(cache, key);
+    }
+  }
+
+  // the caller still gets its value, it is just not kept in the cache
+  LRUHandle *h = NULL;
+  ASSERT_EQ(insertKey(cache, 100, &h), TAOS_LRU_STATUS_OK);
+  ASSERT_NE(h, nullptr);
+  ASSERT_EQ(taosLRUCacheValue(cache, h), toValue(100));
+  ASSERT_EQ(lookupKey(cache, 100), nullptr);
+  ASSERT_TRUE(taosLRUCacheRelease(cache, h, false));
+  ASSERT_EQ(numOfDeleted, 1);
+
+  ASSERT_EQ(insertKey(cache, 101, NULL), TAOS_LRU_STATUS_OK);
+  ASSERT_EQ(numOfDeleted, 2);
+
+  SLRUCacheStat stat = {0};
+  taosLRUCacheGetStat(cache, &stat);
+  ASSERT_EQ(stat.rejections, 2);
+  ASSERT_EQ(stat.evictions, 0);
+  ASSERT_EQ(taosLRUCacheGetUsage(cache), 10);
+
+  taosLRUCacheCleanup(cache);
+}
+
+TEST(lruCacheTest, concurrentLookup) {
+  const int32_t kKeys = 1000;
+  const int32_t kThreads = 8;
+
+  numOfDeleted = 0;
+  SLRUCache *cache = taosLRUCacheInit(kKeys / 2, 2, 0.5);
+  taosLRUCacheSetAdmission(cache, TAOS_LRU_ADMIT_TINY_LFU);
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([cache, t]() {
+      for (int32_t i = 0; i < 20000; ++i) {
+        // skewed towards small keys
+        int64_t    key = (i * 7919 + t * 104729) % kKeys;
+        key = key * key / kKeys;
+        LRUHandle *h = lookupKey(cache, key);
+        if (h == NULL) {
+          insertKey(cache, key, &h);
+        }
+        if (h != NULL) {
+          EXPECT_EQ(taosLRUCacheValue(cache, h), toValue(key));
+          taosLRUCacheRelease(cache, h, false);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_LE(taosLRUCacheGetUsage(cache), kKeys / 2);
+  ASSERT_EQ(taosLRUCacheGetPinnedUsage(cache), 0);
+
+  SLRUCacheStat stat = {0};
+  taosLRUCacheGetStat(cache, &stat);
+  ASSERT_EQ(stat.hits + stat.misses, kThreads * 20000);
+
+  taosLRUCacheCleanup(cache);
+  ASSERT_EQ(numOfDeleted, stat.inserts + stat.rejections);
+}
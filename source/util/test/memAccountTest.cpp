@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "taoserror.h"
+#include "tmemaccount.h"
+
+TEST(memAccountTest, hierarchy) {
+  SMemAccount *query = taosMemAccountCreate(NULL, "query", 1000);
+  SMemAccount *op1 = taosMemAccountCreate(query, "op1", -1);
+  SMemAccount *op2 = taosMemAccountCreate(query, "op2", 300);
+
+  ASSERT_EQ(taosMemAccountReserve(op1, 600), 0);
+  ASSERT_EQ(taosMemAccountReserve(op2, 300), 0);
+  ASSERT_EQ(taosMemAccountGetUsed(query), 900);
+
+  // refused by the operator itself
+  ASSERT_EQ(taosMemAccountReserve(op2, 1), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  // refused by the query, nothing is left charged to the operator
+  ASSERT_EQ(taosMemAccountReserve(op1, 200), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  ASSERT_EQ(taosMemAccountGetUsed(op1), 600);
+  ASSERT_EQ(taosMemAccountGetUsed(query), 900);
+
+  taosMemAccountRelease(op1, 100);
+  ASSERT_EQ(taosMemAccountReserve(op1, 100), 0);
+
+  SMemAccountStat stat = {0};
+  taosMemAccountGetStat(query, &stat);
+  ASSERT_EQ(stat.used, 900);
+  ASSERT_EQ(stat.peak, 900);
+  ASSERT_EQ(stat.limit, 1000);
+  ASSERT_EQ(stat.numOfRejects, 1);
+
+  // the usage left behind by a destroyed account goes back to its parent
+  taosMemAccountDestroy(op1);
+  ASSERT_EQ(taosMemAccountGetUsed(query), 300);
+
+  // a zero limit refuses everything
+  taosMemAccountSetLimit(query, 0);
+  ASSERT_EQ(taosMemAccountReserve(op2, 1), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  taosMemAccountRelease(op2, 100);
+  ASSERT_EQ(taosMemAccountGetUsed(query), 200);
+
+  taosMemAccountDestroy(op2);
+  taosMemAccountGetStat(query, &stat);
+  ASSERT_EQ(stat.used, 0);
+  ASSERT_EQ(stat.peak, 900);
+  taosMemAccountDestroy(query);
+}
+
+TEST(memAccountTest, charge) {
+  SMemAccount *query = taosMemAccountCreate(NULL, "query", 100);
+  SMemAccount *op = taosMemAccountCreate(query, "op", -1);
+
+  ASSERT_EQ(taosMemAccountReserve(op, 100), 0);
+  ASSERT_EQ(taosMemAccountReserve(op, 10), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+
+  // charged beyond the limit, the later reservations are refused until it is given back
+  taosMemAccountCharge(op, 10);
+  ASSERT_EQ(taosMemAccountGetUsed(op), 110);
+  ASSERT_EQ(taosMemAccountGetUsed(query), 110);
+  ASSERT_EQ(taosMemAccountReserve(op, 1), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+
+  SMemAccountStat stat = {0};
+  taosMemAccountGetStat(query, &stat);
+  ASSERT_EQ(stat.peak, 110);
+  ASSERT_EQ(stat.numOfRejects, 2);
+
+  taosMemAccountRelease(op, 20);
+  ASSERT_EQ(taosMemAccountReserve(op, 10), 0);
+
+  taosMemAccountDestroy(op);
+  ASSERT_EQ(taosMemAccountGetUsed(query), 0);
+  taosMemAccountDestroy(query);
+}
+
+TEST(memAccountTest, concurrentReserve) {
+  const int32_t kThreads = 8;
+  const int64_t kLimit = 1000;
+
+  SMemAccount *query = taosMemAccountCreate(NULL, "query", kLimit);
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([query, kLimit]() {
+      SMemAccount *op = taosMemAccountCreate(query, "op", -1);
+      for (int32_t i = 0; i < 10000; ++i) {
+        if (taosMemAccountReserve(op, 10) == 0) {
+          EXPECT_LE(taosMemAccountGetUsed(query), kLimit);
+          taosMemAccountRelease(op, 10);
+        }
+      }
+      taosMemAccountDestroy(op);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  SMemAccountStat stat = {0};
+  taosMemAccountGetStat(query, &stat);
+  ASSERT_EQ(stat.used, 0);
+  ASSERT_LE(stat.peak, kLimit);
+  taosMemAccountDestroy(query);
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 #include <cassert>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "taos.h"
+#include "taoserror.h"
 #include "tpagedbuf.h"
 
 #pragma GCC diagnostic push
@@ -157,6 +160,223 @@ void recyclePageTest() {
 
   destroyDiskbasedBuf(pBuf);
 }
+
+// spill many pages through a small in-memory buffer, then reload them in order and check the content
+void spillReloadTest(bool async, bool comp, bool byDefault = false) {
+  const int32_t numOfPages = 64;
+
+  if (byDefault) {
+    dBufSetDefaultOptions(async, comp);
+  }
+
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        ret = createDiskbasedBuf(&pBuf, 1024, 4 * 1024, "spill", TD_TMP_DIR_PATH);
+  if (byDefault) {
+    dBufSetDefaultOptions(true, true);
+  }
+  ASSERT_EQ(ret, 0);
+  if (!byDefault) {
+    setBufPageAsyncIo(pBuf, async);
+    setBufPageCompressOnDisk(pBuf, comp);
+  }
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    int32_t    pageId = 0;
+    SFilePage* pPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pPage != NULL);
+    ASSERT_EQ(pageId, i);
+
+    // only the head of the page is used
+    pPage->num = i;
+    for (int32_t j = 0; j < 64; ++j) {
+      ((int32_t*)pPage->data)[j] = i * 64 + j;
+    }
+
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pBuf, pPage);
+  }
+
+  for (int32_t round = 0; round < 2; ++round) {
+    for (int32_t i = 0; i < numOfPages; ++i) {
+      SFilePage* pPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+      ASSERT_TRUE(pPage != NULL);
+      ASSERT_EQ(pPage->num, i);
+      for (int32_t j = 0; j < 64; ++j) {
+        ASSERT_EQ(((int32_t*)pPage->data)[j], i * 64 + j);
+      }
+      ASSERT_EQ(((int32_t*)pPage->data)[64], 0);
+
+      // rewrite the pages in the first round, which makes the read ahead copies out of date
+      if (round == 0) {
+        ((int32_t*)pPage->data)[0] = i * 64;
+        setBufPageDirty(pPage, true);
+      }
+      releaseBufPage(pBuf, pPage);
+    }
+  }
+
+  SDiskbasedBufStatis statis = getDBufStatis(pBuf);
+  ASSERT_FALSE(isAllDataInMemBuf(pBuf));
+  ASSERT_GE(statis.flushPages, numOfPages);
+  ASSERT_EQ(statis.rawFlushBytes, statis.flushPages * 1024L);
+  if (comp) {
+    ASSERT_LT(statis.flushBytes * 2, statis.rawFlushBytes);
+  } else {
+    ASSERT_EQ(statis.flushBytes, statis.rawFlushBytes);
+  }
+
+  if (async) {
+    ASSERT_GT(statis.readaheadHits + statis.pendingHits, 0);
+  } else {
+    ASSERT_EQ(statis.readaheadPages, 0);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+}
+
+void memBudgetTest() {
+  const int32_t kPageSize = 1024;
+
+  SMemAccount* pQuery = taosMemAccountCreate(NULL, "query", -1);
+
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        ret = createDiskbasedBuf(&pBuf, kPageSize, 16 * kPageSize, "budget", TD_TMP_DIR_PATH);
+  ASSERT_EQ(ret, 0);
+  ASSERT_EQ(dBufSetMemAccount(pBuf, pQuery), 0);
+
+  int32_t pageId = 0;
+  SFilePage* pPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+  ASSERT_TRUE(pPage != NULL);
+  pPage->num = 0;
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pBuf, pPage);
+
+  // the budget holds four pages, far fewer than the buffer would keep in memory by itself
+  int64_t pageBytes = taosMemAccountGetUsed(pQuery);
+  ASSERT_GT(pageBytes, kPageSize);
+  taosMemAccountSetLimit(pQuery, 4 * pageBytes);
+
+  for (int32_t i = 1; i < 32; ++i) {
+    SFilePage* p = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(p != NULL);
+    p->num = i;
+    setBufPageDirty(p, true);
+    releaseBufPage(pBuf, p);
+  }
+
+  SMemAccountStat stat = {0};
+  taosMemAccountGetStat(pQuery, &stat);
+  ASSERT_EQ(stat.used, 4 * pageBytes);
+  ASSERT_EQ(stat.peak, 4 * pageBytes);
+  ASSERT_GE(getDBufStatis(pBuf).flushPages, 28);
+
+  for (int32_t i = 0; i < 32; ++i) {
+    SFilePage* p = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(p != NULL);
+    ASSERT_EQ(p->num, i);
+    releaseBufPage(pBuf, p);
+  }
+
+  // nothing can be spilled while all of the pages in memory are in use
+  void* pinned[4] = {0};
+  for (int32_t i = 0; i < 4; ++i) {
+    pinned[i] = getBufPage(pBuf, i);
+    ASSERT_TRUE(pinned[i] != NULL);
+  }
+  ASSERT_TRUE(getNewBufPage(pBuf, &pageId) == NULL);
+  ASSERT_EQ(terrno, TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+
+  // a recycled page gives its memory back to the budget
+  dBufSetBufPageRecycled(pBuf, pinned[3]);
+  ASSERT_EQ(taosMemAccountGetUsed(pQuery), 3 * pageBytes);
+  for (int32_t i = 0; i < 3; ++i) {
+    releaseBufPage(pBuf, pinned[i]);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+  ASSERT_EQ(taosMemAccountGetUsed(pQuery), 0);
+  taosMemAccountDestroy(pQuery);
+}
+
+// two buffers of a task share its budget, the one without any page to spill still makes progress
+void sharedBudgetTest() {
+  const int32_t kPageSize = 1024;
+
+  SMemAccount*   pTask = taosMemAccountCreate(NULL, "task", -1);
+  SDiskbasedBuf* pBuf1 = NULL;
+  SDiskbasedBuf* pBuf2 = NULL;
+  ASSERT_EQ(createDiskbasedBuf(&pBuf1, kPageSize, 16 * kPageSize, "shared1", TD_TMP_DIR_PATH), 0);
+  ASSERT_EQ(createDiskbasedBuf(&pBuf2, kPageSize, 16 * kPageSize, "shared2", TD_TMP_DIR_PATH), 0);
+  ASSERT_EQ(dBufSetMemAccount(pBuf1, pTask), 0);
+  ASSERT_EQ(dBufSetMemAccount(pBuf2, pTask), 0);
+
+  int32_t    pageId = 0;
+  SFilePage* pPage = static_cast<SFilePage*>(getNewBufPage(pBuf1, &pageId));
+  ASSERT_TRUE(pPage != NULL);
+  pPage->num = 0;
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pBuf1, pPage);
+
+  // the first buffer takes the whole budget
+  int64_t pageBytes = taosMemAccountGetUsed(pTask);
+  taosMemAccountSetLimit(pTask, 4 * pageBytes);
+  for (int32_t i = 1; i < 8; ++i) {
+    pPage = static_cast<SFilePage*>(getNewBufPage(pBuf1, &pageId));
+    ASSERT_TRUE(pPage != NULL);
+    pPage->num = i;
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pBuf1, pPage);
+  }
+  ASSERT_EQ(taosMemAccountGetUsed(pTask), 4 * pageBytes);
+
+  // the second one has nothing to spill, it is given two pages beyond the budget
+  void* pinned[2] = {0};
+  for (int32_t i = 0; i < 2; ++i) {
+    pinned[i] = getNewBufPage(pBuf2, &pageId);
+    ASSERT_TRUE(pinned[i] != NULL);
+    ((SFilePage*)pinned[i])->num = 100 + i;
+    setBufPageDirty(pinned[i], true);
+  }
+  ASSERT_EQ(getDBufStatis(pBuf2).overdraftPages, 2);
+  ASSERT_EQ(taosMemAccountGetUsed(pTask), 6 * pageBytes);
+
+  // but no more while both of them are in use
+  ASSERT_TRUE(getNewBufPage(pBuf2, &pageId) == NULL);
+  ASSERT_EQ(terrno, TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+
+  // once released, the pages of the second buffer are spilled to make room as usual
+  releaseBufPage(pBuf2, pinned[0]);
+  releaseBufPage(pBuf2, pinned[1]);
+  for (int32_t i = 2; i < 8; ++i) {
+    pPage = static_cast<SFilePage*>(getNewBufPage(pBuf2, &pageId));
+    ASSERT_TRUE(pPage != NULL);
+    pPage->num = 100 + i;
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pBuf2, pPage);
+  }
+  ASSERT_EQ(getDBufStatis(pBuf2).overdraftPages, 2);
+  ASSERT_GE(getDBufStatis(pBuf2).flushPages, 6);
+
+  // the first buffer spills its own pages again, while the budget is still overdrawn
+  for (int32_t i = 0; i < 8; ++i) {
+    pPage = static_cast<SFilePage*>(getBufPage(pBuf1, i));
+    ASSERT_TRUE(pPage != NULL);
+    ASSERT_EQ(pPage->num, i);
+    releaseBufPage(pBuf1, pPage);
+
+    pPage = static_cast<SFilePage*>(getBufPage(pBuf2, i));
+    ASSERT_TRUE(pPage != NULL);
+    ASSERT_EQ(pPage->num, 100 + i);
+    releaseBufPage(pBuf2, pPage);
+  }
+  ASSERT_EQ(getDBufStatis(pBuf1).overdraftPages, 0);
+  ASSERT_EQ(taosMemAccountGetUsed(pTask), 6 * pageBytes);
+
+  destroyDiskbasedBuf(pBuf1);
+  destroyDiskbasedBuf(pBuf2);
+  ASSERT_EQ(taosMemAccountGetUsed(pTask), 0);
+  taosMemAccountDestroy(pTask);
+}
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -166,4 +386,71 @@ TEST(testCase, resultBufferTest) {
   recyclePageTest();
 }
 
+TEST(testCase, spillReloadTest) {
+  spillReloadTest(true, true);
+  spillReloadTest(true, false);
+  spillReloadTest(false, true);
+  spillReloadTest(false, false);
+}
+
+TEST(testCase, defaultOptionsTest) {
+  spillReloadTest(true, false, true);
+  spillReloadTest(false, true, true);
+  spillReloadTest(false, false, true);
+}
+
+// the I/O queues of the destroyed buffers are taken over by the new ones
+TEST(testCase, ioQueueReuseTest) {
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < 8; ++i) {
+    threads.emplace_back([]() {
+      for (int32_t j = 0; j < 16; ++j) {
+        spillReloadTest(true, (j % 2) == 0);
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST(testCase, memBudgetTest) { memBudgetTest(); }
+
+TEST(testCase, sharedBudgetTest) { sharedBudgetTest(); }
+
+// it stops the background I/O of the process, so it runs at last
+TEST(testCase, ioPoolCleanupTest) {
+  spillReloadTest(true, true);
+  dBufCleanupIoPool();
+
+  // the buffers fall back to the synchronous I/O
+  SDiskbasedBuf* pBuf = NULL;
+  ASSERT_EQ(createDiskbasedBuf(&pBuf, 1024, 4 * 1024, "stopped", TD_TMP_DIR_PATH), 0);
+  for (int32_t i = 0; i < 16; ++i) {
+    int32_t    pageId = 0;
+    SFilePage* pPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pPage != NULL);
+    pPage->num = i;
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pBuf, pPage);
+  }
+
+  for (int32_t i = 0; i < 16; ++i) {
+    SFilePage* pPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pPage != NULL);
+    ASSERT_EQ(pPage->num, i);
+    releaseBufPage(pBuf, pPage);
+  }
+
+  SDiskbasedBufStatis statis = getDBufStatis(pBuf);
+  ASSERT_GT(statis.flushPages, 0);
+  ASSERT_EQ(statis.readaheadPages, 0);
+  ASSERT_EQ(statis.pendingHits, 0);
+  destroyDiskbasedBuf(pBuf);
+
+  // repeated cleanup is harmless
+  dBufCleanupIoPool();
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
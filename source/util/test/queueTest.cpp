@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "tqueue.h"
+
+namespace {
+
+const int32_t kProducers = 8;
+const int32_t kItemsPerProducer = 20000;
+
+typedef struct {
+  int32_t producer;
+  int32_t seq;
+} SQueueTestItem;
+
+void writeItems(STaosQueue *queue, int32_t producer) {
+  for (int32_t i = 0; i < kItemsPerProducer; ++i) {
+    SQueueTestItem *pItem = (SQueueTestItem *)taosAllocateQitem(sizeof(SQueueTestItem), DEF_QITEM, 0);
+    ASSERT_NE(pItem, nullptr);
+    pItem->producer = producer;
+    pItem->seq = i;
+    taosWriteQitem(queue, pItem);
+  }
+}
+
+int64_t threadCpuTimeMs() {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+}  // namespace
+
+TEST(queueTest, mpsc) {
+  STaosQueue *queue = taosOpenQueue();
+  ASSERT_NE(queue, nullptr);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+
+  std::vector<std::thread> producers;
+  for (int32_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back(writeItems, queue, p);
+  }
+
+  // items of one producer are read in the order they were written
+  std::vector<int32_t> next(kProducers, 0);
+  STaosQall           *qall = taosAllocateQall();
+  int32_t              total = 0;
+  bool                 single = true;
+  while (total < kProducers * kItemsPerProducer) {
+    void *pItem = NULL;
+    if (single) {
+      if (taosReadQitem(queue, &pItem) == 0) continue;
+      SQueueTestItem *pTest = (SQueueTestItem *)pItem;
+      ASSERT_EQ(pTest->seq, next[pTest->producer]++);
+      taosFreeQitem(pItem);
+      total++;
+    } else {
+      int32_t num = taosReadAllQitems(queue, qall);
+      ASSERT_EQ(num, taosQallItemSize(qall));
+      for (int32_t i = 0; i < num; ++i) {
+        ASSERT_EQ(taosGetQitem(qall, &pItem), 1);
+        SQueueTestItem *pTest = (SQueueTestItem *)pItem;
+        ASSERT_EQ(pTest->seq, next[pTest->producer]++);
+        taosFreeQitem(pItem);
+      }
+      ASSERT_EQ(taosGetQitem(qall, &pItem), 0);
+      total += num;
+    }
+    single = !single;
+  }
+
+  for (auto &t : producers) t.join();
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  taosFreeQall(qall);
+  taosCloseQueue(queue);
+}
+
+TEST(queueTest, qset) {
+  const int32_t kQueues = 4;
+  const int32_t kReaders = 4;
+
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queues[kQueues];
+  for (int32_t q = 0; q < kQueues; ++q) {
+    queues[q] = taosOpenQueue();
+    ASSERT_EQ(taosAddIntoQset(qset, queues[q], NULL), 0);
+  }
+  ASSERT_EQ(taosGetQueueNumber(qset), kQueues);
+
+  std::atomic<int32_t>     consumed(0);
+  std::vector<std::thread> readers;
+  for (int32_t r = 0; r < kReaders; ++r) {
+    readers.emplace_back([&, r]() {
+      SQueueInfo qinfo = {0};
+      STaosQall *qall = taosAllocateQall();
+      while (1) {
+        void   *pItem = NULL;
+        int32_t num = (r % 2) ? taosReadQitemFromQset(qset, &pItem, &qinfo)
+                              : taosReadAllQitemsFromQset(qset, qall, &qinfo);
+        if (num == 0) break;
+        if (r % 2) {
+          taosFreeQitem(pItem);
+        } else {
+          for (int32_t i = 0; i < num; ++i) {
+            taosGetQitem(qall, &pItem);
+            taosFreeQitem(pItem);
+          }
+        }
+        taosUpdateItemSize((STaosQueue *)qinfo.queue, num);
+        consumed += num;
+      }
+      taosFreeQall(qall);
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (int32_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back(writeItems, queues[p % kQueues], p);
+  }
+  for (auto &t : producers) t.join();
+
+  while (consumed < kProducers * kItemsPerProducer) {
+    taosMsleep(1);
+  }
+  for (int32_t r = 0; r < kReaders; ++r) {
+    taosQsetThreadResume(qset);
+  }
+  for (auto &t : readers) t.join();
+
+  ASSERT_EQ(consumed, kProducers * kItemsPerProducer);
+  for (int32_t q = 0; q < kQueues; ++q) {
+    ASSERT_TRUE(taosQueueEmpty(queues[q]));
+    taosCloseQueue(queues[q]);
+  }
+  taosCloseQset(qset);
+}
+
+TEST(queueTest, qsetResumeFirst) {
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queue = taosOpenQueue();
+  ASSERT_EQ(taosAddIntoQset(qset, queue, NULL), 0);
+  writeItems(queue, 0);
+
+  // a resumed reader exits even though items are left
+  SQueueInfo qinfo = {0};
+  void      *pItem = NULL;
+  taosQsetThreadResume(qset);
+  ASSERT_EQ(taosReadQitemFromQset(qset, &pItem, &qinfo), 0);
+
+  ASSERT_EQ(taosReadQitemFromQset(qset, &pItem, &qinfo), 1);
+  taosFreeQitem(pItem);
+
+  taosRemoveFromQset(qset, queue);
+  int32_t num = 0;
+  while (taosReadQitem(queue, &pItem) == 1) {
+    taosFreeQitem(pItem);
+    num++;
+  }
+  ASSERT_EQ(num, kItemsPerProducer - 1);
+  taosCloseQueue(queue);
+  taosCloseQset(qset);
+}
+
+TEST(queueTest, qsetRemoveWhileWriting) {
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queue = taosOpenQueue();
+  ASSERT_EQ(taosAddIntoQset(qset, queue, NULL), 0);
+
+  // the queue leaves and joins the qset while items are written into it
+  std::atomic<bool>        done(false);
+  std::vector<std::thread> producers;
+  for (int32_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back(writeItems, queue, p);
+  }
+  std::thread toggler([&]() {
+    while (!done) {
+      taosRemoveFromQset(qset, queue);
+      taosAddIntoQset(qset, queue, NULL);
+    }
+  });
+  for (auto &t : producers) t.join();
+  done = true;
+  toggler.join();
+
+  // the qset counts exactly the items left, so the reader parks once they are read
+  std::atomic<int32_t> consumed(0);
+  int64_t              cpuMs = 0;
+  std::thread          reader([&]() {
+    SQueueInfo qinfo = {0};
+    STaosQall *qall = taosAllocateQall();
+    int64_t    drainedMs = 0;
+    while (1) {
+      void   *pItem = NULL;
+      int32_t num = taosReadAllQitemsFromQset(qset, qall, &qinfo);
+      if (num == 0) break;
+      for (int32_t i = 0; i < num; ++i) {
+        taosGetQitem(qall, &pItem);
+        taosFreeQitem(pItem);
+      }
+      taosUpdateItemSize((STaosQueue *)qinfo.queue, num);
+      drainedMs = threadCpuTimeMs();
+      consumed += num;
+    }
+    cpuMs = threadCpuTimeMs() - drainedMs;
+    taosFreeQall(qall);
+  });
+
+  while (consumed < kProducers * kItemsPerProducer) {
+    taosMsleep(1);
+  }
+  taosMsleep(300);
+  taosQsetThreadResume(qset);
+  reader.join();
+
+  ASSERT_EQ(consumed, kProducers * kItemsPerProducer);
+  ASSERT_LT(cpuMs, 100);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  taosCloseQueue(queue);
+  taosCloseQset(qset);
+}
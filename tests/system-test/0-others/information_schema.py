@@ -58,7 +58,7 @@ class TDTestCase:
         self.ins_list = ['ins_dnodes','ins_mnodes','ins_modules','ins_qnodes','ins_snodes','ins_cluster','ins_databases','ins_functions',\
             'ins_indexes','ins_stables','ins_tables','ins_tags','ins_users','ins_grants','ins_vgroups','ins_configs','ins_dnode_variables',\
                 'ins_topics','ins_subscriptions','ins_streams','ins_stream_tasks','ins_vnodes','ins_user_privileges']
-        self.perf_list = ['perf_connections','perf_queries','perf_consumers','perf_trans','perf_apps']
+        self.perf_list = ['perf_connections','perf_queries','perf_consumers','perf_trans','perf_apps','perf_query_memory']
     def insert_data(self,column_dict,tbname,row_num):
         insert_sql = self.setsql.set_insertsql(column_dict,tbname,self.binary_str,self.nchar_str)
         for i in range(row_num):